@@ -306,6 +306,7 @@ class boundaryConditions {
 
   void BordersSurface(const int&, array<bool, 4>&) const;
 
+  int PackSize() const;
   void PackBC(char*(&), const int&, int&) const;
   void UnpackBC(char*(&), const int&, int&);
 
@@ -417,6 +418,7 @@ class connection {
   void UpdateBorderFirst(const int&);
   void UpdateBorderSecond(const int&);
   void SwapOrder();
+  void AssignDecomposition(const decomposition&);
   void AdjustForSlice(const bool&, const int&);
   bool TestPatchMatch(const patch&, const patch&);
   void GetAddressesMPI(MPI_Aint (&)[12])const;
@@ -439,11 +441,14 @@ vector<connection> GetConnectionBCs(const vector<boundaryConditions>&,
                                     const decomposition&, const input&);
 vector<connection> GetConnectionBCsPar(const vector<boundaryConditions> &,
                                        const vector<plot3dBlock> &,
+                                       const decomposition &,
                                        const decomposition &, const input &,
                                        const int &, const MPI_Datatype &,
                                        const MPI_Datatype &);
 vector<boundaryConditions> GatherBCs(const vector<boundaryConditions> &,
                                      const decomposition &, const int &);
+vector<boundaryConditions> ScatterBCs(const vector<boundaryConditions> &,
+                                      const decomposition &, const int &);
 
 map<boundarySurface, pair<boundarySurface, int>> GetBlockInterConnBCs(
     const vector<boundaryConditions> &, const vector<plot3dBlock> &,
@@ -0,0 +1,46 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef COMPRESSIONHEADERDEF
+#define COMPRESSIONHEADERDEF
+
+/* This header contains the functions used to losslessly compress restart
+   data. The bytes of an array of doubles are first shuffled so that the same
+   byte of every value is stored together. Neighboring values in a flow
+   solution usually share their sign, exponent, and leading mantissa bytes, so
+   the shuffled bytes contain long repeated runs. The shuffled bytes are then
+   compressed with a fast LZ77 codec in the style of LZ4. Each sequence is a
+   token holding the number of literal bytes and the match length, followed by
+   the literal bytes, a 2 byte offset to the match, and any extra length bytes.
+   The last sequence only has literal bytes.
+ */
+
+#include <vector>   // vector
+#include <cstddef>  // size_t
+
+using std::vector;
+
+// function declarations
+vector<char> ShuffleBytes(const vector<double> &);
+vector<double> UnshuffleBytes(const vector<char> &);
+void WriteExtraLength(size_t, vector<char> &);
+void WriteSequence(const char *, const size_t &, const size_t &,
+                   const size_t &, vector<char> &);
+vector<char> CompressLZ(const vector<char> &);
+size_t ReadExtraLength(const vector<char> &, size_t &);
+vector<char> DecompressLZ(const vector<char> &, const size_t &);
+
+#endif
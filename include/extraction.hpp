@@ -0,0 +1,82 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef EXTRACTIONHEADERDEF
+#define EXTRACTIONHEADERDEF
+
+// This header file contains the definition of a probe, plane, or line to
+// extract from the solution, as specified in the input file. Planes and
+// lines are given by cell indices of a parent (unsplit) block, starting at 0.
+
+#include <vector>      // vector
+#include <array>       // array
+#include <string>      // string
+#include <fstream>     // ifstream
+#include <iostream>    // ostream
+#include "vector3d.hpp"
+
+using std::vector;
+using std::array;
+using std::string;
+using std::ifstream;
+using std::ostream;
+
+// class for an extraction specified in the input file
+class extraction {
+  string type_;               // probe, plane, or line
+  string name_;               // name used for extraction file
+  vector3d<double> point_;    // location of probe
+  int block_ = 0;             // parent block of plane or line
+  string direction_ = "i";    // plane normal or line direction
+  int index_ = 0;             // cell index of plane
+  array<int, 2> indices_;     // cell indices of line in other directions
+  int frequency_ = 1;         // iterations between samples
+
+ public:
+  // constructor
+  explicit extraction(string &);
+  extraction() : type_("probe"), name_("probe"), indices_({0, 0}) {}
+
+  // move constructor and assignment operator
+  extraction(extraction &&) noexcept = default;
+  extraction &operator=(extraction &&) = default;
+
+  // copy constructor and assignment operator
+  extraction(const extraction &) = default;
+  extraction &operator=(const extraction &) = default;
+
+  // member functions
+  string Type() const { return type_; }
+  string Name() const { return name_; }
+  vector3d<double> Point() const { return point_; }
+  int Block() const { return block_; }
+  string Direction() const { return direction_; }
+  int Index() const { return index_; }
+  array<int, 2> Indices() const { return indices_; }
+  int Frequency() const { return frequency_; }
+  bool IsProbe() const { return type_ == "probe"; }
+  bool Sample(const int &nn) const { return (nn + 1) % frequency_ == 0; }
+
+  // destructor
+  ~extraction() noexcept {}
+};
+
+// function declarations
+ostream &operator<<(ostream &, const extraction &);
+string::size_type NextExtraction(const string &);
+vector<extraction> ReadExtractionList(ifstream &, string &);
+
+#endif
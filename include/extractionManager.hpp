@@ -0,0 +1,146 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef EXTRACTIONMANAGERHEADERDEF
+#define EXTRACTIONMANAGERHEADERDEF
+
+/* This header contains the classes used to extract time histories of the
+   solution at probes, constant index planes, and grid lines while the solver
+   runs. An extraction is defined on the parent (unsplit) blocks and is mapped
+   to the cells of the split blocks on each processor. Each processor samples
+   its own cells, buffers the samples, and appends them to a binary file with
+   a collective write, so the solution is never gathered.
+
+   Each extraction is written to <simName>_<name>.ext which contains a header
+   (number of points, number of variables, parent block, starting cell and
+   number of cells in each direction, variable names), the dimensional cell
+   center coordinates of the points, and then one record per sample
+   (iteration, time, point values). When the simulation is restarted, an
+   existing file with a matching header is continued after the last record
+   at or before the restart iteration.
+ */
+
+#include <vector>      // vector
+#include <array>       // array
+#include <string>      // string
+#include "mpi.h"       // parallelism
+#include "range.hpp"
+#include "extraction.hpp"
+#include "output.hpp"  // cellExtractor
+
+using std::vector;
+using std::array;
+using std::string;
+
+// forward class declarations
+class procBlock;
+class decomposition;
+class kdtree;
+class input;
+class physics;
+
+// class for cell of split block that is sampled for an extraction
+class extractionCell {
+  int block_;  // local position of procBlock
+  int i_;      // cell indices in procBlock
+  int j_;
+  int k_;
+  int slot_;   // position of cell in extraction points
+
+ public:
+  // constructor
+  extractionCell(const int &b, const int &i, const int &j, const int &k,
+                 const int &s)
+      : block_(b), i_(i), j_(j), k_(k), slot_(s) {}
+
+  // member functions
+  int Block() const { return block_; }
+  int I() const { return i_; }
+  int J() const { return j_; }
+  int K() const { return k_; }
+  int Slot() const { return slot_; }
+};
+
+// class for the time history file of an extraction
+class extractionSeries {
+  extraction def_;                // extraction definition
+  string fileName_;               // name of extraction file
+  int parent_;                    // parent block of points, -1 if not located
+  array<range, 3> box_;           // parent block cells of points
+  vector<extractionCell> cells_;  // cells on this processor
+  MPI_Offset dataStart_;          // location of first record in file
+  int numRecords_;                // number of records in file
+  int numBuffered_;               // number of records in buffer
+  vector<double> buffer_;         // samples waiting to be written
+
+  // private member functions
+  void FindProbeCell(const kdtree &, const vector<array<int, 4>> &,
+                     const double &, const int &);
+  bool ContinueFile(const vector<string> &, const int &, const int &);
+  void WriteHeader(const vector<procBlock> &, const vector<string> &,
+                   const double &, const int &);
+  void WritePoints(const MPI_Offset &, const int &, const int &,
+                   const vector<double> &, const int &) const;
+
+ public:
+  // constructor
+  extractionSeries(const extraction &, const string &);
+
+  // move constructor and assignment operator
+  extractionSeries(extractionSeries &&) noexcept = default;
+  extractionSeries &operator=(extractionSeries &&) = default;
+
+  // copy constructor and assignment operator
+  extractionSeries(const extractionSeries &) = default;
+  extractionSeries &operator=(const extractionSeries &) = default;
+
+  // member functions
+  const extraction &Definition() const { return def_; }
+  int NumPoints() const {
+    return box_[0].Size() * box_[1].Size() * box_[2].Size();
+  }
+  int NumBuffered() const { return numBuffered_; }
+  bool IsLocated() const { return parent_ >= 0; }
+  void Locate(const vector<procBlock> &, const decomposition &,
+              const vector<vector3d<int>> &, const vector<array<range, 3>> &,
+              const kdtree &, const vector<array<int, 4>> &,
+              const vector<string> &, const input &, const int &);
+  void Sample(const vector<procBlock> &, const vector<cellExtractor> &,
+              const int &, const double &, const int &);
+  void Flush(const int &, const int &);
+};
+
+// class to sample and write all extractions
+class extractionManager {
+  vector<extractionSeries> series_;  // time history of each extraction
+  vector<string> variables_;         // names of variables to extract
+  vector<cellExtractor> extractors_;  // functions to evaluate variables
+  int bufferSize_;                   // number of records to buffer
+
+ public:
+  // constructor
+  extractionManager(const input &, const physics &);
+
+  // member functions
+  bool HaveExtractions() const { return !series_.empty(); }
+  void Locate(const vector<procBlock> &, const decomposition &, const input &,
+              const int &);
+  void Sample(const vector<procBlock> &, const input &, const int &,
+              const int &);
+  void Flush(const int &);
+};
+
+#endif
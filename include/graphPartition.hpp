@@ -0,0 +1,80 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef GRAPHPARTITIONHEADERDEF
+#define GRAPHPARTITIONHEADERDEF
+
+/* This header contains the weightedGraph class which is used to partition the
+   blocks of a grid among processors. Each vertex of the graph is a block
+   weighted by its load, and each edge is a connection between blocks weighted
+   by the number of faces it contains. The graph is partitioned with multilevel
+   recursive bisection so that the weight of the edges cut between partitions
+   is small while the load on each partition stays within a tolerance of the
+   ideal load.
+ */
+
+#include <vector>   // vector
+#include <utility>  // pair
+
+using std::vector;
+using std::pair;
+
+class weightedGraph {
+  vector<double> weight_;                       // vertex weights
+  vector<vector<pair<int, double>>> adjacency_;  // neighbors & edge weights
+
+  // private member functions
+  weightedGraph Coarsen(vector<int> &coarseMap) const;
+  weightedGraph Subgraph(const vector<int> &vertices) const;
+  vector<int> GrowBisection(const double &target) const;
+  void RefineBisection(const double &target, const double &tolerance,
+                       vector<int> &side) const;
+  int PeripheralVertex(const vector<int> &side) const;
+  void PartitionRecursive(const vector<int> &vertices, const int &numParts,
+                          const int &firstPart, const double &tolerance,
+                          vector<int> &part) const;
+
+ public:
+  // Constructor
+  explicit weightedGraph(const vector<double> &weights)
+      : weight_(weights), adjacency_(weights.size()) {}
+  weightedGraph() : weightedGraph(vector<double>()) {}
+
+  // move constructor and assignment operator
+  weightedGraph(weightedGraph &&) noexcept = default;
+  weightedGraph &operator=(weightedGraph &&) noexcept = default;
+
+  // copy constructor and assignment operator
+  weightedGraph(const weightedGraph &) = default;
+  weightedGraph &operator=(const weightedGraph &) = default;
+
+  // Member functions
+  int NumVertices() const { return weight_.size(); }
+  double Weight(const int &a) const { return weight_[a]; }
+  double TotalWeight() const;
+  const vector<pair<int, double>> &Neighbors(const int &a) const {
+    return adjacency_[a];
+  }
+  void AddEdge(const int &a, const int &b, const double &weight);
+  double CutWeight(const vector<int> &part) const;
+  vector<int> Bisect(const double &fraction, const double &tolerance) const;
+  vector<int> Partition(const int &numParts, const double &tolerance) const;
+
+  // Destructor
+  ~weightedGraph() noexcept {}
+};
+
+#endif
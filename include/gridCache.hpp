@@ -0,0 +1,97 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef GRIDCACHEHEADERDEF
+#define GRIDCACHEHEADERDEF
+
+/* This header contains the gridCache class which stores the preprocessed
+   geometry of a simulation so that later runs of the same configuration do
+   not have to rebuild it. The cache holds the connections between blocks, the
+   packed geometry of the procBlocks of the finest level (including the ghost
+   cell geometry), and the wall distance of the procBlocks on all grid levels.
+   It is only valid for the grid, boundary conditions, and decomposition it was
+   written with, so it is keyed with a hash of them. The packed geometry is
+   written in the native MPI_Pack format, so the key also includes the aither
+   version and the packed sizes of the stored types, and a cache written by a
+   different build is rebuilt rather than misread.
+ */
+
+#include <vector>   // vector
+#include <string>   // string
+#include <cstdint>  // uint64_t
+#include "mpi.h"    // parallelism
+
+using std::vector;
+using std::string;
+
+// forward class declarations
+class plot3dBlock;
+class boundaryConditions;
+class decomposition;
+class connection;
+class procBlock;
+class mgSolution;
+class input;
+
+class gridCache {
+  string fileName_;               // name of cache file
+  uint64_t key_;                  // hash of grid, bcs, and decomposition
+  uint64_t gridHash_;             // hash of contents of grid file
+  bool isValid_;                  // flag for cache file matching key
+  vector<MPI_Offset> offsets_;    // start of records of each processor
+  MPI_Offset position_;           // position of next record on this processor
+
+  // private member functions
+  vector<char> ReadRecord(MPI_File &);
+  void WriteRecord(MPI_File &, const char *, const int64_t &);
+
+ public:
+  // constructor
+  explicit gridCache(const input &);
+
+  // move constructor and assignment operator
+  gridCache(gridCache &&) noexcept = default;
+  gridCache &operator=(gridCache &&) = default;
+
+  // copy constructor and assignment operator
+  gridCache(const gridCache &) = default;
+  gridCache &operator=(const gridCache &) = default;
+
+  // member functions
+  string FileName() const { return fileName_; }
+  bool IsValid() const { return isValid_; }
+  void HashGrid(const input &, const int &);
+  void AssignKey(const vector<plot3dBlock> &,
+                 const vector<boundaryConditions> &, const decomposition &,
+                 const input &, const MPI_Datatype &, const MPI_Datatype &,
+                 const MPI_Datatype &);
+  vector<connection> ReadConnections(const MPI_Datatype &);
+  void Broadcast();
+  vector<procBlock> ReadBlocks(const decomposition &, const input &,
+                               const int &, const MPI_Datatype &,
+                               const MPI_Datatype &);
+  void ReadWallDistance(mgSolution &);
+  void Write(const mgSolution &, const int &, const MPI_Datatype &,
+             const MPI_Datatype &, const MPI_Datatype &);
+
+  // destructor
+  ~gridCache() noexcept {}
+};
+
+// function declarations
+uint64_t HashBytes(const void *, const size_t &, uint64_t);
+
+#endif
@@ -21,11 +21,14 @@
 #include <array>
 #include <string>
 #include <memory>
+#include <chrono>
+#include <algorithm>
 #include "procBlock.hpp"
 #include "boundaryConditions.hpp"
 #include "vector3d.hpp"
 #include "matMultiArray3d.hpp"
 #include "linearSolver.hpp"
+#include "haloExchange.hpp"
 #include "mpi.h"
 
 using std::string;
@@ -57,14 +60,53 @@ class gridLevel {
   vector<multiArray3d<double>> volWeightFactor_;
   vector<multiArray3d<std::array<double, 7>>> prolongCoeffs_;
   vector<blkMultiArray3d<varArray>> mgForcing_;
+  haloExchange halo_;  // ghost cell exchange at connection boundaries
+  vector<double> blockTime_;  // time spent on each block since last reset
+
+  // when a coarse level is agglomerated onto fewer processors than the fine
+  // level, restriction and prolongation transfer data between the fine and
+  // coarse ranks with a single all-to-all exchange
+  // -----
+  // the fine blocks on a processor are all sent to the same agglomerated
+  // rank; the coarse blocks on a processor are ordered by their fine rank, and
+  // then by their fine local position, so no indexing data is exchanged
+  bool isAgglomerated_ = false;
+  int aggRank_ = 0;  // rank fine blocks on this processor are coarsened onto
+  vector<int> aggSourceRank_;  // fine level rank of each coarse block
+  vector<vector3d<int>> aggCoarseDims_;  // coarse block size of fine blocks
+
+  // private member functions
+  haloExchange& Halo(const int& rank);
+  void AddBlockTime(
+      const int& bb,
+      const std::chrono::high_resolution_clock::time_point& start) {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+    blockTime_[bb] += elapsed.count();
+  }
+  void ConstructBlocks(const vector<plot3dBlock>& mesh,
+                       const vector<boundaryConditions>& bcs,
+                       const decomposition& decomp, const physics& phys,
+                       const int& rank, const input& inp,
+                       const MPI_Datatype& MPI_vec3d,
+                       const MPI_Datatype& MPI_vec3dMag);
+  void RestrictToAgglomerated(
+      gridLevel& coarse, const vector<blkMultiArray3d<varArray>>& fineResid,
+      vector<blkMultiArray3d<varArray>>& coarseResid) const;
+  vector<blkMultiArray3d<varArray>> AgglomeratedUpdate(
+      const gridLevel& fine) const;
 
  public:
   // Constructor
   gridLevel(const vector<plot3dBlock>& mesh,
-            const vector<boundaryConditions>& bcs, const decomposition& decomp,
-            const physics& phys, const vector<vector3d<int>>& origGridSizes,
-            const string& restartFile, input& inp, residual& first);
-  gridLevel(const int& numBlocks) : blocks_(numBlocks), mgForcing_(numBlocks) {}
+            const vector<boundaryConditions>& bcs,
+            const vector<connection>& connections, const decomposition& decomp,
+            const physics& phys, const int& rank, const input& inp,
+            const MPI_Datatype& MPI_vec3d, const MPI_Datatype& MPI_vec3dMag);
+  gridLevel(vector<procBlock> blocks, const vector<connection>& connections,
+            const physics& phys, const input& inp);
+  gridLevel(const int& numBlocks)
+      : blocks_(numBlocks), mgForcing_(numBlocks), blockTime_(numBlocks, 0.0) {}
   gridLevel() : gridLevel(0) {}
 
   // move constructor and assignment operator
@@ -90,7 +132,10 @@ class gridLevel {
                              const int& rank);
   void CalcResidual(const physics& phys, const input& inp, const int& rank,
                     const MPI_Datatype& MPI_tensorDouble,
-                    const MPI_Datatype& MPI_vec3d);
+                    const MPI_Datatype& MPI_vec3d, const bool& calcJacobian);
+  void GetBoundaryConditionsAndResidual(const physics& phys, const input& inp,
+                                        const int& rank,
+                                        const bool& calcJacobian);
 
   int NumConnections() const { return connections_.size(); }
   const vector<connection>& Connections() const { return connections_; }
@@ -116,28 +161,44 @@ class gridLevel {
   const vector<multiArray3d<double>> &VolWeightFactor() const {
     return volWeightFactor_;
   }
+  double BlockTime(const int& ii) const { return blockTime_[ii]; }
+  void ResetBlockTimes() {
+    std::fill(std::begin(blockTime_), std::end(blockTime_), 0.0);
+  }
 
-  gridLevel SendGridLevel(const int& rank, const int& numProcBlock,
-                          const MPI_Datatype& MPI_vec3d,
-                          const MPI_Datatype& MPI_vec3dMag,
-                          const MPI_Datatype& MPI_connection,
-                          const input& inp) const;
+  gridLevel GatherGridLevel(const decomposition& decomp, const int& rank,
+                            const MPI_Datatype& MPI_vec3d,
+                            const MPI_Datatype& MPI_vec3dMag,
+                            const input& inp) const;
   void GetGridLevel(const gridLevel& local, const int& rank,
                     const MPI_Datatype& MPI_uncoupledScalar,
                     const MPI_Datatype& MPI_vec3d,
                     const MPI_Datatype& MPI_tensorDouble, const input& inp);
+  void AssignDecomposition(const decomposition& decomp);
+  void Redistribute(const decomposition& oldDecomp,
+                    const decomposition& newDecomp, const int& rank,
+                    const input& inp, const MPI_Datatype& MPI_uncoupledScalar,
+                    const MPI_Datatype& MPI_vec3d,
+                    const MPI_Datatype& MPI_vec3dMag,
+                    const MPI_Datatype& MPI_tensorDouble);
   void CalcWallDistance(const kdtree& tree);
+  void UpdateStatistics(const input& inp, const physics& phys);
   void AssignSolToTimeN(const physics& phys);
   void AssignSolToTimeNm1();
   void SwapWallDist(const int& rank, const int& numGhosts);
   void SwapTurbVars(const int& rank, const int& numGhosts);
   void SwapViscosity(const int& rank, const int& numGhosts);
-  void SwapEddyViscAndGradients(const int& rank,
-                                const MPI_Datatype& MPI_tensorDouble,
-                                const MPI_Datatype& MPI_vec3d,
-                                const int& numGhosts);
+  void SwapEddyViscAndGradients(const int& rank, const bool& swapTurbVars);
+  void StartBoundaryConditions(const input& inp, const physics& phys,
+                               const int& rank);
+  void FinishBoundaryConditions(const input& inp, const physics& phys,
+                                const int& rank);
+  void CalcResidualSource(const physics& phys, const input& inp,
+                          const int& rank, const bool& calcJacobian);
+  bool ThreadOverBlocks() const;
   void AuxillaryAndWidths(const physics& phys);
-  gridLevel Coarsen(const decomposition& decomp, const input& inp,
+  bool IsAgglomerated() const { return isAgglomerated_; }
+  gridLevel Coarsen(decomposition& decomp, const input& inp,
                     const physics& phys, const int& rank,
                     const MPI_Datatype& MPI_connection,
                     const MPI_Datatype& MPI_vec3d,
@@ -146,7 +207,8 @@ class gridLevel {
                    const vector<blkMultiArray3d<varArray>>& fineResid,
                    const input& inp, const physics& phys, const int& rank,
                    const MPI_Datatype& MPI_tensorDouble,
-                   const MPI_Datatype& MPI_vec3d) const;
+                   const MPI_Datatype& MPI_vec3d,
+                   const bool& calcJacobian) const;
   void Prolongation(gridLevel& fine) const;
   void SubtractFromUpdate(const vector<blkMultiArray3d<varArray>>& coarseDu);
   vector<blkMultiArray3d<varArray>> Update() const { return solver_->X(); }
@@ -156,6 +218,18 @@ class gridLevel {
 };
 
 // function declarations
+void AgglomerateMeshAndBCs(vector<plot3dBlock>& mesh,
+                           vector<boundaryConditions>& bcs,
+                           const decomposition& fineDecomp,
+                           const decomposition& coarseDecomp, const int& rank,
+                           const MPI_Datatype& MPI_vec3d);
+vector<double> AgglomerationExchange(const vector<double>& sendBuf,
+                                     const vector<int>& sendCounts,
+                                     const vector<int>& recvCounts);
+void CombineResiduals(const vector<residual>& blockL2,
+                      const vector<resid>& blockLinf, residual& residL2,
+                      resid& residLinf);
+
 template <typename T>
 void BlockProlongation(const T& coarse,
                        const multiArray3d<vector3d<int>>& toCoarse,
@@ -0,0 +1,268 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef HALOEXCHANGE_HEADER_DEF
+#define HALOEXCHANGE_HEADER_DEF
+
+/* This header contains the haloExchange class which swaps ghost cell data
+   across connection boundaries. Connections with both sides on the same
+   processor are swapped directly. All connections shared with a neighboring
+   processor are packed into a single message, and the messages to all
+   neighbors are exchanged at once with nonblocking calls. Neighbors on the
+   same node exchange the packed data through a shared memory window instead,
+   so only an empty message is sent to signal that the data is ready. The
+   buffers, requests, and windows for all fields swapped are created when the
+   exchange is constructed, which is collective with the neighboring
+   processors.
+ */
+
+#include <vector>                  // vector
+#include <map>                     // map
+#include "mpi.h"                   // parallelism
+#include "vector3d.hpp"
+#include "macros.hpp"              // MSG_ASSERT
+
+using std::vector;
+
+// forward class declarations
+class connection;
+
+// structure to hold the cells swapped across a connection boundary with a
+// neighboring processor
+struct haloSlice {
+  int block_ = 0;           // local position of block on this processor
+  vector<int> sendCells_;   // cells sent to partner in partner's slice order
+  vector<int> recvCells_;   // ghost cells filled from partner (-1 if unused)
+};
+
+// structure to hold the message buffers and persistent requests for one set
+// of fields swapped with all neighboring processors
+// -----
+// for neighbors on the same node, the packed data is written to this
+// processor's half of a shared memory window and read directly from the
+// neighbor's half; the requests only carry empty messages to signal that the
+// data is ready. Each half holds two buffers that are used on alternate
+// exchanges, so a buffer is not overwritten before the neighbor has read it
+struct haloChannel {
+  int valuesPerCell_ = 0;
+  bool isActive_ = false;  // flag for messages in flight
+  int parity_ = 0;         // shared memory buffer used by current exchange
+  vector<int> count_;      // number of doubles exchanged with each neighbor
+  vector<vector<double>> sendBuf_;
+  vector<vector<double>> recvBuf_;
+  vector<MPI_Request> sendReq_;
+  vector<MPI_Request> recvReq_;
+  vector<MPI_Win> window_;  // shared memory window (MPI_WIN_NULL if unused)
+  vector<double *> sharedSend_;        // this processor's part of window
+  vector<const double *> sharedRecv_;  // neighbor's part of window
+
+  double *SendBuffer(const int &nn) {
+    return (window_[nn] == MPI_WIN_NULL)
+               ? sendBuf_[nn].data()
+               : sharedSend_[nn] + parity_ * count_[nn];
+  }
+  const double *RecvBuffer(const int &nn) const {
+    return (window_[nn] == MPI_WIN_NULL)
+               ? recvBuf_[nn].data()
+               : sharedRecv_[nn] + parity_ * count_[nn];
+  }
+};
+
+class haloExchange {
+  int rank_;                                 // processor rank
+  bool isSetUp_;                             // flag for constructed exchange
+  vector<vector<int>> localConns_;  // connections on this processor grouped
+                                    // so no block is in a group twice
+  vector<int> neighbors_;                    // ranks of neighbor processors
+  vector<bool> isSharedNeighbor_;            // neighbor is on same node
+  vector<vector<haloSlice>> neighborSlices_;  // slices shared with neighbors
+  std::map<int, haloChannel> channels_;      // message data for each tag
+
+  // private member functions
+  void CreateChannel(const int &tag, const int &valuesPerCell);
+  haloChannel &Channel(const int &tag, const int &valuesPerCell);
+  vector<int> SharedNeighborOrder() const;
+  void FindSharedNeighbors();
+  void FreeChannel(haloChannel &channel) const;
+  void FreeRequests();
+
+ public:
+  // Constructor
+  haloExchange(const vector<connection> &conns, const int &rank,
+               const vector<vector3d<int>> &blockDims, const int &numGhosts,
+               const std::map<int, int> &channelValues);
+  haloExchange() : rank_(0), isSetUp_(false) {}
+
+  // move constructor and assignment operator
+  haloExchange(haloExchange &&) noexcept;
+  haloExchange &operator=(haloExchange &&) noexcept;
+
+  // copy constructor and assignment operator are deleted because windows and
+  // requests are created and freed collectively with neighboring processors
+  haloExchange(const haloExchange &) = delete;
+  haloExchange &operator=(const haloExchange &) = delete;
+
+  // Member functions
+  int Rank() const { return rank_; }
+  bool IsSetUp(const int &rank) const { return isSetUp_ && rank_ == rank; }
+  int NumNeighbors() const { return neighbors_.size(); }
+  int Neighbor(const int &a) const { return neighbors_[a]; }
+  bool IsSharedNeighbor(const int &a) const { return isSharedNeighbor_[a]; }
+  int NumLocalConnections() const {
+    auto num = 0;
+    for (const auto &group : localConns_) {
+      num += group.size();
+    }
+    return num;
+  }
+
+  template <typename SwapLocal, typename Pack, typename Unpack>
+  void Exchange(const vector<connection> &conns, const int &tag,
+                const int &valuesPerCell, const SwapLocal &swapLocal,
+                const Pack &pack, const Unpack &unpack);
+  template <typename Pack>
+  void StartExchange(const int &tag, const int &valuesPerCell,
+                     const Pack &pack);
+  template <typename SwapLocal, typename Unpack>
+  void FinishExchange(const vector<connection> &conns, const int &tag,
+                      const SwapLocal &swapLocal, const Unpack &unpack);
+
+  // Destructor
+  ~haloExchange() noexcept { this->FreeRequests(); }
+};
+
+// ----------------------------------------------------------------------------
+// member function definitions
+
+/* Member function to swap data across all connection boundaries. The
+   swapLocal function is called for each connection with both sides on this
+   processor. The pack function is called for each slice shared with a
+   neighboring processor to copy the data for that slice into the message sent
+   to the neighbor. After the message from a neighbor arrives, the unpack
+   function is called for each slice shared with that neighbor in the same
+   order.
+   -----
+   The buffers and persistent requests for each tag are created with the
+   exchange and reused for every swap. Local connections that do not share a
+   block may be swapped concurrently, so swapLocal must only modify the two
+   blocks of the connection. Connections are visited in their global order on
+   both processors, so the messages carry no indexing or size information.
+   -----
+   swapLocal(const connection &)
+   pack(const haloSlice &, double *buffer) -> end of packed data
+   unpack(const haloSlice &, const double *buffer) -> end of unpacked data
+*/
+template <typename SwapLocal, typename Pack, typename Unpack>
+void haloExchange::Exchange(const vector<connection> &conns, const int &tag,
+                            const int &valuesPerCell,
+                            const SwapLocal &swapLocal, const Pack &pack,
+                            const Unpack &unpack) {
+  // conns -- connection boundaries used to construct exchange
+  // tag -- id for MPI messages
+  // valuesPerCell -- number of doubles packed for each cell
+  // swapLocal -- function to swap data for a local connection
+  // pack -- function to pack data for a slice into buffer
+  // unpack -- function to unpack data for a slice from buffer
+  this->StartExchange(tag, valuesPerCell, pack);
+  this->FinishExchange(conns, tag, swapLocal, unpack);
+}
+
+/* Member function to start an exchange. Receives are posted, and the data for
+   each neighbor is packed and sent. The exchange must be completed with
+   FinishExchange before the swapped fields are used or changed; work that only
+   touches data away from the connection boundaries can be done in between.
+*/
+template <typename Pack>
+void haloExchange::StartExchange(const int &tag, const int &valuesPerCell,
+                                 const Pack &pack) {
+  // tag -- id for MPI messages
+  // valuesPerCell -- number of doubles packed for each cell
+  // pack -- function to pack data for a slice into buffer
+  MSG_ASSERT(isSetUp_, "halo exchange used before being constructed");
+  auto &channel = this->Channel(tag, valuesPerCell);
+  MSG_ASSERT(!channel.isActive_, "halo exchange started twice");
+  const auto numNeighbors = this->NumNeighbors();
+
+  // post receives, then pack data for each neighbor and post sends
+  if (numNeighbors > 0) {
+    MPI_Startall(numNeighbors, channel.recvReq_.data());
+  }
+  for (auto nn = 0; nn < numNeighbors; ++nn) {
+    auto *start = channel.SendBuffer(nn);
+    auto *buffer = start;
+    for (const auto &slice : neighborSlices_[nn]) {
+      buffer = pack(slice, buffer);
+    }
+    MSG_ASSERT(buffer == start + channel.count_[nn],
+               "halo data packed does not match message size");
+    // make data in shared memory visible to neighbor before signaling it
+    if (channel.window_[nn] != MPI_WIN_NULL) {
+      MPI_Win_sync(channel.window_[nn]);
+    }
+  }
+  if (numNeighbors > 0) {
+    MPI_Startall(numNeighbors, channel.sendReq_.data());
+  }
+  channel.isActive_ = true;
+}
+
+/* Member function to finish an exchange started with StartExchange. Local
+   connections are swapped while the messages are in flight, then the messages
+   from each neighbor are unpacked.
+*/
+template <typename SwapLocal, typename Unpack>
+void haloExchange::FinishExchange(const vector<connection> &conns,
+                                  const int &tag, const SwapLocal &swapLocal,
+                                  const Unpack &unpack) {
+  // conns -- connection boundaries used to construct exchange
+  // tag -- id for MPI messages
+  // swapLocal -- function to swap data for a local connection
+  // unpack -- function to unpack data for a slice from buffer
+  auto it = channels_.find(tag);
+  MSG_ASSERT(it != channels_.end() && it->second.isActive_,
+             "halo exchange finished before being started");
+  auto &channel = it->second;
+  const auto numNeighbors = this->NumNeighbors();
+
+  // swap local connections while messages are in flight; connections in a
+  // group do not share a block, so they can be swapped concurrently
+  for (const auto &group : localConns_) {
+    const auto numConns = static_cast<int>(group.size());
+#pragma omp parallel for schedule(dynamic)
+    for (auto cc = 0; cc < numConns; ++cc) {
+      swapLocal(conns[group[cc]]);
+    }
+  }
+
+  // unpack messages in neighbor order so result is independent of arrival
+  for (auto nn = 0; nn < numNeighbors; ++nn) {
+    MPI_Wait(&channel.recvReq_[nn], MPI_STATUS_IGNORE);
+    if (channel.window_[nn] != MPI_WIN_NULL) {
+      MPI_Win_sync(channel.window_[nn]);
+    }
+    const auto *buffer = channel.RecvBuffer(nn);
+    for (const auto &slice : neighborSlices_[nn]) {
+      buffer = unpack(slice, buffer);
+    }
+  }
+
+  MPI_Waitall(numNeighbors, channel.sendReq_.data(), MPI_STATUSES_IGNORE);
+  channel.parity_ = 1 - channel.parity_;
+  channel.isActive_ = false;
+}
+
+#endif
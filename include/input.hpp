@@ -26,6 +26,8 @@
 #include "boundaryConditions.hpp"
 #include "inputStates.hpp"
 #include "fluid.hpp"
+#include "extraction.hpp"
+#include "monitor.hpp"
 #include "macros.hpp"
 
 using std::vector;
@@ -73,6 +75,7 @@ class input {
   string equationSet_;  // which set of equations to solver Euler/Navier-Stokes
   string matrixSolver_;  // matrix solver to solve Ax=b
   int matrixSweeps_;  // number of sweeps for matrix solver
+  int jacobianUpdateFrequency_;  // how often to rebuild implicit jacobians
   double matrixRelaxation_;  // relaxation parameter for matrix solver
   double timeIntTheta_;  // beam and warming time integration parameter
   double timeIntZeta_;  // beam and warming time integration parameter
@@ -85,6 +88,7 @@ class input {
   double dualTimeCFL_;  // cfl_ number for dual time
   string inviscidFlux_;  // scheme for inviscid flux calculation
   string decompMethod_;  // method of decomposition for parallel problems
+  bool gridCache_;  // read/write preprocessed grid geometry from cache
   string turbModel_;  // turbulence model
   string thermodynamicModel_;  // model for thermodynamics
   string equationOfState_;  // model for equation of state
@@ -93,6 +97,11 @@ class input {
   string chemistryModel_;  // model for chemical reactions
   string chemistryMechanism_;  // reaction mechanism
   int restartFrequency_;  // how often to output restart data
+  int residualOutputFrequency_;  // how often to output residuals
+  int rebalanceFrequency_;  // how often to rebalance load between processors
+  int outputQueueSize_;  // number of outputs that can be written in background
+  string outputPrecision_;  // precision of function files
+  string restartFormat_;  // compression of restart files
   int iterationStart_;  // starting number for iterations
   double schmidtNumber_;  // schmidt number for species diffusion
   double freezingTemperature_;  // temperature below which reactions cease
@@ -101,22 +110,42 @@ class input {
   int mgPreSweeps_;  // pre-relaxation sweeps
   int mgPostSweeps_;  // post-relaxation sweeps
   string mgCycle_;  // multigrid cycle type
+  int mgAgglomerationThreshold_;  // cells per rank to agglomerate coarse level
 
   set<string> outputVariables_;  // variables to output
   set<string> wallOutputVariables_;  // wall variables to output
 
+  vector<extraction> extractions_;  // probes, planes, and lines to extract
+  set<string> extractionVariables_;  // variables to extract
+  int extractionBufferSize_;  // number of samples buffered before writing
+
+  int statisticsFrequency_;  // how often to sample running statistics
+  int statisticsStart_;  // iteration after which statistics are sampled
+  set<string> statisticsVariables_;  // variables to sample for statistics
+  vector<monitor> monitors_;  // surfaces to integrate forces over
+  int monitorFrequency_;  // how often to integrate monitors
+  double monitorTolerance_;  // relative change of converged monitors
+
   vector<icState> ics_;  // initial conditions
   vector<shared_ptr<inputState>> bcStates_;  // information for boundary conditions
 
   // private member functions
   void CheckNonlinearIterations();
-  void CheckOutputVariables();
+  void CheckOutputVariables(set<string> &) const;
   void CheckWallOutputVariables();
   void CheckTurbulenceModel() const;
   void CheckSpecies() const;
   void CheckNonreflecting() const;
   void CheckChemistryMechanism() const;
   void CheckMultigrid() const;
+  void CheckJacobianUpdateFrequency() const;
+  void CheckResidualOutputFrequency() const;
+  void CheckRebalanceFrequency() const;
+  void CheckOutputQueueSize() const;
+  void CheckOutputFormats() const;
+  void CheckExtractions() const;
+  void CheckStatistics() const;
+  void CheckMonitors() const;
   unique_ptr<turbModel> AssignTurbulenceModel() const;
   unique_ptr<eos> AssignEquationOfState() const;
   unique_ptr<transport> AssignTransportModel() const;
@@ -193,19 +222,54 @@ class input {
 
   int OutputFrequency() const {return outputFrequency_;}
   int RestartFrequency() const {return restartFrequency_;}
+  int ResidualOutputFrequency() const {return residualOutputFrequency_;}
+  int RebalanceFrequency() const {return rebalanceFrequency_;}
+  int OutputQueueSize() const {return outputQueueSize_;}
+  string OutputPrecision() const {return outputPrecision_;}
+  bool IsSinglePrecisionOutput() const {return outputPrecision_ == "single";}
+  string RestartFormat() const {return restartFormat_;}
+  bool IsCompressedRestart() const {return restartFormat_ == "compressed";}
   set<string> OutputVariables() const {return outputVariables_;}
   bool OutputNodalVariables() const { return outputNodalVariables_; }
   set<string> WallOutputVariables() const {return wallOutputVariables_;}
+  const vector<extraction> &Extractions() const {return extractions_;}
+  set<string> ExtractionVariables() const {return extractionVariables_;}
+  int ExtractionBufferSize() const {return extractionBufferSize_;}
+  int StatisticsFrequency() const {return statisticsFrequency_;}
+  int StatisticsStart() const {return statisticsStart_;}
+  set<string> StatisticsVariables() const {return statisticsVariables_;}
+  bool CollectStatistics() const {return statisticsFrequency_ > 0;}
+  const vector<monitor> &Monitors() const {return monitors_;}
+  int MonitorFrequency() const {return monitorFrequency_;}
+  double MonitorTolerance() const {return monitorTolerance_;}
 
   bool WriteOutput(const int &nn) const {return (nn + 1) % outputFrequency_ == 0;}
   bool WriteRestart(const int &nn) const {
     return (restartFrequency_ == 0) ? false : (nn + 1) % restartFrequency_ == 0;
   }
+  bool SampleStatistics(const int &nn) const {
+    return this->CollectStatistics() &&
+           nn + iterationStart_ + 1 > statisticsStart_ &&
+           (nn + 1) % statisticsFrequency_ == 0;
+  }
+  // residuals are always written for the first 5 iterations because they are
+  // used to determine the residual normalization
+  bool WriteResiduals(const int &nn) const {
+    return nn + iterationStart_ < 5 || nn % residualOutputFrequency_ == 0 ||
+           nn == iterations_ - 1;
+  }
+  // load is not rebalanced after the last iteration
+  bool Rebalance(const int &nn) const {
+    return (rebalanceFrequency_ == 0)
+               ? false
+               : (nn + 1) % rebalanceFrequency_ == 0 && nn < iterations_ - 1;
+  }
 
   string EquationSet() const {return equationSet_;}
 
   string MatrixSolver() const {return matrixSolver_;}
   int MatrixSweeps() const {return matrixSweeps_;}
+  int JacobianUpdateFrequency() const {return jacobianUpdateFrequency_;}
   double MatrixRelaxation() const {return matrixRelaxation_;}
   bool MatrixRequiresInitialization() const;
   unique_ptr<linearSolver> AssignLinearSolver(const gridLevel &) const;
@@ -226,6 +290,7 @@ class input {
   string InviscidFlux() const {return inviscidFlux_;}
 
   string DecompMethod() const {return decompMethod_;}
+  bool UseGridCache() const {return gridCache_;}
   string TurbulenceModel() const {return turbModel_;}
   string ThermodynamicModel() const {return thermodynamicModel_;}
   string EquationOfState() const {return equationOfState_;}
@@ -278,6 +343,9 @@ class input {
   int MultigridPreSweeps() const { return mgPreSweeps_; }
   int MultigridPostSweeps() const { return mgPostSweeps_; }
   string MultigridCycleType() const { return mgCycle_; }
+  int MultigridAgglomerationThreshold() const {
+    return mgAgglomerationThreshold_;
+  }
   int MultigridCycleIndex() const {
     if (mgCycle_ == "W") {
       return 2;
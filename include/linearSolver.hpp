@@ -21,6 +21,7 @@
 #include <string>                  // string
 #include "matMultiArray3d.hpp"
 #include "blkMultiArray3d.hpp"
+#include "haloExchange.hpp"
 #include "macros.hpp"
 
 using std::string;
@@ -38,6 +39,7 @@ class linearSolver {
   string solverType_;
   vector<matMultiArray3d> a_;
   vector<matMultiArray3d> aInv_;
+  haloExchange halo_;  // halo exchange for update at connection boundaries
  protected:
   vector<blkMultiArray3d<varArray>> x_;
 
@@ -49,9 +51,9 @@ class linearSolver {
   linearSolver(linearSolver&&) noexcept = default;
   linearSolver& operator=(linearSolver&&) noexcept = default;
 
-  // copy constructor and assignment operator
-  linearSolver(const linearSolver&) = default;
-  linearSolver& operator=(const linearSolver&) = default;
+  // copy constructor and assignment operator are deleted because of halo
+  linearSolver(const linearSolver&) = delete;
+  linearSolver& operator=(const linearSolver&) = delete;
 
   // member functions
   int NumBlocks() const { return a_.size(); }
@@ -77,11 +79,12 @@ class linearSolver {
   void SubtractFromUpdate(const vector<blkMultiArray3d<varArray>>& coarseDu);
   void AddToUpdate(const vector<blkMultiArray3d<varArray>>& correction);
   void ZeroA(const int &bb) { a_[bb].Zero(); }
+  void AssignUpdate(const vector<blkMultiArray3d<varArray>> &x) { x_ = x; }
   void Restriction(unique_ptr<linearSolver> &coarse,
                    const vector<connection> &conn,
                    const vector<multiArray3d<vector3d<int>>> &toCoarse,
                    const vector<multiArray3d<double>> &volWeightFactor,
-                   const int &rank) const;
+                   const int &rank, const int &numGhosts) const;
 
   virtual vector<blkMultiArray3d<varArray>> Relax(const gridLevel &,
                                                   const physics &,
@@ -115,9 +118,9 @@ class lusgs : public linearSolver {
   lusgs(lusgs &&solver) noexcept : linearSolver(std::move(solver)) {}
   lusgs &operator=(lusgs &&) noexcept = default;
 
-  // copy constructor and assignment operator
-  lusgs(const lusgs &solver) : linearSolver(solver) {}
-  lusgs &operator=(const lusgs &) = default;
+  // copy constructor and assignment operator are deleted because of halo
+  lusgs(const lusgs &) = delete;
+  lusgs &operator=(const lusgs &) = delete;
 
   // member functions
   vector<blkMultiArray3d<varArray>> Relax(const gridLevel &, const physics &,
@@ -145,9 +148,9 @@ class dplur : public linearSolver {
   dplur(dplur &&solver) noexcept : linearSolver(std::move(solver)) {}
   dplur &operator=(dplur &&) noexcept = default;
 
-  // copy constructor and assignment operator
-  dplur(const dplur &solver) : linearSolver(solver) {}
-  dplur &operator=(const dplur &) = default;
+  // copy constructor and assignment operator are deleted because of halo
+  dplur(const dplur &) = delete;
+  dplur &operator=(const dplur &) = delete;
 
   // member functions
   vector<blkMultiArray3d<varArray>> Relax(const gridLevel &, const physics &,
@@ -20,6 +20,8 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <vector>
+#include "mpi.h"
 #include "varArray.hpp"
 #include "macros.hpp"
 
@@ -34,6 +36,12 @@ class logFileManager {
   residual l2First_;
   std::chrono::high_resolution_clock::time_point simStartTime_;
   std::chrono::high_resolution_clock::time_point iterStartTime_;
+  // L2 norms, matrix residual, and linf residual being reduced to ROOT
+  std::vector<double> reduceBuffer_;
+  MPI_Request reduceRequest_;
+  double reduceCFL_;
+  int reduceIter_;
+  int reduceNonlinearIter_;
 
  public:
   // Constructor
@@ -43,7 +51,13 @@ class logFileManager {
   residual &L2First() { return l2First_; }
   const residual &L2First() const { return l2First_; }
   void WriteResiduals(const input &, const residual &, const resid &,
-                      const double &, const int &, const int &);
+                      const double &, const double &, const int &,
+                      const int &);
+  int ReductionSize() const { return l2First_.Size() + 7; }
+  void StartResidualReduction(const residual &, const resid &, const double &,
+                              const double &, const int &, const int &,
+                              const MPI_Datatype &, const MPI_Op &);
+  void FinishResidualReduction(const input &, const double &);
   void GetIterStart();
   void WriteTime(const int &nn);
 
@@ -51,6 +65,8 @@ class logFileManager {
   ~logFileManager();
 };
 
+// function declarations
+void ReduceResiduals(double *, double *, int *, MPI_Datatype *);
 
 
 #endif
@@ -30,6 +30,7 @@ using std::vector;
 // forward class declaration
 class plot3dBlock;
 class boundaryConditions;
+class connection;
 class input;
 class decomposition;
 class input;
@@ -41,6 +42,12 @@ class mgSolution {
   vector<gridLevel> solution_;
   int mgCycleIndex_;
 
+  // implicit jacobians on all levels can be reused for several iterations of
+  // steady simulations
+  bool updateJacobian_ = true;  // rebuild jacobians during this iteration
+  int jacobianAge_ = 0;  // iterations current jacobians have been used for
+  vector<double> residNorm_;  // residuals of this processor last iteration
+
   // private member functions
   double ImplicitUpdate(const input& inp, const physics& phys, const int& mm,
                         const int& rank, const MPI_Datatype& MPI_tensorDouble,
@@ -52,6 +59,7 @@ class mgSolution {
                    const MPI_Datatype& MPI_tensorDouble,
                    const MPI_Datatype& MPI_vec3d);
   void Prolongation(const int&);
+  void CheckJacobianUpdate(const input& inp, const residual& residL2);
   double CycleAtLevel(const int&, const int&, const physics&, const input&,
                       const int&, const MPI_Datatype&, const MPI_Datatype&);
   vector<blkMultiArray3d<varArray>> Relax(const int&, const int&,
@@ -83,21 +91,31 @@ class mgSolution {
   int FinestIndex() const { return 0; }
   const gridLevel& Coarsest() const { return solution_.back(); }
 
-  void ConstructFinestLevel(const vector<plot3dBlock>& mesh,
-                            const vector<boundaryConditions>& bcs,
-                            const decomposition& decomp, const physics& phys,
-                            const string& restartFile, input& inp,
-                            residual& first);
   void ConstructMultigrids(const decomposition& decomp, const input& inp,
                            const physics& phys, const int &rank,
                            const MPI_Datatype& MPI_connection,
                            const MPI_Datatype& MPI_vec3d,
                            const MPI_Datatype& MPI_vec3dMag);
-  mgSolution SendFinestGridLevel(const int& rank, const int& numProcBlock,
+  void ConstructLocalFinestLevel(const vector<plot3dBlock>& mesh,
+                                 const vector<boundaryConditions>& bcs,
+                                 const vector<connection>& connections,
+                                 const decomposition& decomp,
+                                 const physics& phys, const int& rank,
+                                 const input& inp,
                                  const MPI_Datatype& MPI_vec3d,
-                                 const MPI_Datatype& MPI_vec3dMag,
-                                 const MPI_Datatype& MPI_connection,
-                                 const input& inp) const;
+                                 const MPI_Datatype& MPI_vec3dMag);
+  void ConstructLocalFinestLevel(vector<procBlock> blocks,
+                                 const vector<connection>& connections,
+                                 const physics& phys, const input& inp);
+  void ReadFinestRestart(const string& restartFile,
+                         const decomposition& decomp, input& inp,
+                         const physics& phys, residual& first,
+                         const int& rank);
+  mgSolution GatherFinestGridLevel(const decomposition& decomp,
+                                   const int& rank,
+                                   const MPI_Datatype& MPI_vec3d,
+                                   const MPI_Datatype& MPI_vec3dMag,
+                                   const input& inp) const;
   void GetFinestGridLevel(const mgSolution& local, const int& rank,
                           const MPI_Datatype& MPI_uncoupledScalar,
                           const MPI_Datatype& MPI_vec3d,
@@ -106,9 +124,22 @@ class mgSolution {
   void AuxillaryAndWidths(const physics& phys);
   void StoreOldSolution(const input& inp, const physics& phys, const int &iter);
   void CalcWallDistance(const kdtree& tree);
+  void UpdateStatistics(const input& inp, const physics& phys) {
+    solution_[this->FinestIndex()].UpdateStatistics(inp, phys);
+  }
   void SwapWallDist(const int& rank, const int& numGhosts);
   void SubtractFromUpdate(const int& ll,
                           const vector<blkMultiArray3d<varArray>>& coarseDu);
+  bool Rebalance(decomposition& decomp, const kdtree& tree, const input& inp,
+                 const physics& phys, const int& rank,
+                 const MPI_Datatype& MPI_uncoupledScalar,
+                 const MPI_Datatype& MPI_connection,
+                 const MPI_Datatype& MPI_vec3d,
+                 const MPI_Datatype& MPI_vec3dMag,
+                 const MPI_Datatype& MPI_tensorDouble);
+  void AssignFinestDecomposition(const decomposition& decomp) {
+    solution_[this->FinestIndex()].AssignDecomposition(decomp);
+  }
   double Iterate(const input& inp, const physics& phys,
                  const MPI_Datatype& MPI_tensorDouble,
                  const MPI_Datatype& MPI_vec3d, const int& mm, const int& rank,
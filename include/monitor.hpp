@@ -0,0 +1,71 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef MONITORHEADERDEF
+#define MONITORHEADERDEF
+
+// This header file contains the definition of a group of boundary surfaces
+// to integrate forces, moments, heat transfer, and mass flow over, as
+// specified in the input file. The surfaces are selected by the tags of their
+// boundary conditions.
+
+#include <vector>      // vector
+#include <string>      // string
+#include <fstream>     // ifstream
+#include <iostream>    // ostream
+#include "vector3d.hpp"
+
+using std::vector;
+using std::string;
+using std::ifstream;
+using std::ostream;
+
+// class for a surface monitor specified in the input file
+class monitor {
+  string name_;              // name used for columns of monitor file
+  vector<int> tags_;         // tags of boundary surfaces to integrate over
+  vector3d<double> point_;   // point moments are taken about
+
+ public:
+  // constructor
+  explicit monitor(string &);
+  monitor() : name_("surface") {}
+
+  // move constructor and assignment operator
+  monitor(monitor &&) noexcept = default;
+  monitor &operator=(monitor &&) = default;
+
+  // copy constructor and assignment operator
+  monitor(const monitor &) = default;
+  monitor &operator=(const monitor &) = default;
+
+  // member functions
+  string Name() const { return name_; }
+  const vector<int> &Tags() const { return tags_; }
+  vector3d<double> Point() const { return point_; }
+  bool HasTag(const int &) const;
+
+  // destructor
+  ~monitor() noexcept {}
+};
+
+// function declarations
+ostream &operator<<(ostream &, const monitor &);
+string::size_type NextMonitor(const string &);
+vector<monitor> ReadMonitorList(ifstream &, string &);
+vector<string> MonitorColumns();
+
+#endif
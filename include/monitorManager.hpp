@@ -0,0 +1,94 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef MONITORMANAGERHEADERDEF
+#define MONITORMANAGERHEADERDEF
+
+/* This header contains the monitorManager class which integrates the pressure
+   and viscous forces, the moment of the total force about a reference point,
+   the heat transfer to the surfaces, and the mass flow out of the domain over
+   the boundary surfaces of each monitor while the solver runs. Each processor
+   integrates over the faces of its own blocks, and the integrals of all
+   monitors are summed with a single nonblocking reduction that is completed
+   at the next sample, so processors are not synchronized by the monitors.
+
+   ROOT appends one line per sample to <simName>.mon next to the residual file.
+   Each line contains the iteration and the dimensional integrals of each
+   monitor. The viscous force and heat transfer are taken from the wall data,
+   so they are only nonzero on viscous walls. With a monitorTolerance, the
+   monitors are converged once the pressure force, viscous force, and moment
+   of every monitor each change between samples by no more than the tolerance
+   times their magnitude, and the solver stops after writing the solution.
+ */
+
+#include <vector>      // vector
+#include <string>      // string
+#include <fstream>     // ofstream
+#include "mpi.h"       // parallelism
+#include "monitor.hpp"
+#include "vector3d.hpp"
+
+using std::vector;
+using std::string;
+
+// forward class declarations
+class procBlock;
+class boundarySurface;
+class input;
+class physics;
+
+// class to integrate and log all monitors
+class monitorManager {
+  vector<monitor> monitors_;  // definition of each monitor
+  std::ofstream log_;         // monitor file
+  int rank_;                  // processor rank
+  int frequency_;             // iterations between samples
+  int width_;                 // width of columns in monitor file
+  vector<double> scales_;     // dimensional scale of each integrated value
+  double lRef_;               // reference length
+  double tolerance_;          // relative change of converged monitors
+
+  // integrals being summed on all processors
+  vector<double> reduceBuffer_;
+  MPI_Request reduceRequest_;
+  int reduceIter_;
+  vector<double> previous_;   // integrals of previous sample
+  bool converged_;            // flag for monitors converged
+
+ public:
+  // constructor
+  monitorManager(const input &, const physics &, const int &);
+
+  // member functions
+  bool HaveMonitors() const { return !monitors_.empty(); }
+  int NumValues() const { return monitors_.size() * scales_.size(); }
+  bool Sample(const int &nn) const {
+    return this->HaveMonitors() && (nn + 1) % frequency_ == 0;
+  }
+  bool Converged() const { return converged_; }
+  void StartIntegration(const vector<procBlock> &, const physics &,
+                        const int &);
+  void FinishIntegration();
+
+  // destructor
+  ~monitorManager();
+};
+
+// function declarations
+void IntegrateSurface(const procBlock &, const boundarySurface &,
+                      const physics &, const vector3d<double> &, double *);
+
+#endif
@@ -30,6 +30,7 @@
 #include <memory>    // unique_ptr
 #include <utility>   // pair
 #include <type_traits>
+#include <cstring>   // memcpy
 #include "mpi.h"
 #include "vector3d.hpp"
 #include "boundaryConditions.hpp"  // connection
@@ -202,6 +203,9 @@ class multiArray3d {
 
   void PackSwapUnpackMPI(const connection &, const MPI_Datatype &, const int &,
                          const int = 1);
+  int PackSizeMPI(const MPI_Datatype &) const;
+  void PackMPI(vector<char> &, int &, const MPI_Datatype &) const;
+  void UnpackMPI(const vector<char> &, int &, const MPI_Datatype &);
 
   T GetElem(const int &ii, const int &jj, const int &kk) const;
 
@@ -822,39 +826,44 @@ void SwapSliceLocal(T &array1, const connection &conn, T &array2) {
   array2.PutSlice(slice1, conn1, array1.GhostLayers());
 }
 
-/* Function to swap slice using MPI. This is similar to the SwapSlice
-   function, but is called when the neighboring procBlocks are on different
-   processors.
+/* Function to get the indices of the slice of an array that is sent to the
+   partner block across a connection boundary.
 */
 template <typename T>
-void SwapSliceParallel(T &array, const connection &conn, const int &rank,
-                       const MPI_Datatype &MPI_arrData, const int tag) {
+void ConnectionSliceIndices(const T &array, const connection &conn,
+                            const int &rank, int &is, int &ie, int &js,
+                            int &je, int &ks, int &ke) {
   // array -- array on local processor to swap
   // conn -- connection boundary information
   // rank -- processor rank
-  // MPI_arrData -- MPI datatype for passing data in *this
-  // tag -- id for MPI swap (default 1)
-
-  // Get indices for slice coming from block to swap
-  auto is = 0, ie = 0;
-  auto js = 0, je = 0;
-  auto ks = 0, ke = 0;
+  // is -- starting i index of slice
+  // ie -- ending i index of slice
+  // js -- starting j index of slice
+  // je -- ending j index of slice
+  // ks -- starting k index of slice
+  // ke -- ending k index of slice
 
   if (rank == conn.RankFirst()) {  // local block first in connection
     conn.FirstSliceIndices(is, ie, js, je, ks, ke, array.GhostLayers());
   } else if (rank == conn.RankSecond()) {  // local block second in connection
     conn.SecondSliceIndices(is, ie, js, je, ks, ke, array.GhostLayers());
   } else {
-    cerr << "ERROR: Error in SwapSliceParallel(). Processor rank does "
+    cerr << "ERROR: Error in ConnectionSliceIndices(). Processor rank does "
             "not match either of connection ranks!" << endl;
     exit(EXIT_FAILURE);
   }
+}
 
-  // get local state slice to swap
-  auto slice = array.Slice({is, ie}, {js, je}, {ks, ke});
-
-  // swap state slices with partner block
-  slice.PackSwapUnpackMPI(conn, MPI_arrData, rank, tag);
+/* Function to insert a slice received from the partner block across a
+   connection boundary into the ghost cells of an array.
+*/
+template <typename T, typename TT>
+void PutConnectionSlice(T &array, const TT &slice, const connection &conn,
+                        const int &rank) {
+  // array -- array on local processor to insert slice into
+  // slice -- slice received from partner block
+  // conn -- connection boundary information
+  // rank -- processor rank
 
   // change connections to work with slice and ghosts
   auto connAdj = conn;
@@ -872,6 +881,88 @@ void SwapSliceParallel(T &array, const connection &conn, const int &rank,
   array.PutSlice(slice, connAdj, array.GhostLayers());
 }
 
+/* Function to swap slice using MPI. This is similar to the SwapSlice
+   function, but is called when the neighboring procBlocks are on different
+   processors.
+*/
+template <typename T>
+void SwapSliceParallel(T &array, const connection &conn, const int &rank,
+                       const MPI_Datatype &MPI_arrData, const int tag) {
+  // array -- array on local processor to swap
+  // conn -- connection boundary information
+  // rank -- processor rank
+  // MPI_arrData -- MPI datatype for passing data in *this
+  // tag -- id for MPI swap (default 1)
+
+  // Get indices for slice coming from block to swap
+  auto is = 0, ie = 0;
+  auto js = 0, je = 0;
+  auto ks = 0, ke = 0;
+  ConnectionSliceIndices(array, conn, rank, is, ie, js, je, ks, ke);
+
+  // get local state slice to swap
+  auto slice = array.Slice({is, ie}, {js, je}, {ks, ke});
+
+  // swap state slices with partner block
+  slice.PackSwapUnpackMPI(conn, MPI_arrData, rank, tag);
+
+  // insert state slice into procBlock
+  PutConnectionSlice(array, slice, conn, rank);
+}
+
+// function to get the number of doubles needed to store one cell of an array
+template <typename T>
+int HaloValuesPerCell(const T &array) {
+  // array -- array to swap
+  using elemType = std::remove_reference_t<decltype(*array.begin())>;
+  static_assert(sizeof(elemType) % sizeof(double) == 0,
+                "halo data must be composed of doubles!");
+  return array.BlockSize() * sizeof(elemType) / sizeof(double);
+}
+
+/* Function to copy the given cells of an array into a buffer. The cells are
+   given as 1D cell locations in the array (including ghost cells). A pointer
+   to the end of the packed data is returned.
+*/
+template <typename T>
+double *PackCells(const T &array, const vector<int> &cells, double *buffer) {
+  // array -- array to copy data from
+  // cells -- locations of cells to copy
+  // buffer -- buffer to copy data into
+  const auto numVals = HaloValuesPerCell(array);
+  const auto bytes = numVals * sizeof(double);
+  const auto *data = &(*array.begin());
+  for (const auto &cc : cells) {
+    std::memcpy(buffer, data + cc * array.BlockSize(), bytes);
+    buffer += numVals;
+  }
+  return buffer;
+}
+
+/* Function to copy data from a buffer into the given cells of an array. Cells
+   with a negative location are not used, and their data is skipped. A pointer
+   to the end of the unpacked data is returned.
+*/
+template <typename T>
+const double *UnpackCells(T &array, const vector<int> &cells,
+                          const double *buffer) {
+  // array -- array to copy data into
+  // cells -- locations of cells to copy into
+  // buffer -- buffer to copy data from
+  const auto numVals = HaloValuesPerCell(array);
+  const auto bytes = numVals * sizeof(double);
+  auto *data = &(*array.begin());
+  for (const auto &cc : cells) {
+    if (cc >= 0) {
+      // element types are composed of doubles, so a raw copy is valid
+      std::memcpy(static_cast<void *>(data + cc * array.BlockSize()), buffer,
+                  bytes);
+    }
+    buffer += numVals;
+  }
+  return buffer;
+}
+
 template <typename T>
 void InsertSlice(T &array1, const T &array2, const connection &inter,
                  const int &d3) {
@@ -1447,7 +1538,30 @@ void multiArray3d<T>::PackSwapUnpackMPI(const connection &inter,
   // tag -- id to send data with (default 1)
 
   // swap with mpi_send_recv_replace
-  // pack data into buffer, but first get size
+  // pack data into buffer
+  vector<char> buffer;
+  auto position = 0;
+  this->PackMPI(buffer, position, MPI_arrData);
+  auto bufSize = static_cast<int>(buffer.size());
+
+  MPI_Status status;
+  if (rank == inter.RankFirst()) {  // send/recv with second entry in connection
+    MPI_Sendrecv_replace(buffer.data(), bufSize, MPI_PACKED, inter.RankSecond(),
+                         tag, inter.RankSecond(), tag, MPI_COMM_WORLD, &status);
+  } else {  // send/recv with first entry in connection
+    MPI_Sendrecv_replace(buffer.data(), bufSize, MPI_PACKED, inter.RankFirst(),
+                         tag, inter.RankFirst(), tag, MPI_COMM_WORLD, &status);
+  }
+
+  // put slice back into multiArray3d
+  position = 0;
+  this->UnpackMPI(buffer, position, MPI_arrData);
+}
+
+// member function to get the size of the buffer needed to pack the array
+template <typename T>
+int multiArray3d<T>::PackSizeMPI(const MPI_Datatype &MPI_arrData) const {
+  // MPI_arrData -- MPI datatype to pass data type in array
   auto bufSize = 0;
   auto tempSize = 0;
   // add size for states
@@ -1456,11 +1570,21 @@ void multiArray3d<T>::PackSwapUnpackMPI(const connection &inter,
   // add size for 5 ints for multiArray3d dims and num ghosts
   MPI_Pack_size(5, MPI_INT, MPI_COMM_WORLD, &tempSize);
   bufSize += tempSize;
+  return bufSize;
+}
 
-  // allocate buffer to pack data into
-  // use unique_ptr to manage memory; use underlying pointer for MPI calls
-  auto buffer = std::make_unique<char[]>(bufSize);
-  auto *rawBuffer = buffer.get();
+/* Member function to append the array dimensions and data to a buffer. The
+   buffer is grown to fit the packed data, so several arrays can be packed
+   into the same buffer one after another.
+*/
+template <typename T>
+void multiArray3d<T>::PackMPI(vector<char> &buffer, int &position,
+                              const MPI_Datatype &MPI_arrData) const {
+  // buffer -- buffer to pack data into
+  // position -- location in buffer to start packing at
+  // MPI_arrData -- MPI datatype to pass data type in array
+  buffer.resize(position + this->PackSizeMPI(MPI_arrData));
+  auto bufSize = static_cast<int>(buffer.size());
 
   // pack data into buffer
   auto numI = this->NumI();
@@ -1468,43 +1592,52 @@ void multiArray3d<T>::PackSwapUnpackMPI(const connection &inter,
   auto numK = this->NumK();
   auto numGhosts = this->GhostLayers();
   auto blkSize = this->BlockSize();
-  auto position = 0;
-  MPI_Pack(&numI, 1, MPI_INT, rawBuffer, bufSize, &position, MPI_COMM_WORLD);
-  MPI_Pack(&numJ, 1, MPI_INT, rawBuffer, bufSize, &position, MPI_COMM_WORLD);
-  MPI_Pack(&numK, 1, MPI_INT, rawBuffer, bufSize, &position, MPI_COMM_WORLD);
-  MPI_Pack(&numGhosts, 1, MPI_INT, rawBuffer, bufSize, &position,
+  MPI_Pack(&numI, 1, MPI_INT, buffer.data(), bufSize, &position,
            MPI_COMM_WORLD);
-  MPI_Pack(&blkSize, 1, MPI_INT, rawBuffer, bufSize, &position, MPI_COMM_WORLD);
-  MPI_Pack(&(*std::begin(data_)), this->Size(), MPI_arrData, rawBuffer, bufSize,
-           &position, MPI_COMM_WORLD);
-
-  MPI_Status status;
-  if (rank == inter.RankFirst()) {  // send/recv with second entry in connection
-    MPI_Sendrecv_replace(rawBuffer, bufSize, MPI_PACKED, inter.RankSecond(),
-                         tag, inter.RankSecond(), tag, MPI_COMM_WORLD, &status);
-  } else {  // send/recv with first entry in connection
-    MPI_Sendrecv_replace(rawBuffer, bufSize, MPI_PACKED, inter.RankFirst(),
-                         tag, inter.RankFirst(), tag, MPI_COMM_WORLD, &status);
-  }
+  MPI_Pack(&numJ, 1, MPI_INT, buffer.data(), bufSize, &position,
+           MPI_COMM_WORLD);
+  MPI_Pack(&numK, 1, MPI_INT, buffer.data(), bufSize, &position,
+           MPI_COMM_WORLD);
+  MPI_Pack(&numGhosts, 1, MPI_INT, buffer.data(), bufSize, &position,
+           MPI_COMM_WORLD);
+  MPI_Pack(&blkSize, 1, MPI_INT, buffer.data(), bufSize, &position,
+           MPI_COMM_WORLD);
+  MPI_Pack(&(*std::begin(data_)), this->Size(), MPI_arrData, buffer.data(),
+           bufSize, &position, MPI_COMM_WORLD);
+}
 
-  // put slice back into multiArray3d
-  position = 0;
-  MPI_Unpack(rawBuffer, bufSize, &position, &numI, 1, MPI_INT,
+/* Member function to unpack an array packed with PackMPI. The array must
+   already be the same total size as the packed array; it is resized to the
+   packed dimensions.
+*/
+template <typename T>
+void multiArray3d<T>::UnpackMPI(const vector<char> &buffer, int &position,
+                                const MPI_Datatype &MPI_arrData) {
+  // buffer -- buffer to unpack data from
+  // position -- location in buffer to start unpacking at
+  // MPI_arrData -- MPI datatype to pass data type in array
+  auto bufSize = static_cast<int>(buffer.size());
+  auto numI = 0;
+  auto numJ = 0;
+  auto numK = 0;
+  auto numGhosts = 0;
+  auto blkSize = 0;
+  MPI_Unpack(buffer.data(), bufSize, &position, &numI, 1, MPI_INT,
              MPI_COMM_WORLD);
-  MPI_Unpack(rawBuffer, bufSize, &position, &numJ, 1, MPI_INT,
+  MPI_Unpack(buffer.data(), bufSize, &position, &numJ, 1, MPI_INT,
              MPI_COMM_WORLD);
-  MPI_Unpack(rawBuffer, bufSize, &position, &numK, 1, MPI_INT,
+  MPI_Unpack(buffer.data(), bufSize, &position, &numK, 1, MPI_INT,
              MPI_COMM_WORLD);
-  MPI_Unpack(rawBuffer, bufSize, &position, &numGhosts, 1, MPI_INT,
+  MPI_Unpack(buffer.data(), bufSize, &position, &numGhosts, 1, MPI_INT,
              MPI_COMM_WORLD);
-  MPI_Unpack(rawBuffer, bufSize, &position, &blkSize, 1, MPI_INT,
+  MPI_Unpack(buffer.data(), bufSize, &position, &blkSize, 1, MPI_INT,
              MPI_COMM_WORLD);
 
   // resize slice
   this->SameSizeResize(numI, numJ, numK);
 
-  MPI_Unpack(rawBuffer, bufSize, &position, &(*std::begin(data_)), this->Size(),
-             MPI_arrData, MPI_COMM_WORLD);
+  MPI_Unpack(buffer.data(), bufSize, &position, &(*std::begin(data_)),
+             this->Size(), MPI_arrData, MPI_COMM_WORLD);
 }
 
 /* Function to swap slice using MPI. This is similar to the SwapSlice
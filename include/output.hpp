@@ -29,6 +29,11 @@ It also writes out a master file in Ensight format to name the Plot3D functions.
 #include <iostream>
 #include <vector>        // vector
 #include <string>        // string
+#include <array>         // array
+#include <functional>    // function
+#include "mpi.h"         // parallelism
+#include "vector3d.hpp"
+#include "range.hpp"
 #include "multiArray3d.hpp"
 #include "blkMultiArray3d.hpp"
 
@@ -37,6 +42,8 @@ using std::string;
 using std::ios;
 using std::ofstream;
 using std::ifstream;
+using std::array;
+using std::function;
 using std::cout;
 using std::endl;
 using std::cerr;
@@ -52,21 +59,39 @@ class input;
 class primitive;
 class residual;
 class gridLevel;
+class outputQueue;
+
+// functions that return the value of an output variable at a cell or wall face
+// of a procBlock
+using cellExtractor =
+    function<double(const procBlock &, const int &, const int &, const int &)>;
+using wallExtractor = function<double(const procBlock &, const int &,
+                                      const int &, const int &, const int &)>;
 
 // function definitions
 template<typename T>
 void WriteBlockDims(ofstream &, const vector<T> &, int = 0);
+void WriteBlockDims(ofstream &, const vector<vector3d<int>> &, int = 0);
 
 void WriteNodes(const string &, const vector<plot3dBlock>&);
 void WriteCellCenter(const string &, const vector<procBlock> &,
                      const decomposition &, const input &);
+void WriteCellCenterMPI(const string &, const vector<procBlock> &,
+                        const decomposition &, const input &, const int &,
+                        outputQueue &);
 void WriteWallFaceCenter(const string &, const vector<procBlock> &,
-                         const double &);
+                         const double &, const bool &);
 void WriteOutput(const vector<procBlock> &, const physics &, const int &,
                  const decomposition &, const input &);
 void WriteFunFile(const vector<procBlock> &, const vector<procBlock> &,
                   const physics &, const decomposition &, const string &,
-                  const input &);
+                  const input &, const bool &);
+void WriteFunFileMPI(const vector<procBlock> &, const physics &,
+                     const decomposition &, const string &, const input &,
+                     const int &, outputQueue &);
+void WriteOutputMPI(const vector<procBlock> &, const physics &, const int &,
+                    const decomposition &, const input &, const int &,
+                    outputQueue &);
 void WriteCenterFun(const vector<procBlock> &, const vector<procBlock> &,
                     const physics &, const int &, const decomposition &,
                     const input &);
@@ -75,33 +100,99 @@ void WriteNodeFun(const vector<procBlock> &, vector<procBlock> &,
                   const input &);
 void WriteWallFun(const vector<procBlock> &, const physics &phys, const int &,
                   const input &);
+cellExtractor FunctionExtractor(const string &, const physics &,
+                                const input &);
+cellExtractor RestartExtractor(const string &, const physics &,
+                               const input &);
+cellExtractor RestartNm1Extractor(const string &, const physics &,
+                                  const input &);
+wallExtractor WallExtractor(const string &, const physics &, const input &);
+bool ThreadOverOutputBlocks(const int &);
+vector<double> CellValues(const procBlock &, const vector<cellExtractor> &,
+                          const bool &);
+vector<double> WallValues(const procBlock &, const vector<wallExtractor> &);
 void WriteMeta(const input &, const int &, const bool &);
 void WriteWallMeta(const input &, const int &);
+void WriteStatisticsMeta(const input &, const int &);
+void WriteStatisticsMPI(const vector<procBlock> &, const int &,
+                        const decomposition &, const input &, const int &,
+                        outputQueue &);
+void WriteStatisticsRestart(const vector<procBlock> &, const int &,
+                            const decomposition &, const input &, const int &,
+                            outputQueue &);
+string StatisticsRestartName(const string &);
+void ReadStatisticsRestart(gridLevel &, const string &, const decomposition &,
+                           const input &, const int &);
 
 void WriteRestart(const vector<procBlock> &, const physics &, const int &,
-                  const decomposition &, const input &, const residual &);
+                  const decomposition &, const input &, const residual &,
+                  const int &, outputQueue &);
+void WriteRestartHeader(ofstream &, int, int, const input &,
+                        const residual &);
+void WriteCompressedRestart(const vector<procBlock> &,
+                            const vector<vector<vector<double>>> &,
+                            const vector<vector3d<int>> &,
+                            const vector<array<range, 3>> &,
+                            const decomposition &, const string &, const int &,
+                            const int &, const input &, const residual &,
+                            const int &, outputQueue &);
 void ReadRestart(gridLevel &, const string &, const decomposition &,
-                 input &, const physics &, residual &,
-                 const vector<vector3d<int>> &);
-
-blkMultiArray3d<primitive> ReadSolFromRestart(ifstream &, const input &,
-                                              const physics &,
+                 input &, const physics &, residual &, const int &);
+vector<vector<double>> ReadSplitBlocksMPI(MPI_File &, const MPI_Offset &,
+                                          const vector<vector3d<int>> &,
+                                          const vector<array<range, 3>> &,
+                                          const vector<procBlock> &,
+                                          const int &, const decomposition &);
+vector<vector<vector<double>>> ReadCompressedChunks(
+    ifstream &, const vector<vector3d<int>> &, const vector<array<range, 3>> &,
+    const vector<procBlock> &, const int &, const int &, const int &);
+
+blkMultiArray3d<primitive> ReadSolFromRestart(const vector<double> &,
+                                              const input &, const physics &,
                                               const vector<string> &,
                                               const int &, const int &,
                                               const int &, const int &);
-blkMultiArray3d<conserved> ReadSolNm1FromRestart(ifstream &, const input &,
+blkMultiArray3d<conserved> ReadSolNm1FromRestart(const vector<double> &,
+                                                 const input &,
                                                  const physics &,
                                                  const vector<string> &,
                                                  const int &, const int &,
                                                  const int &, const int &);
 
 void PrintResiduals(const input &, residual &, const residual &, const resid &,
-                    const double &, const int &, const int &, ostream &);
+                    const double &, const double &, const int &, const int &,
+                    ostream &);
 void PrintHeaders(const input &, ostream &);
 
 vector<procBlock> Recombine(const vector<procBlock> &, const decomposition &);
 int SplitBlockNumber(const vector<procBlock> &, const decomposition &,
                      const int &, const int &, const int &, const int &);
+vector<vector3d<int>> ParentBlockCells(const vector<procBlock> &,
+                                       const decomposition &);
+void WriteSplitBlocksMPI(MPI_File &, const MPI_Offset &,
+                         const vector<vector3d<int>> &,
+                         const vector<array<range, 3>> &,
+                         const vector<procBlock> &,
+                         const vector<vector<double>> &, const int &,
+                         const bool &, const bool &, const decomposition &);
+void WriteSplitValues(const vector<procBlock> &, vector<vector<double>>,
+                      const vector<vector3d<int>> &,
+                      const vector<array<range, 3>> &, const decomposition &,
+                      const string &, const MPI_Offset &, const int &,
+                      const bool &, const bool &, outputQueue &);
+vector<MPI_Offset> ParentBlockOffsets(const MPI_Offset &,
+                                      const vector<vector3d<int>> &,
+                                      const int &, const size_t &);
+vector<int> SplitBlockParents(const vector<procBlock> &,
+                              const decomposition &);
+vector<array<range, 3>> SplitBlockRanges(const vector<procBlock> &,
+                                         const vector<array<range, 3>> &);
+void WriteSplitBlocks(const string &, const MPI_Offset &,
+                      const vector<vector3d<int>> &, const vector<int> &,
+                      const vector<array<range, 3>> &,
+                      const vector<vector<double>> &, const int &,
+                      const bool &, const bool &);
+void WriteValues(ostream &, const double *, const size_t &, const bool &);
 
 // ---------------------------------------------------------------------------
 // function definitions
@@ -0,0 +1,68 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef OUTPUTQUEUEHEADERDEF
+#define OUTPUTQUEUEHEADERDEF
+
+/* This header contains the outputQueue class which writes output files on a
+   background thread so the solver can continue iterating while the files are
+   written. At an output iteration the variables to write are copied into a
+   staging buffer, and a task that writes the buffer to disk is added to the
+   queue. The number of tasks queued or being written is bounded to limit the
+   memory used by the staging buffers. Tasks on the background thread must not
+   call MPI because MPI is only called by the main thread.
+ */
+
+#include <thread>               // thread
+#include <mutex>                // mutex
+#include <condition_variable>   // condition_variable
+#include <functional>           // function
+#include <deque>                // deque
+
+using std::function;
+
+class outputQueue {
+  int maxSize_;                         // maximum number of tasks in queue
+  std::deque<function<void()>> tasks_;  // tasks waiting to be written
+  bool isWriting_;                      // flag for task being written
+  bool isDone_;                         // flag to stop background thread
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::thread writer_;
+
+  // private member functions
+  void WriteTasks();
+
+ public:
+  // Constructor
+  explicit outputQueue(const int &maxSize);
+
+  // move and copy are deleted because the background thread uses this
+  outputQueue(outputQueue &&) = delete;
+  outputQueue &operator=(outputQueue &&) = delete;
+  outputQueue(const outputQueue &) = delete;
+  outputQueue &operator=(const outputQueue &) = delete;
+
+  // Member functions
+  bool IsAsync() const { return maxSize_ > 0; }
+  void Push(const function<void()> &task);
+  void Wait();
+
+  // Destructor
+  ~outputQueue() noexcept;
+};
+
+#endif
@@ -23,9 +23,12 @@
 #include <iostream>
 #include <vector>                  // vector
 #include <string>                  // string
+#include <array>                   // array
+#include <map>                     // map
 #include "mpi.h"                   // parallelism
 #include "vector3d.hpp"
 #include "blkMultiArray3d.hpp"
+#include "range.hpp"
 
 using std::vector;
 using std::string;
@@ -34,6 +37,8 @@ using std::cout;
 using std::endl;
 using std::cerr;
 using std::ostream;
+using std::array;
+using std::map;
 
 // forward class declarations
 class boundaryConditions;
@@ -42,6 +47,7 @@ class plot3dBlock;
 class connection;
 class resid;
 class genArray;
+class input;
 
 class decomposition {
   // rank of each procBlock
@@ -61,11 +67,20 @@ class decomposition {
   vector<int> splitHistIndex_;
   // direction of split (vector size equals number of splits)
   vector<string> splitHistDir_;
+  // relative cost of a cell in each procBlock
+  // (vector size equals number of procBlocks after decomp)
+  vector<double> cellCost_;
+  // additional cost of a face of the boundary surfaces with each tag
+  map<int, double> faceCost_;
   int numProcs_;                     // number of processors
 
  public:
   // Constructor
-  decomposition(const int&, const int&);
+  decomposition(const vector<double>&, const map<int, double>&, const int&);
+  decomposition(const vector<double> &cellCost, const int &nProcs)
+      : decomposition(cellCost, {}, nProcs) {}
+  decomposition(const int &num, const int &nProcs)
+      : decomposition(vector<double>(num, 1.0), nProcs) {}
   decomposition() : decomposition(1, 1) {}
 
   // move constructor and assignment operator
@@ -81,6 +96,10 @@ class decomposition {
   int ParentBlock(const int &a) const {return parBlock_[a];}
   int LocalPosition(const int &a) const {return localPos_[a];}
   int NumProcs() const {return numProcs_;}
+  double CellCost(const int &a) const {return cellCost_[a];}
+  void CalibrateCellCost(const vector<double>&, const vector<int>&);
+  double BlockLoad(const vector<plot3dBlock>&, const int&) const;
+  double FaceLoad(const boundaryConditions&) const;
   double IdealLoad(const vector<plot3dBlock>&) const;
   double MaxLoad(const vector<plot3dBlock>&) const;
   double MinLoad(const vector<plot3dBlock>&) const;
@@ -92,7 +111,9 @@ class decomposition {
   vector<int> NumBlocksOnAllProc() const;
   int NumBlocks() const {return rank_.size();}
   void SendToProc(const int&, const int&, const int&);
-  void Split(const int&, const int&, const string&);
+  void PermuteRanks(const vector<int>&);
+  void Split(const int&, const int&, const string&,
+             const vector<plot3dBlock>&, const vector<boundaryConditions>&);
   int SendWholeOrSplit(const vector<plot3dBlock>&, const int&,
                        const int&, int&, string&) const;
   int Size() const {return static_cast<int> (rank_.size());}
@@ -104,9 +125,13 @@ class decomposition {
   string SplitHistDir(const int &a) const {return splitHistDir_[a];}
   template <typename T>
   void DecompArray(vector<blkMultiArray3d<T>> &) const;
+  vector<array<range, 3>> NodeRanges(const vector<vector3d<int>>&) const;
+  vector<array<range, 3>> CellRanges(const vector<vector3d<int>>&) const;
   void PrintDiagnostics(const vector<plot3dBlock>&) const;
   void Broadcast();
   int GlobalPos(const int &rank, const int &localPos) const;
+  int NumActiveProcs() const;
+  decomposition Agglomerate(const int &numActive) const;
 
   // Destructor
   ~decomposition() noexcept {}
@@ -115,12 +140,32 @@ class decomposition {
 // function definitions
 ostream & operator<< (ostream &os, const decomposition&);
 
+map<int, double> FaceCostModel(const input&,
+                               const vector<boundaryConditions>&);
+vector<double> CellCostModel(const input&, const vector<plot3dBlock>&,
+                             const vector<boundaryConditions>&);
 decomposition ManualDecomposition(vector<plot3dBlock>&,
-                                  vector<boundaryConditions>&, const int&);
+                                  vector<boundaryConditions>&,
+                                  const vector<double>&,
+                                  const map<int, double>&, const int&);
 decomposition CubicDecomposition(vector<plot3dBlock>&,
-                                 vector<boundaryConditions>&, const int&);
+                                 vector<boundaryConditions>&,
+                                 const vector<double>&,
+                                 const map<int, double>&, const int&);
+decomposition GraphDecomposition(vector<plot3dBlock>&,
+                                 vector<boundaryConditions>&,
+                                 const vector<double>&,
+                                 const map<int, double>&, const int&);
+void SplitBlock(vector<plot3dBlock>&, vector<boundaryConditions>&,
+                decomposition&, const int&, const int&, const string&);
+void BalanceLoad(vector<plot3dBlock>&, vector<boundaryConditions>&,
+                 decomposition&);
+int RebalanceLoad(decomposition&, const vector<int>&);
+vector<int> NodeLayout();
+void MapProcsToNodes(const vector<boundaryConditions>&, const vector<int>&,
+                     const input&, decomposition&);
+void PrintLoadSummary(const vector<plot3dBlock>&, const decomposition&);
 
-void SendNumProcBlocks(const vector<int>&, int&);
 
 void SetDataTypesMPI(MPI_Datatype &, MPI_Datatype &, MPI_Datatype &,
                      MPI_Datatype &, MPI_Datatype &, MPI_Datatype &,
@@ -132,7 +177,9 @@ void FreeDataTypesMPI(MPI_Datatype &, MPI_Datatype &, MPI_Datatype &,
 void MaxLinf(resid*, resid*, int*, MPI_Datatype*);
 
 void BroadcastString(string& str);
-void BroadcastViscFaces(const MPI_Datatype&, vector<vector3d<double>> &);
+vector<vector3d<double>> GatherViscFaces(const MPI_Datatype&,
+                                         const vector<vector3d<double>> &);
+void BroadcastConnections(const MPI_Datatype&, vector<connection> &);
 
 template <typename T>
 void decomposition::DecompArray(vector<blkMultiArray3d<T>> &arr) const {
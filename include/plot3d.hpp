@@ -24,25 +24,52 @@
 
 #include <vector>
 #include <string>
+#include <fstream>
+#include <array>
+#include <algorithm>  // reverse
+#include <map>        // map
+#include <memory>     // shared_ptr
 #include "vector3d.hpp"
 #include "multiArray3d.hpp"
+#include "range.hpp"
 
 using std::vector;
 using std::string;
+using std::array;
+
+// forward class declarations
+class plot3dFile;
 
 //-------------------------------------------------------------------------
-// Class for an individual plot3d block
+/* Class for an individual plot3d block. A block either holds the coordinates
+   of all of its nodes, or only its location in a plot3d grid file. The latter
+   is used to decompose the grid and find the connections between blocks
+   without reading the entire grid. Only the dimensions and the coordinates of
+   individual nodes are available for these blocks, and the nodes are read
+   from the file when they are requested.
+*/
 class plot3dBlock {
   // by default everything above the public: declaration is private
   multiArray3d<vector3d<double>> coords_;  // coordinates of nodes in block
+  std::shared_ptr<plot3dFile> file_;       // grid file for nodes not read
+  int fileBlock_;                          // block in grid file
+  vector3d<int> start_;                    // first node in file block
+  vector3d<int> numNodes_;                 // number of nodes in file block
+  double lRef_;                            // reference length for nodes
+
+  // private member functions
+  const vector3d<double> &FileCoords(const int &, const int &,
+                                     const int &) const;
 
  public:
   // constructor -- create a plot3d block by passing the above quantities
   explicit plot3dBlock(const multiArray3d<vector3d<double>> &coordinates) :
-      coords_(coordinates) {}
+      coords_(coordinates), fileBlock_(0), lRef_(1.0) {}
   plot3dBlock(const int &ii, const int &jj, const int &kk) :
-      coords_(ii, jj, kk, 0) {}
-  plot3dBlock() : coords_(0, 0, 0, 0) {}
+      coords_(ii, jj, kk, 0), fileBlock_(0), lRef_(1.0) {}
+  plot3dBlock(const std::shared_ptr<plot3dFile> &, const int &,
+              const double &);
+  plot3dBlock() : coords_(0, 0, 0, 0), fileBlock_(0), lRef_(1.0) {}
 
   // move constructor and assignment operator
   plot3dBlock(plot3dBlock&&) noexcept = default;
@@ -75,28 +102,29 @@ class plot3dBlock {
     coords_.ClearResize(ni, nj, nk, 0);
   }
 
-  int Size() const { return coords_.Size(); }
-  int NumI() const { return coords_.NumI(); }
-  int NumJ() const { return coords_.NumJ(); }
-  int NumK() const { return coords_.NumK(); }
-  int NumCellsI() const { return coords_.NumI() - 1; }
-  int NumCellsJ() const { return coords_.NumJ() - 1; }
-  int NumCellsK() const { return coords_.NumK() - 1; }
+  bool IsInFile() const { return file_ != nullptr; }
+  int Size() const { return this->NumI() * this->NumJ() * this->NumK(); }
+  int NumI() const { return file_ ? numNodes_[0] : coords_.NumI(); }
+  int NumJ() const { return file_ ? numNodes_[1] : coords_.NumJ(); }
+  int NumK() const { return file_ ? numNodes_[2] : coords_.NumK(); }
+  int NumCellsI() const { return this->NumI() - 1; }
+  int NumCellsJ() const { return this->NumJ() - 1; }
+  int NumCellsK() const { return this->NumK() - 1; }
   int NumCells() const {
     return this->NumCellsI() * this->NumCellsJ() * this->NumCellsK();
   }
   const double &X(const int &ii, const int &jj, const int &kk) const {
-    return coords_(ii, jj, kk)[0];
+    return this->Coords(ii, jj, kk)[0];
   }
   const double &Y(const int &ii, const int &jj, const int &kk) const {
-    return coords_(ii, jj, kk)[1];
+    return this->Coords(ii, jj, kk)[1];
   }
   const double &Z(const int &ii, const int &jj, const int &kk) const {
-    return coords_(ii, jj, kk)[2];
+    return this->Coords(ii, jj, kk)[2];
   }
   const vector3d<double> &Coords(const int &ii, const int &jj,
                                  const int &kk) const {
-    return coords_(ii, jj, kk);
+    return file_ ? this->FileCoords(ii, jj, kk) : coords_(ii, jj, kk);
   }
 
   plot3dBlock Split(const string &, const int &);
@@ -106,9 +134,60 @@ class plot3dBlock {
   ~plot3dBlock() noexcept {}
 };
 
+//-------------------------------------------------------------------------
+/* Class for a plot3d grid file. Only the block dimensions are read when the
+   file is opened. The coordinates of a block, or a portion of a block, are read
+   in bulk when requested, so a processor only reads the blocks it needs. The
+   block dimensions are checked against the size of the file, which also
+   detects files written in the opposite byte order or with Fortran record
+   markers. Individual nodes can also be read, and are kept so that each is
+   only read once.
+*/
+class plot3dFile {
+  std::ifstream file_;
+  string name_;
+  vector<vector3d<int>> blkSize_;       // number of nodes in each block
+  vector<std::streamoff> blkOffset_;    // location of each block in file
+  bool swapBytes_;                      // file is in opposite byte order
+  bool recordMarkers_;                  // file has Fortran record markers
+  std::map<array<int, 4>, vector3d<double>> nodes_;  // individual nodes read
+
+  // private member functions
+  bool ReadHeader(const std::streamoff &, const bool &, const bool &);
+
+ public:
+  // constructor
+  explicit plot3dFile(const string &);
+
+  // move constructor and assignment operator
+  plot3dFile(plot3dFile &&) = default;
+  plot3dFile &operator=(plot3dFile &&) = default;
+
+  // copy constructor and assignment operator are deleted because of file
+  plot3dFile(const plot3dFile &) = delete;
+  plot3dFile &operator=(const plot3dFile &) = delete;
+
+  // member functions
+  int NumBlocks() const { return blkSize_.size(); }
+  const vector<vector3d<int>> &BlockSizes() const { return blkSize_; }
+  bool SwapBytes() const { return swapBytes_; }
+  bool RecordMarkers() const { return recordMarkers_; }
+  multiArray3d<vector3d<double>> ReadBlock(const int &, const double &);
+  multiArray3d<vector3d<double>> ReadBlock(const int &,
+                                           const array<range, 3> &,
+                                           const double &);
+  const vector3d<double> &ReadNode(const int &, const int &, const int &,
+                                   const int &, const double &);
+
+  // destructor
+  ~plot3dFile() noexcept {}
+};
+
 //-------------------------------------------------------------------------
 // function declarations
 vector<plot3dBlock> ReadP3dGrid(const string &, const double &, double &);
+vector<plot3dBlock> ReadP3dGridLocal(const string &, const double &,
+                                     const decomposition &, const int &);
 double PyramidVolume(const vector3d<double> &, const vector3d<double> &,
                      const vector3d<double> &, const vector3d<double> &,
                      const vector3d<double> &);
@@ -116,4 +195,12 @@ vector<plot3dBlock> GatherP3ds(const vector<plot3dBlock> &,
                                const decomposition &, const int &,
                                const MPI_Datatype &MPI_vec3d);
 
+// function to reverse the byte order of a value read from a file
+template <typename T>
+T ReverseBytes(T val) {
+  auto bytes = reinterpret_cast<char *>(&val);
+  std::reverse(bytes, bytes + sizeof(T));
+  return val;
+}
+
 #endif
@@ -38,7 +38,9 @@
 #include "macros.hpp"
 #include "uncoupledScalar.hpp"     // uncoupledScalar
 #include "wallData.hpp"
+#include "statistics.hpp"           // runningStatistics
 #include "utility.hpp"
+#include "haloExchange.hpp"        // haloSlice
 
 using std::vector;
 using std::string;
@@ -60,6 +62,12 @@ class matMultiArray3d;
 class physics;
 class turbModel;
 class eos;
+class decomposition;
+
+// faces visited during a residual calculation; interior faces have a
+// reconstruction stencil made up entirely of physical cells, so they do not
+// depend on ghost cell data
+enum class facePass { all, interior, boundary };
 
 class procBlock {
   blkMultiArray3d<primitive> state_;  // primitive vars at cell center
@@ -107,6 +115,8 @@ class procBlock {
 
   vector<wallData> wallData_;  // wall variables at viscous walls
 
+  runningStatistics stats_;  // running statistics of sampled variables
+
   int numGhosts_;  // number of layers of ghost cells surrounding block
   int parBlock_;  // parent block number
   int rank_;  // processor rank
@@ -121,13 +131,24 @@ class procBlock {
   bool isMultiSpecies_;
 
   // private member functions
-  void CalcInvFluxI(const physics &, const input &, matMultiArray3d &);
-  void CalcInvFluxJ(const physics &, const input &, matMultiArray3d &);
-  void CalcInvFluxK(const physics &, const input &, matMultiArray3d &);
-
-  void CalcViscFluxI(const physics &, const input &, matMultiArray3d &);
-  void CalcViscFluxJ(const physics &, const input &, matMultiArray3d &);
-  void CalcViscFluxK(const physics &, const input &, matMultiArray3d &);
+  void CalcInvFluxI(const physics &, const input &, matMultiArray3d &,
+                    const bool &, const facePass &);
+  void CalcInvFluxJ(const physics &, const input &, matMultiArray3d &,
+                    const bool &, const facePass &);
+  void CalcInvFluxK(const physics &, const input &, matMultiArray3d &,
+                    const bool &, const facePass &);
+  bool IsFaceInPass(const facePass &pass, const int &face,
+                    const int &numCells) const {
+    const auto isInterior = face >= numGhosts_ && face <= numCells - numGhosts_;
+    return pass == facePass::all || isInterior == (pass == facePass::interior);
+  }
+
+  void CalcViscFluxI(const physics &, const input &, matMultiArray3d &,
+                     const bool &);
+  void CalcViscFluxJ(const physics &, const input &, matMultiArray3d &,
+                     const bool &);
+  void CalcViscFluxK(const physics &, const input &, matMultiArray3d &,
+                     const bool &);
 
   void CalcCellDt(const int &, const int &, const int &, const double &);
 
@@ -216,6 +237,7 @@ class procBlock {
   const int & LocalPosition() const {return localPos_;}
   const int & Rank() const {return rank_;}
   const int & GlobalPos() const {return globalPos_;}
+  void AssignDecomposition(const decomposition &);
   const bool & IsViscous() const {return isViscous_;}
   const bool & IsTurbulent() const {return isTurbulent_;}
   const bool & IsRANS() const {return isRANS_;}
@@ -228,6 +250,9 @@ class procBlock {
   void Restriction(const procBlock &fine,
                    const multiArray3d<vector3d<int>> &toCoarse,
                    const multiArray3d<double> &volWeightFactor);
+  void AssignRestrictedState(const blkMultiArray3d<primitive> &state) {
+    state_ = state;
+  }
   conservedView ConsVarsN(const int &ii, const int &jj, const int &kk) const {
     return consVarsN_(ii, jj, kk);
   }
@@ -337,6 +362,10 @@ class procBlock {
   const double &WallDist(const int &ii, const int &jj, const int &kk) const {
     return wallDist_(ii, jj, kk);
   }
+  const multiArray3d<double> &WallDistances() const { return wallDist_; }
+  void AssignWallDistances(multiArray3d<double> wallDist) {
+    wallDist_ = std::move(wallDist);
+  }
 
   residualView Residual(const int &ii, const int &jj, const int &kk) const {
     return residual_(ii, jj, kk);
@@ -396,8 +425,10 @@ class procBlock {
                    const blkMultiArray3d<varArray> &, const int &, residual &,
                    resid &);
 
-  void CalcResidualNoSource(const physics &, const input &, matMultiArray3d &);
-  void CalcSrcTerms(const physics &, const input &, matMultiArray3d &);
+  void CalcResidualNoSource(const physics &, const input &, matMultiArray3d &,
+                            const bool &, const facePass & = facePass::all);
+  void CalcSrcTerms(const physics &, const input &, matMultiArray3d &,
+                    const bool &);
 
   void ResetResidWS();
   void ResetGradients();
@@ -483,14 +514,38 @@ class procBlock {
   void SwapEddyViscAndGradientSliceMPI(const connection &, const int &,
                                        const MPI_Datatype &,
                                        const MPI_Datatype &);
-
-  void PackSendGeomMPI(const MPI_Datatype &, const MPI_Datatype &) const;
+  double *PackStateSlice(const haloSlice &, double *) const;
+  const double *UnpackStateSlice(const haloSlice &, const double *);
+  double *PackTurbSlice(const haloSlice &, double *) const;
+  const double *UnpackTurbSlice(const haloSlice &, const double *);
+  double *PackWallDistSlice(const haloSlice &, double *) const;
+  const double *UnpackWallDistSlice(const haloSlice &, const double *);
+  double *PackEddyViscAndGradientSlice(const haloSlice &, double *) const;
+  const double *UnpackEddyViscAndGradientSlice(const haloSlice &,
+                                               const double *);
+  int StateHaloValues() const { return HaloValuesPerCell(state_); }
+  int TurbHaloValues() const {
+    return HaloValuesPerCell(f1_) + HaloValuesPerCell(f2_);
+  }
+  int WallDistHaloValues() const { return HaloValuesPerCell(wallDist_); }
+  int EddyViscAndGradientHaloValues() const {
+    return HaloValuesPerCell(velocityGrad_) +
+           (isTurbulent_ ? HaloValuesPerCell(eddyViscosity_) : 0);
+  }
+
+  int GeomPackSize(const MPI_Datatype &, const MPI_Datatype &) const;
+  void PackGeomMPI(char *, const int &, int &, const MPI_Datatype &,
+                   const MPI_Datatype &) const;
+  void UnpackGeomMPI(char *, const int &, int &, const MPI_Datatype &,
+                     const MPI_Datatype &, const input &);
+  void PackSendGeomMPI(const MPI_Datatype &, const MPI_Datatype &,
+                       const int &) const;
   void RecvUnpackGeomMPI(const MPI_Datatype &, const MPI_Datatype &,
-                         const input &);
+                         const input &, const int &);
   void PackSendSolMPI(const MPI_Datatype &, const MPI_Datatype &,
-                      const MPI_Datatype &) const;
+                      const MPI_Datatype &, const int &) const;
   void RecvUnpackSolMPI(const MPI_Datatype &, const MPI_Datatype &,
-                        const MPI_Datatype &, const input &);
+                        const MPI_Datatype &, const input &, const int &);
 
   void UpdateAuxillaryVariables(const physics &, const bool = true);
   void UpdateUnlimTurbEddyVisc(const unique_ptr<turbModel> &, const bool &);
@@ -502,6 +557,16 @@ class procBlock {
   void CalcCellWidths();
   void GetStatesFromRestart(const blkMultiArray3d<primitive> &);
   void GetSolNm1FromRestart(const blkMultiArray3d<conserved> &);
+  const runningStatistics &Statistics() const { return stats_; }
+  void AssignStatistics(runningStatistics stats) { stats_ = std::move(stats); }
+  void AddStatisticsSample(const vector<double> &, const int &,
+                           const vector<array<int, 2>> &);
+  void SendStatisticsMPI(const int &dest) const {
+    stats_.SendMPI(dest, globalPos_);
+  }
+  void RecvStatisticsMPI(const int &source) {
+    stats_.RecvMPI(source, globalPos_);
+  }
   // DEBUG
   const blkMultiArray3d<primitive> &States() const { return state_; }
 
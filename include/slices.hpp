@@ -103,7 +103,7 @@ class geomSlice {
   }
   void PackSwapUnpackMPI(const connection &, const MPI_Datatype &,
                          const MPI_Datatype &, const int &, const int &);
-  void SameSizeResize(const int &, const int &, const int &, const int &);
+  void ClearResize(const int &, const int &, const int &, const int &);
 
   // destructor
   ~geomSlice() noexcept {}
@@ -0,0 +1,90 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef STATISTICSHEADERDEF
+#define STATISTICSHEADERDEF
+
+/* This header contains the runningStatistics class which accumulates the
+   time average and second moments of variables at every cell of a procBlock.
+   The moments are updated one sample at a time with Welford's algorithm, so
+   the samples do not need to be stored and the result does not suffer from
+   the cancellation of the naive sum of squares. For each cell the class
+   stores the mean of each variable, the sum of squared deviations from the
+   mean of each variable, and the sum of products of deviations of each
+   correlated pair of variables.
+ */
+
+#include <vector>   // vector
+#include <array>    // array
+#include <string>   // string
+#include <set>      // set
+
+using std::vector;
+using std::array;
+using std::string;
+using std::set;
+
+class runningStatistics {
+  int numCells_;                 // number of cells sampled
+  int numVars_;                  // number of variables sampled
+  vector<array<int, 2>> pairs_;  // pairs of variables to correlate
+  int numSamples_;               // number of samples accumulated
+  vector<double> moments_;       // means, squared deviations, and products of
+                                 // deviations -- all moments of one cell, then
+                                 // the next
+
+ public:
+  // constructors
+  runningStatistics(const int &numCells, const int &numVars,
+                    const vector<array<int, 2>> &pairs)
+      : numCells_(numCells),
+        numVars_(numVars),
+        pairs_(pairs),
+        numSamples_(0),
+        moments_(numCells * (2 * numVars + pairs.size()), 0.0) {}
+  runningStatistics() : runningStatistics(0, 0, {}) {}
+
+  // move constructor and assignment operator
+  runningStatistics(runningStatistics &&) noexcept = default;
+  runningStatistics &operator=(runningStatistics &&) noexcept = default;
+
+  // copy constructor and assignment operator
+  runningStatistics(const runningStatistics &) = default;
+  runningStatistics &operator=(const runningStatistics &) = default;
+
+  // member functions
+  int NumCells() const { return numCells_; }
+  int NumVars() const { return numVars_; }
+  int NumPairs() const { return pairs_.size(); }
+  int NumSamples() const { return numSamples_; }
+  int NumMoments() const { return 2 * numVars_ + this->NumPairs(); }
+  bool IsEmpty() const { return moments_.empty(); }
+  const vector<double> &Moments() const { return moments_; }
+  void AssignMoments(const int &, const vector<double> &);
+  void AddSample(const vector<double> &);
+  vector<double> Values() const;
+  void SendMPI(const int &, const int &) const;
+  void RecvMPI(const int &, const int &);
+
+  // destructor
+  ~runningStatistics() noexcept {}
+};
+
+// function declarations
+vector<array<int, 2>> StatisticsPairs(const set<string> &);
+vector<string> StatisticsNames(const set<string> &);
+
+#endif
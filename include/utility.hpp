@@ -43,6 +43,7 @@ class kdtree;
 class resid;
 class primitive;
 class varArray;
+class haloExchange;
 
 // function definitions
 tensor<double> VectorGradGG(const vector3d<double> &, const vector3d<double> &,
@@ -66,7 +67,8 @@ void SwapGeomSliceMPI(connection &inter, procBlock &blk, const int &tag,
                       const MPI_Datatype &MPI_vec3dMag);
 vector<vector3d<double>> GetViscousFaceCenters(const vector<procBlock> &);
 void SwapImplicitUpdate(vector<blkMultiArray3d<varArray>> &,
-                        const vector<connection> &, const int &, const int &);
+                        const vector<connection> &, haloExchange &,
+                        const int &, const int &);
 
 // function to reorder block by hyperplanes
 vector<vector3d<int>> HyperplaneReorder(const int &, const int &, const int &);
@@ -363,6 +363,16 @@ void connection::SwapOrder() {
   }
 }
 
+// Function to assign the processor and local block of both sides of the
+// connection from a decomposition. The global block numbers are unchanged.
+void connection::AssignDecomposition(const decomposition &decomp) {
+  // decomp -- decomposition of grid onto processors
+  for (auto ii = 0; ii < 2; ++ii) {
+    rank_[ii] = decomp.Rank(block_[ii]);
+    localBlock_[ii] = decomp.LocalPosition(block_[ii]);
+  }
+}
+
 range connection::Dir1RangeFirst() const {
   return {d1Start_[0], d1End_[0]};
 }
@@ -422,26 +432,8 @@ vector<boundaryConditions> GatherBCs(const vector<boundaryConditions> &bc,
   } else {
     // send remote data
     for (auto lp = 0U; lp < bc.size(); ++lp) {
-      // add size for number of bc surfaces
       // determine size of buffer to send
-      auto sendBufSize = 0;
-      auto tempSize = 0;
-      MPI_Pack_size(3, MPI_INT, MPI_COMM_WORLD, &tempSize);
-      sendBufSize += tempSize;
-      // add size for BCs
-      // 8x because iMin, iMax, jMin, jMax, kMin, kMax, tags, string sizes
-      MPI_Pack_size(bc[lp].NumSurfaces() * 8, MPI_INT, MPI_COMM_WORLD,
-                    &tempSize);
-      sendBufSize += tempSize;
-
-      auto stringSize = 0;
-      for (auto jj = 0; jj < bc[lp].NumSurfaces(); ++jj) {
-        // add size for bc_ types (+1 for c_str end character)
-        MPI_Pack_size(bc[lp].GetBCTypes(jj).size() + 1, MPI_CHAR,
-                      MPI_COMM_WORLD, &tempSize);
-        stringSize += tempSize;
-      }
-      sendBufSize += stringSize;
+      const auto sendBufSize = bc[lp].PackSize();
 
       // allocate buffer to pack data into
       // use unique_ptr to manage memory; use underlying pointer with MPI calls
@@ -457,19 +449,72 @@ vector<boundaryConditions> GatherBCs(const vector<boundaryConditions> &bc,
   return allBCs;
 }
 
+/* Function to send the boundary conditions of all blocks from the ROOT
+processor to the processor that each block is assigned to. This is the inverse
+of GatherBCs and is used when each processor constructs its own procBlocks.
+Data is sent and received in order of global position to prevent deadlock.
+*/
+vector<boundaryConditions> ScatterBCs(const vector<boundaryConditions> &bc,
+                                      const decomposition &decomp,
+                                      const int &rank) {
+  // bc -- boundary conditions for all blocks (only meaningful on ROOT)
+  // decomp -- decomposition of grid onto processors
+  // rank -- processor rank
+
+  vector<boundaryConditions> localBCs(decomp.NumBlocksOnProc(rank));
+  for (auto gp = 0; gp < decomp.NumBlocks(); ++gp) {
+    const auto receivingRank = decomp.Rank(gp);
+    if (rank == ROOTP && receivingRank == ROOTP) {  // data already on rank 0
+      localBCs[decomp.LocalPosition(gp)] = bc[gp];
+    } else if (rank == ROOTP) {  // send data to remote
+      const auto sendBufSize = bc[gp].PackSize();
+      // allocate buffer to pack data into
+      // use unique_ptr to manage memory; use underlying pointer with MPI calls
+      auto sendBuffer = std::make_unique<char[]>(sendBufSize);
+      auto *rawSendBuffer = sendBuffer.get();
+      auto position = 0;
+      bc[gp].PackBC(rawSendBuffer, sendBufSize, position);
+      MPI_Send(rawSendBuffer, sendBufSize, MPI_PACKED, receivingRank, gp,
+               MPI_COMM_WORLD);
+    } else if (rank == receivingRank) {  // receive data from rank 0
+      MPI_Status status;  // allocate MPI_Status structure
+      // probe message to get correct data size
+      auto recvBufSize = 0;
+      MPI_Probe(ROOTP, gp, MPI_COMM_WORLD, &status);
+      // use MPI_CHAR because sending buffer was allocated with chars
+      MPI_Get_count(&status, MPI_CHAR, &recvBufSize);
+      // allocate buffer of correct size
+      // use unique_ptr to manage memory; use underlying pointer with MPI
+      auto recvBuffer = std::make_unique<char[]>(recvBufSize);
+      auto *rawRecvBuffer = recvBuffer.get();
+      MPI_Recv(rawRecvBuffer, recvBufSize, MPI_PACKED, ROOTP, gp,
+               MPI_COMM_WORLD, &status);
+      auto position = 0;
+      localBCs[decomp.LocalPosition(gp)].UnpackBC(rawRecvBuffer, recvBufSize,
+                                                   position);
+    }
+  }
+  return localBCs;
+}
+
 /* Function to go through the boundary conditions and pair the connection
    BCs together and determine their orientation. This function first gathers
    the BCs and grids to rank 0, then finds the connection BCs. Finally it
-   broadcasts the connections to all processors.*/
+   broadcasts the connections to all processors. The connections are formed
+   with the ranks and local positions of connDecomp, which differs from the
+   decomposition the data is currently distributed with when a coarse
+   multigrid level is agglomerated onto fewer processors.*/
 vector<connection> GetConnectionBCsPar(const vector<boundaryConditions> &bc,
                                        const vector<plot3dBlock> &grid,
                                        const decomposition &decomp,
+                                       const decomposition &connDecomp,
                                        const input &inp, const int &rank,
                                        const MPI_Datatype &MPI_connection,
                                        const MPI_Datatype &MPI_vec3d) {
   // bc -- vector of boundaryConditions for all blocks
   // grid -- vector of plot3Dblocks for entire computational mesh
   // decomp -- decomposition of grid onto processors
+  // connDecomp -- decomposition to form connections for
   // inp -- input variables
   MSG_ASSERT(bc.size() == grid.size(), "BC and block size mismatch");
 
@@ -480,17 +525,11 @@ vector<connection> GetConnectionBCsPar(const vector<boundaryConditions> &bc,
   // find connection BCs on rank 0
   vector<connection> conn;
   if (rank == ROOTP) {
-    conn = GetConnectionBCs(allBCs, allGrids, decomp, inp);
+    conn = GetConnectionBCs(allBCs, allGrids, connDecomp, inp);
   }
 
   // broadcast connections to all procs
-  auto numConn = conn.size();
-  MPI_Bcast(&numConn, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
-  conn.resize(numConn);  // allocate space to receive connections
-
-  // broadcast all connections to all processors
-  MPI_Bcast(&(*std::begin(conn)), conn.size(), MPI_connection, ROOTP,
-            MPI_COMM_WORLD);
+  BroadcastConnections(MPI_connection, conn);
 
   return conn;
 }
@@ -2304,6 +2343,27 @@ ostream &operator<<(ostream &os, const patch &p) {
   return os;
 }
 
+// member function to return the size of the buffer needed to pack the bcs
+int boundaryConditions::PackSize() const {
+  // add size for number of bc surfaces
+  auto bufSize = 0;
+  auto tempSize = 0;
+  MPI_Pack_size(3, MPI_INT, MPI_COMM_WORLD, &tempSize);
+  bufSize += tempSize;
+  // add size for BCs
+  // 8x because iMin, iMax, jMin, jMax, kMin, kMax, tags, string sizes
+  MPI_Pack_size(this->NumSurfaces() * 8, MPI_INT, MPI_COMM_WORLD, &tempSize);
+  bufSize += tempSize;
+
+  for (auto jj = 0; jj < this->NumSurfaces(); ++jj) {
+    // add size for bc_ types (+1 for c_str end character)
+    MPI_Pack_size(this->GetBCTypes(jj).size() + 1, MPI_CHAR, MPI_COMM_WORLD,
+                  &tempSize);
+    bufSize += tempSize;
+  }
+  return bufSize;
+}
+
 /*Member function to pack a boundaryConditions into a buffer so that in can be
  * sent with MPI.*/
 void boundaryConditions::PackBC(char *(&sendBuffer), const int &sendBufSize,
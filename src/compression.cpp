@@ -0,0 +1,205 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <iostream>   // cerr
+#include <cstdlib>    // exit
+#include <cstdint>    // uint32_t
+#include <cstring>    // memcpy, memcmp
+#include <vector>     // vector
+#include "compression.hpp"
+
+using std::cerr;
+using std::endl;
+
+// function to shuffle the bytes of an array of doubles so that the first byte
+// of every value is stored first, then the second byte, and so on
+vector<char> ShuffleBytes(const vector<double> &values) {
+  // values -- values to shuffle
+  const auto numVals = values.size();
+  const auto bytes = reinterpret_cast<const char *>(values.data());
+  vector<char> shuffled(numVals * sizeof(double));
+  for (auto bb = 0U; bb < sizeof(double); ++bb) {
+    auto out = shuffled.data() + bb * numVals;
+    for (auto ii = 0U; ii < numVals; ++ii) {
+      out[ii] = bytes[ii * sizeof(double) + bb];
+    }
+  }
+  return shuffled;
+}
+
+// function to reverse ShuffleBytes
+vector<double> UnshuffleBytes(const vector<char> &shuffled) {
+  // shuffled -- shuffled bytes of values
+  const auto numVals = shuffled.size() / sizeof(double);
+  vector<double> values(numVals);
+  auto bytes = reinterpret_cast<char *>(values.data());
+  for (auto bb = 0U; bb < sizeof(double); ++bb) {
+    const auto in = shuffled.data() + bb * numVals;
+    for (auto ii = 0U; ii < numVals; ++ii) {
+      bytes[ii * sizeof(double) + bb] = in[ii];
+    }
+  }
+  return values;
+}
+
+// function to write a length that does not fit in a token nibble
+void WriteExtraLength(size_t length, vector<char> &out) {
+  // length -- remaining length after nibble
+  // out -- compressed bytes
+  while (length >= 255) {
+    out.push_back(static_cast<char>(255));
+    length -= 255;
+  }
+  out.push_back(static_cast<char>(length));
+}
+
+// function to write a sequence of literal bytes followed by an optional match
+void WriteSequence(const char *literals, const size_t &numLiterals,
+                   const size_t &offset, const size_t &matchLength,
+                   vector<char> &out) {
+  // literals -- literal bytes
+  // numLiterals -- number of literal bytes
+  // offset -- distance back to match (0 for last sequence with no match)
+  // matchLength -- length of match
+  // out -- compressed bytes
+  const auto minMatch = 4U;
+  const auto litNibble = numLiterals < 15 ? numLiterals : 15;
+  const auto matchNibble =
+      offset == 0 ? 0 : (matchLength - minMatch < 15 ? matchLength - minMatch
+                                                     : 15);
+  out.push_back(static_cast<char>((litNibble << 4) | matchNibble));
+  if (litNibble == 15) {
+    WriteExtraLength(numLiterals - 15, out);
+  }
+  out.insert(out.end(), literals, literals + numLiterals);
+  if (offset != 0) {
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (matchNibble == 15) {
+      WriteExtraLength(matchLength - minMatch - 15, out);
+    }
+  }
+}
+
+/* Function to compress bytes with a greedy LZ77 search. A hash table holds the
+last location of each 4 byte sequence, and a match is used if it is within the
+maximum offset.*/
+vector<char> CompressLZ(const vector<char> &in) {
+  // in -- bytes to compress
+  const auto minMatch = 4U;
+  const auto maxOffset = 65535U;
+  const auto hashBits = 16U;
+  vector<int64_t> table(1U << hashBits, -1);
+
+  vector<char> out;
+  out.reserve(in.size() / 2 + 16);
+  const auto numBytes = in.size();
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + minMatch <= numBytes) {
+    uint32_t seq = 0;
+    std::memcpy(&seq, in.data() + pos, sizeof(seq));
+    const auto hash = (seq * 2654435761U) >> (32U - hashBits);
+    const auto prev = table[hash];
+    table[hash] = pos;
+    const auto cand = static_cast<size_t>(prev);
+    if (prev >= 0 && pos - cand <= maxOffset &&
+        std::memcmp(in.data() + cand, in.data() + pos, minMatch) == 0) {
+      size_t length = minMatch;
+      while (pos + length < numBytes && in[cand + length] == in[pos + length]) {
+        length++;
+      }
+      WriteSequence(in.data() + anchor, pos - anchor, pos - cand, length, out);
+      pos += length;
+      anchor = pos;
+    } else {
+      pos++;
+    }
+  }
+  WriteSequence(in.data() + anchor, numBytes - anchor, 0, 0, out);
+  return out;
+}
+
+// function to read a length that does not fit in a token nibble
+size_t ReadExtraLength(const vector<char> &in, size_t &pos) {
+  // in -- compressed bytes
+  // pos -- location in compressed bytes
+  size_t length = 0;
+  unsigned char byte = 255;
+  while (byte == 255 && pos < in.size()) {
+    byte = static_cast<unsigned char>(in[pos++]);
+    length += byte;
+  }
+  return length;
+}
+
+// function to decompress bytes compressed by CompressLZ
+vector<char> DecompressLZ(const vector<char> &in, const size_t &rawSize) {
+  // in -- compressed bytes
+  // rawSize -- number of bytes before compression
+  const auto minMatch = 4U;
+  vector<char> out(rawSize);
+
+  size_t pos = 0;
+  size_t outPos = 0;
+  auto isCorrupt = false;
+  while (pos < in.size()) {
+    const auto token = static_cast<unsigned char>(in[pos++]);
+    size_t numLiterals = token >> 4;
+    if (numLiterals == 15) {
+      numLiterals += ReadExtraLength(in, pos);
+    }
+    if (pos + numLiterals > in.size() || outPos + numLiterals > rawSize) {
+      isCorrupt = true;
+      break;
+    }
+    std::memcpy(out.data() + outPos, in.data() + pos, numLiterals);
+    pos += numLiterals;
+    outPos += numLiterals;
+    if (pos == in.size()) {
+      break;
+    }
+
+    if (pos + 2 > in.size()) {
+      isCorrupt = true;
+      break;
+    }
+    const size_t offset = static_cast<unsigned char>(in[pos]) |
+                          (static_cast<unsigned char>(in[pos + 1]) << 8);
+    pos += 2;
+    size_t length = (token & 0x0F) + minMatch;
+    if ((token & 0x0F) == 15) {
+      length += ReadExtraLength(in, pos);
+    }
+    if (offset == 0 || offset > outPos || outPos + length > rawSize) {
+      isCorrupt = true;
+      break;
+    }
+    // copy one byte at a time because match can overlap bytes being written
+    const auto from = outPos - offset;
+    for (auto ii = 0U; ii < length; ++ii) {
+      out[outPos + ii] = out[from + ii];
+    }
+    outPos += length;
+  }
+
+  if (isCorrupt || outPos != rawSize) {
+    cerr << "ERROR: Error in DecompressLZ(). Compressed data is corrupt!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+  return out;
+}
@@ -0,0 +1,188 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <iostream>     // cerr
+#include <fstream>      // ifstream
+#include <vector>       // vector
+#include <string>       // string
+#include <algorithm>    // min
+#include "extraction.hpp"
+#include "inputStates.hpp"  // Tokenize, RemoveTrailing
+
+using std::endl;
+using std::cerr;
+
+// construct extraction from string
+extraction::extraction(string &str) : extraction() {
+  const auto start = str.find("(") + 1;
+  const auto end = str.find(")") - 1;
+  const auto range = end - start + 1;  // +/-1 to ignore ()
+  auto def = str.substr(start, range);
+  type_ = Trim(str.substr(0, start - 1));
+  if (type_ != "probe" && type_ != "plane" && type_ != "line") {
+    cerr << "ERROR. Extraction specifier " << type_ << " is not recognized!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+  auto tokens = Tokenize(def, ";");
+
+  // erase portion used so multiple extractions in same string can be found
+  str.erase(0, end);
+
+  // parameter counters
+  auto nameCount = 0;
+  auto pointCount = 0;
+  auto blockCount = 0;
+  auto indexCount = 0;
+  auto indicesCount = 0;
+
+  for (auto &token : tokens) {
+    auto param = Tokenize(token, "=");
+    if (param.size() != 2) {
+      cerr << "ERROR. Problem with " << type_ << " parameter " << token << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    if (param[0] == "name") {
+      name_ = RemoveTrailing(param[1], ",");
+      nameCount++;
+    } else if (param[0] == "frequency") {
+      frequency_ = stoi(RemoveTrailing(param[1], ","));
+    } else if (param[0] == "point" && type_ == "probe") {
+      point_ = ReadVector(RemoveTrailing(param[1], ","));
+      pointCount++;
+    } else if (param[0] == "block" && type_ != "probe") {
+      block_ = stoi(RemoveTrailing(param[1], ","));
+      blockCount++;
+    } else if (param[0] == "direction" && type_ != "probe") {
+      direction_ = RemoveTrailing(param[1], ",");
+    } else if (param[0] == "index" && type_ == "plane") {
+      index_ = stoi(RemoveTrailing(param[1], ","));
+      indexCount++;
+    } else if (param[0] == "indices" && type_ == "line") {
+      auto inds = ReadVectorXd(RemoveTrailing(param[1], ","));
+      if (inds.size() != 2) {
+        cerr << "ERROR. Line 'indices' must have two components, found "
+             << inds.size() << endl;
+        exit(EXIT_FAILURE);
+      }
+      indices_ = {static_cast<int>(inds[0]), static_cast<int>(inds[1])};
+      indicesCount++;
+    } else {
+      cerr << "ERROR. " << type_ << " specifier " << param[0]
+           << " is not recognized in extraction definition!" << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // sanity checks
+  // required variables
+  if (nameCount != 1) {
+    cerr << "ERROR. For " << type_ << " 'name' must be specified" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (type_ == "probe" && pointCount != 1) {
+    cerr << "ERROR. For probe 'point' must be specified" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (type_ == "plane" && (blockCount != 1 || indexCount != 1)) {
+    cerr << "ERROR. For plane 'block' and 'index' must be specified" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (type_ == "line" && (blockCount != 1 || indicesCount != 1)) {
+    cerr << "ERROR. For line 'block' and 'indices' must be specified" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (direction_ != "i" && direction_ != "j" && direction_ != "k") {
+    cerr << "ERROR. Extraction direction " << direction_
+         << " is not recognized! Options are i, j, k" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (frequency_ <= 0) {
+    cerr << "ERROR. Extraction frequency must be greater than zero" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// function to print extraction
+ostream &operator<<(ostream &os, const extraction &ex) {
+  os << ex.Type() << "(name=" << ex.Name();
+  if (ex.IsProbe()) {
+    os << "; point=[" << ex.Point().X() << ", " << ex.Point().Y() << ", "
+       << ex.Point().Z() << "]";
+  } else {
+    os << "; block=" << ex.Block() << "; direction=" << ex.Direction();
+    if (ex.Type() == "plane") {
+      os << "; index=" << ex.Index();
+    } else {
+      os << "; indices=[" << ex.Indices()[0] << ", " << ex.Indices()[1] << "]";
+    }
+  }
+  os << "; frequency=" << ex.Frequency() << ")";
+  return os;
+}
+
+// function to find position of next extraction in string
+string::size_type NextExtraction(const string &str) {
+  return std::min({str.find("probe("), str.find("plane("), str.find("line(")});
+}
+
+// function to read extractions from input file
+vector<extraction> ReadExtractionList(ifstream &inFile, string &str) {
+  vector<extraction> extractionList;
+  auto openList = false;
+  do {
+    const auto start = openList ? 0 : str.find("<");
+    const auto listOpened = str.find("<") == string::npos ? false : true;
+    const auto end = str.find(">");
+    openList = (end == string::npos) ? true : false;
+
+    // test for extraction on current line
+    // if < or > is alone on a line, should not look for extraction
+    auto extractionPos = NextExtraction(str);
+    if (extractionPos != string::npos) {  // there is an extraction on line
+      string list;
+      if (listOpened && openList) {  // list opened on this line, remains open
+        list = str.substr(start + 1, string::npos);
+      } else if (listOpened && !openList) {  // list opened/closed on this line
+        const auto range = end - start - 1;
+        list = str.substr(start + 1, range);  // +/- 1 to ignore <>
+      } else if (!listOpened && openList) {  // list was open and remains open
+        list = str.substr(start, string::npos);
+      } else {  // list was open and is now closed
+        const auto range = end - start;
+        list = str.substr(start, range);
+      }
+
+      list.erase(0, NextExtraction(list));  // remove text before extraction
+      extractionList.emplace_back(list);
+
+      auto nextExtraction = NextExtraction(list);
+      while (nextExtraction != string::npos) {  // more extractions to read
+        list.erase(0, nextExtraction);  // remove commas separating states
+        extractionList.emplace_back(list);
+        nextExtraction = NextExtraction(list);
+      }
+    }
+
+    if (openList) {
+      getline(inFile, str);
+      str = Trim(str);
+    }
+  } while (openList);
+
+  return extractionList;
+}
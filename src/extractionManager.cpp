@@ -0,0 +1,546 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <iostream>     // cout
+#include <fstream>      // ofstream, ifstream
+#include <vector>       // vector
+#include <string>       // string
+#include <algorithm>    // sort, min, max, any_of
+#include <limits>       // numeric_limits
+#include "extractionManager.hpp"
+#include "procBlock.hpp"    // procBlock
+#include "parallel.hpp"     // decomposition
+#include "input.hpp"        // input
+#include "kdtree.hpp"       // kdtree
+#include "macros.hpp"
+
+using std::cout;
+using std::endl;
+using std::cerr;
+using std::ofstream;
+using std::ifstream;
+using std::ios;
+
+// constructor -- points are found when extraction is located
+extractionSeries::extractionSeries(const extraction &def,
+                                   const string &fileName)
+    : def_(def),
+      fileName_(fileName),
+      parent_(-1),
+      box_{{range(0), range(0), range(0)}},
+      dataStart_(0),
+      numRecords_(0),
+      numBuffered_(0) {}
+
+// member function to find the cell nearest to a probe. The cell center nearest
+// to the probe is found on each processor, and the processor with the nearest
+// one broadcasts its location in its parent block.
+void extractionSeries::FindProbeCell(const kdtree &tree,
+                                     const vector<array<int, 4>> &parentCells,
+                                     const double &lRef, const int &rank) {
+  // tree -- k-d tree of cell centers on this processor
+  // parentCells -- parent block and cell indices of each point in tree
+  // lRef -- reference length
+  // rank -- processor rank
+
+  // find nearest cell on this processor
+  struct {
+    double dist;
+    int rank;
+  } nearest = {std::numeric_limits<double>::max(), rank};
+  array<int, 4> loc = {0, 0, 0, 0};
+  if (tree.Size() > 0) {
+    vector3d<double> neighbor;
+    auto id = 0;
+    nearest.dist = tree.NearestNeighbor(def_.Point() / lRef, neighbor, id);
+    loc = parentCells[id];
+  }
+
+  // processor with nearest cell broadcasts its location
+  MPI_Allreduce(MPI_IN_PLACE, &nearest, 1, MPI_DOUBLE_INT, MPI_MINLOC,
+                MPI_COMM_WORLD);
+  MPI_Bcast(loc.data(), loc.size(), MPI_INT, nearest.rank, MPI_COMM_WORLD);
+
+  parent_ = loc[0];
+  box_ = {range(loc[1]), range(loc[2]), range(loc[3])};
+
+  if (rank == ROOTP) {
+    cout << "Probe " << def_.Name() << " located at cell (" << loc[1] << ", "
+         << loc[2] << ", " << loc[3] << ") of block " << loc[0]
+         << ", distance " << nearest.dist * lRef << endl;
+  }
+}
+
+// member function to write the header and point coordinates of the extraction
+// file. ROOT writes the header, and then each processor writes the
+// coordinates of its own points.
+void extractionSeries::WriteHeader(const vector<procBlock> &blks,
+                                   const vector<string> &varNames,
+                                   const double &lRef, const int &rank) {
+  // blks -- procBlocks on this processor
+  // varNames -- names of variables extracted
+  // lRef -- reference length
+  // rank -- processor rank
+
+  MPI_Offset headerSize = 0;
+  if (rank == ROOTP) {
+    ofstream outFile(fileName_, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Extraction file " << fileName_
+           << " did not open correctly!!!" << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // write number of points and variables
+    auto numPoints = this->NumPoints();
+    outFile.write(reinterpret_cast<char *>(&numPoints), sizeof(numPoints));
+    auto numVars = static_cast<int>(varNames.size());
+    outFile.write(reinterpret_cast<char *>(&numVars), sizeof(numVars));
+
+    // write parent block, starting cell, and number of cells in each direction
+    array<int, 7> dims = {parent_,          box_[0].Start(), box_[1].Start(),
+                          box_[2].Start(),  box_[0].Size(),  box_[1].Size(),
+                          box_[2].Size()};
+    outFile.write(reinterpret_cast<char *>(dims.data()),
+                  dims.size() * sizeof(dims[0]));
+
+    // write variable names (including sizes)
+    for (const auto &var : varNames) {
+      auto varSize = var.size();
+      outFile.write(reinterpret_cast<char *>(&varSize), sizeof(varSize));
+      outFile.write(var.c_str(), varSize * sizeof(char));
+    }
+    headerSize = outFile.tellp();
+  }
+  MPI_Bcast(&headerSize, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
+
+  // write dimensional cell center coordinates of points
+  vector<double> coords;
+  coords.reserve(3 * cells_.size());
+  for (const auto &cell : cells_) {
+    const auto center =
+        blks[cell.Block()].Center(cell.I(), cell.J(), cell.K()) * lRef;
+    coords.push_back(center.X());
+    coords.push_back(center.Y());
+    coords.push_back(center.Z());
+  }
+  this->WritePoints(headerSize, 0, 3, coords, rank);
+
+  dataStart_ = headerSize + 3 * this->NumPoints() * sizeof(double);
+  numRecords_ = 0;
+}
+
+/* Member function to continue an existing extraction file on restart. ROOT
+checks that the header of the file matches this extraction, and finds the last
+complete record at or before the restart iteration. Records written after the
+restart iteration are removed so new records follow the kept ones. Returns
+false if there is no file to continue.
+*/
+bool extractionSeries::ContinueFile(const vector<string> &varNames,
+                                    const int &lastIter, const int &rank) {
+  // varNames -- names of variables extracted
+  // lastIter -- iteration of restart solution
+  // rank -- processor rank
+
+  const auto numVars = static_cast<int>(varNames.size());
+  const auto recordBytes =
+      (2 + static_cast<MPI_Offset>(this->NumPoints()) * numVars) *
+      sizeof(double);
+
+  int found = 0;
+  if (rank == ROOTP) {
+    ifstream inFile(fileName_, ios::in | ios::binary);
+    if (!inFile.fail()) {
+      found = 1;
+
+      // check that header matches extraction
+      auto numPoints = 0;
+      auto fileVars = 0;
+      array<int, 7> dims;
+      inFile.read(reinterpret_cast<char *>(&numPoints), sizeof(numPoints));
+      inFile.read(reinterpret_cast<char *>(&fileVars), sizeof(fileVars));
+      inFile.read(reinterpret_cast<char *>(dims.data()),
+                  dims.size() * sizeof(dims[0]));
+      const array<int, 7> expected = {
+          parent_,         box_[0].Start(), box_[1].Start(), box_[2].Start(),
+          box_[0].Size(),  box_[1].Size(),  box_[2].Size()};
+      auto match = !inFile.fail() && numPoints == this->NumPoints() &&
+                   fileVars == numVars && dims == expected;
+      for (auto ii = 0; match && ii < numVars; ++ii) {
+        auto varSize = varNames[ii].size();
+        inFile.read(reinterpret_cast<char *>(&varSize), sizeof(varSize));
+        match = !inFile.fail() && varSize == varNames[ii].size();
+        if (match) {
+          string var(varSize, ' ');
+          inFile.read(&var[0], varSize * sizeof(char));
+          match = !inFile.fail() && var == varNames[ii];
+        }
+      }
+      if (!match) {
+        cerr << "ERROR: Header of extraction file " << fileName_
+             << " does not match " << def_.Type() << " " << def_.Name()
+             << "! Remove or rename the file to restart." << endl;
+        exit(EXIT_FAILURE);
+      }
+      dataStart_ = static_cast<MPI_Offset>(inFile.tellg()) +
+                   3 * this->NumPoints() * sizeof(double);
+
+      // keep complete records up to restart iteration
+      inFile.seekg(0, ios::end);
+      const MPI_Offset fileSize = inFile.tellg();
+      if (fileSize < dataStart_) {
+        cerr << "ERROR: Extraction file " << fileName_ << " is truncated!"
+             << endl;
+        exit(EXIT_FAILURE);
+      }
+      numRecords_ = (fileSize - dataStart_) / recordBytes;
+      while (numRecords_ > 0) {
+        auto iter = 0.0;
+        inFile.seekg(dataStart_ + (numRecords_ - 1) * recordBytes);
+        inFile.read(reinterpret_cast<char *>(&iter), sizeof(iter));
+        if (iter <= lastIter) {
+          break;
+        }
+        numRecords_--;
+      }
+      cout << "Continuing extraction file " << fileName_ << " after record "
+           << numRecords_ << endl;
+    }
+  }
+  MPI_Bcast(&found, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
+  if (found == 0) {
+    return false;
+  }
+  MPI_Bcast(&dataStart_, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
+  MPI_Bcast(&numRecords_, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
+
+  // remove partial records and records past restart iteration
+  MPI_File outFile;
+  if (MPI_File_open(MPI_COMM_WORLD, fileName_.c_str(), MPI_MODE_WRONLY,
+                    MPI_INFO_NULL, &outFile) != MPI_SUCCESS) {
+    cerr << "ERROR: Extraction file " << fileName_
+         << " did not open correctly!!!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  MPI_File_set_size(outFile, dataStart_ + numRecords_ * recordBytes);
+  MPI_File_close(&outFile);
+  return true;
+}
+
+/* Member function to write records of point values to the extraction file.
+Each record holds a header written by ROOT followed by the values of every
+point, so the file view of each processor selects the record header (on ROOT)
+and the slots of its own points. Records are written with one collective call.
+*/
+void extractionSeries::WritePoints(const MPI_Offset &start,
+                                   const int &headerLength,
+                                   const int &pointLength,
+                                   const vector<double> &values,
+                                   const int &rank) const {
+  // start -- location of first record in file
+  // headerLength -- number of values in record header
+  // pointLength -- number of values for each point
+  // values -- values to write for all records
+  // rank -- processor rank
+
+  // find blocks of record that this processor writes, merging adjacent slots
+  vector<int> lengths, disps;
+  if (rank == ROOTP && headerLength > 0) {
+    lengths.push_back(headerLength);
+    disps.push_back(0);
+  }
+  for (const auto &cell : cells_) {
+    const auto disp = headerLength + cell.Slot() * pointLength;
+    if (!disps.empty() && disps.back() + lengths.back() == disp) {
+      lengths.back() += pointLength;
+    } else {
+      lengths.push_back(pointLength);
+      disps.push_back(disp);
+    }
+  }
+
+  MPI_File outFile;
+  if (MPI_File_open(MPI_COMM_WORLD, fileName_.c_str(), MPI_MODE_WRONLY,
+                    MPI_INFO_NULL, &outFile) != MPI_SUCCESS) {
+    cerr << "ERROR: Extraction file " << fileName_
+         << " did not open correctly!!!" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // collective writes must be called by all processors, so processors without
+  // points make empty writes
+  if (lengths.empty()) {
+    MPI_File_set_view(outFile, 0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+    MPI_File_write_all(outFile, nullptr, 0, MPI_BYTE, MPI_STATUS_IGNORE);
+  } else {
+    // extent of type is one record, so consecutive records tile the file
+    const auto recordLength = headerLength + this->NumPoints() * pointLength;
+    MPI_Datatype MPI_points, MPI_record;
+    MPI_Type_indexed(lengths.size(), lengths.data(), disps.data(), MPI_DOUBLE,
+                     &MPI_points);
+    MPI_Type_create_resized(MPI_points, 0, recordLength * sizeof(double),
+                            &MPI_record);
+    MPI_Type_commit(&MPI_record);
+    MPI_File_set_view(outFile, start, MPI_DOUBLE, MPI_record, "native",
+                      MPI_INFO_NULL);
+    MPI_File_write_all(outFile, values.data(), values.size(), MPI_DOUBLE,
+                       MPI_STATUS_IGNORE);
+    MPI_Type_free(&MPI_record);
+    MPI_Type_free(&MPI_points);
+  }
+  MPI_File_close(&outFile);
+}
+
+// member function to find the cells of the extraction on this processor. The
+// points are found in the parent block the first time the extraction is
+// located, and the extraction file is started. Afterwards only the cells on
+// this processor are updated, so the extraction can be relocated after blocks
+// move between processors.
+void extractionSeries::Locate(const vector<procBlock> &blks,
+                              const decomposition &decomp,
+                              const vector<vector3d<int>> &parentCells,
+                              const vector<array<range, 3>> &ranges,
+                              const kdtree &tree,
+                              const vector<array<int, 4>> &treeCells,
+                              const vector<string> &varNames,
+                              const input &inp, const int &rank) {
+  // blks -- procBlocks on this processor
+  // decomp -- decomposition
+  // parentCells -- number of cells in each parent block
+  // ranges -- range of parent block cells that make up each procBlock
+  // tree -- k-d tree of cell centers on this processor
+  // treeCells -- parent block and cell indices of each point in tree
+  // varNames -- names of variables extracted
+  // inp -- input variables
+  // rank -- processor rank
+
+  const auto isNew = !this->IsLocated();
+  if (isNew && def_.IsProbe()) {
+    this->FindProbeCell(tree, treeCells, inp.LRef(), rank);
+  } else if (isNew) {
+    if (def_.Block() < 0 ||
+        def_.Block() >= static_cast<int>(parentCells.size())) {
+      cerr << "ERROR: Block " << def_.Block() << " of " << def_.Type() << " "
+           << def_.Name() << " does not exist!" << endl;
+      exit(EXIT_FAILURE);
+    }
+    parent_ = def_.Block();
+    const auto &par = parentCells[parent_];
+    box_ = {range(0, par.X()), range(0, par.Y()), range(0, par.Z())};
+
+    // planes are one cell thick in direction, lines are one cell thick in
+    // other directions
+    const auto dir =
+        def_.Direction() == "i" ? 0 : (def_.Direction() == "j" ? 1 : 2);
+    vector<int> fixedDirs, fixedInds;
+    if (def_.Type() == "plane") {
+      fixedDirs = {dir};
+      fixedInds = {def_.Index()};
+    } else {
+      fixedDirs = {(dir + 1) % 3, (dir + 2) % 3};
+      fixedInds = {def_.Indices()[dir == 1 ? 1 : 0],
+                   def_.Indices()[dir == 1 ? 0 : 1]};
+    }
+    for (auto ii = 0U; ii < fixedDirs.size(); ++ii) {
+      if (fixedInds[ii] < 0 || fixedInds[ii] >= box_[fixedDirs[ii]].End()) {
+        cerr << "ERROR: Cell index " << fixedInds[ii] << " of "
+             << def_.Type() << " " << def_.Name() << " is outside of block "
+             << parent_ << "!" << endl;
+        exit(EXIT_FAILURE);
+      }
+      box_[fixedDirs[ii]] = range(fixedInds[ii]);
+    }
+  }
+
+  // find cells of extraction in procBlocks on this processor
+  const auto &ri = box_[0];
+  const auto &rj = box_[1];
+  const auto &rk = box_[2];
+  cells_.clear();
+  for (auto bb = 0U; bb < blks.size(); ++bb) {
+    const auto &blk = blks[bb];
+    const auto gp = blk.GlobalPos();
+    if (decomp.ParentBlock(gp) != parent_) {
+      continue;
+    }
+    const auto &br = ranges[gp];
+    const auto iS = std::max(ri.Start(), br[0].Start());
+    const auto iE = std::min(ri.End(), br[0].End());
+    const auto jS = std::max(rj.Start(), br[1].Start());
+    const auto jE = std::min(rj.End(), br[1].End());
+    const auto kS = std::max(rk.Start(), br[2].Start());
+    const auto kE = std::min(rk.End(), br[2].End());
+    for (auto kk = kS; kk < kE; kk++) {
+      for (auto jj = jS; jj < jE; jj++) {
+        for (auto ii = iS; ii < iE; ii++) {
+          const auto slot =
+              ((kk - rk.Start()) * rj.Size() + (jj - rj.Start())) * ri.Size() +
+              ii - ri.Start();
+          cells_.emplace_back(bb, ii - br[0].Start() + blk.StartI(),
+                              jj - br[1].Start() + blk.StartJ(),
+                              kk - br[2].Start() + blk.StartK(), slot);
+        }
+      }
+    }
+  }
+  std::sort(cells_.begin(), cells_.end(),
+            [](const auto &a, const auto &b) { return a.Slot() < b.Slot(); });
+
+  if (isNew && !(inp.IsRestart() &&
+                 this->ContinueFile(varNames, inp.IterationStart(), rank))) {
+    this->WriteHeader(blks, varNames, inp.LRef(), rank);
+  }
+}
+
+// member function to add a record of the point values on this processor to
+// the buffer
+void extractionSeries::Sample(const vector<procBlock> &blks,
+                              const vector<cellExtractor> &extractors,
+                              const int &iter, const double &time,
+                              const int &rank) {
+  // blks -- procBlocks on this processor
+  // extractors -- functions to evaluate variables
+  // iter -- iteration number
+  // time -- simulation time
+  // rank -- processor rank
+
+  if (rank == ROOTP) {
+    buffer_.push_back(iter);
+    buffer_.push_back(time);
+  }
+  for (const auto &cell : cells_) {
+    for (const auto &var : extractors) {
+      buffer_.push_back(
+          var(blks[cell.Block()], cell.I(), cell.J(), cell.K()));
+    }
+  }
+  numBuffered_++;
+}
+
+// member function to append the buffered records to the extraction file
+void extractionSeries::Flush(const int &numVars, const int &rank) {
+  // numVars -- number of variables extracted
+  // rank -- processor rank
+
+  // number of buffered records is the same on all processors
+  if (numBuffered_ == 0) {
+    return;
+  }
+  const auto recordBytes =
+      (2 + static_cast<MPI_Offset>(this->NumPoints()) * numVars) *
+      sizeof(double);
+  this->WritePoints(dataStart_ + numRecords_ * recordBytes, 2, numVars,
+                    buffer_, rank);
+  numRecords_ += numBuffered_;
+  numBuffered_ = 0;
+  buffer_.clear();
+}
+
+// ---------------------------------------------------------------------------
+// constructor -- variables are resolved once for all extractions
+extractionManager::extractionManager(const input &inp, const physics &phys)
+    : bufferSize_(inp.ExtractionBufferSize()) {
+  // inp -- input variables
+  // phys -- physics models
+  for (const auto &def : inp.Extractions()) {
+    series_.emplace_back(def,
+                         inp.SimNameRoot() + "_" + def.Name() + ".ext");
+  }
+  for (const auto &var : inp.ExtractionVariables()) {
+    variables_.push_back(var);
+    extractors_.push_back(FunctionExtractor(var, phys, inp));
+  }
+}
+
+// member function to find the cells of all extractions on this processor
+void extractionManager::Locate(const vector<procBlock> &blks,
+                               const decomposition &decomp, const input &inp,
+                               const int &rank) {
+  // blks -- procBlocks on this processor
+  // decomp -- decomposition
+  // inp -- input variables
+  // rank -- processor rank
+
+  if (!this->HaveExtractions()) {
+    return;
+  }
+  const auto parentCells = ParentBlockCells(blks, decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
+
+  // one k-d tree of cell centers on this processor is shared by all probes
+  // that have not been located yet
+  vector<vector3d<double>> centers;
+  vector<array<int, 4>> treeCells;
+  const auto needTree =
+      std::any_of(series_.begin(), series_.end(), [](const auto &series) {
+        return !series.IsLocated() && series.Definition().IsProbe();
+      });
+  if (needTree) {
+    for (const auto &blk : blks) {
+      const auto gp = blk.GlobalPos();
+      for (auto kk = blk.StartK(); kk < blk.EndK(); kk++) {
+        for (auto jj = blk.StartJ(); jj < blk.EndJ(); jj++) {
+          for (auto ii = blk.StartI(); ii < blk.EndI(); ii++) {
+            centers.push_back(blk.Center(ii, jj, kk));
+            treeCells.push_back(
+                {decomp.ParentBlock(gp),
+                 ii - blk.StartI() + ranges[gp][0].Start(),
+                 jj - blk.StartJ() + ranges[gp][1].Start(),
+                 kk - blk.StartK() + ranges[gp][2].Start()});
+          }
+        }
+      }
+    }
+  }
+  const kdtree tree(centers);
+
+  for (auto &series : series_) {
+    series.Locate(blks, decomp, parentCells, ranges, tree, treeCells,
+                  variables_, inp, rank);
+  }
+}
+
+// member function to sample the extractions that are due at this iteration,
+// and write the ones with full buffers
+void extractionManager::Sample(const vector<procBlock> &blks,
+                               const input &inp, const int &nn,
+                               const int &rank) {
+  // blks -- procBlocks on this processor
+  // inp -- input variables
+  // nn -- iteration
+  // rank -- processor rank
+
+  const auto iter = nn + inp.IterationStart() + 1;
+  const auto time = inp.IsTimeAccurate() ? iter * inp.Dt() : 0.0;
+  for (auto &series : series_) {
+    if (series.Definition().Sample(nn)) {
+      series.Sample(blks, extractors_, iter, time, rank);
+      if (series.NumBuffered() >= bufferSize_) {
+        series.Flush(variables_.size(), rank);
+      }
+    }
+  }
+}
+
+// member function to write all buffered records
+void extractionManager::Flush(const int &rank) {
+  // rank -- processor rank
+  for (auto &series : series_) {
+    series.Flush(variables_.size(), rank);
+  }
+}
@@ -0,0 +1,361 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <vector>     // vector
+#include <numeric>    // accumulate, iota
+#include <queue>      // queue
+#include <limits>     // numeric_limits
+#include "graphPartition.hpp"
+#include "macros.hpp"
+
+using std::vector;
+using std::pair;
+
+// member function to add an edge between two vertices; the weights of
+// repeated edges are summed
+void weightedGraph::AddEdge(const int &a, const int &b, const double &weight) {
+  // a -- first vertex
+  // b -- second vertex
+  // weight -- weight of edge
+  MSG_ASSERT(a < this->NumVertices() && b < this->NumVertices(),
+             "vertex out of range");
+  if (a == b) {
+    return;
+  }
+  const auto addTo = [&weight](vector<pair<int, double>> &adj, const int &v) {
+    for (auto &edge : adj) {
+      if (edge.first == v) {
+        edge.second += weight;
+        return;
+      }
+    }
+    adj.emplace_back(v, weight);
+  };
+  addTo(adjacency_[a], b);
+  addTo(adjacency_[b], a);
+}
+
+double weightedGraph::TotalWeight() const {
+  return std::accumulate(weight_.begin(), weight_.end(), 0.0);
+}
+
+// member function to calculate the weight of the edges between partitions
+double weightedGraph::CutWeight(const vector<int> &part) const {
+  // part -- partition of each vertex
+  auto cut = 0.0;
+  for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+    for (const auto &edge : adjacency_[aa]) {
+      if (edge.first > aa && part[edge.first] != part[aa]) {
+        cut += edge.second;
+      }
+    }
+  }
+  return cut;
+}
+
+/* Member function to coarsen the graph by heavy edge matching. Each vertex is
+matched with the unmatched neighbor it shares the heaviest edge with, and each
+matched pair becomes one vertex of the coarse graph. The coarse vertex of each
+vertex is returned in coarseMap.
+*/
+weightedGraph weightedGraph::Coarsen(vector<int> &coarseMap) const {
+  // coarseMap -- vertex of coarse graph for each vertex
+  coarseMap.assign(this->NumVertices(), -1);
+  auto numCoarse = 0;
+  for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+    if (coarseMap[aa] >= 0) {
+      continue;
+    }
+    auto match = -1;
+    auto matchWeight = 0.0;
+    for (const auto &edge : adjacency_[aa]) {
+      if (coarseMap[edge.first] < 0 && edge.second > matchWeight) {
+        match = edge.first;
+        matchWeight = edge.second;
+      }
+    }
+    coarseMap[aa] = numCoarse;
+    if (match >= 0) {
+      coarseMap[match] = numCoarse;
+    }
+    numCoarse++;
+  }
+
+  vector<double> coarseWeight(numCoarse, 0.0);
+  for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+    coarseWeight[coarseMap[aa]] += weight_[aa];
+  }
+  weightedGraph coarse(coarseWeight);
+  for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+    for (const auto &edge : adjacency_[aa]) {
+      if (edge.first > aa) {
+        coarse.AddEdge(coarseMap[aa], coarseMap[edge.first], edge.second);
+      }
+    }
+  }
+  return coarse;
+}
+
+// member function to get the graph made up of the given vertices and the
+// edges between them
+weightedGraph weightedGraph::Subgraph(const vector<int> &vertices) const {
+  // vertices -- vertices to keep
+  vector<int> local(this->NumVertices(), -1);
+  vector<double> weight(vertices.size());
+  for (auto ii = 0U; ii < vertices.size(); ++ii) {
+    local[vertices[ii]] = ii;
+    weight[ii] = weight_[vertices[ii]];
+  }
+  weightedGraph sub(weight);
+  for (const auto &aa : vertices) {
+    for (const auto &edge : adjacency_[aa]) {
+      if (edge.first > aa && local[edge.first] >= 0) {
+        sub.AddEdge(local[aa], local[edge.first], edge.second);
+      }
+    }
+  }
+  return sub;
+}
+
+/* Member function to find a vertex on the periphery of the vertices that are
+on side 1. A breadth first search is done twice, each time starting from the
+last vertex reached by the previous search. Only vertices on side 1 are
+searched.
+*/
+int weightedGraph::PeripheralVertex(const vector<int> &side) const {
+  // side -- side of bisection for each vertex
+  auto start = -1;
+  for (auto aa = 0; aa < this->NumVertices() && start < 0; ++aa) {
+    if (side[aa] == 1) {
+      start = aa;
+    }
+  }
+  for (auto search = 0; search < 2 && start >= 0; ++search) {
+    vector<bool> visited(this->NumVertices(), false);
+    std::queue<int> next;
+    next.push(start);
+    visited[start] = true;
+    while (!next.empty()) {
+      start = next.front();
+      next.pop();
+      for (const auto &edge : adjacency_[start]) {
+        if (!visited[edge.first] && side[edge.first] == 1) {
+          visited[edge.first] = true;
+          next.push(edge.first);
+        }
+      }
+    }
+  }
+  return start;
+}
+
+/* Member function to get an initial bisection of the graph by growing side 0
+from a peripheral vertex. The vertex added at each step is the one that most
+reduces the weight of the cut edges. Growth stops when adding another vertex
+would move the weight of side 0 further from the target.
+*/
+vector<int> weightedGraph::GrowBisection(const double &target) const {
+  // target -- desired weight of side 0
+  vector<int> side(this->NumVertices(), 1);
+  vector<double> toSide0(this->NumVertices(), 0.0);
+  vector<double> degree(this->NumVertices(), 0.0);
+  for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+    for (const auto &edge : adjacency_[aa]) {
+      degree[aa] += edge.second;
+    }
+  }
+
+  auto weight0 = 0.0;
+  while (weight0 < target) {
+    // find frontier vertex with largest gain
+    auto next = -1;
+    auto bestGain = std::numeric_limits<double>::lowest();
+    for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+      if (side[aa] == 1 && toSide0[aa] > 0.0) {
+        const auto gain = 2.0 * toSide0[aa] - degree[aa];
+        if (gain > bestGain) {
+          bestGain = gain;
+          next = aa;
+        }
+      }
+    }
+    // no frontier at start or for disconnected graph
+    if (next < 0) {
+      next = this->PeripheralVertex(side);
+      if (next < 0) {
+        break;
+      }
+    }
+
+    if (weight0 > 0.0 && weight0 + weight_[next] - target > target - weight0) {
+      break;
+    }
+    side[next] = 0;
+    weight0 += weight_[next];
+    for (const auto &edge : adjacency_[next]) {
+      toSide0[edge.first] += edge.second;
+    }
+  }
+  return side;
+}
+
+/* Member function to refine a bisection by moving single vertices between
+sides. If a side is overloaded, vertices are moved off of it to restore the
+balance. Otherwise, vertices are moved if that reduces the weight of the cut
+edges without overloading the other side. Each vertex is moved at most once
+per pass.
+*/
+void weightedGraph::RefineBisection(const double &target,
+                                    const double &tolerance,
+                                    vector<int> &side) const {
+  // target -- desired weight of side 0
+  // tolerance -- allowable fraction a side can be over its desired weight
+  // side -- side of bisection for each vertex
+  const auto total = this->TotalWeight();
+  const double maxWeight[2] = {target * (1.0 + tolerance),
+                               (total - target) * (1.0 + tolerance)};
+  double weight[2] = {0.0, 0.0};
+  for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+    weight[side[aa]] += weight_[aa];
+  }
+
+  constexpr auto maxPasses = 10;
+  for (auto pass = 0; pass < maxPasses; ++pass) {
+    vector<bool> moved(this->NumVertices(), false);
+    auto numMoved = 0;
+    while (true) {
+      auto overloaded = -1;
+      if (weight[0] > maxWeight[0]) {
+        overloaded = 0;
+      } else if (weight[1] > maxWeight[1]) {
+        overloaded = 1;
+      }
+
+      auto best = -1;
+      auto bestGain = std::numeric_limits<double>::lowest();
+      for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+        const auto from = side[aa];
+        const auto to = 1 - from;
+        if (moved[aa] || (overloaded >= 0 && from != overloaded) ||
+            weight[to] + weight_[aa] > maxWeight[to] ||
+            weight[from] - weight_[aa] <= 0.0) {
+          continue;
+        }
+        auto gain = 0.0;
+        for (const auto &edge : adjacency_[aa]) {
+          gain += (side[edge.first] == from) ? -edge.second : edge.second;
+        }
+        if ((overloaded >= 0 || gain > 0.0) && gain > bestGain) {
+          bestGain = gain;
+          best = aa;
+        }
+      }
+      if (best < 0) {
+        break;
+      }
+      weight[side[best]] -= weight_[best];
+      side[best] = 1 - side[best];
+      weight[side[best]] += weight_[best];
+      moved[best] = true;
+      numMoved++;
+    }
+    if (numMoved == 0) {
+      break;
+    }
+  }
+}
+
+/* Member function to bisect the graph. The graph is coarsened by heavy edge
+matching until it is small, an initial bisection of the coarsest graph is
+found by graph growing, and then the bisection is projected back to the finer
+graphs and refined at each level. The side (0 or 1) of each vertex is returned.
+*/
+vector<int> weightedGraph::Bisect(const double &fraction,
+                                  const double &tolerance) const {
+  // fraction -- fraction of total weight desired on side 0
+  // tolerance -- allowable fraction a side can be over its desired weight
+  const auto target = fraction * this->TotalWeight();
+
+  constexpr auto coarsestSize = 16;
+  if (this->NumVertices() > coarsestSize) {
+    vector<int> coarseMap;
+    const auto coarse = this->Coarsen(coarseMap);
+    // only use coarse graph if matching reduced the graph size enough
+    if (coarse.NumVertices() < 0.9 * this->NumVertices()) {
+      const auto coarseSide = coarse.Bisect(fraction, tolerance);
+      vector<int> side(this->NumVertices());
+      for (auto aa = 0; aa < this->NumVertices(); ++aa) {
+        side[aa] = coarseSide[coarseMap[aa]];
+      }
+      this->RefineBisection(target, tolerance, side);
+      return side;
+    }
+  }
+
+  auto side = this->GrowBisection(target);
+  this->RefineBisection(target, tolerance, side);
+  return side;
+}
+
+/* Member function to partition the graph by recursive bisection. At each
+level the vertices are split between two groups of partitions in proportion
+to the number of partitions in each group. The partition of each vertex is
+returned. Partitions with consecutive indices are close to each other in the
+graph.
+*/
+vector<int> weightedGraph::Partition(const int &numParts,
+                                     const double &tolerance) const {
+  // numParts -- number of partitions
+  // tolerance -- allowable fraction a side can be over its desired weight
+  vector<int> part(this->NumVertices(), 0);
+  vector<int> all(this->NumVertices());
+  std::iota(all.begin(), all.end(), 0);
+  this->PartitionRecursive(all, numParts, 0, tolerance, part);
+  return part;
+}
+
+void weightedGraph::PartitionRecursive(const vector<int> &vertices,
+                                       const int &numParts,
+                                       const int &firstPart,
+                                       const double &tolerance,
+                                       vector<int> &part) const {
+  // vertices -- vertices to partition
+  // numParts -- number of partitions
+  // firstPart -- index of first partition
+  // tolerance -- allowable fraction a side can be over its desired weight
+  // part -- partition of each vertex
+  if (numParts == 1 || vertices.size() <= 1) {
+    for (const auto &aa : vertices) {
+      part[aa] = firstPart;
+    }
+    return;
+  }
+
+  const auto numLower = numParts / 2;
+  const auto side = this->Subgraph(vertices).Bisect(
+      static_cast<double>(numLower) / numParts, tolerance);
+  vector<int> lower, upper;
+  for (auto ii = 0U; ii < vertices.size(); ++ii) {
+    if (side[ii] == 0) {
+      lower.push_back(vertices[ii]);
+    } else {
+      upper.push_back(vertices[ii]);
+    }
+  }
+  this->PartitionRecursive(lower, numLower, firstPart, tolerance, part);
+  this->PartitionRecursive(upper, numParts - numLower, firstPart + numLower,
+                           tolerance, part);
+}
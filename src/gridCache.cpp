@@ -0,0 +1,434 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <iostream>     // cout
+#include <fstream>      // ifstream, ofstream
+#include <sstream>      // ostringstream
+#include <vector>       // vector
+#include <string>       // string
+#include <cstring>      // memcpy
+#include <algorithm>    // min
+#include "gridCache.hpp"
+#include "plot3d.hpp"
+#include "boundaryConditions.hpp"
+#include "parallel.hpp"
+#include "procBlock.hpp"
+#include "mgSolution.hpp"
+#include "input.hpp"
+#include "macros.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::ios;
+using std::ifstream;
+using std::ofstream;
+
+// constructor
+gridCache::gridCache(const input &inp)
+    : fileName_(inp.SimNameRoot() + ".gcache"),
+      key_(0),
+      gridHash_(0),
+      isValid_(false),
+      position_(0) {}
+
+/* Member function to hash the contents of the grid file. Each processor hashes
+an equal portion of the file, and the hashes of the portions are gathered on
+ROOT and combined in order. This way the grid is never read in full by a single
+processor. This must be called on all processors before the key is found.*/
+void gridCache::HashGrid(const input &inp, const int &rank) {
+  // inp -- input variables
+  // rank -- processor rank
+  auto numProcs = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+
+  const auto gridName = inp.GridName() + ".xyz";
+  ifstream gridFile(gridName, ios::in | ios::binary | ios::ate);
+  if (gridFile.fail()) {
+    cerr << "ERROR: Error in gridCache::HashGrid(). Grid file " << gridName
+         << " did not open correctly!!!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  const int64_t fileSize = gridFile.tellg();
+
+  // portion of file hashed by this processor
+  const auto portion = fileSize / numProcs + 1;
+  const auto start = std::min(rank * portion, fileSize);
+  const auto end = std::min(start + portion, fileSize);
+
+  auto hash = HashBytes(&fileSize, sizeof(fileSize), 14695981039346656037ULL);
+  constexpr int64_t chunkSize = 1 << 20;
+  vector<char> buffer(chunkSize);
+  gridFile.seekg(start);
+  for (auto pos = start; pos < end; pos += chunkSize) {
+    const auto numBytes = std::min(chunkSize, end - pos);
+    gridFile.read(buffer.data(), numBytes);
+    hash = HashBytes(buffer.data(), numBytes, hash);
+  }
+  if (gridFile.fail()) {
+    cerr << "ERROR: Error in gridCache::HashGrid(). Could not read grid file "
+         << gridName << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  vector<uint64_t> hashes(numProcs);
+  MPI_Gather(&hash, 1, MPI_UINT64_T, hashes.data(), 1, MPI_UINT64_T, ROOTP,
+             MPI_COMM_WORLD);
+  if (rank == ROOTP) {
+    gridHash_ = HashBytes(hashes.data(), hashes.size() * sizeof(hashes[0]),
+                          14695981039346656037ULL);
+  }
+}
+
+/* Member function to find the key of the cache from the grid, boundary
+conditions, and decomposition. The settings of the input file that change the
+size or contents of the procBlocks are included as well. The grid is included
+through the hash of the grid file, and the dimensions of the blocks, so only
+the header of the grid is needed. This should only be called on ROOT.*/
+void gridCache::AssignKey(const vector<plot3dBlock> &mesh,
+                          const vector<boundaryConditions> &bcs,
+                          const decomposition &decomp, const input &inp,
+                          const MPI_Datatype &MPI_connection,
+                          const MPI_Datatype &MPI_vec3d,
+                          const MPI_Datatype &MPI_vec3dMag) {
+  // mesh -- plot3dBlocks of entire grid (nodes may not be read)
+  // bcs -- boundary conditions of entire grid
+  // decomp -- decomposition of grid onto processors
+  // inp -- input variables
+  // MPI_connection -- MPI data type for a connection
+  // MPI_vec3d -- MPI data type for a vector3d
+  // MPI_vec3dMag -- MPI data type for a unitVect3dMag
+
+  // version of cache layout, changed when the layout or packed data change
+  const auto version = 1;
+  key_ = HashBytes(&version, sizeof(version), 14695981039346656037ULL);
+
+  // caches written by another version of aither are not trusted
+  const int aitherVersion[3] = {MAJORVERSION, MINORVERSION, PATCHNUMBER};
+  key_ = HashBytes(aitherVersion, sizeof(aitherVersion), key_);
+
+  // packed blocks and connections depend on the size of the packed types, so
+  // a cache written by a build with a different layout is not reused
+  const MPI_Datatype packedTypes[6] = {MPI_INT,   MPI_CXX_BOOL, MPI_DOUBLE,
+                                       MPI_vec3d, MPI_vec3dMag, MPI_connection};
+  int layout[9] = {static_cast<int>(sizeof(connection)),
+                   static_cast<int>(sizeof(MPI_Offset)),
+                   static_cast<int>(sizeof(int64_t))};
+  for (auto ii = 0; ii < 6; ++ii) {
+    MPI_Pack_size(1, packedTypes[ii], MPI_COMM_WORLD, &layout[ii + 3]);
+  }
+  key_ = HashBytes(layout, sizeof(layout), key_);
+
+  key_ = HashBytes(&gridHash_, sizeof(gridHash_), key_);
+  for (const auto &blk : mesh) {
+    const int dims[3] = {blk.NumI(), blk.NumJ(), blk.NumK()};
+    key_ = HashBytes(dims, sizeof(dims), key_);
+  }
+
+  std::ostringstream settings;
+  for (const auto &bc : bcs) {
+    settings << bc << endl;
+  }
+  settings << decomp << endl;
+  settings << inp.LRef() << " " << inp.EquationSet() << " "
+           << inp.TurbulenceModel() << " " << inp.TimeIntegration() << " "
+           << inp.NumEquations() << " " << inp.NumSpecies() << " "
+           << inp.NumberGhostLayers() << " "
+           << inp.MultigridLevels() << " "
+           << inp.MultigridAgglomerationThreshold() << endl;
+  const auto str = settings.str();
+  key_ = HashBytes(str.data(), str.size(), key_);
+}
+
+/* Member function to read the header of the cache file on the ROOT processor.
+If the file exists and matches the key, the connections stored in it are
+returned and the cache is marked as valid. Otherwise no connections are
+returned and the grid must be preprocessed.*/
+vector<connection> gridCache::ReadConnections(
+    const MPI_Datatype &MPI_connection) {
+  // MPI_connection -- MPI data type for a connection
+  vector<connection> connections;
+  isValid_ = false;
+
+  ifstream inFile(fileName_, ios::in | ios::binary);
+  if (inFile.fail()) {
+    cout << "Grid cache " << fileName_ << " not found, preprocessing grid"
+         << endl;
+    return connections;
+  }
+
+  // check that cache was written for this configuration
+  uint64_t key = 0;
+  auto numProcs = 0;
+  inFile.read(reinterpret_cast<char *>(&key), sizeof(key));
+  inFile.read(reinterpret_cast<char *>(&numProcs), sizeof(numProcs));
+  auto currentProcs = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &currentProcs);
+  if (inFile.fail() || key != key_ || numProcs != currentProcs) {
+    cout << "Grid cache " << fileName_ << " does not match grid, boundary "
+         << "conditions, and decomposition, preprocessing grid" << endl;
+    return connections;
+  }
+
+  // connections are packed with their MPI data type
+  auto numConnections = 0;
+  auto bufSize = 0;
+  inFile.read(reinterpret_cast<char *>(&numConnections),
+              sizeof(numConnections));
+  inFile.read(reinterpret_cast<char *>(&bufSize), sizeof(bufSize));
+  vector<char> buffer(bufSize);
+  inFile.read(buffer.data(), buffer.size());
+  offsets_.resize(numProcs);
+  inFile.read(reinterpret_cast<char *>(offsets_.data()),
+              offsets_.size() * sizeof(MPI_Offset));
+  if (inFile.fail()) {
+    cerr << "ERROR: Grid cache " << fileName_ << " is truncated!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  connections.resize(numConnections);
+  auto position = 0;
+  MPI_Unpack(buffer.data(), bufSize, &position, connections.data(),
+             numConnections, MPI_connection, MPI_COMM_WORLD);
+
+  cout << "Reading geometry from grid cache " << fileName_ << endl;
+  isValid_ = true;
+  return connections;
+}
+
+// member function to send the validity of the cache, and the position of the
+// records of each processor, from ROOT to all processors
+void gridCache::Broadcast() {
+  MPI_Bcast(&isValid_, 1, MPI_CXX_BOOL, ROOTP, MPI_COMM_WORLD);
+  if (isValid_) {
+    MPI_Scatter(offsets_.data(), 1, MPI_OFFSET, &position_, 1, MPI_OFFSET,
+                ROOTP, MPI_COMM_WORLD);
+  }
+}
+
+// member function to read the next record of this processor -- a record is
+// its size in bytes followed by the data
+vector<char> gridCache::ReadRecord(MPI_File &cacheFile) {
+  // cacheFile -- cache file opened with MPI
+  int64_t size = 0;
+  MPI_File_read_at(cacheFile, position_, &size, sizeof(size), MPI_BYTE,
+                   MPI_STATUS_IGNORE);
+  position_ += sizeof(size);
+  vector<char> record(size);
+  MPI_File_read_at(cacheFile, position_, record.data(), size, MPI_BYTE,
+                   MPI_STATUS_IGNORE);
+  position_ += size;
+  return record;
+}
+
+// member function to write the next record of this processor
+void gridCache::WriteRecord(MPI_File &cacheFile, const char *data,
+                            const int64_t &size) {
+  // cacheFile -- cache file opened with MPI
+  // data -- data to write
+  // size -- size of data in bytes
+  MPI_File_write_at(cacheFile, position_, &size, sizeof(size), MPI_BYTE,
+                    MPI_STATUS_IGNORE);
+  position_ += sizeof(size);
+  MPI_File_write_at(cacheFile, position_, data, size, MPI_BYTE,
+                    MPI_STATUS_IGNORE);
+  position_ += size;
+}
+
+/* Member function to read the procBlocks of the finest level on this
+processor from the cache. The procBlocks contain their geometry, including the
+ghost cell geometry swapped across connections, and their boundary conditions,
+so they only need their states initialized.*/
+vector<procBlock> gridCache::ReadBlocks(const decomposition &decomp,
+                                        const input &inp, const int &rank,
+                                        const MPI_Datatype &MPI_vec3d,
+                                        const MPI_Datatype &MPI_vec3dMag) {
+  // decomp -- decomposition of grid onto processors
+  // inp -- input variables
+  // rank -- processor rank
+  // MPI_vec3d -- MPI data type for a vector3d
+  // MPI_vec3dMag -- MPI data type for a unitVect3dMag
+
+  MPI_File cacheFile;
+  if (MPI_File_open(MPI_COMM_WORLD, fileName_.c_str(), MPI_MODE_RDONLY,
+                    MPI_INFO_NULL, &cacheFile) != MPI_SUCCESS) {
+    cerr << "ERROR: Grid cache " << fileName_ << " did not open correctly!!!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  vector<procBlock> blocks(decomp.NumBlocksOnProc(rank));
+  for (auto ll = 0U; ll < blocks.size(); ++ll) {
+    auto record = this->ReadRecord(cacheFile);
+    auto position = 0;
+    blocks[ll].UnpackGeomMPI(record.data(), record.size(), position,
+                             MPI_vec3d, MPI_vec3dMag, inp);
+    if (blocks[ll].GlobalPos() != decomp.GlobalPos(rank, ll)) {
+      cerr << "ERROR: Block in grid cache " << fileName_
+           << " does not match decomposition!" << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  MPI_File_close(&cacheFile);
+  return blocks;
+}
+
+// member function to read the wall distance of the procBlocks on this
+// processor on all grid levels from the cache
+void gridCache::ReadWallDistance(mgSolution &sol) {
+  // sol -- solution on all grid levels
+  MPI_File cacheFile;
+  if (MPI_File_open(MPI_COMM_WORLD, fileName_.c_str(), MPI_MODE_RDONLY,
+                    MPI_INFO_NULL, &cacheFile) != MPI_SUCCESS) {
+    cerr << "ERROR: Grid cache " << fileName_ << " did not open correctly!!!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  for (auto ll = 0; ll < sol.NumGridLevels(); ++ll) {
+    for (auto bb = 0; bb < sol[ll].NumBlocks(); ++bb) {
+      auto &block = sol[ll].Block(bb);
+      auto wallDist = block.WallDistances();
+      const auto record = this->ReadRecord(cacheFile);
+      if (record.size() != wallDist.Size() * sizeof(double)) {
+        cerr << "ERROR: Wall distance in grid cache " << fileName_
+             << " does not match grid level " << ll << "!" << endl;
+        exit(EXIT_FAILURE);
+      }
+      std::memcpy(&(*std::begin(wallDist)), record.data(), record.size());
+      block.AssignWallDistances(std::move(wallDist));
+    }
+  }
+  MPI_File_close(&cacheFile);
+}
+
+/* Member function to write the cache. The header is written by ROOT and
+contains the key, the connections, and the position of the records of each
+processor. Each processor then writes the packed geometry of its procBlocks on
+the finest level, followed by the wall distance of its procBlocks on all grid
+levels.*/
+void gridCache::Write(const mgSolution &sol, const int &rank,
+                      const MPI_Datatype &MPI_connection,
+                      const MPI_Datatype &MPI_vec3d,
+                      const MPI_Datatype &MPI_vec3dMag) {
+  // sol -- solution on all grid levels
+  // rank -- processor rank
+  // MPI_connection -- MPI data type for a connection
+  // MPI_vec3d -- MPI data type for a vector3d
+  // MPI_vec3dMag -- MPI data type for a unitVect3dMag
+
+  // get size of records on this processor
+  const auto &finest = sol.Finest();
+  MPI_Offset localSize = 0;
+  for (const auto &block : finest.Blocks()) {
+    localSize += sizeof(int64_t) + block.GeomPackSize(MPI_vec3d, MPI_vec3dMag);
+  }
+  for (auto ll = 0; ll < sol.NumGridLevels(); ++ll) {
+    for (const auto &block : sol[ll].Blocks()) {
+      localSize += sizeof(int64_t) + block.WallDistances().Size() *
+                                         sizeof(double);
+    }
+  }
+  auto numProcs = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  vector<MPI_Offset> sizes(numProcs, 0);
+  MPI_Gather(&localSize, 1, MPI_OFFSET, sizes.data(), 1, MPI_OFFSET, ROOTP,
+             MPI_COMM_WORLD);
+
+  // header is written by ROOT before the records are written
+  if (rank == ROOTP) {
+    ofstream outFile(fileName_, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Grid cache " << fileName_ << " did not open correctly!!!"
+           << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // connections are packed with their MPI data type
+    auto connections = finest.Connections();
+    auto numConnections = static_cast<int>(connections.size());
+    auto bufSize = 0;
+    MPI_Pack_size(numConnections, MPI_connection, MPI_COMM_WORLD, &bufSize);
+    vector<char> buffer(bufSize);
+    auto position = 0;
+    MPI_Pack(connections.data(), numConnections, MPI_connection, buffer.data(),
+             bufSize, &position, MPI_COMM_WORLD);
+
+    outFile.write(reinterpret_cast<char *>(&key_), sizeof(key_));
+    outFile.write(reinterpret_cast<char *>(&numProcs), sizeof(numProcs));
+    outFile.write(reinterpret_cast<char *>(&numConnections),
+                  sizeof(numConnections));
+    outFile.write(reinterpret_cast<char *>(&bufSize), sizeof(bufSize));
+    outFile.write(buffer.data(), buffer.size());
+
+    // records of each processor follow the header
+    offsets_.assign(numProcs, 0);
+    MPI_Offset offset = static_cast<MPI_Offset>(outFile.tellp()) +
+                        numProcs * sizeof(MPI_Offset);
+    for (auto pp = 0; pp < numProcs; ++pp) {
+      offsets_[pp] = offset;
+      offset += sizes[pp];
+    }
+    outFile.write(reinterpret_cast<char *>(offsets_.data()),
+                  offsets_.size() * sizeof(MPI_Offset));
+  }
+  MPI_Scatter(offsets_.data(), 1, MPI_OFFSET, &position_, 1, MPI_OFFSET,
+              ROOTP, MPI_COMM_WORLD);
+
+  MPI_File cacheFile;
+  if (MPI_File_open(MPI_COMM_WORLD, fileName_.c_str(), MPI_MODE_WRONLY,
+                    MPI_INFO_NULL, &cacheFile) != MPI_SUCCESS) {
+    cerr << "ERROR: Grid cache " << fileName_ << " did not open correctly!!!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // pack one procBlock at a time to limit memory use
+  for (const auto &block : finest.Blocks()) {
+    const auto size = block.GeomPackSize(MPI_vec3d, MPI_vec3dMag);
+    vector<char> record(size);
+    auto position = 0;
+    block.PackGeomMPI(record.data(), size, position, MPI_vec3d, MPI_vec3dMag);
+    this->WriteRecord(cacheFile, record.data(), record.size());
+  }
+  for (auto ll = 0; ll < sol.NumGridLevels(); ++ll) {
+    for (const auto &block : sol[ll].Blocks()) {
+      const auto &wallDist = block.WallDistances();
+      const auto *data = &(*std::begin(wallDist));
+      this->WriteRecord(cacheFile, reinterpret_cast<const char *>(data),
+                        wallDist.Size() * sizeof(double));
+    }
+  }
+  MPI_File_close(&cacheFile);
+
+  if (rank == ROOTP) {
+    cout << "Wrote grid cache " << fileName_ << endl;
+  }
+}
+
+// function to hash bytes with the 64 bit FNV-1a algorithm
+uint64_t HashBytes(const void *data, const size_t &size, uint64_t hash) {
+  // data -- bytes to hash
+  // size -- number of bytes
+  // hash -- hash to continue from
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (size_t ii = 0; ii < size; ++ii) {
+    hash ^= bytes[ii];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
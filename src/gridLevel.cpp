@@ -18,6 +18,11 @@
 #include <cstdlib>      // exit()
 #include <vector>
 #include <string>
+#include <algorithm>    // max, copy
+#include <numeric>      // accumulate
+#include <memory>       // unique_ptr
+#include <chrono>       // high_resolution_clock
+#include <utility>      // move
 #include "gridLevel.hpp"
 #include "utility.hpp"
 #include "parallel.hpp"
@@ -31,133 +36,172 @@
 #include "kdtree.hpp"
 #include "matMultiArray3d.hpp"
 #include "linearSolver.hpp"
+#include "haloExchange.hpp"
 #include "macros.hpp"
 
+#ifdef _OPENMP
+#include <omp.h>        // omp_get_max_threads
+#endif
+
 using std::cerr;
 using std::cout;
 using std::endl;
 using std::string;
 using std::vector;
 
-// constructor
+/* Constructor for a gridLevel containing only the procBlocks on this
+processor. Each processor constructs its own procBlocks from the portion of the
+grid it has read, so the procBlocks do not need to be constructed on ROOT and
+sent to the other processors.
+*/
 gridLevel::gridLevel(const vector<plot3dBlock>& mesh,
                      const vector<boundaryConditions>& bcs,
+                     const vector<connection>& connections,
                      const decomposition& decomp, const physics& phys,
-                     const vector<vector3d<int>>& origGridSizes,
-                     const string& restartFile, input& inp, residual& first) {
+                     const int& rank, const input& inp,
+                     const MPI_Datatype& MPI_vec3d,
+                     const MPI_Datatype& MPI_vec3dMag)
+    : connections_(connections) {
+  // mesh -- plot3dBlocks on this processor in order of local position
+  // bcs -- boundary conditions on this processor in order of local position
+  // connections -- connections for all blocks
+  // decomp -- decomposition of grid onto processors
+  // rank -- processor rank
+  this->ConstructBlocks(mesh, bcs, decomp, phys, rank, inp, MPI_vec3d,
+                        MPI_vec3dMag);
+
+  // now allocate memory for linear solver
+  solver_ = inp.AssignLinearSolver(*this);
+}
+
+/* Constructor for a gridLevel from procBlocks on this processor whose geometry
+is already complete, such as those read from the grid cache. The ghost cell
+geometry at interblock boundaries has already been swapped, so only the states
+need to be initialized.
+*/
+gridLevel::gridLevel(vector<procBlock> blocks,
+                     const vector<connection>& connections,
+                     const physics& phys, const input& inp)
+    : blocks_(std::move(blocks)), connections_(connections) {
+  // blocks -- procBlocks on this processor in order of local position
+  // connections -- connections for all blocks
+  mgForcing_.reserve(blocks_.size());
+  for (auto& block : blocks_) {
+    block.InitializeStates(inp, phys);
+    mgForcing_.emplace_back(block.NumI(), block.NumJ(), block.NumK(), 0,
+                            block.NumEquations(), block.NumSpecies(), 0);
+  }
+  blockTime_.assign(blocks_.size(), 0.0);
+
+  // now allocate memory for linear solver
+  solver_ = inp.AssignLinearSolver(*this);
+}
+
+/* Member function to construct the procBlocks on this processor from their
+plot3dBlocks and boundary conditions. The ghost cell geometry at interblock
+boundaries is swapped with the neighboring blocks, using MPI for neighbors on
+other processors. The connections must be assigned before calling this
+function.
+*/
+void gridLevel::ConstructBlocks(const vector<plot3dBlock>& mesh,
+                                const vector<boundaryConditions>& bcs,
+                                const decomposition& decomp,
+                                const physics& phys, const int& rank,
+                                const input& inp,
+                                const MPI_Datatype& MPI_vec3d,
+                                const MPI_Datatype& MPI_vec3dMag) {
+  // mesh -- plot3dBlocks on this processor in order of local position
+  // bcs -- boundary conditions on this processor in order of local position
+  // decomp -- decomposition of this level
+  // rank -- processor rank
   MSG_ASSERT(mesh.size() == bcs.size(), "block size mismatch");
-  connections_ = GetConnectionBCs(bcs, mesh, decomp, inp);
+
   blocks_.reserve(mesh.size());
   mgForcing_.reserve(mesh.size());
   for (auto ll = 0U; ll < mesh.size(); ++ll) {
-    blocks_.emplace_back(mesh[ll], decomp.ParentBlock(ll), bcs[ll], ll,
-                         decomp.Rank(ll), decomp.LocalPosition(ll), inp);
+    const auto gp = decomp.GlobalPos(rank, ll);
+    blocks_.emplace_back(mesh[ll], decomp.ParentBlock(gp), bcs[ll], gp, rank,
+                         ll, inp);
     blocks_.back().InitializeStates(inp, phys);
     blocks_.back().AssignGhostCellsGeom();
     mgForcing_.emplace_back(
         blocks_.back().NumI(), blocks_.back().NumJ(), blocks_.back().NumK(), 0,
         blocks_.back().NumEquations(), blocks_.back().NumSpecies(), 0);
   }
+  blockTime_.assign(blocks_.size(), 0.0);
 
-  // if restart, get data from restart file
-  if (inp.IsRestart()) {
-    ReadRestart(*this, restartFile, decomp, inp, phys, first, origGridSizes);
-  }
-
-  // Swap geometry for interblock BCs - assumes all data on rank 0
-  for (auto& conn : connections_) {
+  // Swap geometry for interblock BCs
+  for (auto ii = 0U; ii < connections_.size(); ++ii) {
+    auto& conn = connections_[ii];
     if (conn.IsInterblock()) {
-      SwapGeomSlice(conn, blocks_[conn.BlockFirst()],
-                    blocks_[conn.BlockSecond()]);
+      if (rank == conn.RankFirst() && rank == conn.RankSecond()) {
+        // all data is local
+        SwapGeomSlice(conn, blocks_[conn.LocalBlockFirst()],
+                      blocks_[conn.LocalBlockSecond()]);
+      } else if (rank == conn.RankFirst()) {
+        // first connection swapping with remote processor
+        SwapGeomSliceMPI(conn, blocks_[conn.LocalBlockFirst()], ii, MPI_vec3d,
+                         MPI_vec3dMag);
+      } else if (rank == conn.RankSecond()) {
+        // second connection swapping with remote processor
+        SwapGeomSliceMPI(conn, blocks_[conn.LocalBlockSecond()], ii,
+                         MPI_vec3d, MPI_vec3dMag);
+      }
     }
   }
   // Get ghost cell edge data
   for (auto& block : blocks_) {
     block.AssignGhostCellsGeomEdge();
   }
-
-  // Setup linear solver
-  if (inp.IsImplicit()) {
-    solver_ = inp.AssignLinearSolver(*this);
-  }
 }
 
-/* Function to send procBlocks to their appropriate processor. This function is
-called after the decomposition has been run. The procBlock data all
-resides on the ROOT processor. In this function, the ROOT processor packs the
-procBlocks and sends them to the appropriate processor. All the non-ROOT
-processors receive and unpack the data from ROOT. This is used to send the
-geometric block data from ROOT to all the processors at the beginning of the
-simulation.
+/* Function to gather the procBlock geometry on the ROOT processor. Each
+processor constructs its own procBlocks, so the returned gridLevel holds all
+procBlocks and is only meaningful on the ROOT processor. It is used to write out
+results.
 */
-gridLevel gridLevel::SendGridLevel(const int& rank, const int& numProcBlock,
-                                   const MPI_Datatype& MPI_vec3d,
-                                   const MPI_Datatype& MPI_vec3dMag,
-                                   const MPI_Datatype& MPI_connection,
-                                   const input& inp) const {
-  // *this -- global gridLevel, only meaningful on ROOT processor
+gridLevel gridLevel::GatherGridLevel(const decomposition& decomp,
+                                     const int& rank,
+                                     const MPI_Datatype& MPI_vec3d,
+                                     const MPI_Datatype& MPI_vec3dMag,
+                                     const input& inp) const {
+  // *this -- local gridLevel
+  // decomp -- decomposition of grid onto processors
   // rank -- proc rank, used to determine if process should send or receive
-  // numProcBlock -- number of procBlocks that the processor should have. (All
-  //                 processors may give different values).
   // MPI_vec3d -- MPI_Datatype used for vector3d<double>  transmission
   // MPI_vec3dMag -- MPI_Datatype used for unitVec3dMag<double>  transmission
-  // MPI_connection -- MPI_Datatype used for connection  transmission
   // input -- input variables
 
-  gridLevel local(numProcBlock);
+  gridLevel global;
   //------------------------------------------------------------------------
   //                                  ROOT
   //------------------------------------------------------------------------
-  if (rank == ROOTP) {  // may have to pack and send data
+  if (rank == ROOTP) {  // may have to recv and unpack data
+    global.blocks_.resize(decomp.NumBlocks());
+    global.connections_ = connections_;
     // loop over ALL blocks
-    for (const auto &global : blocks_) {
-      // no need to send data because it is already on root processor
-      if (global.Rank() == ROOTP) {
-        const auto lp = global.LocalPosition();
-        local.blocks_[lp] = global;
-        local.mgForcing_[lp] = blkMultiArray3d<varArray>(
-            global.NumI(), global.NumJ(), global.NumK(), 0,
-            global.NumEquations(), global.NumSpecies());
-      } else {  // send data to receiving processors
-        // pack and send procBlock
-        global.PackSendGeomMPI(MPI_vec3d, MPI_vec3dMag);
+    for (auto gp = 0; gp < decomp.NumBlocks(); ++gp) {
+      if (decomp.Rank(gp) == ROOTP) {  // data already on ROOT processor
+        global.blocks_[gp] = blocks_[decomp.LocalPosition(gp)];
+      } else {  // recv data from sending processors
+        global.blocks_[gp].RecvUnpackGeomMPI(MPI_vec3d, MPI_vec3dMag, inp,
+                                             decomp.Rank(gp));
       }
     }
     //--------------------------------------------------------------------------
     //                                NON - ROOT
     //--------------------------------------------------------------------------
-  } else {  // receive and unpack data (non-root)
-    for (auto ii = 0; ii < numProcBlock; ++ii) {
-      // recv and unpack procBlock
-      procBlock tempBlock;
-      tempBlock.RecvUnpackGeomMPI(MPI_vec3d, MPI_vec3dMag, inp);
-
-      // add procBlock to output vector
-      const auto lp = tempBlock.LocalPosition();
-      local.blocks_[lp] = tempBlock;
-      local.mgForcing_[lp] = blkMultiArray3d<varArray>(
-          tempBlock.NumI(), tempBlock.NumJ(), tempBlock.NumK(), 0,
-          tempBlock.NumEquations(), tempBlock.NumSpecies());
+  } else {  // pack and send data (non-root)
+    // need to send data in order of global position, not local position to
+    // prevent deadlock
+    for (auto gp = 0; gp < decomp.NumBlocks(); ++gp) {
+      if (decomp.Rank(gp) == rank) {
+        blocks_[decomp.LocalPosition(gp)].PackSendGeomMPI(MPI_vec3d,
+                                                         MPI_vec3dMag, ROOTP);
+      }
     }
   }
-
-  // now do connections -------------------------------------------------------
-  // first determine the number of connections and send that to all processors
-  if (rank == ROOTP) {
-    local.connections_ = connections_;
-  }
-  auto numCon = local.NumConnections();
-  MPI_Bcast(&numCon, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
-  local.connections_.resize(numCon);  // allocate space to receive connections
-
-  // broadcast all connections to all processors
-  MPI_Bcast(&(*std::begin(local.connections_)), local.connections_.size(),
-            MPI_connection, ROOTP, MPI_COMM_WORLD);
-
-  // now allocate memory for linear solver
-  local.solver_ = inp.AssignLinearSolver(local);
-
-  return local;
+  return global;
 }
 
 /* Function to send procBlocks to the root processor. In this function, the
@@ -190,7 +234,7 @@ void gridLevel::GetGridLevel(const gridLevel& local, const int& rank,
         global = local.blocks_[global.LocalPosition()];
       } else {  // recv data from sending processors
         global.RecvUnpackSolMPI(MPI_uncoupledScalar, MPI_vec3d,
-                                MPI_tensorDouble, inp);
+                                MPI_tensorDouble, inp, global.Rank());
       }
     }
     //-------------------------------------------------------------------------
@@ -212,37 +256,145 @@ void gridLevel::GetGridLevel(const gridLevel& local, const int& rank,
 
     for (auto &lp : localPos) {
       local.blocks_[lp.first].PackSendSolMPI(MPI_uncoupledScalar, MPI_vec3d,
-                                             MPI_tensorDouble);
+                                             MPI_tensorDouble, ROOTP);
     }
   }
 }
 
+// member function to assign the processor and local position of all procBlocks
+// and connections from a decomposition
+void gridLevel::AssignDecomposition(const decomposition& decomp) {
+  // decomp -- decomposition of grid onto processors
+  for (auto& block : blocks_) {
+    block.AssignDecomposition(decomp);
+  }
+  for (auto& conn : connections_) {
+    conn.AssignDecomposition(decomp);
+  }
+}
+
+/* Member function to move procBlocks between processors during a simulation.
+The new decomposition must contain the same blocks as the old one, only their
+processors and local positions may differ. Blocks that change processor are
+sent with both their geometry and solution, so the simulation can continue
+without a restart. Afterwards, the connections are updated for the new
+decomposition, and the linear solver and halo exchange are rebuilt for the
+blocks now on this processor. The data used to transfer to a coarser level is
+indexed by local position, so it is cleared and must be rebuilt by coarsening
+this level again.
+*/
+void gridLevel::Redistribute(const decomposition& oldDecomp,
+                             const decomposition& newDecomp, const int& rank,
+                             const input& inp,
+                             const MPI_Datatype& MPI_uncoupledScalar,
+                             const MPI_Datatype& MPI_vec3d,
+                             const MPI_Datatype& MPI_vec3dMag,
+                             const MPI_Datatype& MPI_tensorDouble) {
+  // oldDecomp -- current decomposition of this level
+  // newDecomp -- decomposition to move blocks to
+  // rank -- processor rank
+  // inp -- input variables
+  // MPI_uncoupledScalar -- MPI_Datatype used for uncoupledScalar transmission
+  // MPI_vec3d -- MPI_Datatype used for vector3d<double> transmission
+  // MPI_vec3dMag -- MPI_Datatype used for unitVec3dMag<double> transmission
+  // MPI_tensorDouble -- MPI_Datatype used for tensor<double> transmission
+  MSG_ASSERT(!isAgglomerated_, "agglomerated level cannot be redistributed");
+  MSG_ASSERT(oldDecomp.NumBlocks() == newDecomp.NumBlocks(),
+             "block size mismatch");
+
+  // need to send data in order of global position to prevent deadlock
+  vector<procBlock> blocks(newDecomp.NumBlocksOnProc(rank));
+  for (auto gp = 0; gp < newDecomp.NumBlocks(); ++gp) {
+    const auto oldRank = oldDecomp.Rank(gp);
+    const auto newRank = newDecomp.Rank(gp);
+    if (oldRank == rank && newRank == rank) {  // block stays on processor
+      blocks[newDecomp.LocalPosition(gp)] =
+          std::move(blocks_[oldDecomp.LocalPosition(gp)]);
+    } else if (oldRank == rank) {  // send block to new processor
+      const auto& block = blocks_[oldDecomp.LocalPosition(gp)];
+      block.PackSendGeomMPI(MPI_vec3d, MPI_vec3dMag, newRank);
+      block.PackSendSolMPI(MPI_uncoupledScalar, MPI_vec3d, MPI_tensorDouble,
+                           newRank);
+      if (inp.CollectStatistics()) {
+        block.SendStatisticsMPI(newRank);
+      }
+    } else if (newRank == rank) {  // recv block from old processor
+      auto& block = blocks[newDecomp.LocalPosition(gp)];
+      block.RecvUnpackGeomMPI(MPI_vec3d, MPI_vec3dMag, inp, oldRank);
+      block.RecvUnpackSolMPI(MPI_uncoupledScalar, MPI_vec3d, MPI_tensorDouble,
+                             inp, oldRank);
+      if (inp.CollectStatistics()) {
+        block.RecvStatisticsMPI(oldRank);
+      }
+    }
+  }
+  blocks_ = std::move(blocks);
+  this->AssignDecomposition(newDecomp);
+
+  mgForcing_.clear();
+  mgForcing_.reserve(blocks_.size());
+  for (const auto& block : blocks_) {
+    mgForcing_.emplace_back(block.NumI(), block.NumJ(), block.NumK(), 0,
+                            block.NumEquations(), block.NumSpecies(), 0);
+  }
+  blockTime_.assign(blocks_.size(), 0.0);
+  toCoarse_.clear();
+  volWeightFactor_.clear();
+
+  // halo exchange is rebuilt on first use
+  halo_ = haloExchange();
+  solver_ = inp.AssignLinearSolver(*this);
+}
+
 // function to calculate the distance to the nearest viscous wall of all
 // cell centers
 void gridLevel::CalcWallDistance(const kdtree &tree) {
-  for (auto &block : blocks_) {
-    block.CalcWallDistance(tree);
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    blocks_[bb].CalcWallDistance(tree);
+  }
+}
+
+// function to add the current solution to the running statistics of all
+// blocks
+void gridLevel::UpdateStatistics(const input &inp, const physics &phys) {
+  // inp -- input variables
+  // phys -- physics models
+  const auto vars = inp.StatisticsVariables();
+  vector<cellExtractor> extractors;
+  for (const auto &var : vars) {
+    extractors.push_back(FunctionExtractor(var, phys, inp));
+  }
+  const auto pairs = StatisticsPairs(vars);
+
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    blocks_[bb].AddStatisticsSample(CellValues(blocks_[bb], extractors, false),
+                                    extractors.size(), pairs);
   }
 }
 
 void gridLevel::AssignSolToTimeN(const physics &phys) {
-  for (auto &block : blocks_) {
-    block.AssignSolToTimeN(phys);
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    blocks_[bb].AssignSolToTimeN(phys);
   }
 }
 
 void gridLevel::AssignSolToTimeNm1() {
-  for (auto &block : blocks_) {
-    block.AssignSolToTimeNm1();
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    blocks_[bb].AssignSolToTimeNm1();
   }
 }
 
 void gridLevel::CalcTimeStep(const input &inp) {
   // states -- vector of all procBlocks on processor
   // inp -- input variables
-  for (auto &block : blocks_) {
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
     // calculate time step
-    block.CalcBlockTimeStep(inp);
+    blocks_[bb].CalcBlockTimeStep(inp);
   }
 }
 
@@ -252,32 +404,83 @@ void gridLevel::ExplicitUpdate(const input& inp, const physics& phys,
                                resid& residLinf) {
   // create dummy update (not used in explicit update)
   blkMultiArray3d<varArray> du;
+  // residual norms are accumulated for each block and combined in block
+  // order, so they do not depend on the number of threads
+  vector<residual> blockL2(this->NumBlocks(),
+                           residual(inp.NumEquations(), inp.NumSpecies()));
+  vector<resid> blockLinf(this->NumBlocks(), residLinf);
   // loop over all blocks and update
-  for (auto &block : blocks_) {
-    block.UpdateBlock(inp, phys, du, mm, residL2, residLinf);
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    blocks_[bb].UpdateBlock(inp, phys, du, mm, blockL2[bb], blockLinf[bb]);
+    this->AddBlockTime(bb, start);
   }
+  CombineResiduals(blockL2, blockLinf, residL2, residLinf);
 }
 
-void gridLevel::SwapWallDist(const int& rank, const int& numGhosts) {
+/* Member function to determine if the residual should be threaded over the
+blocks of this processor. When there are fewer blocks than threads, the face
+loops within each block are threaded instead.
+*/
+bool gridLevel::ThreadOverBlocks() const {
+#ifdef _OPENMP
+  return this->NumBlocks() >= omp_get_max_threads();
+#else
+  return false;
+#endif
+}
+
+/* Member function to get the halo exchange for the connection boundaries of
+this grid level. The exchange is constructed on first use, after the blocks and
+connections on this processor are final, and reused for the rest of the run.
+The channels for all fields swapped on the grid level are created with it.
+*/
+haloExchange& gridLevel::Halo(const int& rank) {
   // rank -- processor rank
-  // numGhosts -- number of ghost cells
+  if (!halo_.IsSetUp(rank)) {
+    vector<vector3d<int>> dims;
+    dims.reserve(blocks_.size());
+    for (const auto& block : blocks_) {
+      dims.emplace_back(block.NumI(), block.NumJ(), block.NumK());
+    }
+    const auto numGhosts = blocks_.empty() ? 0 : blocks_[0].NumGhosts();
 
-  // loop over all connections and swap connection updates when necessary
-  for (auto &conn : connections_) {
-    if (conn.RankFirst() == rank && conn.RankSecond() == rank) {
-      // both sides of connection are on this processor, swap w/o mpi
-      blocks_[conn.LocalBlockFirst()].SwapWallDistSlice(
-          conn, blocks_[conn.LocalBlockSecond()]);
-    } else if (conn.RankFirst() == rank) {
-      // rank matches rank of first side of connection, swap over mpi
-      blocks_[conn.LocalBlockFirst()].SwapWallDistSliceMPI(conn, rank);
-    } else if (conn.RankSecond() == rank) {
-      // rank matches rank of second side of connection, swap over mpi
-      blocks_[conn.LocalBlockSecond()].SwapWallDistSliceMPI(conn, rank);
+    // number of values per cell for each tag swapped
+    std::map<int, int> channelValues = {{1, 0}, {2, 0}, {3, 0}, {5, 0},
+                                        {6, 0}};
+    if (!blocks_.empty()) {
+      const auto &block = blocks_[0];
+      channelValues[1] = block.StateHaloValues();
+      channelValues[2] = block.TurbHaloValues();
+      channelValues[3] = block.WallDistHaloValues();
+      channelValues[5] = block.EddyViscAndGradientHaloValues();
+      channelValues[6] = channelValues[5] + block.TurbHaloValues();
     }
-    // if rank doesn't match either side of connection, then do nothing and
-    // move on to the next connection
+    halo_ = haloExchange(connections_, rank, dims, numGhosts, channelValues);
   }
+  return halo_;
+}
+
+void gridLevel::SwapWallDist(const int& rank, const int& numGhosts) {
+  // rank -- processor rank
+  // numGhosts -- number of ghost cells
+
+  // swap local connections directly, and connections shared with other
+  // processors with one message per neighboring processor
+  const auto numVals = blocks_.empty() ? 0 : blocks_[0].WallDistHaloValues();
+  this->Halo(rank).Exchange(
+      connections_, 3, numVals,
+      [&](const connection &conn) {
+        blocks_[conn.LocalBlockFirst()].SwapWallDistSlice(
+            conn, blocks_[conn.LocalBlockSecond()]);
+      },
+      [&](const haloSlice &slice, double *buffer) {
+        return blocks_[slice.block_].PackWallDistSlice(slice, buffer);
+      },
+      [&](const haloSlice &slice, const double *buffer) {
+        return blocks_[slice.block_].UnpackWallDistSlice(slice, buffer);
+      });
 }
 
 /* Function to populate ghost cells with proper cell states for inviscid flow
@@ -289,32 +492,60 @@ void gridLevel::GetBoundaryConditions(const input& inp, const physics& phys,
   // inp -- all input variables
   // phys -- physics models
   // rank -- processor rank
+  this->StartBoundaryConditions(inp, phys, rank);
+  this->FinishBoundaryConditions(inp, phys, rank);
+}
+
+/* Member function to assign the ghost cells at physical boundaries and start
+sending the states across connection boundaries. The ghost cells at
+connection boundaries and block edges are not valid until
+FinishBoundaryConditions is called.
+*/
+void gridLevel::StartBoundaryConditions(const input& inp, const physics& phys,
+                                        const int& rank) {
+  // inp -- all input variables
+  // phys -- physics models
+  // rank -- processor rank
 
   // loop over all blocks and assign inviscid ghost cells
-  for (auto &block : blocks_) {
-    block.AssignInviscidGhostCells(inp, phys);
-  }
-
-  // loop over connections and swap ghost cells where needed
-  for (auto &conn : connections_) {
-    if (conn.RankFirst() == rank && conn.RankSecond() == rank) {
-      // both sides of connection on this processor, swap w/o mpi
-      blocks_[conn.LocalBlockFirst()].SwapStateSlice(
-          conn, blocks_[conn.LocalBlockSecond()]);
-    } else if (conn.RankFirst() == rank) {
-      // rank matches rank of first side of connection, swap over mpi
-      blocks_[conn.LocalBlockFirst()].SwapStateSliceMPI(conn, rank);
-    } else if (conn.RankSecond() == rank) {
-      // rank matches rank of second side of connection, swap over mpi
-      blocks_[conn.LocalBlockSecond()].SwapStateSliceMPI(conn, rank);
-    }
-    // if rank doesn't match either side of connection, then do nothing and
-    // move on to the next connection
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    blocks_[bb].AssignInviscidGhostCells(inp, phys);
   }
 
+  // connections shared with other processors are sent with one message per
+  // neighboring processor
+  const auto numVals = blocks_.empty() ? 0 : blocks_[0].StateHaloValues();
+  this->Halo(rank).StartExchange(
+      1, numVals, [&](const haloSlice &slice, double *buffer) {
+        return blocks_[slice.block_].PackStateSlice(slice, buffer);
+      });
+}
+
+// member function to complete the ghost cells started with
+// StartBoundaryConditions
+void gridLevel::FinishBoundaryConditions(const input& inp, const physics& phys,
+                                         const int& rank) {
+  // inp -- all input variables
+  // phys -- physics models
+  // rank -- processor rank
+
+  // swap local connections directly, and unpack messages from neighboring
+  // processors
+  this->Halo(rank).FinishExchange(
+      connections_, 1,
+      [&](const connection &conn) {
+        blocks_[conn.LocalBlockFirst()].SwapStateSlice(
+            conn, blocks_[conn.LocalBlockSecond()]);
+      },
+      [&](const haloSlice &slice, const double *buffer) {
+        return blocks_[slice.block_].UnpackStateSlice(slice, buffer);
+      });
+
   // loop over all blocks and get ghost cell edge data
-  for (auto &block : blocks_) {
-    block.AssignInviscidGhostCellsEdge(inp, phys);
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    blocks_[bb].AssignInviscidGhostCellsEdge(inp, phys);
   }
 }
 
@@ -322,79 +553,148 @@ void gridLevel::SwapTurbVars(const int& rank, const int& numGhosts) {
   // rank -- processor rank
   // numGhosts -- number of ghost cells
 
-  // loop over all connections and swap connection updates when necessary
-  for (auto &conn : connections_) {
-    if (conn.RankFirst() == rank && conn.RankSecond() == rank) {
-      // both sides of connection are on this processor, swap w/o mpi
-      blocks_[conn.LocalBlockFirst()].SwapTurbSlice(
-          conn, blocks_[conn.LocalBlockSecond()]);
-    } else if (conn.RankFirst() == rank) {
-      // rank matches rank of first side of connection, swap over mpi
-      blocks_[conn.LocalBlockFirst()].SwapTurbSliceMPI(conn, rank);
-    } else if (conn.RankSecond() == rank) {
-      // rank matches rank of second side of connection, swap over mpi
-      blocks_[conn.LocalBlockSecond()].SwapTurbSliceMPI(conn, rank);
-    }
-    // if rank doesn't match either side of connection, then do nothing and
-    // move on to the next connection
-  }
+  // swap local connections directly, and connections shared with other
+  // processors with one message per neighboring processor
+  const auto numVals = blocks_.empty() ? 0 : blocks_[0].TurbHaloValues();
+  this->Halo(rank).Exchange(
+      connections_, 2, numVals,
+      [&](const connection &conn) {
+        blocks_[conn.LocalBlockFirst()].SwapTurbSlice(
+            conn, blocks_[conn.LocalBlockSecond()]);
+      },
+      [&](const haloSlice &slice, double *buffer) {
+        return blocks_[slice.block_].PackTurbSlice(slice, buffer);
+      },
+      [&](const haloSlice &slice, const double *buffer) {
+        return blocks_[slice.block_].UnpackTurbSlice(slice, buffer);
+      });
 }
 
+/* Member function to swap the eddy viscosity and velocity gradients calculated
+during the residual calculation. For RANS simulations the turbulence blending
+functions are also calculated during the residual calculation, so they are
+swapped in the same messages.
+*/
 void gridLevel::SwapEddyViscAndGradients(const int& rank,
-                                         const MPI_Datatype& MPI_tensorDouble,
-                                         const MPI_Datatype& MPI_vec3d,
-                                         const int& numGhosts) {
+                                         const bool& swapTurbVars) {
   // rank -- processor rank
-  // MPI_tensorDouble -- MPI datatype for tensor<double>
-  // MPI_vec3d -- MPI datatype for vector3d<double>
-  // numGhosts -- number of ghost cells
+  // swapTurbVars -- flag to also swap turbulence blending functions
 
-  // loop over all connections and swap connection updates when necessary
-  for (auto &conn : connections_) {
-    if (conn.RankFirst() == rank && conn.RankSecond() == rank) {
-      // both sides of connection are on this processor, swap w/o mpi
-      blocks_[conn.LocalBlockFirst()].SwapEddyViscAndGradientSlice(
-          conn, blocks_[conn.LocalBlockSecond()]);
-    } else if (conn.RankFirst() == rank) {
-      // rank matches rank of first side of connection, swap over mpi
-      blocks_[conn.LocalBlockFirst()].SwapEddyViscAndGradientSliceMPI(
-          conn, rank, MPI_tensorDouble, MPI_vec3d);
-    } else if (conn.RankSecond() == rank) {
-      // rank matches rank of second side of connection, swap over mpi
-      blocks_[conn.LocalBlockSecond()].SwapEddyViscAndGradientSliceMPI(
-          conn, rank, MPI_tensorDouble, MPI_vec3d);
+  // swap local connections directly, and connections shared with other
+  // processors with one message per neighboring processor
+  auto numVals = 0;
+  if (!blocks_.empty()) {
+    numVals = blocks_[0].EddyViscAndGradientHaloValues();
+    if (swapTurbVars) {
+      numVals += blocks_[0].TurbHaloValues();
     }
-    // if rank doesn't match either side of connection, then do nothing and
-    // move on to the next connection
   }
+  this->Halo(rank).Exchange(
+      connections_, swapTurbVars ? 6 : 5, numVals,
+      [&](const connection &conn) {
+        auto &first = blocks_[conn.LocalBlockFirst()];
+        auto &second = blocks_[conn.LocalBlockSecond()];
+        first.SwapEddyViscAndGradientSlice(conn, second);
+        if (swapTurbVars) {
+          first.SwapTurbSlice(conn, second);
+        }
+      },
+      [&](const haloSlice &slice, double *buffer) {
+        const auto &block = blocks_[slice.block_];
+        buffer = block.PackEddyViscAndGradientSlice(slice, buffer);
+        if (swapTurbVars) {
+          buffer = block.PackTurbSlice(slice, buffer);
+        }
+        return buffer;
+      },
+      [&](const haloSlice &slice, const double *buffer) {
+        auto &block = blocks_[slice.block_];
+        buffer = block.UnpackEddyViscAndGradientSlice(slice, buffer);
+        if (swapTurbVars) {
+          buffer = block.UnpackTurbSlice(slice, buffer);
+        }
+        return buffer;
+      });
 }
 
 void gridLevel::CalcResidual(const physics& phys, const input& inp,
                              const int& rank,
                              const MPI_Datatype& MPI_tensorDouble,
-                             const MPI_Datatype& MPI_vec3d) {
+                             const MPI_Datatype& MPI_vec3d,
+                             const bool& calcJacobian) {
   // phys -- physics models
   // inp -- input variables
   // rank -- processor rank
   // MPI_tensorDouble -- MPI datatype for tensor<double>
   // MPI_vec3d -- MPI datatype for vector3d<double>
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
 
+#pragma omp parallel for schedule(dynamic) if (this->ThreadOverBlocks())
   for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
     // calculate residual
-    blocks_[bb].CalcResidualNoSource(phys, inp, solver_->A(bb));
+    const auto start = std::chrono::high_resolution_clock::now();
+    blocks_[bb].CalcResidualNoSource(phys, inp, solver_->A(bb), calcJacobian);
+    this->AddBlockTime(bb, start);
+  }
+  this->CalcResidualSource(phys, inp, rank, calcJacobian);
+}
+
+/* Member function to get the boundary conditions and calculate the residual.
+This gives the same result as calling GetBoundaryConditions and CalcResidual,
+but the inviscid fluxes on the interior faces of each block are calculated
+while the states are being swapped across connection boundaries. This hides
+the communication time behind the flux calculation.
+*/
+void gridLevel::GetBoundaryConditionsAndResidual(const physics& phys,
+                                                 const input& inp,
+                                                 const int& rank,
+                                                 const bool& calcJacobian) {
+  // phys -- physics models
+  // inp -- input variables
+  // rank -- processor rank
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
+
+  this->StartBoundaryConditions(inp, phys, rank);
+#pragma omp parallel for schedule(dynamic) if (this->ThreadOverBlocks())
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    blocks_[bb].CalcResidualNoSource(phys, inp, solver_->A(bb), calcJacobian,
+                                     facePass::interior);
+    this->AddBlockTime(bb, start);
   }
-  // swap mut & gradients calculated during residual calculation
-  this->SwapEddyViscAndGradients(rank, MPI_tensorDouble, MPI_vec3d,
-                                 inp.NumberGhostLayers());
+  this->FinishBoundaryConditions(inp, phys, rank);
 
-  if (inp.IsRANS()) {
-    // swap turbulence variables calculated during residual calculation
-    this->SwapTurbVars(rank, inp.NumberGhostLayers());
+#pragma omp parallel for schedule(dynamic) if (this->ThreadOverBlocks())
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    blocks_[bb].CalcResidualNoSource(phys, inp, solver_->A(bb), calcJacobian,
+                                     facePass::boundary);
+    this->AddBlockTime(bb, start);
   }
+  this->CalcResidualSource(phys, inp, rank, calcJacobian);
+}
+
+// member function to swap the data calculated during the residual calculation
+// and add the source terms to the residual
+void gridLevel::CalcResidualSource(const physics& phys, const input& inp,
+                                   const int& rank,
+                                   const bool& calcJacobian) {
+  // phys -- physics models
+  // inp -- input variables
+  // rank -- processor rank
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
+
+  // swap mut, gradients, & turbulence variables calculated during residual
+  // calculation
+  this->SwapEddyViscAndGradients(rank, inp.IsRANS());
+
   if (inp.IsRANS() || phys.Chemistry()->IsReacting()) {
+#pragma omp parallel for schedule(dynamic)
     for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
       // calculate source terms for residual
-      blocks_[bb].CalcSrcTerms(phys, inp, solver_->A(bb));
+      const auto start = std::chrono::high_resolution_clock::now();
+      blocks_[bb].CalcSrcTerms(phys, inp, solver_->A(bb), calcJacobian);
+      this->AddBlockTime(bb, start);
     }
   }
 }
@@ -406,6 +706,7 @@ void gridLevel::InvertDiagonal(const input& inp) {
 }
 
 void gridLevel::ResetDiagonal() {
+#pragma omp parallel for schedule(dynamic)
   for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
     solver_->ZeroA(bb);
   }
@@ -418,30 +719,44 @@ void gridLevel::InitializeMatrixUpdate(const input& inp, const physics& phys) {
 void gridLevel::UpdateBlocks(const input& inp, const physics& phys,
                              const int& mm,
                              residual& residL2, resid& residLinf) {
+  // residual norms are accumulated for each block and combined in block
+  // order, so they do not depend on the number of threads
+  vector<residual> blockL2(this->NumBlocks(),
+                           residual(inp.NumEquations(), inp.NumSpecies()));
+  vector<resid> blockLinf(this->NumBlocks(), residLinf);
+
   // Update blocks
+#pragma omp parallel for schedule(dynamic)
   for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
     // Update solution
-    blocks_[bb].UpdateBlock(inp, phys, solver_->X(bb), mm, residL2, residLinf);
+    const auto start = std::chrono::high_resolution_clock::now();
+    blocks_[bb].UpdateBlock(inp, phys, solver_->X(bb), mm, blockL2[bb],
+                            blockLinf[bb]);
+    this->AddBlockTime(bb, start);
 
     // Assign time n to time n-1 at end of nonlinear iterations
     if (inp.IsMultilevelInTime() && mm == inp.NonlinearIterations() - 1) {
       blocks_[bb].AssignSolToTimeNm1();
     }
   }
+  CombineResiduals(blockL2, blockLinf, residL2, residLinf);
 }
 
 void gridLevel::AuxillaryAndWidths(const physics& phys) {
-  for (auto& block : blocks_) {
-    block.UpdateAuxillaryVariables(phys, false);
-    block.CalcCellWidths();
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    blocks_[bb].UpdateAuxillaryVariables(phys, false);
+    blocks_[bb].CalcCellWidths();
   }
 }
 
-gridLevel gridLevel::Coarsen(const decomposition& decomp, const input& inp,
+gridLevel gridLevel::Coarsen(decomposition& decomp, const input& inp,
                              const physics& phys, const int& rank,
                              const MPI_Datatype& MPI_connection,
                              const MPI_Datatype& MPI_vec3d,
                              const MPI_Datatype& MPI_vec3dMag) {
+  // decomp -- decomposition of this level, returned as that of coarse level
+
   // get plot3dBlocks and bcs for coarsened grid level
   vector<plot3dBlock> coarseMesh;
   coarseMesh.reserve(this->NumBlocks());
@@ -453,46 +768,34 @@ gridLevel gridLevel::Coarsen(const decomposition& decomp, const input& inp,
     blk.GetCoarseMeshAndBCs(coarseMesh, coarseBCs, toCoarse_, volWeightFactor_);
   }
 
+  // agglomerate coarse level onto fewer processors if there are too few cells
+  // per processor for the parallel communication to be worthwhile
   gridLevel coarse;
-  coarse.connections_ = GetConnectionBCsPar(coarseBCs, coarseMesh, decomp, inp,
-                                            rank, MPI_connection, MPI_vec3d);
-  coarse.blocks_.reserve(coarseMesh.size());
-  coarse.mgForcing_.reserve(coarseMesh.size());
-  for (auto ll = 0U; ll < coarseMesh.size(); ++ll) {
-    coarse.blocks_.emplace_back(coarseMesh[ll], blocks_[ll].ParentBlock(),
-                                coarseBCs[ll], ll, blocks_[ll].Rank(),
-                                blocks_[ll].LocalPosition(), inp);
-    coarse.blocks_.back().InitializeStates(inp, phys);
-    coarse.blocks_.back().AssignGhostCellsGeom();
-    coarse.mgForcing_.emplace_back(
-        coarse.blocks_.back().NumI(), coarse.blocks_.back().NumJ(),
-        coarse.blocks_.back().NumK(), 0, coarse.blocks_.back().NumEquations(),
-        coarse.blocks_.back().NumSpecies(), 0);
-  }
-
-  // Swap geometry for interblock BCs
-  for (auto ii = 0U; ii < coarse.connections_.size(); ++ii) {
-    auto& conn = coarse.connections_[ii];
-    if (conn.IsInterblock()) {
-      if (rank == conn.RankFirst() && rank == conn.RankSecond()) {
-        // all data is local
-        SwapGeomSlice(conn, coarse.blocks_[conn.LocalBlockFirst()],
-                      coarse.blocks_[conn.LocalBlockSecond()]);
-      } else if (rank == conn.RankFirst()) {
-        // first connection swapping with remote processor
-        SwapGeomSliceMPI(conn, coarse.blocks_[conn.LocalBlockFirst()], ii,
-                         MPI_vec3d, MPI_vec3dMag);
-      } else if (rank == conn.RankSecond()) {
-        // second connection swapping with remote processor
-        SwapGeomSliceMPI(conn, coarse.blocks_[conn.LocalBlockSecond()], ii,
-                         MPI_vec3d, MPI_vec3dMag);
+  auto coarseDecomp = decomp;
+  const auto threshold = inp.MultigridAgglomerationThreshold();
+  if (threshold > 0) {
+    auto numCells = 0;
+    for (const auto& msh : coarseMesh) {
+      numCells += msh.NumCells();
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &numCells, 1, MPI_INT, MPI_SUM,
+                  MPI_COMM_WORLD);
+    const auto numActive = decomp.NumActiveProcs();
+    const auto numAgg = std::max(numCells / threshold, 1);
+    if (numAgg < numActive) {
+      coarseDecomp = decomp.Agglomerate(numAgg);
+      coarse.isAgglomerated_ = true;
+      if (rank == ROOTP) {
+        cout << "Agglomerating coarse grid level with " << numCells
+             << " cells from " << numActive << " to " << numAgg
+             << " processors" << endl;
       }
     }
   }
-  // Get ghost cell edge data
-  for (auto& block : coarse.blocks_) {
-    block.AssignGhostCellsGeomEdge();
-  }
+
+  coarse.connections_ =
+      GetConnectionBCsPar(coarseBCs, coarseMesh, decomp, coarseDecomp, inp,
+                          rank, MPI_connection, MPI_vec3d);
 
   // Calculate prolongation coefficients
   coarse.prolongCoeffs_.reserve(this->NumBlocks());
@@ -508,18 +811,15 @@ gridLevel gridLevel::Coarsen(const decomposition& decomp, const input& inp,
           // coordinates of fine cell center
           const auto fc = blocks_[ll].Center(ii, jj, kk);
           // nodal coordinates of bounding coarse cell
-          const auto c0 = coarse.blocks_[ll].Node(ci.X(), ci.Y(), ci.Z());
-          const auto c1 = coarse.blocks_[ll].Node(ci.X() + 1, ci.Y(), ci.Z());
-          const auto c2 = coarse.blocks_[ll].Node(ci.X(), ci.Y() + 1, ci.Z());
-          const auto c3 =
-              coarse.blocks_[ll].Node(ci.X() + 1, ci.Y() + 1, ci.Z());
-          const auto c4 = coarse.blocks_[ll].Node(ci.X(), ci.Y(), ci.Z() + 1);
-          const auto c5 =
-              coarse.blocks_[ll].Node(ci.X() + 1, ci.Y(), ci.Z() + 1);
-          const auto c6 =
-              coarse.blocks_[ll].Node(ci.X(), ci.Y() + 1, ci.Z() + 1);
-          const auto c7 =
-              coarse.blocks_[ll].Node(ci.X() + 1, ci.Y() + 1, ci.Z() + 1);
+          const auto& cm = coarseMesh[ll];
+          const auto c0 = cm.Coords(ci.X(), ci.Y(), ci.Z());
+          const auto c1 = cm.Coords(ci.X() + 1, ci.Y(), ci.Z());
+          const auto c2 = cm.Coords(ci.X(), ci.Y() + 1, ci.Z());
+          const auto c3 = cm.Coords(ci.X() + 1, ci.Y() + 1, ci.Z());
+          const auto c4 = cm.Coords(ci.X(), ci.Y(), ci.Z() + 1);
+          const auto c5 = cm.Coords(ci.X() + 1, ci.Y(), ci.Z() + 1);
+          const auto c6 = cm.Coords(ci.X(), ci.Y() + 1, ci.Z() + 1);
+          const auto c7 = cm.Coords(ci.X() + 1, ci.Y() + 1, ci.Z() + 1);
           coarse.prolongCoeffs_.back()(ii, jj, kk) =
               TrilinearInterpCoeff(c0, c1, c2, c3, c4, c5, c6, c7, fc);
         }
@@ -527,54 +827,164 @@ gridLevel gridLevel::Coarsen(const decomposition& decomp, const input& inp,
     }
   }
 
+  // move coarse blocks to their agglomerated processors
+  if (coarse.isAgglomerated_) {
+    coarse.aggCoarseDims_.reserve(coarseMesh.size());
+    for (const auto& msh : coarseMesh) {
+      coarse.aggCoarseDims_.emplace_back(msh.NumCellsI(), msh.NumCellsJ(),
+                                         msh.NumCellsK());
+    }
+    if (this->NumBlocks() > 0) {
+      coarse.aggRank_ = coarseDecomp.Rank(decomp.GlobalPos(rank, 0));
+    }
+    AgglomerateMeshAndBCs(coarseMesh, coarseBCs, decomp, coarseDecomp, rank,
+                          MPI_vec3d);
+    coarse.aggSourceRank_.reserve(coarseMesh.size());
+    for (auto ll = 0U; ll < coarseMesh.size(); ++ll) {
+      coarse.aggSourceRank_.push_back(
+          decomp.Rank(coarseDecomp.GlobalPos(rank, ll)));
+    }
+  }
+
+  coarse.ConstructBlocks(coarseMesh, coarseBCs, coarseDecomp, phys, rank, inp,
+                         MPI_vec3d, MPI_vec3dMag);
+
   // Setup linear solver
   if (inp.IsImplicit()) {
     coarse.solver_ = inp.AssignLinearSolver(coarse);
   }
 
+  decomp = coarseDecomp;
   return coarse;
 }
 
+/* Member function to restrict the solution, implicit update, and matrix
+residual of the fine level to an agglomerated coarse level. The restriction is
+done on the fine level processors, and the restricted data for all blocks is
+sent to the coarse level processors with a single all-to-all exchange.*/
+void gridLevel::RestrictToAgglomerated(
+    gridLevel& coarse, const vector<blkMultiArray3d<varArray>>& fineResid,
+    vector<blkMultiArray3d<varArray>>& coarseResid) const {
+  // coarse -- agglomerated coarse level
+  // fineResid -- matrix residual on fine level
+  // coarseResid -- restricted matrix residual on coarse level
+  MSG_ASSERT(coarse.isAgglomerated_, "coarse level is not agglomerated");
+
+  auto numProcs = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  vector<int> sendCounts(numProcs, 0);
+  vector<int> recvCounts(numProcs, 0);
+
+  // restrict fine level data and pack into buffer
+  vector<double> sendBuf;
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    const auto& blk = blocks_[bb];
+    const auto& dims = coarse.aggCoarseDims_[bb];
+    blkMultiArray3d<primitive> state(dims.X(), dims.Y(), dims.Z(),
+                                     blk.NumGhosts(), blk.NumEquations(),
+                                     blk.NumSpecies());
+    BlockRestriction(blk.States(), toCoarse_[bb], volWeightFactor_[bb], state);
+    blkMultiArray3d<varArray> update(dims.X(), dims.Y(), dims.Z(),
+                                     blk.NumGhosts(), blk.NumEquations(),
+                                     blk.NumSpecies());
+    BlockRestriction(solver_->X(bb), toCoarse_[bb], volWeightFactor_[bb],
+                     update);
+    blkMultiArray3d<varArray> resid(dims.X(), dims.Y(), dims.Z(), 0,
+                                    blk.NumEquations(), blk.NumSpecies());
+    BlockRestriction(fineResid[bb], toCoarse_[bb], resid);
+
+    sendBuf.insert(std::end(sendBuf), std::begin(state), std::end(state));
+    sendBuf.insert(std::end(sendBuf), std::begin(update), std::end(update));
+    sendBuf.insert(std::end(sendBuf), std::begin(resid), std::end(resid));
+    sendCounts[coarse.aggRank_] += state.Size() + update.Size() + resid.Size();
+  }
+
+  for (auto bb = 0; bb < coarse.NumBlocks(); ++bb) {
+    recvCounts[coarse.aggSourceRank_[bb]] +=
+        coarse.blocks_[bb].States().Size() + coarse.solver_->X(bb).Size() +
+        coarse.mgForcing_[bb].Size();
+  }
+
+  const auto recvBuf = AgglomerationExchange(sendBuf, sendCounts, recvCounts);
+
+  // unpack restricted data into coarse level
+  auto coarseUpdate = coarse.solver_->X();
+  coarseResid = coarse.mgForcing_;
+  auto pos = std::begin(recvBuf);
+  for (auto bb = 0; bb < coarse.NumBlocks(); ++bb) {
+    auto state = coarse.blocks_[bb].States();
+    std::copy(pos, pos + state.Size(), std::begin(state));
+    pos += state.Size();
+    coarse.blocks_[bb].AssignRestrictedState(state);
+    std::copy(pos, pos + coarseUpdate[bb].Size(), std::begin(coarseUpdate[bb]));
+    pos += coarseUpdate[bb].Size();
+    std::copy(pos, pos + coarseResid[bb].Size(), std::begin(coarseResid[bb]));
+    pos += coarseResid[bb].Size();
+  }
+  coarse.solver_->AssignUpdate(coarseUpdate);
+}
+
 void gridLevel::Restriction(gridLevel& coarse, const int &mm,
                             const vector<blkMultiArray3d<varArray>>& fineResid,
                             const input& inp, const physics& phys,
                             const int& rank,
                             const MPI_Datatype& MPI_tensorDouble,
-                            const MPI_Datatype& MPI_vec3d) const {
-  MSG_ASSERT(blocks_.size() == coarse.blocks_.size(),
+                            const MPI_Datatype& MPI_vec3d,
+                            const bool& calcJacobian) const {
+  MSG_ASSERT(coarse.isAgglomerated_ || blocks_.size() == coarse.blocks_.size(),
              "gridLevel size mismatch");
   MSG_ASSERT(blocks_.size() == fineResid.size(), "residual size mismatch");
   MSG_ASSERT(inp.IsImplicit(), "calling gridLevel::Restriction for explicit");
 
-  for (auto ii = 0; ii < this->NumBlocks(); ++ii) {
-    // restrict solution
-    coarse.blocks_[ii].Restriction(blocks_[ii], toCoarse_[ii],
-                                   volWeightFactor_[ii]);
+  // restrict solution
+  vector<blkMultiArray3d<varArray>> coarseResid;
+  if (coarse.isAgglomerated_) {
+    // solution, update, and matrix residual are restricted together
+    this->RestrictToAgglomerated(coarse, fineResid, coarseResid);
     if (mm == 0) {  // need to store solution at time n for linear solvers
       coarse.AssignSolToTimeN(phys);
     }
+  } else {
+    for (auto ii = 0; ii < this->NumBlocks(); ++ii) {
+      coarse.blocks_[ii].Restriction(blocks_[ii], toCoarse_[ii],
+                                     volWeightFactor_[ii]);
+      if (mm == 0) {  // need to store solution at time n for linear solvers
+        coarse.AssignSolToTimeN(phys);
+      }
+    }
   }
 
   // calculate residual and implicit matrix using restricted solution
-  coarse.GetBoundaryConditions(inp, phys, rank);
-  coarse.CalcResidual(phys, inp, rank, MPI_tensorDouble, MPI_vec3d);
+  coarse.GetBoundaryConditionsAndResidual(phys, inp, rank, calcJacobian);
   coarse.CalcTimeStep(inp);
   // add volume and time term and calculate inverse of main diagonal
-  coarse.InvertDiagonal(inp);
+  // if jacobians are reused, the inverse from a prior iteration is kept
+  if (calcJacobian) {
+    coarse.InvertDiagonal(inp);
+  }
 
   // restrict linear system update
-  solver_->Restriction(coarse.solver_, coarse.connections_, toCoarse_,
-                       volWeightFactor_, rank);
+  if (coarse.isAgglomerated_) {
+    coarse.solver_->SwapUpdate(coarse.connections_, rank,
+                               inp.NumberGhostLayers());
+  } else {
+    solver_->Restriction(coarse.solver_, coarse.connections_, toCoarse_,
+                         volWeightFactor_, rank, inp.NumberGhostLayers());
+  }
 
   // get Ax-b for coarse level
   const auto axmb = coarse.AXmB(phys, inp);
   
-  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+  for (auto bb = 0; bb < coarse.NumBlocks(); ++bb) {
     auto& coarseForce = coarse.mgForcing_[bb];
     // forcing term is Ax - b + r
     // Ax - b is from coarse level (using restricted update and state
     // r is matrix residual (f - (Ax - b)) for fine, restricted to coarse level
-    BlockRestriction(fineResid[bb], toCoarse_[bb], coarseForce);
+    if (coarse.isAgglomerated_) {
+      coarseForce = coarseResid[bb];
+    } else {
+      BlockRestriction(fineResid[bb], toCoarse_[bb], coarseForce);
+    }
 
     // doing this instead of -= because axmb and forcing have different 
     // number of ghost cells
@@ -594,18 +1004,223 @@ void gridLevel::SubtractFromUpdate(
   solver_->SubtractFromUpdate(coarseDu);
 }
 
+/* Member function to send the implicit update of an agglomerated coarse level
+back to the fine level processors with a single all-to-all exchange. The
+returned updates are in the fine level local order.*/
+vector<blkMultiArray3d<varArray>> gridLevel::AgglomeratedUpdate(
+    const gridLevel& fine) const {
+  // fine -- fine level to send coarse level update to
+  MSG_ASSERT(isAgglomerated_, "coarse level is not agglomerated");
+
+  auto numProcs = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+  vector<int> sendCounts(numProcs, 0);
+  vector<int> recvCounts(numProcs, 0);
+
+  vector<double> sendBuf;
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    const auto& update = solver_->X(bb);
+    sendBuf.insert(std::end(sendBuf), std::begin(update), std::end(update));
+    sendCounts[aggSourceRank_[bb]] += update.Size();
+  }
+
+  vector<blkMultiArray3d<varArray>> coarseUpdate;
+  coarseUpdate.reserve(fine.NumBlocks());
+  for (auto bb = 0; bb < fine.NumBlocks(); ++bb) {
+    const auto& blk = fine.blocks_[bb];
+    const auto& dims = aggCoarseDims_[bb];
+    coarseUpdate.emplace_back(dims.X(), dims.Y(), dims.Z(), blk.NumGhosts(),
+                              blk.NumEquations(), blk.NumSpecies());
+    recvCounts[aggRank_] += coarseUpdate.back().Size();
+  }
+
+  const auto recvBuf = AgglomerationExchange(sendBuf, sendCounts, recvCounts);
+
+  auto pos = std::begin(recvBuf);
+  for (auto& update : coarseUpdate) {
+    std::copy(pos, pos + update.Size(), std::begin(update));
+    pos += update.Size();
+  }
+  return coarseUpdate;
+}
+
 void gridLevel::Prolongation(gridLevel& fine) const {
-  MSG_ASSERT(blocks_.size() == fine.blocks_.size(), "gridLevel size mismatch");
+  MSG_ASSERT(isAgglomerated_ || blocks_.size() == fine.blocks_.size(),
+             "gridLevel size mismatch");
+  vector<blkMultiArray3d<varArray>> aggUpdate;
+  if (isAgglomerated_) {
+    aggUpdate = this->AgglomeratedUpdate(fine);
+  }
+  const auto& coarseUpdate = isAgglomerated_ ? aggUpdate : solver_->X();
+
   vector<blkMultiArray3d<varArray>> fineCorrVec;
-  fineCorrVec.reserve(this->NumBlocks());
-  for (auto ii = 0; ii < this->NumBlocks(); ++ii) {
+  fineCorrVec.reserve(fine.NumBlocks());
+  for (auto ii = 0; ii < fine.NumBlocks(); ++ii) {
     blkMultiArray3d<varArray> fineCorrection(
         fine.blocks_[ii].NumI(), fine.blocks_[ii].NumJ(),
         fine.blocks_[ii].NumK(), fine.blocks_[ii].NumGhosts(),
         fine.blocks_[ii].NumEquations(), fine.blocks_[ii].NumSpecies());
-    BlockProlongation(solver_->X(ii), fine.toCoarse_[ii], prolongCoeffs_[ii],
+    BlockProlongation(coarseUpdate[ii], fine.toCoarse_[ii], prolongCoeffs_[ii],
                       fineCorrection);
     fineCorrVec.push_back(fineCorrection);
   }
   fine.solver_->AddToUpdate(fineCorrVec);
 }
+
+/* Function to transfer the coarse meshes and boundary conditions from the
+processors of the fine level to the processors of an agglomerated coarse level.
+On return the meshes and boundary conditions are in the coarse level local
+order.*/
+void AgglomerateMeshAndBCs(vector<plot3dBlock>& mesh,
+                           vector<boundaryConditions>& bcs,
+                           const decomposition& fineDecomp,
+                           const decomposition& coarseDecomp, const int& rank,
+                           const MPI_Datatype& MPI_vec3d) {
+  // mesh -- coarse meshes of blocks on this processor
+  // bcs -- coarse boundary conditions of blocks on this processor
+  // fineDecomp -- decomposition of fine level
+  // coarseDecomp -- agglomerated decomposition of coarse level
+  // rank -- processor rank
+  MSG_ASSERT(mesh.size() == bcs.size(), "BC and block size mismatch");
+
+  // send blocks that are moving to a different processor
+  // use nonblocking sends because a processor can both send and receive
+  vector<unique_ptr<char[]>> sendBuffers;
+  vector<MPI_Request> requests;
+  for (auto lp = 0U; lp < mesh.size(); ++lp) {
+    const auto globalPos = fineDecomp.GlobalPos(rank, lp);
+    const auto dest = coarseDecomp.Rank(globalPos);
+    if (dest == rank) {
+      continue;
+    }
+
+    // determine size of buffer to send
+    auto sendBufSize = 0;
+    auto tempSize = 0;
+    // 6x because 3 for mesh dimensions, 3 for number of bc surfaces
+    MPI_Pack_size(6, MPI_INT, MPI_COMM_WORLD, &tempSize);
+    sendBufSize += tempSize;
+    MPI_Pack_size(mesh[lp].Size(), MPI_vec3d, MPI_COMM_WORLD, &tempSize);
+    sendBufSize += tempSize;
+    // 8x because iMin, iMax, jMin, jMax, kMin, kMax, tags, string sizes
+    MPI_Pack_size(bcs[lp].NumSurfaces() * 8, MPI_INT, MPI_COMM_WORLD,
+                  &tempSize);
+    sendBufSize += tempSize;
+    for (auto jj = 0; jj < bcs[lp].NumSurfaces(); ++jj) {
+      // add size for bc_ types (+1 for c_str end character)
+      MPI_Pack_size(bcs[lp].GetBCTypes(jj).size() + 1, MPI_CHAR,
+                    MPI_COMM_WORLD, &tempSize);
+      sendBufSize += tempSize;
+    }
+
+    // pack mesh dimensions, nodes, and bcs into buffer
+    sendBuffers.push_back(std::make_unique<char[]>(sendBufSize));
+    auto *rawSendBuffer = sendBuffers.back().get();
+    auto position = 0;
+    const auto numI = mesh[lp].NumI();
+    const auto numJ = mesh[lp].NumJ();
+    const auto numK = mesh[lp].NumK();
+    MPI_Pack(&numI, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
+             MPI_COMM_WORLD);
+    MPI_Pack(&numJ, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
+             MPI_COMM_WORLD);
+    MPI_Pack(&numK, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
+             MPI_COMM_WORLD);
+    MPI_Pack(&(*std::begin(mesh[lp])), mesh[lp].Size(), MPI_vec3d,
+             rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+    bcs[lp].PackBC(rawSendBuffer, sendBufSize, position);
+
+    requests.emplace_back();
+    MPI_Isend(rawSendBuffer, sendBufSize, MPI_PACKED, dest, globalPos,
+              MPI_COMM_WORLD, &requests.back());
+  }
+
+  // gather blocks agglomerated onto this processor
+  const auto numAgg = coarseDecomp.NumBlocksOnProc(rank);
+  vector<plot3dBlock> aggMesh(numAgg);
+  vector<boundaryConditions> aggBCs(numAgg);
+  for (auto lp = 0; lp < numAgg; ++lp) {
+    const auto globalPos = coarseDecomp.GlobalPos(rank, lp);
+    const auto source = fineDecomp.Rank(globalPos);
+    if (source == rank) {  // data already on this processor
+      aggMesh[lp] = mesh[fineDecomp.LocalPosition(globalPos)];
+      aggBCs[lp] = bcs[fineDecomp.LocalPosition(globalPos)];
+    } else {  // need to receive remote data
+      MPI_Status status;  // allocate MPI_Status structure
+      // probe message to get correct data size
+      auto recvBufSize = 0;
+      MPI_Probe(source, globalPos, MPI_COMM_WORLD, &status);
+      // use MPI_CHAR because sending buffer was allocated with chars
+      MPI_Get_count(&status, MPI_CHAR, &recvBufSize);
+      // use unique_ptr to manage memory; use underlying pointer with MPI
+      auto recvBuffer = std::make_unique<char[]>(recvBufSize);
+      auto *rawRecvBuffer = recvBuffer.get();
+      MPI_Recv(rawRecvBuffer, recvBufSize, MPI_PACKED, source, globalPos,
+               MPI_COMM_WORLD, &status);
+      auto position = 0;
+      auto numI = 0, numJ = 0, numK = 0;
+      MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &numI, 1, MPI_INT,
+                 MPI_COMM_WORLD);
+      MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &numJ, 1, MPI_INT,
+                 MPI_COMM_WORLD);
+      MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &numK, 1, MPI_INT,
+                 MPI_COMM_WORLD);
+      aggMesh[lp].ClearResize(numI, numJ, numK);
+      MPI_Unpack(rawRecvBuffer, recvBufSize, &position,
+                 &(*std::begin(aggMesh[lp])), aggMesh[lp].Size(), MPI_vec3d,
+                 MPI_COMM_WORLD);
+      aggBCs[lp].UnpackBC(rawRecvBuffer, recvBufSize, position);
+    }
+  }
+
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+  mesh = aggMesh;
+  bcs = aggBCs;
+}
+
+/* Function to exchange data between the processors of a fine grid level and
+the processors of its agglomerated coarse level. All data is transferred with
+a single all-to-all call. Data in the send and receive buffers is ordered by
+rank.*/
+vector<double> AgglomerationExchange(const vector<double>& sendBuf,
+                                     const vector<int>& sendCounts,
+                                     const vector<int>& recvCounts) {
+  // sendBuf -- data to send, ordered by destination rank
+  // sendCounts -- number of values to send to each rank
+  // recvCounts -- number of values to receive from each rank
+  MSG_ASSERT(sendCounts.size() == recvCounts.size(), "rank size mismatch");
+
+  vector<int> sendDispl(sendCounts.size(), 0);
+  vector<int> recvDispl(recvCounts.size(), 0);
+  for (auto pp = 1U; pp < sendCounts.size(); ++pp) {
+    sendDispl[pp] = sendDispl[pp - 1] + sendCounts[pp - 1];
+    recvDispl[pp] = recvDispl[pp - 1] + recvCounts[pp - 1];
+  }
+
+  vector<double> recvBuf(
+      std::accumulate(std::begin(recvCounts), std::end(recvCounts), 0));
+  MPI_Alltoallv(sendBuf.data(), sendCounts.data(), sendDispl.data(),
+                MPI_DOUBLE, recvBuf.data(), recvCounts.data(),
+                recvDispl.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+  return recvBuf;
+}
+
+/* Function to combine the residual norms accumulated for each block into the
+norms for the processor. Blocks are combined in order, so the location of the
+l-infinity residual is the same as if the blocks were updated serially.
+*/
+void CombineResiduals(const vector<residual>& blockL2,
+                      const vector<resid>& blockLinf, residual& residL2,
+                      resid& residLinf) {
+  // blockL2 -- l-2 norm of residual (sum of squares) for each block
+  // blockLinf -- l-infinity norm of residual for each block
+  // residL2 -- l-2 norm of residual (sum of squares) to add to
+  // residLinf -- l-infinity norm of residual to update
+  MSG_ASSERT(blockL2.size() == blockLinf.size(), "block size mismatch");
+  for (auto bb = 0U; bb < blockL2.size(); ++bb) {
+    residL2 += blockL2[bb];
+    if (blockLinf[bb].Linf() > residLinf.Linf()) {
+      residLinf = blockLinf[bb];
+    }
+  }
+}
@@ -0,0 +1,328 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include <vector>
+#include <map>
+#include <algorithm>  // find, max
+#include <numeric>    // iota
+#include <utility>    // move
+#include "haloExchange.hpp"
+#include "boundaryConditions.hpp"  // connection
+#include "multiArray3d.hpp"
+
+using std::vector;
+
+/* Constructor for haloExchange class. The connections are sorted into those
+   local to this processor and those shared with each neighboring processor.
+   The local connections are grouped so that no two connections in a group
+   share a block, and connections sharing a block keep their relative order.
+   For each shared connection, the locations of the cells sent to the partner
+   block and the ghost cells filled by the partner block are precomputed so
+   data can be copied directly between the block arrays and the message
+   buffers. The locations are valid for any array with the same dimensions and
+   number of ghost layers as the block. Neighbors on the same node as this
+   processor are found so that their data can be exchanged through shared
+   memory. The buffers, requests, and windows for each field swapped are
+   created here so that all collective calls with the neighbors happen at
+   construction.
+*/
+haloExchange::haloExchange(const vector<connection> &conns, const int &rank,
+                           const vector<vector3d<int>> &blockDims,
+                           const int &numGhosts,
+                           const std::map<int, int> &channelValues)
+    : rank_(rank), isSetUp_(true) {
+  // conns -- connection boundaries
+  // rank -- processor rank
+  // blockDims -- number of physical cells in each block on this processor
+  // numGhosts -- number of ghost cell layers
+  // channelValues -- number of doubles per cell swapped with each tag
+
+  // last group of local connections each block is swapped in
+  vector<int> lastGroup(blockDims.size(), -1);
+  for (auto cc = 0U; cc < conns.size(); ++cc) {
+    const auto &conn = conns[cc];
+    auto neighbor = 0;
+    if (conn.RankFirst() == rank && conn.RankSecond() == rank) {
+      // both sides of connection on this processor, swap w/o mpi
+      // add to group after the last one that swaps either block, so
+      // connections sharing a block are swapped in their original order
+      const auto group =
+          std::max(lastGroup[conn.LocalBlockFirst()],
+                   lastGroup[conn.LocalBlockSecond()]) + 1;
+      if (group == static_cast<int>(localConns_.size())) {
+        localConns_.emplace_back();
+      }
+      lastGroup[conn.LocalBlockFirst()] = group;
+      lastGroup[conn.LocalBlockSecond()] = group;
+      localConns_[group].push_back(cc);
+      continue;
+    } else if (conn.RankFirst() == rank) {
+      neighbor = conn.RankSecond();
+    } else if (conn.RankSecond() == rank) {
+      neighbor = conn.RankFirst();
+    } else {
+      // connection is not on this processor
+      continue;
+    }
+
+    haloSlice slice;
+    const auto isFirst = conn.RankFirst() == rank;
+    slice.block_ =
+        isFirst ? conn.LocalBlockFirst() : conn.LocalBlockSecond();
+    const auto &dims = blockDims[slice.block_];
+
+    // number cells in block in storage order
+    multiArray3d<int> cellLoc(dims.X(), dims.Y(), dims.Z(), numGhosts);
+    std::iota(cellLoc.begin(), cellLoc.end(), 0);
+
+    // cells sent to partner
+    auto is = 0, ie = 0, js = 0, je = 0, ks = 0, ke = 0;
+    ConnectionSliceIndices(cellLoc, conn, rank, is, ie, js, je, ks, ke);
+    const auto send = cellLoc.Slice({is, ie}, {js, je}, {ks, ke});
+    slice.sendCells_.assign(send.begin(), send.end());
+
+    // number cells in partner slice in storage order and insert into ghost
+    // cells to find where each partner cell goes
+    if (isFirst) {
+      conn.SecondSliceIndices(is, ie, js, je, ks, ke, numGhosts);
+    } else {
+      conn.FirstSliceIndices(is, ie, js, je, ks, ke, numGhosts);
+    }
+    multiArray3d<int> partnerLoc(ie - is, je - js, ke - ks, 0);
+    std::iota(partnerLoc.begin(), partnerLoc.end(), 0);
+    multiArray3d<int> ghostLoc(dims.X(), dims.Y(), dims.Z(), numGhosts, 1, -1);
+    PutConnectionSlice(ghostLoc, partnerLoc, conn, rank);
+
+    slice.recvCells_.assign(partnerLoc.Size(), -1);
+    for (auto ll = 0; ll < ghostLoc.Size(); ++ll) {
+      const auto pos = *(ghostLoc.begin() + ll);
+      if (pos >= 0) {
+        slice.recvCells_[pos] = ll;
+      }
+    }
+    MSG_ASSERT(slice.recvCells_.size() == slice.sendCells_.size(),
+               "connection slices differ in size");
+
+    // add slice to list for neighboring processor
+    auto it = std::find(neighbors_.begin(), neighbors_.end(), neighbor);
+    if (it == neighbors_.end()) {
+      neighbors_.push_back(neighbor);
+      neighborSlices_.emplace_back(1, std::move(slice));
+    } else {
+      neighborSlices_[it - neighbors_.begin()].push_back(std::move(slice));
+    }
+  }
+
+  this->FindSharedNeighbors();
+
+  // tags are visited in the same order on all processors
+  for (const auto &channel : channelValues) {
+    this->CreateChannel(channel.first, channel.second);
+  }
+}
+
+haloExchange::haloExchange(haloExchange &&other) noexcept
+    : rank_(other.rank_),
+      isSetUp_(other.isSetUp_),
+      localConns_(std::move(other.localConns_)),
+      neighbors_(std::move(other.neighbors_)),
+      isSharedNeighbor_(std::move(other.isSharedNeighbor_)),
+      neighborSlices_(std::move(other.neighborSlices_)),
+      channels_(std::move(other.channels_)) {
+  // requests are now owned by this object
+  other.channels_.clear();
+}
+
+haloExchange &haloExchange::operator=(haloExchange &&other) noexcept {
+  if (this != &other) {
+    this->FreeRequests();
+    rank_ = other.rank_;
+    isSetUp_ = other.isSetUp_;
+    localConns_ = std::move(other.localConns_);
+    neighbors_ = std::move(other.neighbors_);
+    isSharedNeighbor_ = std::move(other.isSharedNeighbor_);
+    neighborSlices_ = std::move(other.neighborSlices_);
+    channels_ = std::move(other.channels_);
+    other.channels_.clear();
+  }
+  return *this;
+}
+
+/* Member function to return the indices of the neighbors on the same node in
+   order of their rank. Setting up shared memory is collective over each pair
+   of neighbors, so all processors must visit the pairs in the same order to
+   prevent deadlock.
+*/
+vector<int> haloExchange::SharedNeighborOrder() const {
+  vector<int> order;
+  for (auto nn = 0; nn < this->NumNeighbors(); ++nn) {
+    if (isSharedNeighbor_.empty() || isSharedNeighbor_[nn]) {
+      order.push_back(nn);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&](const int &a, const int &b) {
+    return neighbors_[a] < neighbors_[b];
+  });
+  return order;
+}
+
+/* Member function to find which neighbors are on the same node as this
+   processor. A communicator is created for each pair of neighbors, and split
+   by shared memory. If the split communicator still holds both processors,
+   they can share memory. Only the two processors of a pair take part in each
+   call.
+*/
+void haloExchange::FindSharedNeighbors() {
+  MPI_Group worldGroup;
+  MPI_Comm_group(MPI_COMM_WORLD, &worldGroup);
+  isSharedNeighbor_.clear();
+  const auto order = this->SharedNeighborOrder();
+  isSharedNeighbor_.assign(this->NumNeighbors(), false);
+  for (const auto &nn : order) {
+    const int pair[2] = {std::min(rank_, neighbors_[nn]),
+                         std::max(rank_, neighbors_[nn])};
+    MPI_Group pairGroup;
+    MPI_Group_incl(worldGroup, 2, pair, &pairGroup);
+    MPI_Comm pairComm, nodeComm;
+    MPI_Comm_create_group(MPI_COMM_WORLD, pairGroup, 0, &pairComm);
+    MPI_Comm_split_type(pairComm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                        &nodeComm);
+    auto nodeSize = 0;
+    MPI_Comm_size(nodeComm, &nodeSize);
+    isSharedNeighbor_[nn] = nodeSize == 2;
+    MPI_Comm_free(&nodeComm);
+    MPI_Comm_free(&pairComm);
+    MPI_Group_free(&pairGroup);
+  }
+  MPI_Group_free(&worldGroup);
+}
+
+/* Member function to get the message buffers and persistent requests for a
+   tag. These are created with the exchange, so only tags given at construction
+   can be swapped.
+*/
+haloChannel &haloExchange::Channel(const int &tag, const int &valuesPerCell) {
+  // tag -- id for MPI messages
+  // valuesPerCell -- number of doubles packed for each cell
+  auto it = channels_.find(tag);
+  MSG_ASSERT(it != channels_.end() &&
+                 it->second.valuesPerCell_ == valuesPerCell,
+             "halo exchange tag was not set up with this number of values");
+  return it->second;
+}
+
+/* Member function to create the message buffers and persistent requests for a
+   tag. Both sides of a connection exchange the same number of cells, so the
+   send and receive buffers for a neighbor are the same size. For neighbors on
+   the same node, a shared memory window is allocated instead of the message
+   buffers. Allocating a window is collective over the pair of neighbors, so
+   this must be called with the tags in the same order on all processors.
+*/
+void haloExchange::CreateChannel(const int &tag, const int &valuesPerCell) {
+  // tag -- id for MPI messages
+  // valuesPerCell -- number of doubles packed for each cell
+  auto &channel = channels_[tag];
+  const auto numNeighbors = this->NumNeighbors();
+  channel.valuesPerCell_ = valuesPerCell;
+  channel.count_.resize(numNeighbors);
+  channel.sendBuf_.resize(numNeighbors);
+  channel.recvBuf_.resize(numNeighbors);
+  channel.sendReq_.resize(numNeighbors);
+  channel.recvReq_.resize(numNeighbors);
+  channel.window_.assign(numNeighbors, MPI_WIN_NULL);
+  channel.sharedSend_.assign(numNeighbors, nullptr);
+  channel.sharedRecv_.assign(numNeighbors, nullptr);
+  for (auto nn = 0; nn < numNeighbors; ++nn) {
+    auto numCells = 0;
+    for (const auto &slice : neighborSlices_[nn]) {
+      numCells += slice.sendCells_.size();
+    }
+    channel.count_[nn] = numCells * valuesPerCell;
+  }
+
+  // allocate shared memory windows for neighbors on same node
+  MPI_Group worldGroup;
+  MPI_Comm_group(MPI_COMM_WORLD, &worldGroup);
+  for (const auto &nn : this->SharedNeighborOrder()) {
+    const int pair[2] = {std::min(rank_, neighbors_[nn]),
+                         std::max(rank_, neighbors_[nn])};
+    MPI_Group pairGroup;
+    MPI_Group_incl(worldGroup, 2, pair, &pairGroup);
+    MPI_Comm pairComm;
+    MPI_Comm_create_group(MPI_COMM_WORLD, pairGroup, tag, &pairComm);
+
+    // two buffers per processor, used on alternate exchanges
+    const MPI_Aint windowSize = 2 * channel.count_[nn] * sizeof(double);
+    MPI_Win_allocate_shared(windowSize, sizeof(double), MPI_INFO_NULL,
+                            pairComm, &channel.sharedSend_[nn],
+                            &channel.window_[nn]);
+    MPI_Aint size = 0;
+    auto dispUnit = 0;
+    double *partner = nullptr;
+    MPI_Win_shared_query(channel.window_[nn], (rank_ == pair[0]) ? 1 : 0,
+                         &size, &dispUnit, &partner);
+    channel.sharedRecv_[nn] = partner;
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, channel.window_[nn]);
+    MPI_Comm_free(&pairComm);
+    MPI_Group_free(&pairGroup);
+  }
+  MPI_Group_free(&worldGroup);
+
+  // messages to neighbors on same node only signal that data is ready
+  for (auto nn = 0; nn < numNeighbors; ++nn) {
+    const auto count =
+        (channel.window_[nn] == MPI_WIN_NULL) ? channel.count_[nn] : 0;
+    channel.sendBuf_[nn].resize(count);
+    channel.recvBuf_[nn].resize(count);
+    MPI_Recv_init(channel.recvBuf_[nn].data(), count, MPI_DOUBLE,
+                  neighbors_[nn], tag, MPI_COMM_WORLD, &channel.recvReq_[nn]);
+    MPI_Send_init(channel.sendBuf_[nn].data(), count, MPI_DOUBLE,
+                  neighbors_[nn], tag, MPI_COMM_WORLD, &channel.sendReq_[nn]);
+  }
+}
+
+/* Member function to free the persistent requests and shared memory windows of
+   a channel. Freeing a window is collective over the pair of neighbors, so
+   windows are freed in the same order they are allocated.
+*/
+void haloExchange::FreeChannel(haloChannel &channel) const {
+  for (auto &req : channel.sendReq_) {
+    MPI_Request_free(&req);
+  }
+  for (auto &req : channel.recvReq_) {
+    MPI_Request_free(&req);
+  }
+  for (const auto &nn : this->SharedNeighborOrder()) {
+    if (channel.window_[nn] != MPI_WIN_NULL) {
+      MPI_Win_unlock_all(channel.window_[nn]);
+      MPI_Win_free(&channel.window_[nn]);
+    }
+  }
+}
+
+// member function to free the persistent requests of all channels
+void haloExchange::FreeRequests() {
+  // requests cannot be freed after MPI is finalized
+  auto isFinalized = 0;
+  MPI_Finalized(&isFinalized);
+  if (!isFinalized) {
+    for (auto &channel : channels_) {
+      this->FreeChannel(channel.second);
+    }
+  }
+  channels_.clear();
+}
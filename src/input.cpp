@@ -71,6 +71,7 @@ input::input(const string &name, const string &resName) : simName_(name),
   equationSet_ = "euler";
   matrixSolver_ = "lusgs";
   matrixSweeps_ = 1;
+  jacobianUpdateFrequency_ = 1;  // default to rebuild jacobians every iteration
   matrixRelaxation_ = 1.0;  // default is symmetric Gauss-Seidel
                             // with no overrelaxation
   timeIntTheta_ = 1.0;  // default results in implicit euler
@@ -85,6 +86,7 @@ input::input(const string &name, const string &resName) : simName_(name),
                        // stepping is not used
   inviscidFlux_ = "roe";  // default value is roe flux
   decompMethod_ = "cubic";  // default is cubic decomposition
+  gridCache_ = false;  // default to preprocess grid every run
   turbModel_ = "none";  // default turbulence model is none
   thermodynamicModel_ = "caloricallyPerfect";  // default to cpg
   equationOfState_ = "idealGas";  // default to ideal gas
@@ -93,10 +95,16 @@ input::input(const string &name, const string &resName) : simName_(name),
   chemistryModel_ = "frozen";  // default to nonreacting flow
   chemistryMechanism_ = "none";  // default to no mechanism
   restartFrequency_ = 0;  // default to not write restarts
+  residualOutputFrequency_ = 1;  // default to write residuals every iteration
+  rebalanceFrequency_ = 0;  // default to not rebalance load
+  outputQueueSize_ = 0;  // default to write output before continuing
+  outputPrecision_ = "double";  // default to double precision function files
+  restartFormat_ = "uncompressed";  // default to uncompressed restart files
   iterationStart_ = 0;  // default to start from iteration zero
   schmidtNumber_ = 0.9;
   freezingTemperature_ = 0.0;
   mgLevels_ = 1;
+  mgAgglomerationThreshold_ = 0;  // default to no coarse level agglomeration
   outputNodalVariables_ = false;
   mgPreSweeps_ = 2;
   mgPostSweeps_ = 1;
@@ -105,6 +113,16 @@ input::input(const string &name, const string &resName) : simName_(name),
   // default to primitive variables
   outputVariables_ = {"density", "vel_x", "vel_y", "vel_z", "pressure"};
   wallOutputVariables_ = {};
+  extractions_ = {};
+  extractionVariables_ = {"density", "vel_x", "vel_y", "vel_z", "pressure"};
+  extractionBufferSize_ = 10;  // default to write every 10 samples
+  statisticsFrequency_ = 0;  // default to not collect statistics
+  statisticsStart_ = 0;
+  statisticsVariables_ = {"density", "pressure", "temperature", "vel_x",
+                          "vel_y", "vel_z"};
+  monitors_ = {};
+  monitorFrequency_ = 1;  // default to integrate monitors every iteration
+  monitorTolerance_ = 0.0;  // default to not stop on converged monitors
 
   // keywords in the input file that the parser is looking for to define
   // variables
@@ -121,9 +139,15 @@ input::input(const string &name, const string &resName) : simName_(name),
            "limiter",
            "outputFrequency",
            "restartFrequency",
+           "residualOutputFrequency",
+           "rebalanceFrequency",
+           "outputQueueSize",
+           "outputPrecision",
+           "restartFormat",
            "equationSet",
            "matrixSolver",
            "matrixSweeps",
+           "jacobianUpdateFrequency",
            "matrixRelaxation",
            "nonlinearIterations",
            "cflMax",
@@ -133,6 +157,7 @@ input::input(const string &name, const string &resName) : simName_(name),
            "dualTimeCFL",
            "inviscidFlux",
            "decompositionMethod",
+           "gridCache",
            "turbulenceModel",
            "thermodynamicModel",
            "diffusionModel",
@@ -143,6 +168,15 @@ input::input(const string &name, const string &resName) : simName_(name),
            "outputVariables",
            "outputNodalVariables",
            "wallOutputVariables",
+           "extractions",
+           "extractionVariables",
+           "extractionBufferSize",
+           "statisticsFrequency",
+           "statisticsStart",
+           "statisticsVariables",
+           "monitors",
+           "monitorFrequency",
+           "monitorTolerance",
            "initialConditions",
            "schmidtNumber",
            "freezingTemperature",
@@ -150,6 +184,7 @@ input::input(const string &name, const string &resName) : simName_(name),
            "multigridPreSweeps",
            "multigridPostSweeps",
            "multigridCycle",
+           "multigridAgglomerationThreshold",
            "boundaryStates",
            "boundaryConditions"};
 }
@@ -328,6 +363,31 @@ void input::ReadInput(const int &rank) {
           if (rank == ROOTP) {
             cout << key << ": " << this->RestartFrequency() << endl;
           }
+        } else if (key == "residualOutputFrequency") {
+          residualOutputFrequency_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->ResidualOutputFrequency() << endl;
+          }
+        } else if (key == "rebalanceFrequency") {
+          rebalanceFrequency_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->RebalanceFrequency() << endl;
+          }
+        } else if (key == "outputQueueSize") {
+          outputQueueSize_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->OutputQueueSize() << endl;
+          }
+        } else if (key == "outputPrecision") {
+          outputPrecision_ = tokens[1];
+          if (rank == ROOTP) {
+            cout << key << ": " << this->OutputPrecision() << endl;
+          }
+        } else if (key == "restartFormat") {
+          restartFormat_ = tokens[1];
+          if (rank == ROOTP) {
+            cout << key << ": " << this->RestartFormat() << endl;
+          }
         } else if (key == "equationSet") {
           equationSet_ = tokens[1];
           if (rank == ROOTP) {
@@ -343,6 +403,11 @@ void input::ReadInput(const int &rank) {
           if (rank == ROOTP) {
             cout << key << ": " << this->MatrixSweeps() << endl;
           }
+        } else if (key == "jacobianUpdateFrequency") {
+          jacobianUpdateFrequency_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->JacobianUpdateFrequency() << endl;
+          }
         } else if (key == "matrixRelaxation") {
           matrixRelaxation_ =
               stod(tokens[1]);  // double variable (stod)
@@ -389,6 +454,11 @@ void input::ReadInput(const int &rank) {
           if (rank == ROOTP) {
             cout << key << ": " << this->DecompMethod() << endl;
           }
+        } else if (key == "gridCache") {
+          gridCache_ = tokens[1] == "yes" || tokens[1] == "true";
+          if (rank == ROOTP) {
+            cout << key << ": " << this->UseGridCache() << endl;
+          }
         } else if (key == "turbulenceModel") {
           turbModel_ = tokens[1];
           if (rank == ROOTP) {
@@ -454,6 +524,12 @@ void input::ReadInput(const int &rank) {
           if (rank == ROOTP) {
             cout << key << ": " << this->MultigridCycleType() << endl;
           }
+        } else if (key == "multigridAgglomerationThreshold") {
+          mgAgglomerationThreshold_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->MultigridAgglomerationThreshold()
+                 << endl;
+          }
         } else if (key == "outputNodalVariables") {
           outputNodalVariables_ = tokens[1] == "yes" || tokens[1] == "true";
           if (rank == ROOTP) {
@@ -511,6 +587,109 @@ void input::ReadInput(const int &rank) {
             }
             cout << endl;
           }
+        } else if (key == "extractions") {
+          extractions_ = ReadExtractionList(inFile, tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": <";
+            for (auto ii = 0U; ii < extractions_.size(); ++ii) {
+              cout << extractions_[ii];
+              if (ii == extractions_.size() - 1) {
+                cout << ">" << endl;
+              } else {
+                cout << "," << endl << "              ";
+              }
+            }
+          }
+        } else if (key == "extractionVariables") {
+          // clear default variables from set
+          extractionVariables_.clear();
+          auto specifiedVars = ReadStringList(inFile, tokens[1]);
+          for (auto &vars : specifiedVars) {
+            extractionVariables_.insert(vars);
+          }
+          if (rank == ROOTP) {
+            cout << key << ": <";
+            auto count = 0U;
+            auto numChars = 0U;
+            for (auto &vars : extractionVariables_) {
+              if (count == extractionVariables_.size() - 1) {
+                cout << vars << ">" << endl;
+              } else {
+                cout << vars << ", ";
+                numChars += vars.length();
+                if (numChars >= 50) {  // if more than 50 chars, go to next line
+                  cout << endl << "                      ";
+                  numChars = 0U;
+                }
+              }
+              count++;
+            }
+            cout << endl;
+          }
+        } else if (key == "extractionBufferSize") {
+          extractionBufferSize_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->ExtractionBufferSize() << endl;
+          }
+        } else if (key == "statisticsFrequency") {
+          statisticsFrequency_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->StatisticsFrequency() << endl;
+          }
+        } else if (key == "statisticsStart") {
+          statisticsStart_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->StatisticsStart() << endl;
+          }
+        } else if (key == "statisticsVariables") {
+          // clear default variables from set
+          statisticsVariables_.clear();
+          auto specifiedVars = ReadStringList(inFile, tokens[1]);
+          for (auto &vars : specifiedVars) {
+            statisticsVariables_.insert(vars);
+          }
+          if (rank == ROOTP) {
+            cout << key << ": <";
+            auto count = 0U;
+            auto numChars = 0U;
+            for (auto &vars : statisticsVariables_) {
+              if (count == statisticsVariables_.size() - 1) {
+                cout << vars << ">" << endl;
+              } else {
+                cout << vars << ", ";
+                numChars += vars.length();
+                if (numChars >= 50) {  // if more than 50 chars, go to next line
+                  cout << endl << "                      ";
+                  numChars = 0U;
+                }
+              }
+              count++;
+            }
+            cout << endl;
+          }
+        } else if (key == "monitors") {
+          monitors_ = ReadMonitorList(inFile, tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": <";
+            for (auto ii = 0U; ii < monitors_.size(); ++ii) {
+              cout << monitors_[ii];
+              if (ii == monitors_.size() - 1) {
+                cout << ">" << endl;
+              } else {
+                cout << "," << endl << "           ";
+              }
+            }
+          }
+        } else if (key == "monitorFrequency") {
+          monitorFrequency_ = stoi(tokens[1]);
+          if (rank == ROOTP) {
+            cout << key << ": " << this->MonitorFrequency() << endl;
+          }
+        } else if (key == "monitorTolerance") {
+          monitorTolerance_ = stod(tokens[1]);  // double variable (stod)
+          if (rank == ROOTP) {
+            cout << key << ": " << this->MonitorTolerance() << endl;
+          }
         } else if (key == "initialConditions") {
           ics_ = ReadICList(inFile, tokens[1]);
           if (rank == ROOTP) {
@@ -624,13 +803,23 @@ void input::ReadInput(const int &rank) {
 
   // input file sanity checks
   this->CheckNonlinearIterations();
-  this->CheckOutputVariables();
+  this->CheckOutputVariables(outputVariables_);
+  this->CheckOutputVariables(extractionVariables_);
+  this->CheckOutputVariables(statisticsVariables_);
   this->CheckWallOutputVariables();
   this->CheckTurbulenceModel();
   this->CheckSpecies();
   this->CheckNonreflecting();
   this->CheckChemistryMechanism();
   this->CheckMultigrid();
+  this->CheckJacobianUpdateFrequency();
+  this->CheckResidualOutputFrequency();
+  this->CheckRebalanceFrequency();
+  this->CheckOutputQueueSize();
+  this->CheckOutputFormats();
+  this->CheckExtractions();
+  this->CheckStatistics();
+  this->CheckMonitors();
 
   if (rank == ROOTP) {
     cout << endl;
@@ -891,8 +1080,9 @@ void input::CheckNonlinearIterations() {
 }
 
 // member function to check validity of the requested output variables
-void input::CheckOutputVariables() {
-  auto oVars = outputVariables_;
+void input::CheckOutputVariables(set<string> &vars) const {
+  // vars -- requested variables, unavailable variables are removed
+  auto oVars = vars;
   for (auto &var : oVars) {
     if (!this->IsRANS()) {  // can't have RANS variables output
       if (var == "tke" || var == "sdr" || var.find("tkeGrad_") != string::npos ||
@@ -900,7 +1090,7 @@ void input::CheckOutputVariables() {
           var == "resid_sdr" || var == "f1" || var == "f2") {
         cerr << "WARNING: Variable " << var <<
             " is not available for non-RANS simulations." << endl;
-        outputVariables_.erase(var);
+        vars.erase(var);
       }
     }
 
@@ -908,7 +1098,7 @@ void input::CheckOutputVariables() {
       if (var == "viscosityRatio" || var == "turbulentViscosity") {
         cerr << "WARNING: Variable " << var <<
             " is not available for laminar simulations." << endl;
-        outputVariables_.erase(var);
+        vars.erase(var);
       }
     }
 
@@ -916,7 +1106,7 @@ void input::CheckOutputVariables() {
       if (var == "viscosity") {
         cerr << "WARNING: Variable " << var <<
             " is not available for inviscid simulations." << endl;
-        outputVariables_.erase(var);
+        vars.erase(var);
       }
     }
 
@@ -925,7 +1115,7 @@ void input::CheckOutputVariables() {
         !this->HaveSpecies(var.substr(3, string::npos))) {
       cerr << "WARNING: Species " << var.substr(3, string::npos)
            << " is not present. Removing mass fraction output request" << endl;
-      outputVariables_.erase(var);
+      vars.erase(var);
     }
   }
 }
@@ -1049,6 +1239,121 @@ void input::CheckMultigrid() const {
     cerr << "ERROR: multigridCycle must be 'V' or 'W'" << endl;
     exit(EXIT_FAILURE);
   }
+  if (mgAgglomerationThreshold_ < 0) {
+    cerr << "ERROR: multigridAgglomerationThreshold must be >= 0!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// check that jacobians are only reused for implicit steady simulations
+void input::CheckJacobianUpdateFrequency() const {
+  if (jacobianUpdateFrequency_ < 1) {
+    cerr << "ERROR: jacobianUpdateFrequency must be >= 1!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (jacobianUpdateFrequency_ > 1 &&
+      (!this->IsImplicit() || this->IsTimeAccurate())) {
+    cerr << "ERROR: jacobianUpdateFrequency > 1 is only supported for "
+         << "implicit steady simulations!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// check that residual output frequency is valid
+void input::CheckResidualOutputFrequency() const {
+  if (residualOutputFrequency_ < 1) {
+    cerr << "ERROR: residualOutputFrequency must be >= 1!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// check that rebalance frequency is valid
+void input::CheckRebalanceFrequency() const {
+  if (rebalanceFrequency_ < 0) {
+    cerr << "ERROR: rebalanceFrequency must be >= 0!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// check that output queue size is valid
+void input::CheckOutputQueueSize() const {
+  if (outputQueueSize_ < 0) {
+    cerr << "ERROR: outputQueueSize must be >= 0!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// check that output precision and restart format are valid
+void input::CheckOutputFormats() const {
+  if (outputPrecision_ != "double" && outputPrecision_ != "single") {
+    cerr << "ERROR: outputPrecision " << outputPrecision_
+         << " is not recognized! Choose double or single." << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (restartFormat_ != "uncompressed" && restartFormat_ != "compressed") {
+    cerr << "ERROR: restartFormat " << restartFormat_
+         << " is not recognized! Choose uncompressed or compressed." << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// check that extractions can be written
+void input::CheckExtractions() const {
+  if (extractions_.empty()) {
+    return;
+  }
+  if (extractionVariables_.empty()) {
+    cerr << "ERROR: extractionVariables must contain at least one variable "
+         << "to extract!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (extractionBufferSize_ <= 0) {
+    cerr << "ERROR: extractionBufferSize must be greater than zero!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  // extraction names are used in file names, so they must be unique
+  set<string> names;
+  for (const auto &ex : extractions_) {
+    if (!names.insert(ex.Name()).second) {
+      cerr << "ERROR: extraction name " << ex.Name() << " is used more than "
+           << "once!" << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+// check that statistics can be collected
+void input::CheckStatistics() const {
+  if (statisticsFrequency_ < 0) {
+    cerr << "ERROR: statisticsFrequency must be nonnegative!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (this->CollectStatistics() && statisticsVariables_.empty()) {
+    cerr << "ERROR: statisticsVariables must contain at least one variable "
+         << "to sample!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// check that monitors can be integrated
+void input::CheckMonitors() const {
+  if (monitorFrequency_ <= 0) {
+    cerr << "ERROR: monitorFrequency must be greater than zero!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (monitorTolerance_ < 0.0) {
+    cerr << "ERROR: monitorTolerance must not be negative!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  // monitor names are used in column headers, so they must be unique
+  set<string> names;
+  for (const auto &mon : monitors_) {
+    if (!names.insert(mon.Name()).second) {
+      cerr << "ERROR: monitor name " << mon.Name() << " is used more than "
+           << "once!" << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
 }
 
 // check that chemistry mechanism is only used with reacting flow
@@ -92,6 +92,7 @@ vector<blkMultiArray3d<varArray>> linearSolver::AXmB(const gridLevel &level,
 vector<blkMultiArray3d<varArray>> linearSolver::Residual(
     const gridLevel &level, const physics &phys, const input &inp) const {
   auto resid = this->AXmB(level, phys, inp);
+#pragma omp parallel for schedule(dynamic)
   for (auto bb = 0; bb < level.NumBlocks(); ++bb) {
     const auto &blk = level.Block(bb);
     for (auto kk = blk.StartK(); kk < blk.EndK(); ++kk) {
@@ -116,10 +117,12 @@ void linearSolver::InitializeMatrixUpdate(const gridLevel &level,
   // phys -- physics models
 
   MSG_ASSERT(level.NumBlocks() == this->NumBlocks(), "block size mismatch");
-  MSG_ASSERT(level.Block(0).NumCells() == a_[0].NumBlocks(),
+  MSG_ASSERT(level.NumBlocks() == 0 ||
+                 level.Block(0).NumCells() == a_[0].NumBlocks(),
              "cell number mismatch");
 
   // allocate multiarray for update
+#pragma omp parallel for schedule(dynamic)
   for (auto bb = 0; bb < level.NumBlocks(); ++bb) {
     const auto &blk = level.Block(bb);
     if (inp.MatrixRequiresInitialization()) {
@@ -148,10 +151,12 @@ void linearSolver::AddDiagonalTerms(const gridLevel &level, const input &inp) {
   // inp -- input variables
 
   MSG_ASSERT(level.NumBlocks() == this->NumBlocks(), "block size mismatch");
-  MSG_ASSERT(level.Block(0).NumCells() == a_[0].NumBlocks(),
+  MSG_ASSERT(level.NumBlocks() == 0 ||
+                 level.Block(0).NumCells() == a_[0].NumBlocks(),
              "cell number mismatch");
 
   // loop over blocks in grid level
+#pragma omp parallel for schedule(dynamic)
   for (auto bb = 0; bb < level.NumBlocks(); ++bb) {
     const auto &blk = level.Block(bb);
     // loop over physical cells
@@ -176,7 +181,9 @@ void linearSolver::AddDiagonalTerms(const gridLevel &level, const input &inp) {
 
 void linearSolver::Invert() {
   aInv_ = a_;
-  for (auto &ai : aInv_) {
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
+    auto &ai = aInv_[bb];
     for (auto kk = ai.StartK(); kk < ai.EndK(); ++kk) {
       for (auto jj = ai.StartJ(); jj < ai.EndJ(); ++jj) {
         for (auto ii = ai.StartI(); ii < ai.EndI(); ++ii) {
@@ -189,7 +196,7 @@ void linearSolver::Invert() {
 
 void linearSolver::SwapUpdate(const vector<connection> &conn, const int &rank,
                               const int &numGhost) {
-  SwapImplicitUpdate(x_, conn, rank, numGhost);
+  SwapImplicitUpdate(x_, conn, halo_, rank, numGhost);
 }
 
 void linearSolver::SubtractFromUpdate(
@@ -212,13 +219,13 @@ void linearSolver::Restriction(
     unique_ptr<linearSolver> &coarse, const vector<connection> &conn,
     const vector<multiArray3d<vector3d<int>>> &toCoarse,
     const vector<multiArray3d<double>> &volWeightFactor,
-    const int &rank) const {
+    const int &rank, const int &numGhosts) const {
   for (auto bb = 0; bb < this->NumBlocks(); ++bb) {
     // restrict update
     BlockRestriction(x_[bb], toCoarse[bb], volWeightFactor[bb], coarse->x_[bb]);
   }
   // swap updates for ghost cells
-  coarse->SwapUpdate(conn, rank, coarse->x_[0].GhostLayers());
+  coarse->SwapUpdate(conn, rank, numGhosts);
 }
 
 // constructor
@@ -436,16 +443,18 @@ vector<blkMultiArray3d<varArray>> lusgs::Relax(const gridLevel &level,
              "number of blocks mismatch");
   MSG_ASSERT(this->NumBlocks() == static_cast<int>(reorder_.size()),
              "reorder block size mismatch");
-  MSG_ASSERT(level.Block(0).NumCells() == this->A(0).NumBlocks(),
+  MSG_ASSERT(level.NumBlocks() == 0 ||
+                 level.Block(0).NumCells() == this->A(0).NumBlocks(),
              "cell number mismatch");
 
   // start sweeps through domain
-  const auto numG = level.Block(0).NumGhosts();
+  const auto numG = inp.NumberGhostLayers();
   for (auto ii = 0; ii < sweeps; ++ii) {
     // swap updates for ghost cells
     this->SwapUpdate(level.Connections(), rank, numG);
 
     // forward lu-sgs sweep
+#pragma omp parallel for schedule(dynamic)
     for (auto bb = 0; bb < level.NumBlocks(); ++bb) {
       this->LUSGS_Forward(level.Block(bb), reorder_[bb], phys, inp,
                           this->AInv(bb), ii, level.Forcing(bb), x_[bb]);
@@ -455,6 +464,7 @@ vector<blkMultiArray3d<varArray>> lusgs::Relax(const gridLevel &level,
     this->SwapUpdate(level.Connections(), rank, numG);
 
     // backward lu-sgs sweep
+#pragma omp parallel for schedule(dynamic)
     for (auto bb = 0; bb < level.NumBlocks(); ++bb) {
       this->LUSGS_Backward(level.Block(bb), reorder_[bb], phys, inp,
                            this->AInv(bb), this->A(bb), ii, level.Forcing(bb),
@@ -513,15 +523,17 @@ vector<blkMultiArray3d<varArray>> dplur::Relax(const gridLevel &level,
                                                const int &sweeps) {
   MSG_ASSERT(level.NumBlocks() == this->NumBlocks(),
              "number of blocks mismatch");
-  MSG_ASSERT(level.Block(0).NumCells() == this->A(0).NumBlocks(),
+  MSG_ASSERT(level.NumBlocks() == 0 ||
+                 level.Block(0).NumCells() == this->A(0).NumBlocks(),
              "cell number mismatch");
   // start sweeps through domain
-  const auto numG = level.Block(0).NumGhosts();
+  const auto numG = inp.NumberGhostLayers();
   for (auto ii = 0; ii < sweeps; ++ii) {
     // swap updates for ghost cells
     this->SwapUpdate(level.Connections(), rank, numG);
 
     // dplur sweep
+#pragma omp parallel for schedule(dynamic)
     for (auto bb = 0; bb < level.NumBlocks(); ++bb) {
       this->DPLUR(level.Block(bb), phys, inp, this->AInv(bb), this->A(bb),
                   level.Forcing(bb), x_[bb]);
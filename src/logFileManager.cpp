@@ -19,6 +19,8 @@
 #include <cstdlib>      // exit()
 #include <fstream>
 #include <chrono>
+#include <vector>
+#include <cmath>        // sqrt
 #include "logFileManager.hpp"
 #include "input.hpp"
 #include "output.hpp"
@@ -32,7 +34,12 @@ using std::cerr;
 
 // constructor
 logFileManager::logFileManager(const input &inp, const int &rank)
-    : l2First_(inp.NumEquations(), inp.NumSpecies()) {
+    : l2First_(inp.NumEquations(), inp.NumSpecies()),
+      reduceBuffer_(this->ReductionSize(), 0.0),
+      reduceRequest_(MPI_REQUEST_NULL),
+      reduceCFL_(0.0),
+      reduceIter_(0),
+      reduceNonlinearIter_(0) {
   rank_ = rank;
   if (rank_ != ROOTP) {
     return;
@@ -74,7 +81,8 @@ logFileManager::~logFileManager() {
 // function to write out residual information
 void logFileManager::WriteResiduals(const input &inp, const residual &residL2,
                                     const resid &residLinf,
-                                    const double &matrixResid, const int &nn,
+                                    const double &matrixResid,
+                                    const double &cfl, const int &nn,
                                     const int &mm) {
   if (rank_ != ROOTP) {
     return;
@@ -86,12 +94,91 @@ void logFileManager::WriteResiduals(const input &inp, const residual &residL2,
   }
 
   // print residuals to standard out
-  PrintResiduals(inp, l2First_, residL2, residLinf, matrixResid, nn, mm, cout);
+  PrintResiduals(inp, l2First_, residL2, residLinf, matrixResid, cfl, nn, mm,
+                 cout);
   // print residuals to residual file
-  PrintResiduals(inp, l2First_, residL2, residLinf, matrixResid, nn, mm,
+  PrintResiduals(inp, l2First_, residL2, residLinf, matrixResid, cfl, nn, mm,
                  resid_);
 }
 
+/* Member function to start the reduction of the residuals from all processors
+to ROOT. The L2 norms, matrix residual, and linf residual are packed into one
+buffer so that a single nonblocking reduction is used. The reduction is not
+waited on until FinishResidualReduction is called, so processors are not
+synchronized every time residuals are logged.
+*/
+void logFileManager::StartResidualReduction(
+    const residual &residL2, const resid &residLinf, const double &matrixResid,
+    const double &cfl, const int &nn, const int &mm,
+    const MPI_Datatype &MPI_residuals,
+    const MPI_Op &MPI_REDUCE_RESID) {
+  // residL2 -- l2 norm of residual on this processor
+  // residLinf -- linf norm of residual on this processor
+  // matrixResid -- matrix residual on this processor
+  // cfl -- cfl number at iteration
+  // nn -- iteration number
+  // mm -- nonlinear iteration number
+  // MPI_residuals -- MPI_Datatype for the reduction buffer
+  // MPI_REDUCE_RESID -- MPI_Op to sum l2 norms and take max of linf norm
+  MSG_ASSERT(reduceRequest_ == MPI_REQUEST_NULL,
+             "residual reduction already in progress");
+
+  auto ind = 0;
+  for (auto ii = 0; ii < residL2.Size(); ++ii) {
+    reduceBuffer_[ind++] = residL2[ii];
+  }
+  reduceBuffer_[ind++] = matrixResid;
+  reduceBuffer_[ind++] = residLinf.Linf();
+  reduceBuffer_[ind++] = residLinf.Block();
+  reduceBuffer_[ind++] = residLinf.ILoc();
+  reduceBuffer_[ind++] = residLinf.JLoc();
+  reduceBuffer_[ind++] = residLinf.KLoc();
+  reduceBuffer_[ind++] = residLinf.Eqn();
+  reduceCFL_ = cfl;
+  reduceIter_ = nn;
+  reduceNonlinearIter_ = mm;
+
+  if (rank_ == ROOTP) {
+    MPI_Ireduce(MPI_IN_PLACE, reduceBuffer_.data(), 1, MPI_residuals,
+                MPI_REDUCE_RESID, ROOTP, MPI_COMM_WORLD, &reduceRequest_);
+  } else {
+    MPI_Ireduce(reduceBuffer_.data(), nullptr, 1, MPI_residuals,
+                MPI_REDUCE_RESID, ROOTP, MPI_COMM_WORLD, &reduceRequest_);
+  }
+}
+
+/* Member function to wait for the residual reduction started by
+StartResidualReduction and write out the residuals. If no reduction is in
+progress nothing is done.
+*/
+void logFileManager::FinishResidualReduction(const input &inp,
+                                             const double &numCells) {
+  // inp -- input variables
+  // numCells -- total number of cells in grid
+  if (reduceRequest_ == MPI_REQUEST_NULL) {
+    return;
+  }
+  MPI_Wait(&reduceRequest_, MPI_STATUS_IGNORE);
+  if (rank_ != ROOTP) {
+    return;
+  }
+
+  const auto numL2 = l2First_.Size();
+  residual residL2(reduceBuffer_.begin(), reduceBuffer_.begin() + numL2,
+                   l2First_.NumSpecies());
+  residL2.SquareRoot();
+  const auto matrixResid =
+      sqrt(reduceBuffer_[numL2] / (numCells * inp.NumEquations()));
+  const resid residLinf(
+      reduceBuffer_[numL2 + 1], static_cast<int>(reduceBuffer_[numL2 + 2]),
+      static_cast<int>(reduceBuffer_[numL2 + 3]),
+      static_cast<int>(reduceBuffer_[numL2 + 4]),
+      static_cast<int>(reduceBuffer_[numL2 + 5]),
+      static_cast<int>(reduceBuffer_[numL2 + 6]));
+  this->WriteResiduals(inp, residL2, residLinf, matrixResid, reduceCFL_,
+                       reduceIter_, reduceNonlinearIter_);
+}
+
 void logFileManager::GetIterStart() {
   if (rank_ != ROOTP) {
     return;
@@ -110,4 +197,36 @@ void logFileManager::WriteTime(const int &nn) {
         << std::setprecision(6) << std::scientific << iterDuration.count()
         << std::setw(16) << duration.count() << endl;
   time_.unsetf(std::ios::fixed | std::ios::scientific);
-}
\ No newline at end of file
+}
+
+/* Function to reduce the buffer of residuals used by logFileManager. The l2
+norms and matrix residual are summed, and the linf residual with the largest
+value is kept along with its location. This is used to create an operation for
+MPI_Ireduce.
+*/
+void ReduceResiduals(double *in, double *inout, int *len,
+                     MPI_Datatype *MPI_residuals) {
+  // *in -- pointer to input buffers
+  // *inout -- pointer to input and output buffers. The answer is stored here
+  // *len -- pointer to number of buffers
+  // *MPI_residuals -- pointer to MPI_Datatype for a buffer
+
+  auto typeSize = 0;
+  MPI_Type_size(*MPI_residuals, &typeSize);
+  const auto bufSize = typeSize / static_cast<int>(sizeof(double));
+  // last 6 entries are linf residual and location
+  const auto numSum = bufSize - 6;
+
+  for (auto ii = 0; ii < *len; ++ii) {
+    for (auto jj = 0; jj < numSum; ++jj) {
+      inout[jj] += in[jj];
+    }
+    if (in[numSum] >= inout[numSum]) {
+      for (auto jj = numSum; jj < bufSize; ++jj) {
+        inout[jj] = in[jj];
+      }
+    }
+    in += bufSize;
+    inout += bufSize;
+  }
+}
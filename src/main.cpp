@@ -26,6 +26,10 @@
 #include <xmmintrin.h>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>         // omp_get_max_threads
+#endif
+
 #include "plot3d.hpp"
 #include "vector3d.hpp"
 #include "input.hpp"
@@ -46,6 +50,10 @@
 #include "matMultiArray3d.hpp"
 #include "mgSolution.hpp"
 #include "logFileManager.hpp"
+#include "outputQueue.hpp"
+#include "extractionManager.hpp"
+#include "monitorManager.hpp"
+#include "gridCache.hpp"
 
 using std::cout;
 using std::cerr;
@@ -57,7 +65,9 @@ int main(int argc, char *argv[]) {
   // of processors and rank of each processor
   auto numProcs = 1;
   auto rank = 0;
-  MPI_Init(&argc, &argv);
+  // mpi is only called by the main thread when using openmp
+  int threadSupport = MPI_THREAD_SINGLE;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &threadSupport);
   MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
@@ -71,15 +81,26 @@ int main(int argc, char *argv[]) {
     cout << "Compiled on " << __DATE__ << " at " << __TIME__ << endl;
     cout << "Using MPI Version " << version << "." << subversion << endl;
     cout << "Using " << numProcs << " processors" << endl;
+#ifdef _OPENMP
+    cout << "Using " << omp_get_max_threads() << " threads per processor"
+         << endl;
+    if (threadSupport < MPI_THREAD_FUNNELED) {
+      cerr << "WARNING: MPI library does not support threads" << endl;
+    }
+#endif
   }
   MPI_Barrier(MPI_COMM_WORLD);
 
   // Enable exceptions so code won't run with NANs
+  // exceptions are set per thread, so enable them on all threads
+#pragma omp parallel
+  {
 #ifdef __linux__
-  feenableexcept(FE_DIVBYZERO | FE_INVALID);
+    feenableexcept(FE_DIVBYZERO | FE_INVALID);
 #elif __APPLE__
-  _MM_SET_EXCEPTION_MASK(_MM_GET_EXCEPTION_MASK() & ~_MM_MASK_INVALID);
+    _MM_SET_EXCEPTION_MASK(_MM_GET_EXCEPTION_MASK() & ~_MM_MASK_INVALID);
 #endif
+  }
 
   // Check command line inputs
   // Name of input file is the second argument (the executable being the first)
@@ -100,7 +121,6 @@ int main(int argc, char *argv[]) {
   auto totalCells = 0.0;
   input inp(inputFile, restartFile);
   decomposition decomp;
-  auto numProcBlock = 0;
 
   // Parse input file
   inp.ReadInput(rank);
@@ -115,66 +135,131 @@ int main(int argc, char *argv[]) {
   // Nondimensionalize BC & IC data
   inp.NondimensionalizeStateData(phys.EoS());
 
-  mgSolution solution;  // only keep finest grid level globally
+  // output written during the simulation can be written in the background
+  outputQueue writer(inp.OutputQueueSize());
+
+  // nodal and wall variables are found from the recombined parent blocks, so
+  // only then is the finest grid level gathered on ROOT for output; otherwise
+  // each processor writes its own blocks and ROOT holds no copy of the grid
+  const auto gatherOutput =
+      inp.OutputNodalVariables() || inp.NumWallVarsOutput() > 0;
+  mgSolution solution;  // finest grid level on ROOT, only if gatherOutput
   vector<vector3d<double>> viscFaces;
+  vector<boundaryConditions> bcs;
+  vector<connection> connections;
+
+  // node of each processor, used to map decomposition onto machine
+  const auto nodeOfRank = NodeLayout();
+
+  // geometry preprocessed by an earlier run of the same configuration
+  gridCache cache(inp);
+
+  // Set MPI datatypes
+  MPI_Datatype MPI_vec3d, MPI_procBlockInts, MPI_connection, MPI_DOUBLE_5INT,
+      MPI_vec3dMag, MPI_uncoupledScalar, MPI_tensorDouble;
+  SetDataTypesMPI(MPI_vec3d, MPI_procBlockInts, MPI_connection, MPI_DOUBLE_5INT,
+                  MPI_vec3dMag, MPI_uncoupledScalar, MPI_tensorDouble);
+
+  // grid file is hashed in portions on all processors for cache key
+  if (inp.UseGridCache()) {
+    cache.HashGrid(inp, rank);
+  }
 
   if (rank == ROOTP) {
     cout << "Number of equations: " << inp.NumEquations() << endl << endl;
 
-    // Read grid
+    // Read grid header, only nodes at corners of boundary surfaces are read
+    // to find connections
     auto mesh = ReadP3dGrid(inp.GridName(), inp.LRef(), totalCells);
     // Get BCs for blocks
-    auto bcs = inp.AllBC();
+    bcs = inp.AllBC();
 
     // Decompose grid
+    const auto cellCost = CellCostModel(inp, mesh, bcs);
+    const auto faceCost = FaceCostModel(inp, bcs);
     if (inp.DecompMethod() == "manual") {
-      decomp = ManualDecomposition(mesh, bcs, numProcs);
+      decomp = ManualDecomposition(mesh, bcs, cellCost, faceCost, numProcs);
     } else if (inp.DecompMethod() == "cubic") {
-      decomp = CubicDecomposition(mesh, bcs, numProcs);
+      decomp = CubicDecomposition(mesh, bcs, cellCost, faceCost, numProcs);
+    } else if (inp.DecompMethod() == "graph") {
+      decomp = GraphDecomposition(mesh, bcs, cellCost, faceCost, numProcs);
     } else {
       cerr << "ERROR: Domain decomposition method " << inp.DecompMethod()
            << " is not recognized!" << endl;
       exit(EXIT_FAILURE);
     }
 
-    solution.ConstructFinestLevel(mesh, bcs, decomp, phys, restartFile, inp,
-                                  logs.L2First());
+    // keep processors sharing the most faces on the same node
+    MapProcsToNodes(bcs, nodeOfRank, inp, decomp);
 
-    // Get face centers of faces with viscous wall BC
-    viscFaces = GetViscousFaceCenters(solution.Finest().Blocks());
+    // geometry of the same grid, bcs, and decomposition may be cached
+    if (inp.UseGridCache()) {
+      cache.AssignKey(mesh, bcs, decomp, inp, MPI_connection, MPI_vec3d,
+                      MPI_vec3dMag);
+      connections = cache.ReadConnections(MPI_connection);
+    }
 
-    cout << "Solution Initialized" << endl << endl;
-    //---------------------------------------------------------------------
+    // blocks are constructed on each processor, only connections needed
+    if (!cache.IsValid()) {
+      connections = GetConnectionBCs(bcs, mesh, decomp, inp);
+    }
   }
 
-  // Set MPI datatypes
-  MPI_Datatype MPI_vec3d, MPI_procBlockInts, MPI_connection, MPI_DOUBLE_5INT,
-      MPI_vec3dMag, MPI_uncoupledScalar, MPI_tensorDouble;
-  SetDataTypesMPI(MPI_vec3d, MPI_procBlockInts, MPI_connection, MPI_DOUBLE_5INT,
-                  MPI_vec3dMag, MPI_uncoupledScalar, MPI_tensorDouble);
-
   // Broadcast decomposition to all processors
   decomp.Broadcast();
+  cache.Broadcast();
+
+  // Each processor reads its portion of the grid and constructs its blocks
+  mgSolution localSolution(inp);
+  BroadcastConnections(MPI_connection, connections);
+  if (cache.IsValid()) {
+    localSolution.ConstructLocalFinestLevel(
+        cache.ReadBlocks(decomp, inp, rank, MPI_vec3d, MPI_vec3dMag),
+        connections, phys, inp);
+  } else {
+    const auto localBCs = ScatterBCs(bcs, decomp, rank);
+    const auto localMesh =
+        ReadP3dGridLocal(inp.GridName(), inp.LRef(), decomp, rank);
+    localSolution.ConstructLocalFinestLevel(localMesh, localBCs, connections,
+                                            decomp, phys, rank, inp,
+                                            MPI_vec3d, MPI_vec3dMag);
+  }
+
+  // Each processor reads the restart data of its own blocks
+  if (inp.IsRestart()) {
+    localSolution.ReadFinestRestart(restartFile, decomp, inp, phys,
+                                    logs.L2First(), rank);
+  }
+
+  // Gather viscous face centers on all processors
+  viscFaces = GatherViscFaces(
+      MPI_vec3d, GetViscousFaceCenters(localSolution.Finest().Blocks()));
 
-  // Send number of procBlocks to all processors
-  SendNumProcBlocks(decomp.NumBlocksOnAllProc(), numProcBlock);
+  // Gather finest gridLevel geometry on ROOT for nodal or wall output
+  if (gatherOutput) {
+    solution = localSolution.GatherFinestGridLevel(decomp, rank, MPI_vec3d,
+                                                   MPI_vec3dMag, inp);
+  }
+  bcs.clear();
+  connections.clear();
+
+  if (rank == ROOTP) {
+    cout << "Solution Initialized" << endl << endl;
+  }
 
-  // Send finest gridLevel to appropriate processor
-  auto localSolution = solution.SendFinestGridLevel(
-      rank, numProcBlock, MPI_vec3d, MPI_vec3dMag, MPI_connection, inp);
   localSolution.ConstructMultigrids(decomp, inp, phys, rank, MPI_connection,
                                     MPI_vec3d, MPI_vec3dMag);
 
   // Update auxillary variables (temperature, viscosity, etc), cell widths
   localSolution.AuxillaryAndWidths(phys);
 
-  // Broadcast viscous face centers to all processors
-  BroadcastViscFaces(MPI_vec3d, viscFaces);
-
-  // Create operation
-  MPI_Op MPI_MAX_LINF;
-  MPI_Op_create(reinterpret_cast<MPI_User_function *> (MaxLinf), true,
-                &MPI_MAX_LINF);
+  // Create datatype and operation for residual reduction
+  MPI_Datatype MPI_residuals;
+  MPI_Type_contiguous(logs.ReductionSize(), MPI_DOUBLE, &MPI_residuals);
+  MPI_Type_commit(&MPI_residuals);
+  MPI_Op MPI_REDUCE_RESID;
+  MPI_Op_create(reinterpret_cast<MPI_User_function *> (ReduceResiduals), true,
+                &MPI_REDUCE_RESID);
 
   //-----------------------------------------------------------------------
   // wall distance calculation
@@ -197,7 +282,9 @@ int main(int argc, char *argv[]) {
          << endl;
   }
 
-  if (tree.Size() > 0) {
+  if (cache.IsValid()) {
+    cache.ReadWallDistance(localSolution);
+  } else if (tree.Size() > 0) {
     localSolution.CalcWallDistance(tree);
     localSolution.SwapWallDist(rank, inp.NumberGhostLayers());
   }
@@ -210,26 +297,46 @@ int main(int argc, char *argv[]) {
          << " seconds" << endl << endl;
   }
 
+  // geometry and wall distance are cached for later runs
+  if (inp.UseGridCache() && !cache.IsValid()) {
+    cache.Write(localSolution, rank, MPI_connection, MPI_vec3d,
+                MPI_vec3dMag);
+  }
+
   //-----------------------------------------------------------------------
-  // Send/recv solutions - necessary to get wall distances
-  solution.GetFinestGridLevel(localSolution, rank, MPI_uncoupledScalar,
-                              MPI_vec3d, MPI_tensorDouble, inp);
+  // Write out cell centers grid file and initial results
+  if (gatherOutput) {
+    // Send/recv solutions - necessary to get wall distances
+    solution.GetFinestGridLevel(localSolution, rank, MPI_uncoupledScalar,
+                                MPI_vec3d, MPI_tensorDouble, inp);
+    if (rank == ROOTP) {
+      cout << "Nodal or wall output requested, solution is gathered on ROOT "
+           << "for output" << endl;
+      WriteCellCenter(inp.GridName(), solution.Finest().Blocks(), decomp,
+                      inp);
+      WriteOutput(solution.Finest().Blocks(), phys, inp.IterationStart(),
+                  decomp, inp);
+    }
+  } else {
+    // each processor writes its own blocks
+    WriteCellCenterMPI(inp.GridName(), localSolution.Finest().Blocks(), decomp,
+                       inp, rank, writer);
+    WriteOutputMPI(localSolution.Finest().Blocks(), phys, inp.IterationStart(),
+                   decomp, inp, rank, writer);
+  }
 
-  if (rank == ROOTP) {
-    // Write out cell centers grid file
-    WriteCellCenter(inp.GridName(), solution.Finest().Blocks(), decomp, inp);
+  // Find probes, planes, and lines on each processor and start their files
+  extractionManager extractions(inp, phys);
+  extractions.Locate(localSolution.Finest().Blocks(), decomp, inp, rank);
 
-    // Write out initial results
-    WriteOutput(solution.Finest().Blocks(), phys, inp.IterationStart(), decomp,
-                inp);
-  }
+  // Open monitor file for forces integrated over boundary surfaces
+  monitorManager monitors(inp, phys, rank);
 
   // ----------------------------------------------------------------------
   // ----------------------- Start Main Loop ------------------------------
   // ----------------------------------------------------------------------
   // loop over time
   for (auto nn = 0; nn < inp.Iterations(); ++nn) {
-    MPI_Barrier(MPI_COMM_WORLD);
     logs.GetIterStart();
 
     // Calculate cfl number
@@ -251,55 +358,125 @@ int main(int argc, char *argv[]) {
 
       // ----------------------------------------------------------------------
       // Get residuals from all processors
-      residL2.GlobalReduceMPI(rank);
-      residLinf.GlobalReduceMPI(rank, MPI_DOUBLE_5INT, MPI_MAX_LINF);
-
-      // Get matrix residuals from all processors
-      if (rank == ROOTP) {
-        MPI_Reduce(MPI_IN_PLACE, &matrixResid, 1, MPI_DOUBLE, MPI_SUM,
-                   ROOTP, MPI_COMM_WORLD);
-      } else {
-        MPI_Reduce(&matrixResid, &matrixResid, 1, MPI_DOUBLE, MPI_SUM,
-                   ROOTP, MPI_COMM_WORLD);
+      // previous reduction is only waited on when the next one is started, so
+      // its communication is overlapped with the iterations in between
+      if (inp.WriteResiduals(nn)) {
+        logs.FinishResidualReduction(inp, totalCells);
+        logs.StartResidualReduction(residL2, residLinf, matrixResid, inp.CFL(),
+                                    nn + inp.IterationStart(), mm,
+                                    MPI_residuals, MPI_REDUCE_RESID);
       }
+    }  // loop for nonlinear iterations ---------------------------------------
 
-      if (rank == ROOTP) {
-        // Finish calculation of L2 norm of residual
-        residL2.SquareRoot();
+    // each processor samples the extractions in its own blocks
+    extractions.Sample(localSolution.Finest().Blocks(), inp, nn, rank);
 
-        // Finish calculation of matrix residual
-        matrixResid = sqrt(matrixResid/(totalCells * inp.NumEquations()));
+    // each processor integrates the monitors over its own blocks; previous
+    // reduction is only waited on when the next one is started
+    if (monitors.Sample(nn)) {
+      monitors.FinishIntegration();
+      monitors.StartIntegration(localSolution.Finest().Blocks(), phys,
+                                nn + inp.IterationStart());
+    }
 
-        // Print out run information
-        logs.WriteResiduals(inp, residL2, residLinf, matrixResid,
-                            nn + inp.IterationStart(), mm);
-      }
-    }  // loop for nonlinear iterations ---------------------------------------
+    // stop early once monitored forces have converged, writing the solution
+    // and restart data (if restarts are written) of this iteration
+    const auto stop = monitors.Converged();
+    const auto writeOutput = inp.WriteOutput(nn) || stop;
+    const auto writeRestart =
+        inp.WriteRestart(nn) || (stop && inp.RestartFrequency() > 0);
+
+    // each processor accumulates the statistics of its own blocks
+    if (inp.SampleStatistics(nn)) {
+      localSolution.UpdateStatistics(inp, phys);
+    }
 
     // write out function file
-    if (inp.WriteOutput(nn) || inp.WriteRestart(nn)) {
-      // Send/recv solutions
-      solution.GetFinestGridLevel(localSolution, rank, MPI_uncoupledScalar,
-                                  MPI_vec3d, MPI_tensorDouble, inp);
-
-      if (rank == ROOTP && inp.WriteOutput(nn)) {
-        cout << "writing out function file at iteration "
-             << nn + inp.IterationStart()<< endl;
-        // Write out function file
-        WriteOutput(solution.Finest().Blocks(), phys,
-                    (nn + inp.IterationStart() + 1), decomp, inp);
+    if (writeOutput || writeRestart) {
+      // residual normalization is written to restart file
+      logs.FinishResidualReduction(inp, totalCells);
+
+      if (writeOutput) {
+        if (rank == ROOTP) {
+          cout << "writing out function file at iteration "
+               << nn + inp.IterationStart()<< endl;
+        }
+        // nodal and wall variables are found from the recombined blocks, so
+        // the solution must be gathered on ROOT
+        if (gatherOutput) {
+          // Send/recv solutions
+          solution.GetFinestGridLevel(localSolution, rank, MPI_uncoupledScalar,
+                                      MPI_vec3d, MPI_tensorDouble, inp);
+          if (rank == ROOTP) {
+            // Write out function file; blocks and decomposition are copied
+            // so they can be written in the background
+            const auto solIter = nn + inp.IterationStart() + 1;
+            if (writer.IsAsync()) {
+              writer.Push([&phys, &inp, solIter, decomp,
+                           blks = solution.Finest().Blocks()]() {
+                WriteOutput(blks, phys, solIter, decomp, inp);
+              });
+            } else {
+              WriteOutput(solution.Finest().Blocks(), phys, solIter, decomp,
+                          inp);
+            }
+          }
+        } else {
+          // each processor writes its own blocks to function file
+          WriteOutputMPI(localSolution.Finest().Blocks(), phys,
+                         (nn + inp.IterationStart() + 1), decomp, inp, rank,
+                         writer);
+        }
+        if (inp.CollectStatistics()) {
+          WriteStatisticsMPI(localSolution.Finest().Blocks(),
+                             (nn + inp.IterationStart() + 1), decomp, inp,
+                             rank, writer);
+        }
       }
-      if (rank == ROOTP && inp.WriteRestart(nn)) {
-        cout << "writing out restart file at iteration "
-             << nn + inp.IterationStart()<< endl;
-        // Write out restart file
-        WriteRestart(solution.Finest().Blocks(), phys,
+      if (writeRestart) {
+        if (rank == ROOTP) {
+          cout << "writing out restart file at iteration "
+               << nn + inp.IterationStart()<< endl;
+        }
+        // each processor writes its own blocks to restart file
+        WriteRestart(localSolution.Finest().Blocks(), phys,
                      (nn + inp.IterationStart() + 1), decomp, inp,
-                     logs.L2First());
+                     logs.L2First(), rank, writer);
+      }
+    }
+
+    // move blocks between processors if the load is out of balance
+    if (inp.Rebalance(nn)) {
+      const auto moved = localSolution.Rebalance(
+          decomp, tree, inp, phys, rank, MPI_uncoupledScalar, MPI_connection,
+          MPI_vec3d, MPI_vec3dMag, MPI_tensorDouble);
+      // solution is gathered on ROOT from the new processors of moved blocks
+      if (moved && gatherOutput && rank == ROOTP) {
+        solution.AssignFinestDecomposition(decomp);
+      }
+      // buffered samples are written before extractions are found in the
+      // moved blocks
+      if (moved) {
+        extractions.Flush(rank);
+        extractions.Locate(localSolution.Finest().Blocks(), decomp, inp, rank);
       }
     }
     logs.WriteTime(nn);
+
+    if (stop) {
+      if (rank == ROOTP) {
+        cout << "monitors converged at iteration "
+             << nn + inp.IterationStart() << endl;
+      }
+      break;
+    }
   }  // loop for time step -----------------------------------------------------
+  logs.FinishResidualReduction(inp, totalCells);
+  monitors.FinishIntegration();
+  extractions.Flush(rank);
+
+  // wait for output still being written in the background
+  writer.Wait();
 
   if (rank == ROOTP) {
     cout << endl << "Program Complete" << endl;
@@ -310,8 +487,9 @@ int main(int argc, char *argv[]) {
   FreeDataTypesMPI(MPI_vec3d, MPI_procBlockInts, MPI_connection,
                    MPI_DOUBLE_5INT, MPI_vec3dMag, MPI_uncoupledScalar,
                    MPI_tensorDouble);
-  // Free operation previously created
-  MPI_Op_free(&MPI_MAX_LINF);
+  // Free datatype and operation previously created
+  MPI_Type_free(&MPI_residuals);
+  MPI_Op_free(&MPI_REDUCE_RESID);
 
   MPI_Finalize();
 
@@ -17,6 +17,7 @@
 #include <iostream>     // cout
 #include <cstdlib>      // exit()
 #include <vector>
+#include <numeric>      // accumulate
 #include "mgSolution.hpp"
 #include "gridLevel.hpp"
 #include "parallel.hpp"
@@ -27,6 +28,7 @@
 #include "output.hpp"
 #include "resid.hpp"
 #include "vector3d.hpp"
+#include "kdtree.hpp"
 #include "macros.hpp"
 
 using std::cerr;
@@ -41,35 +43,42 @@ mgSolution::mgSolution(const int &numLevels, const int &cycle) {
 }
 
 // member functions
-void mgSolution::ConstructFinestLevel(
+// construct finest level from the blocks local to this processor
+void mgSolution::ConstructLocalFinestLevel(
     const vector<plot3dBlock>& mesh, const vector<boundaryConditions>& bcs,
-    const decomposition& decomp, const physics& phys,
-   const string& restartFile,
-    input& inp, residual& first) {
+    const vector<connection>& connections, const decomposition& decomp,
+    const physics& phys, const int& rank, const input& inp,
+    const MPI_Datatype& MPI_vec3d, const MPI_Datatype& MPI_vec3dMag) {
   MSG_ASSERT(solution_.size() == 0U,
              "should only be called once to initialize");
-  // inputs correspond to finest mesh
-  // get original grid sizes (before decomposition)
-  vector<vector3d<int>> gridSizes;
-  gridSizes.reserve(mesh.size());
-  for (const auto& msh : mesh) {
-    gridSizes.emplace_back(msh.NumCellsI(), msh.NumCellsJ(), msh.NumCellsK());
-  }
+  solution_.emplace_back(mesh, bcs, connections, decomp, phys, rank, inp,
+                         MPI_vec3d, MPI_vec3dMag);
+}
 
-  solution_.emplace_back(mesh, bcs, decomp, phys, gridSizes, restartFile, inp,
-                         first);
+// construct finest level from procBlocks whose geometry is already complete
+void mgSolution::ConstructLocalFinestLevel(
+    vector<procBlock> blocks, const vector<connection>& connections,
+    const physics& phys, const input& inp) {
+  MSG_ASSERT(solution_.size() == 0U,
+             "should only be called once to initialize");
+  solution_.emplace_back(std::move(blocks), connections, phys, inp);
 }
 
-mgSolution mgSolution::SendFinestGridLevel(const int& rank,
-                                           const int& numProcBlock,
-                                           const MPI_Datatype& MPI_vec3d,
-                                           const MPI_Datatype& MPI_vec3dMag,
-                                           const MPI_Datatype& MPI_connection,
-                                           const input& inp) const {
-  mgSolution local(inp);
-  local.solution_.emplace_back(this->Finest().SendGridLevel(
-      rank, numProcBlock, MPI_vec3d, MPI_vec3dMag, MPI_connection, inp));
-  return local;
+// read restart data for the blocks of the finest level on this processor
+void mgSolution::ReadFinestRestart(const string& restartFile,
+                                   const decomposition& decomp, input& inp,
+                                   const physics& phys, residual& first,
+                                   const int& rank) {
+  ReadRestart(solution_[0], restartFile, decomp, inp, phys, first, rank);
+}
+
+mgSolution mgSolution::GatherFinestGridLevel(
+    const decomposition& decomp, const int& rank, const MPI_Datatype& MPI_vec3d,
+    const MPI_Datatype& MPI_vec3dMag, const input& inp) const {
+  mgSolution global;
+  global.solution_.emplace_back(this->Finest().GatherGridLevel(
+      decomp, rank, MPI_vec3d, MPI_vec3dMag, inp));
+  return global;
 }
 
 void mgSolution::GetFinestGridLevel(const mgSolution& local, const int& rank,
@@ -88,9 +97,11 @@ void mgSolution::ConstructMultigrids(const decomposition& decomp,
                                      const MPI_Datatype& MPI_vec3d,
                                      const MPI_Datatype& MPI_vec3dMag) {
   const auto numLevels = solution_.capacity();
+  // coarse levels may be agglomerated onto fewer processors
+  auto levelDecomp = decomp;
   while (solution_.size() < numLevels) {
     solution_.push_back(solution_.back().Coarsen(
-        decomp, inp, phys, rank, MPI_connection, MPI_vec3d, MPI_vec3dMag));
+        levelDecomp, inp, phys, rank, MPI_connection, MPI_vec3d, MPI_vec3dMag));
   }
 }
 
@@ -125,6 +136,94 @@ void mgSolution::SwapWallDist(const int& rank, const int& numGhosts) {
   }
 }
 
+/* Member function to rebalance the load between processors during a
+simulation. The time spent on each block of the finest level since the last
+rebalance is used to calibrate the cell costs of the decomposition. If the load
+is out of balance, whole blocks of the finest level are moved to less loaded
+processors, and the coarse levels are rebuilt from the redistributed finest
+level. Returns true if any blocks were moved.*/
+bool mgSolution::Rebalance(decomposition& decomp, const kdtree& tree,
+                           const input& inp, const physics& phys,
+                           const int& rank,
+                           const MPI_Datatype& MPI_uncoupledScalar,
+                           const MPI_Datatype& MPI_connection,
+                           const MPI_Datatype& MPI_vec3d,
+                           const MPI_Datatype& MPI_vec3dMag,
+                           const MPI_Datatype& MPI_tensorDouble) {
+  // decomp -- decomposition of finest level, updated if blocks are moved
+  // tree -- kdtree of viscous wall faces for coarse level wall distance
+  // inp -- input variables
+  // phys -- physics models
+  // rank -- processor rank
+
+  // get time and number of cells of each block on ROOT
+  auto& finest = solution_[this->FinestIndex()];
+  vector<double> blockTime(decomp.NumBlocks(), 0.0);
+  vector<int> numCells(decomp.NumBlocks(), 0);
+  for (auto bb = 0; bb < finest.NumBlocks(); ++bb) {
+    const auto gp = finest.Block(bb).GlobalPos();
+    blockTime[gp] = finest.BlockTime(bb);
+    numCells[gp] = finest.Block(bb).NumCells();
+  }
+  finest.ResetBlockTimes();
+  if (rank == ROOTP) {
+    MPI_Reduce(MPI_IN_PLACE, blockTime.data(), blockTime.size(), MPI_DOUBLE,
+               MPI_SUM, ROOTP, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, numCells.data(), numCells.size(), MPI_INT,
+               MPI_SUM, ROOTP, MPI_COMM_WORLD);
+  } else {
+    MPI_Reduce(blockTime.data(), blockTime.data(), blockTime.size(),
+               MPI_DOUBLE, MPI_SUM, ROOTP, MPI_COMM_WORLD);
+    MPI_Reduce(numCells.data(), numCells.data(), numCells.size(), MPI_INT,
+               MPI_SUM, ROOTP, MPI_COMM_WORLD);
+  }
+
+  // rebalance on ROOT and send new decomposition to all processors
+  auto newDecomp = decomp;
+  auto numMoved = 0;
+  if (rank == ROOTP) {
+    newDecomp.CalibrateCellCost(blockTime, numCells);
+    numMoved = RebalanceLoad(newDecomp, numCells);
+    if (numMoved > 0) {
+      cout << "Rebalancing load by moving " << numMoved
+           << " blocks between processors" << endl;
+    }
+  }
+  newDecomp.Broadcast();
+  MPI_Bcast(&numMoved, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
+  if (numMoved == 0) {
+    decomp = newDecomp;
+    return false;
+  }
+
+  finest.Redistribute(decomp, newDecomp, rank, inp, MPI_uncoupledScalar,
+                      MPI_vec3d, MPI_vec3dMag, MPI_tensorDouble);
+  decomp = newDecomp;
+
+  // rebuild coarse levels in the same way they were built at startup
+  solution_.erase(std::begin(solution_) + 1, std::end(solution_));
+  this->ConstructMultigrids(decomp, inp, phys, rank, MPI_connection, MPI_vec3d,
+                            MPI_vec3dMag);
+  for (auto ll = 1; ll < this->NumGridLevels(); ++ll) {
+    auto& level = solution_[ll];
+    level.AuxillaryAndWidths(phys);
+    if (tree.Size() > 0) {
+      level.CalcWallDistance(tree);
+      level.SwapWallDist(rank, inp.NumberGhostLayers());
+    }
+    if (inp.NeedToStoreTimeN()) {
+      level.AssignSolToTimeN(phys);
+      if (inp.IsMultilevelInTime()) {
+        level.AssignSolToTimeNm1();
+      }
+    }
+  }
+
+  // jacobians are not sent with the blocks, so they must be rebuilt
+  updateJacobian_ = true;
+  return true;
+}
+
 // multigrid restriction - fine grid to coarse grid operator
 void mgSolution::Restriction(
     const int& fi, const int& mm,
@@ -134,7 +233,7 @@ void mgSolution::Restriction(
   MSG_ASSERT(fi >= 0 && fi < static_cast<int>(solution_.size() - 1),
              "index for restriction out of range");
   solution_[fi].Restriction(solution_[fi + 1], mm, matrixResid, inp, phys, rank,
-                            MPI_tensorDouble, MPI_vec3d);
+                            MPI_tensorDouble, MPI_vec3d, updateJacobian_);
 }
 
 vector<blkMultiArray3d<varArray>> mgSolution::Relax(const int& ll,
@@ -203,7 +302,8 @@ double mgSolution::CycleAtLevel(const int& fl, const int& mm,
     l2Resid += std::accumulate(std::begin(mr), std::end(mr), 0.0);
     totalSize += mr.Size();
   }
-  return l2Resid / totalSize;
+  // agglomerated coarse levels may have no blocks on this processor
+  return totalSize > 0 ? l2Resid / totalSize : 0.0;
 }
 
 double mgSolution::ImplicitUpdate(const input& inp,
@@ -222,8 +322,11 @@ double mgSolution::ImplicitUpdate(const input& inp,
   auto matrixError = 0.0;
 
   // add volume and time term and calculate inverse of main diagonal
+  // if jacobians are reused, the inverse from a prior iteration is kept
   const auto fl = this->FinestIndex();
-  solution_[fl].InvertDiagonal(inp);
+  if (updateJacobian_) {
+    solution_[fl].InvertDiagonal(inp);
+  }
 
   // initialize matrix update
   solution_[fl].InitializeMatrixUpdate(inp, phys);
@@ -235,25 +338,62 @@ double mgSolution::ImplicitUpdate(const input& inp,
   // Update blocks
   solution_[fl].UpdateBlocks(inp, phys, mm, residL2, residLinf);
 
-  // Reset main diagonal on all levels
-  for (auto level = fl; level < this->NumGridLevels(); ++level) {
-    solution_[level].ResetDiagonal();
+  // Reset main diagonal on all levels if it is rebuilt next iteration
+  this->CheckJacobianUpdate(inp, residL2);
+  if (updateJacobian_) {
+    for (auto level = fl; level < this->NumGridLevels(); ++level) {
+      solution_[level].ResetDiagonal();
+    }
   }
 
   return matrixError;
 }
 
+/* Member function to determine if the implicit jacobians should be rebuilt
+for the next iteration. When the jacobianUpdateFrequency option is used, the
+assembled and inverted main diagonals on all grid levels are kept until they
+have been used for the given number of iterations. They are rebuilt early
+whenever the residual of any equation rises, so they are only reused while the
+solution is converging. The decision is made by each processor from its own
+residual, so no communication is added to the iteration. The jacobians of each
+processor only affect the preconditioning of its own blocks, so processors do
+not need to agree on when they are rebuilt.*/
+void mgSolution::CheckJacobianUpdate(const input& inp,
+                                     const residual& residL2) {
+  // inp -- input variables
+  // residL2 -- L2 residual of this processor (sum of squares)
+
+  const auto frequency = inp.JacobianUpdateFrequency();
+  if (frequency <= 1) {
+    updateJacobian_ = true;
+    return;
+  }
+
+  jacobianAge_ = updateJacobian_ ? 1 : jacobianAge_ + 1;
+
+  // get residual of each equation on this processor to compare to last
+  // iteration
+  vector<double> residNorm(std::begin(residL2), std::end(residL2));
+  // jacobians are not reused until residuals can be compared
+  auto residRose = residNorm_.size() != residNorm.size();
+  for (auto ii = 0U; !residRose && ii < residNorm.size(); ++ii) {
+    residRose = residNorm[ii] > residNorm_[ii];
+  }
+  residNorm_ = residNorm;
+
+  updateJacobian_ = jacobianAge_ >= frequency || residRose;
+}
+
 double mgSolution::Iterate(const input& inp, const physics& phys,
                            const MPI_Datatype& MPI_tensorDouble,
                            const MPI_Datatype& MPI_vec3d, const int& mm,
                            const int& rank, residual& residL2,
                            resid& residLinf) {
   const auto fl = this->FinestIndex();
-  // Get boundary conditions for all blocks
-  solution_[fl].GetBoundaryConditions(inp, phys, rank);
-
-  // Calculate residual (RHS)
-  solution_[fl].CalcResidual(phys, inp, rank, MPI_tensorDouble, MPI_vec3d);
+  // Get boundary conditions for all blocks and calculate residual (RHS),
+  // overlapping the ghost cell exchange with the interior fluxes
+  solution_[fl].GetBoundaryConditionsAndResidual(phys, inp, rank,
+                                                 updateJacobian_);
 
   // Calculate time step
   solution_[fl].CalcTimeStep(inp);
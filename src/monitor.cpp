@@ -0,0 +1,165 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <iostream>     // cerr
+#include <fstream>      // ifstream
+#include <vector>       // vector
+#include <string>       // string
+#include <algorithm>    // find
+#include "monitor.hpp"
+#include "inputStates.hpp"  // Tokenize, RemoveTrailing
+
+using std::endl;
+using std::cerr;
+
+// construct monitor from string
+monitor::monitor(string &str) : monitor() {
+  const auto start = str.find("(") + 1;
+  const auto end = str.find(")") - 1;
+  const auto range = end - start + 1;  // +/-1 to ignore ()
+  auto def = str.substr(start, range);
+  const auto type = Trim(str.substr(0, start - 1));
+  if (type != "surface") {
+    cerr << "ERROR. Monitor specifier " << type << " is not recognized!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+  auto tokens = Tokenize(def, ";");
+
+  // erase portion used so multiple monitors in same string can be found
+  str.erase(0, end);
+
+  // parameter counters
+  auto nameCount = 0;
+  auto tagsCount = 0;
+
+  for (auto &token : tokens) {
+    auto param = Tokenize(token, "=");
+    if (param.size() != 2) {
+      cerr << "ERROR. Problem with " << type << " parameter " << token << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    if (param[0] == "name") {
+      name_ = RemoveTrailing(param[1], ",");
+      nameCount++;
+    } else if (param[0] == "tags") {
+      for (const auto &tag : ReadVectorXd(RemoveTrailing(param[1], ","))) {
+        tags_.push_back(static_cast<int>(tag));
+      }
+      tagsCount++;
+    } else if (param[0] == "point") {
+      point_ = ReadVector(RemoveTrailing(param[1], ","));
+    } else {
+      cerr << "ERROR. " << type << " specifier " << param[0]
+           << " is not recognized in monitor definition!" << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  // sanity checks
+  // required variables
+  if (nameCount != 1 || tagsCount != 1) {
+    cerr << "ERROR. For " << type << " 'name' and 'tags' must be specified"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (tags_.empty()) {
+    cerr << "ERROR. Monitor " << name_ << " must have at least one tag"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// member function to determine if boundary surfaces with the given tag are
+// integrated over
+bool monitor::HasTag(const int &tag) const {
+  return std::find(tags_.begin(), tags_.end(), tag) != tags_.end();
+}
+
+// function to print monitor
+ostream &operator<<(ostream &os, const monitor &mon) {
+  os << "surface(name=" << mon.Name() << "; tags=[";
+  for (auto ii = 0U; ii < mon.Tags().size(); ++ii) {
+    os << mon.Tags()[ii];
+    if (ii != mon.Tags().size() - 1) {
+      os << ", ";
+    }
+  }
+  os << "]; point=[" << mon.Point().X() << ", " << mon.Point().Y() << ", "
+     << mon.Point().Z() << "])";
+  return os;
+}
+
+// function to find position of next monitor in string
+string::size_type NextMonitor(const string &str) {
+  return str.find("surface(");
+}
+
+// function to read monitors from input file
+vector<monitor> ReadMonitorList(ifstream &inFile, string &str) {
+  vector<monitor> monitorList;
+  auto openList = false;
+  do {
+    const auto start = openList ? 0 : str.find("<");
+    const auto listOpened = str.find("<") == string::npos ? false : true;
+    const auto end = str.find(">");
+    openList = (end == string::npos) ? true : false;
+
+    // test for monitor on current line
+    // if < or > is alone on a line, should not look for monitor
+    auto monitorPos = NextMonitor(str);
+    if (monitorPos != string::npos) {  // there is a monitor on line
+      string list;
+      if (listOpened && openList) {  // list opened on this line, remains open
+        list = str.substr(start + 1, string::npos);
+      } else if (listOpened && !openList) {  // list opened/closed on this line
+        const auto range = end - start - 1;
+        list = str.substr(start + 1, range);  // +/- 1 to ignore <>
+      } else if (!listOpened && openList) {  // list was open and remains open
+        list = str.substr(start, string::npos);
+      } else {  // list was open and is now closed
+        const auto range = end - start;
+        list = str.substr(start, range);
+      }
+
+      list.erase(0, NextMonitor(list));  // remove text before monitor
+      monitorList.emplace_back(list);
+
+      auto nextMonitor = NextMonitor(list);
+      while (nextMonitor != string::npos) {  // more monitors to read
+        list.erase(0, nextMonitor);  // remove commas separating monitors
+        monitorList.emplace_back(list);
+        nextMonitor = NextMonitor(list);
+      }
+    }
+
+    if (openList) {
+      getline(inFile, str);
+      str = Trim(str);
+    }
+  } while (openList);
+
+  return monitorList;
+}
+
+// function to get the names of the values integrated for each monitor --
+// pressure force, viscous force, moment of total force, heat transfer to
+// surfaces, and mass flow out of domain
+vector<string> MonitorColumns() {
+  return {"Fp-X", "Fp-Y", "Fp-Z", "Fv-X", "Fv-Y", "Fv-Z", "M-X", "M-Y",
+          "M-Z",  "Heat", "MassFlow"};
+}
@@ -0,0 +1,274 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <iostream>     // cerr
+#include <iomanip>      // setw, setprecision
+#include <fstream>      // ofstream
+#include <vector>       // vector
+#include <string>       // string
+#include <array>        // array
+#include <algorithm>    // max, fill
+#include "mpi.h"        // parallelism
+#include "monitorManager.hpp"
+#include "procBlock.hpp"           // procBlock
+#include "boundaryConditions.hpp"  // boundarySurface
+#include "input.hpp"               // input
+#include "physicsModels.hpp"       // physics
+#include "macros.hpp"
+
+using std::endl;
+using std::cerr;
+using std::setw;
+using std::array;
+
+// constructor -- ROOT opens monitor file and writes column headers
+monitorManager::monitorManager(const input &inp, const physics &phys,
+                               const int &rank)
+    : monitors_(inp.Monitors()),
+      rank_(rank),
+      frequency_(inp.MonitorFrequency()),
+      width_(16),
+      lRef_(inp.LRef()),
+      tolerance_(inp.MonitorTolerance()),
+      reduceRequest_(MPI_REQUEST_NULL),
+      reduceIter_(0),
+      converged_(false) {
+  // integrals are found with nondimensional values, so they are scaled by the
+  // reference area -- the wall shear stress and heat flux are the viscous
+  // momentum and energy fluxes, so they have the same scaling as the pressure
+  // and energy flux
+  const auto areaScale = lRef_ * lRef_;
+  const auto forceScale = inp.RRef() * inp.ARef() * inp.ARef() * areaScale;
+  scales_ = {forceScale,
+             forceScale,
+             forceScale,
+             forceScale,
+             forceScale,
+             forceScale,
+             forceScale * lRef_,
+             forceScale * lRef_,
+             forceScale * lRef_,
+             forceScale * inp.ARef(),
+             inp.RRef() * inp.ARef() * areaScale};
+  MSG_ASSERT(scales_.size() == MonitorColumns().size(),
+             "monitor scale size mismatch");
+  reduceBuffer_.resize(this->NumValues());
+
+  if (rank_ != ROOTP || !this->HaveMonitors()) {
+    return;
+  }
+
+  // open monitor file, a restart appends to the file it continues
+  const auto fileName = inp.SimNameRoot() + ".mon";
+  const auto isNew = !inp.IsRestart() || !std::ifstream(fileName).good();
+  if (isNew) {
+    log_.open(fileName, std::ios::out);
+  } else {
+    log_.open(fileName, std::ios::app);
+  }
+  if (log_.fail()) {
+    cerr << "ERROR: Could not open monitor file " << fileName << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // columns are wide enough for longest header
+  const auto columns = MonitorColumns();
+  for (const auto &mon : monitors_) {
+    for (const auto &col : columns) {
+      width_ = std::max(width_, static_cast<int>(mon.Name().length() +
+                                                 col.length() + 2));
+    }
+  }
+
+  // column headers are only written at the top of the file
+  if (isNew) {
+    log_ << std::left << setw(7) << "Step";
+    for (const auto &mon : monitors_) {
+      for (const auto &col : columns) {
+        log_ << setw(width_) << mon.Name() + "-" + col;
+      }
+    }
+    log_ << endl;
+  }
+}
+
+// destructor
+monitorManager::~monitorManager() {
+  if (log_.is_open()) {
+    log_.close();
+  }
+}
+
+/* Member function to integrate all monitors over the blocks on this processor,
+and start summing the integrals on all processors. The integrals of all
+monitors are packed into one buffer so that a single reduction is used. The
+reduction is not waited on until FinishIntegration is called, so its
+communication is overlapped with the iterations between samples.
+*/
+void monitorManager::StartIntegration(const vector<procBlock> &blks,
+                                      const physics &phys, const int &nn) {
+  // blks -- procBlocks on this processor
+  // phys -- physics models
+  // nn -- iteration number
+  MSG_ASSERT(reduceRequest_ == MPI_REQUEST_NULL,
+             "monitor reduction already in progress");
+
+  const auto numCols = scales_.size();
+  std::fill(reduceBuffer_.begin(), reduceBuffer_.end(), 0.0);
+  for (auto mm = 0U; mm < monitors_.size(); ++mm) {
+    const auto point = monitors_[mm].Point() / lRef_;
+    for (const auto &blk : blks) {
+      const auto &bc = blk.BC();
+      for (auto ss = 0; ss < bc.NumSurfaces(); ++ss) {
+        const auto surf = bc.GetSurface(ss);
+        if (!surf.IsConnection() && monitors_[mm].HasTag(surf.Tag())) {
+          IntegrateSurface(blk, surf, phys, point,
+                           &reduceBuffer_[mm * numCols]);
+        }
+      }
+    }
+  }
+  reduceIter_ = nn;
+
+  // all processors need the integrals to check for convergence
+  MPI_Iallreduce(MPI_IN_PLACE, reduceBuffer_.data(), reduceBuffer_.size(),
+                 MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &reduceRequest_);
+}
+
+/* Member function to wait for the reduction started by StartIntegration,
+check the monitors for convergence, and write the dimensional integrals to the
+monitor file on ROOT. If no reduction is in progress nothing is done.
+*/
+void monitorManager::FinishIntegration() {
+  if (reduceRequest_ == MPI_REQUEST_NULL) {
+    return;
+  }
+  MPI_Wait(&reduceRequest_, MPI_STATUS_IGNORE);
+
+  // converged when the change of the pressure force, viscous force, and
+  // moment of every monitor is within the tolerance relative to its magnitude;
+  // heat transfer and mass flow are not checked because they are only noise
+  // on adiabatic walls and closed surfaces
+  const auto numCols = scales_.size();
+  if (tolerance_ > 0.0 && !previous_.empty()) {
+    const array<int, 4> quantities = {0, 3, 6, 9};
+    converged_ = true;
+    for (auto mm = 0U; mm < monitors_.size() && converged_; ++mm) {
+      for (auto qq = 0U; qq < quantities.size() - 1 && converged_; ++qq) {
+        auto magSq = 0.0;
+        auto changeSq = 0.0;
+        for (auto ii = mm * numCols + quantities[qq];
+             ii < mm * numCols + quantities[qq + 1]; ++ii) {
+          magSq += reduceBuffer_[ii] * reduceBuffer_[ii];
+          changeSq += (reduceBuffer_[ii] - previous_[ii]) *
+                      (reduceBuffer_[ii] - previous_[ii]);
+        }
+        converged_ = changeSq <= tolerance_ * tolerance_ * magSq;
+      }
+    }
+  }
+  previous_ = reduceBuffer_;
+
+  if (rank_ != ROOTP) {
+    return;
+  }
+  log_ << std::left << setw(7) << reduceIter_;
+  for (auto ii = 0U; ii < reduceBuffer_.size(); ++ii) {
+    log_ << setw(width_) << std::setprecision(8) << std::scientific
+         << reduceBuffer_[ii] * scales_[ii % numCols];
+  }
+  log_ << endl;
+}
+
+/* Function to add the integrals over a boundary surface to the given
+integrals. Area vectors point in the direction of increasing index, so they
+are flipped on lower surfaces to point out of the domain. The forces are the
+forces of the fluid on the surface, the heat transfer is positive out of the
+fluid, and the mass flow is positive out of the domain. On viscous walls the
+pressure, shear stress, and heat flux are taken from the wall data. On other
+surfaces the pressure and mass flux are averaged from the interior and ghost
+cells next to the face, and there is no viscous force or heat transfer.
+*/
+void IntegrateSurface(const procBlock &blk, const boundarySurface &surf,
+                      const physics &phys, const vector3d<double> &point,
+                      double *vals) {
+  // blk -- procBlock surface is on
+  // surf -- boundary surface to integrate over
+  // phys -- physics models
+  // point -- nondimensional point moments are taken about
+  // vals -- integrals to add to
+
+  const auto surfType = surf.SurfaceType();
+  const auto sign = surf.IsUpper() ? 1.0 : -1.0;
+  const auto isWall = surf.BCType() == "viscousWall";
+  const auto wallInd = isWall ? blk.WallDataIndex(surf) : -1;
+
+  for (auto kk = surf.RangeK().Start(); kk < surf.RangeK().End(); kk++) {
+    for (auto jj = surf.RangeJ().Start(); jj < surf.RangeJ().End(); jj++) {
+      for (auto ii = surf.RangeI().Start(); ii < surf.RangeI().End(); ii++) {
+        // get area and center of face, and cells on either side of it
+        vector3d<double> areaUnit, center;
+        auto areaMag = 0.0;
+        vector3d<int> lower(ii, jj, kk), upper(ii, jj, kk);
+        if (surfType <= 2) {
+          areaUnit = blk.FAreaUnitI(ii, jj, kk);
+          areaMag = blk.FAreaMagI(ii, jj, kk);
+          center = blk.FCenterI(ii, jj, kk);
+          lower[0]--;
+        } else if (surfType <= 4) {
+          areaUnit = blk.FAreaUnitJ(ii, jj, kk);
+          areaMag = blk.FAreaMagJ(ii, jj, kk);
+          center = blk.FCenterJ(ii, jj, kk);
+          lower[1]--;
+        } else {
+          areaUnit = blk.FAreaUnitK(ii, jj, kk);
+          areaMag = blk.FAreaMagK(ii, jj, kk);
+          center = blk.FCenterK(ii, jj, kk);
+          lower[2]--;
+        }
+        const auto area = sign * areaMag * areaUnit;
+
+        vector3d<double> pressureForce, viscousForce;
+        auto heat = 0.0;
+        auto massFlow = 0.0;
+        if (isWall) {
+          pressureForce =
+              blk.WallPressure(wallInd, ii, jj, kk, phys.EoS()) * area;
+          viscousForce =
+              -sign * areaMag * blk.WallShearStress(wallInd, ii, jj, kk);
+          heat = -sign * areaMag * blk.WallHeatFlux(wallInd, ii, jj, kk);
+        } else {
+          const auto stateL = blk.State(lower[0], lower[1], lower[2]);
+          const auto stateU = blk.State(upper[0], upper[1], upper[2]);
+          pressureForce = 0.5 * (stateL.P() + stateU.P()) * area;
+          const auto massFlux = 0.5 * (stateL.Rho() * stateL.Velocity() +
+                                       stateU.Rho() * stateU.Velocity());
+          massFlow = massFlux.DotProd(area);
+        }
+        const auto moment =
+            (center - point).CrossProd(pressureForce + viscousForce);
+
+        for (auto dd = 0; dd < 3; ++dd) {
+          vals[dd] += pressureForce[dd];
+          vals[dd + 3] += viscousForce[dd];
+          vals[dd + 6] += moment[dd];
+        }
+        vals[9] += heat;
+        vals[10] += massFlow;
+      }
+    }
+  }
+}
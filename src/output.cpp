@@ -20,7 +20,10 @@
 #include <vector>
 #include <string>
 #include <utility>  // pair
+#include <array>
 #include <cmath>
+#include <functional>  // function
+#include <algorithm>   // copy
 #include "output.hpp"
 #include "vector3d.hpp"  // vector3d
 #include "multiArray3d.hpp"  // multiArray3d
@@ -37,6 +40,13 @@
 #include "varArray.hpp"            // residual
 #include "utility.hpp"
 #include "gridLevel.hpp"
+#include "outputQueue.hpp"         // outputQueue
+#include "compression.hpp"         // CompressLZ
+#include "macros.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>         // omp_get_max_threads
+#endif
 
 using std::cout;
 using std::endl;
@@ -45,9 +55,11 @@ using std::vector;
 using std::string;
 using std::ios;
 using std::ofstream;
+using std::fstream;
 using std::to_string;
 using std::max;
 using std::pair;
+using std::array;
 using std::setw;
 using std::setprecision;
 
@@ -76,6 +88,8 @@ void WriteCellCenter(const string &gridName, const vector<procBlock> &vars,
 
   // write out x, y, z coordinates of cell centers
   for (auto &blk : recombVars) {  // loop over all blocks
+    vector<double> coords;
+    coords.reserve(3 * blk.NumCells());
     for (auto nn = 0; nn < 3; nn++) {  // loop over dimensions (3)
       for (auto kk = blk.StartK(); kk < blk.EndK(); kk++) {
         for (auto jj = blk.StartJ(); jj < blk.EndJ(); jj++) {
@@ -85,23 +99,83 @@ void WriteCellCenter(const string &gridName, const vector<procBlock> &vars,
 
             // for a given block, first write out all x coordinates, then all y
             // coordinates, then all z coordinates
-            auto dumDouble = dumVec[nn];
-            // write to file
-            outFile.write(reinterpret_cast<char *>(&dumDouble),
-                          sizeof(dumDouble));
+            coords.push_back(dumVec[nn]);
           }
         }
       }
     }
+    // grid precision must match function file precision for Paraview
+    WriteValues(outFile, coords.data(), coords.size(),
+                inp.IsSinglePrecisionOutput());
   }
   // close output file
   outFile.close();
 
   if (inp.NumWallVarsOutput() > 0) {
-    WriteWallFaceCenter(gridName, recombVars, inp.LRef());
+    WriteWallFaceCenter(gridName, recombVars, inp.LRef(),
+                        inp.IsSinglePrecisionOutput());
   }
 }
 
+/* Function to write out the cell centers of the procBlocks on this processor
+in plot3d format. All processors write their procBlocks into the correct
+locations of the parent blocks in the shared file with collective MPI-IO, so
+the grid does not need to be gathered and recombined on ROOT. Wall face centers
+need the recombined parent blocks, so they are written by WriteCellCenter
+instead.*/
+void WriteCellCenterMPI(const string &gridName, const vector<procBlock> &blks,
+                        const decomposition &decomp, const input &inp,
+                        const int &rank, outputQueue &writer) {
+  // gridName -- name of grid file (without extension)
+  // blks -- procBlocks on this processor
+  // decomp -- decomposition
+  // inp -- input variables
+  // rank -- processor rank
+  // writer -- queue to write output in background
+
+  const auto parentCells = ParentBlockCells(blks, decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
+  const auto writeName = gridName + "_center.xyz";
+
+  // header is written by ROOT before the blocks are written
+  MPI_Offset headerSize = 0;
+  if (rank == ROOTP) {
+    ofstream outFile(writeName, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Grid file " << writeName << " did not open correctly!!!"
+           << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    WriteBlockDims(outFile, parentCells);
+    headerSize = outFile.tellp();
+  }
+  MPI_Bcast(&headerSize, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
+
+  // all x coordinates of a block are written, then y, then z (dimensionalized)
+  vector<cellExtractor> coords;
+  for (auto dd = 0; dd < 3; ++dd) {
+    coords.push_back([dd, &inp](const procBlock &blk, const int &ii,
+                                const int &jj, const int &kk) {
+      return blk.Center(ii, jj, kk)[dd] * inp.LRef();
+    });
+  }
+
+  const auto numBlks = static_cast<int>(blks.size());
+  vector<vector<double>> values(numBlks);
+#pragma omp parallel for schedule(dynamic) if (ThreadOverOutputBlocks(numBlks))
+  for (auto bb = 0; bb < numBlks; ++bb) {
+    values[bb] = CellValues(blks[bb], coords, true);
+  }
+
+  // grid precision must match function file precision for Paraview
+  WriteSplitValues(blks, std::move(values), parentCells, ranges, decomp,
+                   writeName, headerSize, 3, true,
+                   inp.IsSinglePrecisionOutput(), writer);
+}
+
 // function to write out cell centers of grid in plot3d format
 void WriteNodes(const string &gridName, const vector<plot3dBlock> &blks) {
   // open binary output file
@@ -144,7 +218,7 @@ void WriteNodes(const string &gridName, const vector<plot3dBlock> &blks) {
 
 // function to write out wall face centers of grid in plot3d format
 void WriteWallFaceCenter(const string &gridName, const vector<procBlock> &vars,
-                         const double &LRef) {
+                         const double &LRef, const bool &isSingle) {
   // open binary output file
   const string fEnd = "_wall_center";
   const string fPostfix = ".xyz";
@@ -180,6 +254,8 @@ void WriteWallFaceCenter(const string &gridName, const vector<procBlock> &vars,
 
   // write out x, y, z coordinates of cell centers
   for (auto &wBlk : wallCenters) {  // loop over all blocks
+    vector<double> coords;
+    coords.reserve(3 * wBlk.NumBlocks());
     for (auto nn = 0; nn < 3; nn++) {  // loop over dimensions (3)
       for (auto kk = wBlk.StartK(); kk < wBlk.EndK(); kk++) {
         for (auto jj = wBlk.StartJ(); jj < wBlk.EndJ(); jj++) {
@@ -189,14 +265,12 @@ void WriteWallFaceCenter(const string &gridName, const vector<procBlock> &vars,
 
             // for a given block, first write out all x coordinates, then all y
             // coordinates, then all z coordinates
-            auto dumDouble = dumVec[nn];
-            // write to file
-            outFile.write(reinterpret_cast<char *>(&dumDouble),
-                          sizeof(dumDouble));
+            coords.push_back(dumVec[nn]);
           }
         }
       }
     }
+    WriteValues(outFile, coords.data(), coords.size(), isSingle);
   }
 
   // close output file
@@ -204,12 +278,557 @@ void WriteWallFaceCenter(const string &gridName, const vector<procBlock> &vars,
 }
 
 
+/* Function to resolve the name of a function file variable into a function
+that returns the dimensional value of the variable at a cell of a procBlock.
+The name is only compared once, instead of at every cell that is written.*/
+cellExtractor FunctionExtractor(const string &var, const physics &phys,
+                                const input &inp) {
+  // var -- name of variable
+  // phys -- physics models
+  // inp -- input variables
+
+  const auto rRef = inp.RRef();
+  const auto aRef = inp.ARef();
+  const auto tRef = inp.TRef();
+  const auto lRef = inp.LRef();
+  const auto muRef = phys.Transport()->MuRef();
+
+  if (var == "density") {
+    return [scale = rRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).Rho() * scale;
+    };
+  } else if (var == "vel_x") {
+    return [scale = aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).U() * scale;
+    };
+  } else if (var == "vel_y") {
+    return [scale = aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).V() * scale;
+    };
+  } else if (var == "vel_z") {
+    return [scale = aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).W() * scale;
+    };
+  } else if (var == "pressure") {
+    return [scale = rRef * aRef * aRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.State(i, j, k).P() * scale;
+    };
+  } else if (var == "mach") {
+    return [&phys](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).Velocity().Mag() / b.State(i, j, k).SoS(phys);
+    };
+  } else if (var == "sos") {
+    return [&phys, scale = aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).SoS(phys) * scale;
+    };
+  } else if (var == "dt") {
+    return [scale = aRef * lRef](const procBlock &b, int i, int j, int k) {
+      return b.Dt(i, j, k) / scale;
+    };
+  } else if (var == "temperature") {
+    return [scale = tRef](const procBlock &b, int i, int j, int k) {
+      return b.Temperature(i, j, k) * scale;
+    };
+  } else if (var == "energy") {
+    return [&phys, scale = aRef * aRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.State(i, j, k).Energy(phys) * scale;
+    };
+  } else if (var == "enthalpy") {
+    return [&phys, scale = aRef * aRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.State(i, j, k).Enthalpy(phys) * scale;
+    };
+  } else if (var == "cp") {
+    return [&phys, scale = aRef * aRef / tRef](const procBlock &b, int i,
+                                               int j, int k) {
+      return phys.Thermodynamic()->Cp(b.Temperature(i, j, k),
+                                      b.State(i, j, k).MassFractions()) *
+             scale;
+    };
+  } else if (var == "cv") {
+    return [&phys, scale = aRef * aRef / tRef](const procBlock &b, int i,
+                                               int j, int k) {
+      return phys.Thermodynamic()->Cv(b.Temperature(i, j, k),
+                                      b.State(i, j, k).MassFractions()) *
+             scale;
+    };
+  } else if (var == "rank") {
+    return [](const procBlock &b, int i, int j, int k) {
+      return static_cast<double>(b.Rank());
+    };
+  } else if (var == "globalPosition") {
+    return [](const procBlock &b, int i, int j, int k) {
+      return static_cast<double>(b.GlobalPos());
+    };
+  } else if (var == "viscosityRatio") {
+    return [](const procBlock &b, int i, int j, int k) {
+      return b.IsTurbulent() ? b.EddyViscosity(i, j, k) / b.Viscosity(i, j, k)
+                             : 0.0;
+    };
+  } else if (var == "turbulentViscosity") {
+    return [scale = muRef](const procBlock &b, int i, int j, int k) {
+      return b.EddyViscosity(i, j, k) * scale;
+    };
+  } else if (var == "viscosity") {
+    return [scale = muRef](const procBlock &b, int i, int j, int k) {
+      return b.Viscosity(i, j, k) * scale;
+    };
+  } else if (var == "tke") {
+    return [scale = aRef * aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).Tke() * scale;
+    };
+  } else if (var == "sdr") {
+    return [scale = aRef * aRef * rRef / muRef](const procBlock &b, int i,
+                                                int j, int k) {
+      return b.State(i, j, k).Omega() * scale;
+    };
+  } else if (var == "f1") {
+    return [](const procBlock &b, int i, int j, int k) {
+      return b.F1(i, j, k);
+    };
+  } else if (var == "f2") {
+    return [](const procBlock &b, int i, int j, int k) {
+      return b.F2(i, j, k);
+    };
+  } else if (var == "wallDistance") {
+    return [scale = lRef](const procBlock &b, int i, int j, int k) {
+      return b.WallDist(i, j, k) * scale;
+    };
+  } else if (var == "velGrad_ux") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).XX() * scale;
+    };
+  } else if (var == "velGrad_vx") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).XY() * scale;
+    };
+  } else if (var == "velGrad_wx") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).XZ() * scale;
+    };
+  } else if (var == "velGrad_uy") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).YX() * scale;
+    };
+  } else if (var == "velGrad_vy") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).YY() * scale;
+    };
+  } else if (var == "velGrad_wy") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).YZ() * scale;
+    };
+  } else if (var == "velGrad_uz") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).ZX() * scale;
+    };
+  } else if (var == "velGrad_vz") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).ZY() * scale;
+    };
+  } else if (var == "velGrad_wz") {
+    return [scale = aRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.VelGrad(i, j, k).ZZ() * scale;
+    };
+  } else if (var == "tempGrad_x") {
+    return [scale = tRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.TempGrad(i, j, k).X() * scale;
+    };
+  } else if (var == "tempGrad_y") {
+    return [scale = tRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.TempGrad(i, j, k).Y() * scale;
+    };
+  } else if (var == "tempGrad_z") {
+    return [scale = tRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.TempGrad(i, j, k).Z() * scale;
+    };
+  } else if (var == "densityGrad_x") {
+    return [scale = rRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.DensityGrad(i, j, k).X() * scale;
+    };
+  } else if (var == "densityGrad_y") {
+    return [scale = rRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.DensityGrad(i, j, k).Y() * scale;
+    };
+  } else if (var == "densityGrad_z") {
+    return [scale = rRef / lRef](const procBlock &b, int i, int j, int k) {
+      return b.DensityGrad(i, j, k).Z() * scale;
+    };
+  } else if (var == "pressGrad_x") {
+    return [scale = rRef * aRef * aRef / lRef](const procBlock &b, int i,
+                                               int j, int k) {
+      return b.PressureGrad(i, j, k).X() * scale;
+    };
+  } else if (var == "pressGrad_y") {
+    return [scale = rRef * aRef * aRef / lRef](const procBlock &b, int i,
+                                               int j, int k) {
+      return b.PressureGrad(i, j, k).Y() * scale;
+    };
+  } else if (var == "pressGrad_z") {
+    return [scale = rRef * aRef * aRef / lRef](const procBlock &b, int i,
+                                               int j, int k) {
+      return b.PressureGrad(i, j, k).Z() * scale;
+    };
+  } else if (var == "tkeGrad_x") {
+    return [scale = aRef * aRef / lRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.TkeGrad(i, j, k).X() * scale;
+    };
+  } else if (var == "tkeGrad_y") {
+    return [scale = aRef * aRef / lRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.TkeGrad(i, j, k).Y() * scale;
+    };
+  } else if (var == "tkeGrad_z") {
+    return [scale = aRef * aRef / lRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.TkeGrad(i, j, k).Z() * scale;
+    };
+  } else if (var == "omegaGrad_x") {
+    return [scale = aRef * aRef * rRef / (muRef * lRef)](
+               const procBlock &b, int i, int j, int k) {
+      return b.OmegaGrad(i, j, k).X() * scale;
+    };
+  } else if (var == "omegaGrad_y") {
+    return [scale = aRef * aRef * rRef / (muRef * lRef)](
+               const procBlock &b, int i, int j, int k) {
+      return b.OmegaGrad(i, j, k).Y() * scale;
+    };
+  } else if (var == "omegaGrad_z") {
+    return [scale = aRef * aRef * rRef / (muRef * lRef)](
+               const procBlock &b, int i, int j, int k) {
+      return b.OmegaGrad(i, j, k).Z() * scale;
+    };
+  } else if (var == "resid_mass") {
+    return [scale = rRef * aRef * lRef * lRef](const procBlock &b, int i,
+                                               int j, int k) {
+      return b.Residual(i, j, k, 0) * scale;
+    };
+  } else if (var == "resid_mom_x") {
+    return [scale = rRef * aRef * aRef * lRef * lRef](const procBlock &b,
+                                                      int i, int j, int k) {
+      return b.Residual(i, j, k, 1) * scale;
+    };
+  } else if (var == "resid_mom_y") {
+    return [scale = rRef * aRef * aRef * lRef * lRef](const procBlock &b,
+                                                      int i, int j, int k) {
+      return b.Residual(i, j, k, 2) * scale;
+    };
+  } else if (var == "resid_mom_z") {
+    return [scale = rRef * aRef * aRef * lRef * lRef](const procBlock &b,
+                                                      int i, int j, int k) {
+      return b.Residual(i, j, k, 3) * scale;
+    };
+  } else if (var == "resid_energy") {
+    return [scale = rRef * pow(aRef, 3.0) * lRef * lRef](
+               const procBlock &b, int i, int j, int k) {
+      return b.Residual(i, j, k, 4) * scale;
+    };
+  } else if (var == "resid_tke") {
+    return [scale = rRef * pow(aRef, 3.0) * lRef * lRef](
+               const procBlock &b, int i, int j, int k) {
+      return b.Residual(i, j, k, 5) * scale;
+    };
+  } else if (var == "resid_sdr") {
+    return [scale = rRef * rRef * pow(aRef, 4.0) * lRef * lRef / muRef](
+               const procBlock &b, int i, int j, int k) {
+      return b.Residual(i, j, k, 6) * scale;
+    };
+  } else if (var.substr(0, 3) == "mf_" &&
+             inp.HaveSpecies(var.substr(3, string::npos))) {
+    const auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
+    return [ind](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).MassFractionN(ind);
+    };
+  } else if (var.substr(0, 3) == "vf_" &&
+             inp.HaveSpecies(var.substr(3, string::npos))) {
+    const auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
+    return [&phys, ind](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).VolumeFractions(phys.Transport())[ind];
+    };
+  } else {
+    cerr << "ERROR: Variable " << var
+         << " to write to function file is not defined!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Function to resolve the name of a restart file variable into a function
+that returns the dimensional value of the variable at a cell of a procBlock.*/
+cellExtractor RestartExtractor(const string &var, const physics &phys,
+                               const input &inp) {
+  // var -- name of variable
+  // phys -- physics models
+  // inp -- input variables
+
+  const auto rRef = inp.RRef();
+  const auto aRef = inp.ARef();
+  const auto muRef = phys.Transport()->MuRef();
+
+  if (var == "density") {
+    return [scale = rRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).Rho() * scale;
+    };
+  } else if (var == "vel_x") {
+    return [scale = aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).U() * scale;
+    };
+  } else if (var == "vel_y") {
+    return [scale = aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).V() * scale;
+    };
+  } else if (var == "vel_z") {
+    return [scale = aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).W() * scale;
+    };
+  } else if (var == "pressure") {
+    return [scale = rRef * aRef * aRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.State(i, j, k).P() * scale;
+    };
+  } else if (var == "tke") {
+    return [scale = aRef * aRef](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).Tke() * scale;
+    };
+  } else if (var == "sdr") {
+    return [scale = aRef * aRef * rRef / muRef](const procBlock &b, int i,
+                                                int j, int k) {
+      return b.State(i, j, k).Omega() * scale;
+    };
+  } else if (var.substr(0, 3) == "mf_" &&
+             inp.HaveSpecies(var.substr(3, string::npos))) {
+    const auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
+    return [ind](const procBlock &b, int i, int j, int k) {
+      return b.State(i, j, k).MassFractionN(ind);
+    };
+  } else {
+    cerr << "ERROR: Variable " << var
+         << " to write to restart file is not defined!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Function to resolve the name of a restart file variable into a function
+that returns the dimensional value of the variable at a cell of a procBlock at
+time n-1. These variables are conserved variables.*/
+cellExtractor RestartNm1Extractor(const string &var, const physics &phys,
+                                  const input &inp) {
+  // var -- name of variable
+  // phys -- physics models
+  // inp -- input variables
+
+  const auto rRef = inp.RRef();
+  const auto aRef = inp.ARef();
+  const auto muRef = phys.Transport()->MuRef();
+
+  if (var == "density") {
+    return [scale = rRef](const procBlock &b, int i, int j, int k) {
+      return b.ConsVarsNm1(i, j, k)[0] * scale;
+    };
+  } else if (var == "vel_x") {  // conserved var is rho-u
+    return [scale = aRef * rRef](const procBlock &b, int i, int j, int k) {
+      return b.ConsVarsNm1(i, j, k)[1] * scale;
+    };
+  } else if (var == "vel_y") {  // conserved var is rho-v
+    return [scale = aRef * rRef](const procBlock &b, int i, int j, int k) {
+      return b.ConsVarsNm1(i, j, k)[2] * scale;
+    };
+  } else if (var == "vel_z") {  // conserved var is rho-w
+    return [scale = aRef * rRef](const procBlock &b, int i, int j, int k) {
+      return b.ConsVarsNm1(i, j, k)[3] * scale;
+    };
+  } else if (var == "pressure") {  // conserved var is rho-E
+    return [scale = aRef * aRef * rRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.ConsVarsNm1(i, j, k)[4] * scale;
+    };
+  } else if (var == "tke") {  // conserved var is rho-tke
+    return [scale = aRef * aRef * rRef](const procBlock &b, int i, int j,
+                                        int k) {
+      return b.ConsVarsNm1(i, j, k)[5] * scale;
+    };
+  } else if (var == "sdr") {  // conserved var is rho-sdr
+    return [scale = aRef * aRef * rRef * rRef / muRef](const procBlock &b,
+                                                       int i, int j, int k) {
+      return b.ConsVarsNm1(i, j, k)[6] * scale;
+    };
+  } else if (var.substr(0, 3) == "mf_" &&
+             inp.HaveSpecies(var.substr(3, string::npos))) {
+    const auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
+    return [ind](const procBlock &b, int i, int j, int k) {
+      return b.ConsVarsNm1(i, j, k).MassFractionN(ind);
+    };
+  } else {
+    cerr << "ERROR: Variable " << var
+         << " to write to restart file is not defined!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Function to resolve the name of a wall function file variable into a
+function that returns the dimensional value of the variable at a face of a
+wall surface of a procBlock.*/
+wallExtractor WallExtractor(const string &var, const physics &phys,
+                            const input &inp) {
+  // var -- name of variable
+  // phys -- physics models
+  // inp -- input variables
+
+  const auto rRef = inp.RRef();
+  const auto aRef = inp.ARef();
+  const auto tRef = inp.TRef();
+  const auto lRef = inp.LRef();
+  const auto muRef = phys.Transport()->MuRef();
+  const auto invScale = phys.Transport()->InvNondimScaling();
+
+  if (var == "yplus") {
+    return [](const procBlock &b, int l, int i, int j, int k) {
+      return b.WallYplus(l, i, j, k);
+    };
+  } else if (var == "shearStress") {
+    return [scale = invScale * muRef * aRef / lRef](const procBlock &b, int l,
+                                                    int i, int j, int k) {
+      return b.WallShearStress(l, i, j, k).Mag() * scale;
+    };
+  } else if (var == "viscosityRatio") {
+    return [](const procBlock &b, int l, int i, int j, int k) {
+      return b.WallEddyVisc(l, i, j, k) / (b.WallViscosity(l, i, j, k) + EPS);
+    };
+  } else if (var == "heatFlux") {
+    return [scale = muRef * tRef / lRef](const procBlock &b, int l, int i,
+                                         int j, int k) {
+      return b.WallHeatFlux(l, i, j, k) * scale;
+    };
+  } else if (var == "frictionVelocity") {
+    return [scale = aRef](const procBlock &b, int l, int i, int j, int k) {
+      return b.WallFrictionVelocity(l, i, j, k) * scale;
+    };
+  } else if (var == "density") {
+    return [scale = rRef](const procBlock &b, int l, int i, int j, int k) {
+      return b.WallDensity(l, i, j, k) * scale;
+    };
+  } else if (var == "pressure") {
+    return [&phys, scale = rRef * aRef * aRef](const procBlock &b, int l,
+                                               int i, int j, int k) {
+      return b.WallPressure(l, i, j, k, phys.EoS()) * scale;
+    };
+  } else if (var == "temperature") {
+    return [scale = tRef](const procBlock &b, int l, int i, int j, int k) {
+      return b.WallTemperature(l, i, j, k) * scale;
+    };
+  } else if (var == "viscosity") {
+    return [scale = muRef * invScale](const procBlock &b, int l, int i, int j,
+                                      int k) {
+      return b.WallViscosity(l, i, j, k) * scale;
+    };
+  } else if (var == "tke") {
+    return [scale = aRef * aRef](const procBlock &b, int l, int i, int j,
+                                 int k) {
+      return b.WallTke(l, i, j, k) * scale;
+    };
+  } else if (var == "sdr") {
+    return [scale = aRef * aRef * rRef / muRef](const procBlock &b, int l,
+                                                int i, int j, int k) {
+      return b.WallSdr(l, i, j, k) * scale;
+    };
+  } else {
+    cerr << "ERROR: Variable " << var
+         << " to write to wall function file is not defined!" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// function to determine if output variables are evaluated with one thread per
+// block, or with all threads on each block in turn
+bool ThreadOverOutputBlocks(const int &numBlocks) {
+  // numBlocks -- number of blocks to evaluate
+#ifdef _OPENMP
+  return numBlocks >= omp_get_max_threads();
+#else
+  return false;
+#endif
+}
+
+/* Function to evaluate variables over the physical cells of a procBlock into a
+contiguous buffer. The variables are either ordered variable by variable
+(function files), or cell by cell (restart files). Planes of cells are
+evaluated concurrently unless this is called from a parallel region over
+blocks.*/
+vector<double> CellValues(const procBlock &blk,
+                          const vector<cellExtractor> &vars,
+                          const bool &varMajor) {
+  // blk -- procBlock to evaluate variables over
+  // vars -- variables to evaluate
+  // varMajor -- flag that is true if variables are ordered variable by variable
+
+  const auto numVars = static_cast<int>(vars.size());
+  const auto numI = blk.NumI();
+  const auto numJ = blk.NumJ();
+  const auto numK = blk.NumK();
+  const auto planeSize = numI * numJ;
+  vector<double> values(planeSize * numK * numVars);
+
+  if (varMajor) {
+#pragma omp parallel for schedule(dynamic)
+    for (auto vk = 0; vk < numVars * numK; ++vk) {
+      const auto &var = vars[vk / numK];
+      const auto kk = blk.StartK() + vk % numK;
+      auto nn = vk * planeSize;
+      for (auto jj = blk.StartJ(); jj < blk.EndJ(); jj++) {
+        for (auto ii = blk.StartI(); ii < blk.EndI(); ii++) {
+          values[nn++] = var(blk, ii, jj, kk);
+        }
+      }
+    }
+  } else {
+#pragma omp parallel for schedule(dynamic)
+    for (auto kk = blk.StartK(); kk < blk.EndK(); kk++) {
+      auto nn = (kk - blk.StartK()) * planeSize * numVars;
+      for (auto jj = blk.StartJ(); jj < blk.EndJ(); jj++) {
+        for (auto ii = blk.StartI(); ii < blk.EndI(); ii++) {
+          for (const auto &var : vars) {
+            values[nn++] = var(blk, ii, jj, kk);
+          }
+        }
+      }
+    }
+  }
+  return values;
+}
+
+/* Function to evaluate variables over the wall surfaces of a procBlock into a
+contiguous buffer. For each variable the values on each wall surface are
+ordered one after another.*/
+vector<double> WallValues(const procBlock &blk,
+                          const vector<wallExtractor> &vars) {
+  // blk -- procBlock to evaluate variables over
+  // vars -- variables to evaluate
+
+  vector<double> values;
+  for (const auto &var : vars) {
+    for (auto ll = 0; ll < blk.WallDataSize(); ++ll) {
+      const auto surf = blk.WallSurface(ll);
+      for (auto kk = surf.RangeK().Start(); kk < surf.RangeK().End(); kk++) {
+        for (auto jj = surf.RangeJ().Start(); jj < surf.RangeJ().End(); jj++) {
+          for (auto ii = surf.RangeI().Start(); ii < surf.RangeI().End();
+               ii++) {
+            values.push_back(var(blk, ll, ii, jj, kk));
+          }
+        }
+      }
+    }
+  }
+  return values;
+}
+
 //----------------------------------------------------------------------
 // function to write out variables in function file format
 void WriteFunFile(const vector<procBlock> &vars,
                   const vector<procBlock> &recombVars, const physics &phys,
                   const decomposition &decomp, const string &writeName,
-                  const input &inp) {
+                  const input &inp, const bool &isSingle) {
   // open binary plot3d function file
   ofstream outFile(writeName, ios::out | ios::binary);
 
@@ -222,213 +841,43 @@ void WriteFunFile(const vector<procBlock> &vars,
 
   WriteBlockDims(outFile, recombVars, inp.NumVarsOutput());
 
-  // write out variables
-  auto ll = 0;
-  for (auto &blk : recombVars) {  // loop over all blocks
-    // loop over the number of variables to write out
-    for (auto &var : inp.OutputVariables()) {
-      // write out dimensional variables -- loop over physical cells
-      for (auto kk = blk.StartK(); kk < blk.EndK(); kk++) {
-        for (auto jj = blk.StartJ(); jj < blk.EndJ(); jj++) {
-          for (auto ii = blk.StartI(); ii < blk.EndI(); ii++) {
-            auto value = 0.0;
-            if (var == "density") {
-              value = blk.State(ii, jj, kk).Rho();
-              value *= inp.RRef();
-            } else if (var == "vel_x") {
-              value = blk.State(ii, jj, kk).U();
-              value *= inp.ARef();
-            } else if (var == "vel_y") {
-              value = blk.State(ii, jj, kk).V();
-              value *= inp.ARef();
-            } else if (var == "vel_z") {
-              value = blk.State(ii, jj, kk).W();
-              value *= inp.ARef();
-            } else if (var == "pressure") {
-              value = blk.State(ii, jj, kk).P();
-              value *= inp.RRef() * inp.ARef() * inp.ARef();
-            } else if (var == "mach") {
-              auto vel = blk.State(ii, jj, kk).Velocity();
-              value = vel.Mag() / blk.State(ii, jj, kk).SoS(phys);
-            } else if (var == "sos") {
-              value = blk.State(ii, jj, kk).SoS(phys);
-              value *= inp.ARef();
-            } else if (var == "dt") {
-              value = blk.Dt(ii, jj, kk);
-              value /= inp.ARef() * inp.LRef();
-            } else if (var == "temperature") {
-              value = blk.Temperature(ii, jj, kk);
-              value *= inp.TRef();
-            } else if (var == "energy") {
-              value = blk.State(ii, jj, kk).Energy(phys);
-              value *= inp.ARef() * inp.ARef();
-            } else if (var == "enthalpy") {
-              value = blk.State(ii, jj, kk).Enthalpy(phys);
-              value *= inp.ARef() * inp.ARef();
-            } else if (var == "cp") {
-              value = phys.Thermodynamic()->Cp(
-                  blk.Temperature(ii, jj, kk),
-                  blk.State(ii, jj, kk).MassFractions());
-              value *= inp.ARef() * inp.ARef() / inp.TRef();
-            } else if (var == "cv") {
-              value = phys.Thermodynamic()->Cv(
-                  blk.Temperature(ii, jj, kk),
-                  blk.State(ii, jj, kk).MassFractions());
-              value *= inp.ARef() * inp.ARef() / inp.TRef();
-            } else if (var == "rank") {
-              value = vars[SplitBlockNumber(recombVars, decomp,
-                                            ll, ii, jj, kk)].Rank();
-            } else if (var == "globalPosition") {
-              value = vars[SplitBlockNumber(recombVars, decomp,
-                                            ll, ii, jj, kk)].GlobalPos();
-            } else if (var == "viscosityRatio") {
-              value = blk.IsTurbulent() ?
-                  blk.EddyViscosity(ii, jj, kk) /
-                  blk.Viscosity(ii, jj, kk)
-                  : 0.0;
-            } else if (var == "turbulentViscosity") {
-              value = blk.EddyViscosity(ii, jj, kk);
-              value *= phys.Transport()->MuRef();
-            } else if (var == "viscosity") {
-              value = blk.Viscosity(ii, jj, kk);
-              value *= phys.Transport()->MuRef();
-            } else if (var == "tke") {
-              value = blk.State(ii, jj, kk).Tke();
-              value *= inp.ARef() * inp.ARef();
-            } else if (var == "sdr") {
-              value = blk.State(ii, jj, kk).Omega();
-              value *= inp.ARef() * inp.ARef() * inp.RRef() /
-                       phys.Transport()->MuRef();
-            } else if (var == "f1") {
-              value = blk.F1(ii, jj, kk);
-            } else if (var == "f2") {
-              value = blk.F2(ii, jj, kk);
-            } else if (var == "wallDistance") {
-              value = blk.WallDist(ii, jj, kk);
-              value *= inp.LRef();
-            } else if (var == "velGrad_ux") {
-              value = blk.VelGrad(ii, jj, kk).XX();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_vx") {
-              value = blk.VelGrad(ii, jj, kk).XY();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_wx") {
-              value = blk.VelGrad(ii, jj, kk).XZ();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_uy") {
-              value = blk.VelGrad(ii, jj, kk).YX();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_vy") {
-              value = blk.VelGrad(ii, jj, kk).YY();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_wy") {
-              value = blk.VelGrad(ii, jj, kk).YZ();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_uz") {
-              value = blk.VelGrad(ii, jj, kk).ZX();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_vz") {
-              value = blk.VelGrad(ii, jj, kk).ZY();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "velGrad_wz") {
-              value = blk.VelGrad(ii, jj, kk).ZZ();
-              value *= inp.ARef() / inp.LRef();
-            } else if (var == "tempGrad_x") {
-              value = blk.TempGrad(ii, jj, kk).X();
-              value *= inp.TRef() / inp.LRef();
-            } else if (var == "tempGrad_y") {
-              value = blk.TempGrad(ii, jj, kk).Y();
-              value *= inp.TRef() / inp.LRef();
-            } else if (var == "tempGrad_z") {
-              value = blk.TempGrad(ii, jj, kk).Z();
-              value *= inp.TRef() / inp.LRef();
-            } else if (var == "densityGrad_x") {
-              value = blk.DensityGrad(ii, jj, kk).X();
-              value *= inp.RRef() / inp.LRef();
-            } else if (var == "densityGrad_y") {
-              value = blk.DensityGrad(ii, jj, kk).Y();
-              value *= inp.RRef() / inp.LRef();
-            } else if (var == "densityGrad_z") {
-              value = blk.DensityGrad(ii, jj, kk).Z();
-              value *= inp.RRef() / inp.LRef();
-            } else if (var == "pressGrad_x") {
-              value = blk.PressureGrad(ii, jj, kk).X();
-              value *= inp.RRef() * inp.ARef() * inp.ARef() / inp.LRef();
-            } else if (var == "pressGrad_y") {
-              value = blk.PressureGrad(ii, jj, kk).Y();
-              value *= inp.RRef() * inp.ARef() * inp.ARef() / inp.LRef();
-            } else if (var == "pressGrad_z") {
-              value = blk.PressureGrad(ii, jj, kk).Z();
-              value *= inp.RRef() * inp.ARef() * inp.ARef() / inp.LRef();
-            } else if (var == "tkeGrad_x") {
-              value = blk.TkeGrad(ii, jj, kk).X();
-              value *= inp.ARef() * inp.ARef() / inp.LRef();
-            } else if (var == "tkeGrad_y") {
-              value = blk.TkeGrad(ii, jj, kk).Y();
-              value *= inp.ARef() * inp.ARef() / inp.LRef();
-            } else if (var == "tkeGrad_z") {
-              value = blk.TkeGrad(ii, jj, kk).Z();
-              value *= inp.ARef() * inp.ARef() / inp.LRef();
-            } else if (var == "omegaGrad_x") {
-              value = blk.OmegaGrad(ii, jj, kk).X();
-              value *= inp.ARef() * inp.ARef() * inp.RRef() /
-                  (phys.Transport()->MuRef() * inp.LRef());
-            } else if (var == "omegaGrad_y") {
-              value = blk.OmegaGrad(ii, jj, kk).Y();
-              value *= inp.ARef() * inp.ARef() * inp.RRef() /
-                  (phys.Transport()->MuRef() * inp.LRef());
-            } else if (var == "omegaGrad_z") {
-              value = blk.OmegaGrad(ii, jj, kk).Z();
-              value *= inp.ARef() * inp.ARef() * inp.RRef() /
-                  (phys.Transport()->MuRef() * inp.LRef());
-            } else if (var == "resid_mass") {
-              value = blk.Residual(ii, jj, kk, 0);
-              value *= inp.RRef() * inp.ARef() * inp.LRef() * inp.LRef();
-            } else if (var == "resid_mom_x") {
-              value = blk.Residual(ii, jj, kk, 1);
-              value *= inp.RRef() * inp.ARef() * inp.ARef() * inp.LRef() *
-                  inp.LRef();
-            } else if (var == "resid_mom_y") {
-              value = blk.Residual(ii, jj, kk, 2);
-              value *= inp.RRef() * inp.ARef() * inp.ARef() * inp.LRef() *
-                  inp.LRef();
-            } else if (var == "resid_mom_z") {
-              value = blk.Residual(ii, jj, kk, 3);
-              value *= inp.RRef() * inp.ARef() * inp.ARef() * inp.LRef() *
-                  inp.LRef();
-            } else if (var == "resid_energy") {
-              value = blk.Residual(ii, jj, kk, 4);
-              value *= inp.RRef() * pow(inp.ARef(), 3.0) * inp.LRef() *
-                  inp.LRef();
-            } else if (var == "resid_tke") {
-              value = blk.Residual(ii, jj, kk, 5);
-              value *= inp.RRef() * pow(inp.ARef(), 3.0) * inp.LRef() *
-                  inp.LRef();
-            } else if (var == "resid_sdr") {
-              value = blk.Residual(ii, jj, kk, 6);
-              value *= inp.RRef() * inp.RRef() * pow(inp.ARef(), 4.0) *
-                  inp.LRef() * inp.LRef() / phys.Transport()->MuRef();
-            } else if (var.substr(0, 3) == "mf_" &&
-                       inp.HaveSpecies(var.substr(3, string::npos))) {
-              auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
-              value = blk.State(ii, jj, kk).MassFractionN(ind);
-            } else if (var.substr(0, 3) == "vf_" &&
-                       inp.HaveSpecies(var.substr(3, string::npos))) {
-              auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
-              value =
-                  blk.State(ii, jj, kk).VolumeFractions(phys.Transport())[ind];
-            } else {
-              cerr << "ERROR: Variable " << var
-                   << " to write to function file is not defined!" << endl;
-              exit(EXIT_FAILURE);
-            }
-
-            outFile.write(reinterpret_cast<char *>(&value), sizeof(value));
-          }
-        }
+  // resolve output variables once
+  vector<cellExtractor> extractors;
+  for (const auto &var : inp.OutputVariables()) {
+    extractors.push_back(FunctionExtractor(var, phys, inp));
+  }
+
+  // get variables of each block -- all of one variable, then the next
+  const auto numBlks = static_cast<int>(recombVars.size());
+  vector<vector<double>> values(numBlks);
+#pragma omp parallel for schedule(dynamic) if (ThreadOverOutputBlocks(numBlks))
+  for (auto ll = 0; ll < numBlks; ++ll) {
+    // rank and global position come from the procBlock a cell was split into
+    auto blkVars = extractors;
+    auto vv = 0;
+    for (const auto &var : inp.OutputVariables()) {
+      if (var == "rank") {
+        blkVars[vv] = [&vars, &recombVars, &decomp, ll](
+                          const procBlock &b, int i, int j, int k) {
+          return static_cast<double>(
+              vars[SplitBlockNumber(recombVars, decomp, ll, i, j, k)].Rank());
+        };
+      } else if (var == "globalPosition") {
+        blkVars[vv] = [&vars, &recombVars, &decomp, ll](
+                          const procBlock &b, int i, int j, int k) {
+          return static_cast<double>(
+              vars[SplitBlockNumber(recombVars, decomp, ll, i, j, k)]
+                  .GlobalPos());
+        };
       }
+      vv++;
     }
-    ll++;
+    values[ll] = CellValues(recombVars[ll], blkVars, true);
+  }
+
+  // write out variables of each block at once
+  for (const auto &blkValues : values) {
+    WriteValues(outFile, blkValues.data(), blkValues.size(), isSingle);
   }
 
   // close plot3d function file
@@ -445,7 +894,8 @@ void WriteCenterFun(const vector<procBlock> &vars,
   const string fPostfix = ".fun";
   const auto writeName = inp.SimNameRoot() + "_" + to_string(solIter) + fEnd +
       fPostfix;
-  WriteFunFile(vars, recombVars, phys, decomp, writeName, inp);
+  WriteFunFile(vars, recombVars, phys, decomp, writeName, inp,
+               inp.IsSinglePrecisionOutput());
 }
 
 // function to write out variables in function file format
@@ -454,18 +904,20 @@ void WriteNodeFun(const vector<procBlock> &vars,
                   const int &solIter, const decomposition &decomp,
                   const input &inp) {
   // interpolate data from cell centers to nodes
-  vector<procBlock> recombVars;
-  recombVars.reserve(recombVarsCells.size());
-  for (auto &rvc : recombVarsCells) {
-    rvc.AssignCornerGhostCells();
-    recombVars.push_back(rvc.CellToNode());
+  const auto numBlks = static_cast<int>(recombVarsCells.size());
+  vector<procBlock> recombVars(numBlks);
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < numBlks; ++bb) {
+    recombVarsCells[bb].AssignCornerGhostCells();
+    recombVars[bb] = recombVarsCells[bb].CellToNode();
   }
 
   // open binary plot3d function file
   const string fPostfix = ".fun";
   const auto writeName =
       inp.SimNameRoot() + "_" + to_string(solIter) + fPostfix;
-  WriteFunFile(vars, recombVars, phys, decomp, writeName, inp);
+  // nodal variables share the double precision grid given by the user
+  WriteFunFile(vars, recombVars, phys, decomp, writeName, inp, false);
 }
 
 // function to write out variables in function file format
@@ -501,69 +953,24 @@ void WriteWallFun(const vector<procBlock> &vars, const physics &phys,
 
   WriteBlockDims(outFile, wallSurfs, inp.NumWallVarsOutput());
 
-  // write out variables
-  for (auto &blk : vars) {  // loop over all blocks
-    // loop over the number of variables to write out
-    for (auto &var : inp.WallOutputVariables()) {
-      // loop over wall boundaries
-      for (auto ll = 0; ll < blk.WallDataSize(); ++ll) {
-        const auto surf = blk.WallSurface(ll);
-        // write out dimensional variables -- loop over physical cells
-        for (auto kk = surf.RangeK().Start(); kk < surf.RangeK().End(); kk++) {
-          for (auto jj = surf.RangeJ().Start(); jj < surf.RangeJ().End();
-               jj++) {
-            for (auto ii = surf.RangeI().Start(); ii < surf.RangeI().End();
-                 ii++) {
-              // now calculate wall variables
-              auto value = 0.0;
-              if (var == "yplus") {
-                value = blk.WallYplus(ll, ii, jj, kk);
-              } else if (var == "shearStress") {
-                value = blk.WallShearStress(ll, ii, jj, kk).Mag();
-                value *= phys.Transport()->InvNondimScaling() *
-                         phys.Transport()->MuRef() * inp.ARef() / inp.LRef();
-              } else if (var == "viscosityRatio") {
-                value = blk.WallEddyVisc(ll, ii, jj, kk) /
-                        (blk.WallViscosity(ll, ii, jj, kk) + EPS);
-              } else if (var == "heatFlux") {
-                value = blk.WallHeatFlux(ll, ii, jj, kk);
-                value *= phys.Transport()->MuRef() * inp.TRef() / inp.LRef();
-              } else if (var == "frictionVelocity") {
-                value = blk.WallFrictionVelocity(ll, ii, jj, kk);
-                value *= inp.ARef();
-              } else if (var == "density") {
-                value = blk.WallDensity(ll, ii, jj, kk);
-                value *= inp.RRef();
-              } else if (var == "pressure") {
-                value = blk.WallPressure(ll, ii, jj, kk, phys.EoS());
-                value *= inp.RRef() * inp.ARef() * inp.ARef();
-              } else if (var == "temperature") {
-                value = blk.WallTemperature(ll, ii, jj, kk);
-                value *= inp.TRef();
-              } else if (var == "viscosity") {
-                value = blk.WallViscosity(ll, ii, jj, kk);
-                value *= phys.Transport()->MuRef() *
-                         phys.Transport()->InvNondimScaling();
-              } else if (var == "tke") {
-                value = blk.WallTke(ll, ii, jj, kk);
-                value *= inp.ARef() * inp.ARef();
-              } else if (var == "sdr") {
-                value = blk.WallSdr(ll, ii, jj, kk);
-                value *= inp.ARef() * inp.ARef() * inp.RRef() /
-                         phys.Transport()->MuRef();
-              } else {
-                cerr << "ERROR: Variable " << var
-                     << " to write to wall function file is not defined!"
-                     << endl;
-                exit(EXIT_FAILURE);
-              }
-
-              outFile.write(reinterpret_cast<char *>(&value), sizeof(value));
-            }
-          }
-        }
-      }
-    }
+  // resolve wall output variables once
+  vector<wallExtractor> extractors;
+  for (const auto &var : inp.WallOutputVariables()) {
+    extractors.push_back(WallExtractor(var, phys, inp));
+  }
+
+  // get variables of each block -- all of one variable, then the next
+  const auto numBlks = static_cast<int>(vars.size());
+  vector<vector<double>> values(numBlks);
+#pragma omp parallel for schedule(dynamic)
+  for (auto bb = 0; bb < numBlks; ++bb) {
+    values[bb] = WallValues(vars[bb], extractors);
+  }
+
+  // write out variables of each block at once
+  for (const auto &blkValues : values) {
+    WriteValues(outFile, blkValues.data(), blkValues.size(),
+                inp.IsSinglePrecisionOutput());
   }
 
   // close plot3d function file
@@ -587,33 +994,421 @@ void WriteOutput(const vector<procBlock> &vars, const physics &phys,
   }
 }
 
-// function to write out restart variables
-void WriteRestart(const vector<procBlock> &splitVars, const physics &phys,
+/* Function to write out the variables of the procBlocks on this processor in
+function file format. All processors write their procBlocks into the correct
+locations of the parent blocks in the shared file with collective MPI-IO, so
+the solution does not need to be gathered and recombined on ROOT. If the output
+queue writes in the background, the variables are copied into a staging buffer
+and the file is written on the background thread without MPI.*/
+void WriteFunFileMPI(const vector<procBlock> &blks, const physics &phys,
+                     const decomposition &decomp, const string &writeName,
+                     const input &inp, const int &rank, outputQueue &writer) {
+  // blks -- procBlocks on this processor
+  // phys -- physics models
+  // decomp -- decomposition
+  // writeName -- name of function file
+  // inp -- input variables
+  // rank -- processor rank
+  // writer -- queue to write output in background
+
+  const auto parentCells = ParentBlockCells(blks, decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
+
+  // header is written by ROOT before the blocks are written
+  MPI_Offset headerSize = 0;
+  if (rank == ROOTP) {
+    ofstream outFile(writeName, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Function file " << writeName
+           << " did not open correctly!!!" << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    WriteBlockDims(outFile, parentCells, inp.NumVarsOutput());
+    headerSize = outFile.tellp();
+  }
+  MPI_Bcast(&headerSize, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
+
+  // resolve output variables once
+  vector<cellExtractor> extractors;
+  for (const auto &var : inp.OutputVariables()) {
+    extractors.push_back(FunctionExtractor(var, phys, inp));
+  }
+
+  // get variables of each block -- all of one variable, then the next
+  const auto numBlks = static_cast<int>(blks.size());
+  vector<vector<double>> values(numBlks);
+#pragma omp parallel for schedule(dynamic) if (ThreadOverOutputBlocks(numBlks))
+  for (auto bb = 0; bb < numBlks; ++bb) {
+    values[bb] = CellValues(blks[bb], extractors, true);
+  }
+
+  WriteSplitValues(blks, std::move(values), parentCells, ranges, decomp,
+                   writeName, headerSize, inp.NumVarsOutput(), true,
+                   inp.IsSinglePrecisionOutput(), writer);
+}
+
+/* Function to write the variables of the procBlocks on this processor into a
+file whose header has already been written. All processors write their
+procBlocks into the correct locations of the parent blocks with collective
+MPI-IO. If the output queue writes in the background, the variables are
+moved into the task and the file is written on the background thread without
+MPI.*/
+void WriteSplitValues(const vector<procBlock> &blks,
+                      vector<vector<double>> values,
+                      const vector<vector3d<int>> &parentCells,
+                      const vector<array<range, 3>> &ranges,
+                      const decomposition &decomp, const string &writeName,
+                      const MPI_Offset &headerSize, const int &numVars,
+                      const bool &varMajor, const bool &isSingle,
+                      outputQueue &writer) {
+  // blks -- procBlocks on this processor
+  // values -- variables to write for each procBlock
+  // parentCells -- number of cells in each parent block
+  // ranges -- range of parent block cells that make up each procBlock
+  // decomp -- decomposition
+  // writeName -- name of file to write
+  // headerSize -- size of header preceding the blocks
+  // numVars -- number of variables per cell
+  // varMajor -- flag that is true if variables are ordered variable by variable
+  // isSingle -- flag that is true if values are written in single precision
+  // writer -- queue to write output in background
+
+  if (writer.IsAsync()) {
+    // file already exists because header was written before broadcast
+    const auto parents = SplitBlockParents(blks, decomp);
+    const auto blkRanges = SplitBlockRanges(blks, ranges);
+    writer.Push([writeName, headerSize, parentCells, parents, blkRanges,
+                 numVars, varMajor, isSingle, values = std::move(values)]() {
+      WriteSplitBlocks(writeName, headerSize, parentCells, parents, blkRanges,
+                       values, numVars, varMajor, isSingle);
+    });
+    return;
+  }
+
+  MPI_File outFile;
+  if (MPI_File_open(MPI_COMM_WORLD, writeName.c_str(), MPI_MODE_WRONLY,
+                    MPI_INFO_NULL, &outFile) != MPI_SUCCESS) {
+    cerr << "ERROR: File " << writeName << " did not open correctly!!!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+  WriteSplitBlocksMPI(outFile, headerSize, parentCells, ranges, blks, values,
+                      numVars, varMajor, isSingle, decomp);
+  MPI_File_close(&outFile);
+}
+
+/* Function to write out the cell center function file with collective MPI-IO.
+Nodal and wall variables need the recombined parent blocks, so they are written
+by WriteOutput instead.*/
+void WriteOutputMPI(const vector<procBlock> &blks, const physics &phys,
+                    const int &solIter, const decomposition &decomp,
+                    const input &inp, const int &rank, outputQueue &writer) {
+  // blks -- procBlocks on this processor
+  // phys -- physics models
+  // solIter -- iteration number
+  // decomp -- decomposition
+  // inp -- input variables
+  // rank -- processor rank
+  // writer -- queue to write output in background
+
+  const string fEnd = "_center";
+  const string fPostfix = ".fun";
+  const auto writeName = inp.SimNameRoot() + "_" + to_string(solIter) + fEnd +
+      fPostfix;
+  WriteFunFileMPI(blks, phys, decomp, writeName, inp, rank, writer);
+  if (rank == ROOTP) {
+    WriteMeta(inp, solIter, true);
+  }
+}
+
+/* Function to write out the running statistics of the procBlocks on this
+processor in function file format with collective MPI-IO. The mean and rms of
+each sampled variable, and the covariance of each pair of velocity components,
+are written at the cell centers.*/
+void WriteStatisticsMPI(const vector<procBlock> &blks, const int &solIter,
+                        const decomposition &decomp, const input &inp,
+                        const int &rank, outputQueue &writer) {
+  // blks -- procBlocks on this processor
+  // solIter -- iteration number
+  // decomp -- decomposition
+  // inp -- input variables
+  // rank -- processor rank
+  // writer -- queue to write output in background
+
+  const auto parentCells = ParentBlockCells(blks, decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
+  const auto numVars =
+      static_cast<int>(StatisticsNames(inp.StatisticsVariables()).size());
+  const auto writeName =
+      inp.SimNameRoot() + "_" + to_string(solIter) + "_stats.fun";
+
+  // header is written by ROOT before the blocks are written
+  MPI_Offset headerSize = 0;
+  if (rank == ROOTP) {
+    ofstream outFile(writeName, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Function file " << writeName
+           << " did not open correctly!!!" << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    WriteBlockDims(outFile, parentCells, numVars);
+    headerSize = outFile.tellp();
+    WriteStatisticsMeta(inp, solIter);
+  }
+  MPI_Bcast(&headerSize, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
+
+  // statistics are zero before the first sample -- all of one value, then the
+  // next
+  vector<vector<double>> values(blks.size());
+  for (auto bb = 0U; bb < blks.size(); ++bb) {
+    const auto &stats = blks[bb].Statistics();
+    values[bb] = stats.IsEmpty()
+                     ? vector<double>(blks[bb].NumCells() * numVars, 0.0)
+                     : stats.Values();
+  }
+
+  WriteSplitValues(blks, std::move(values), parentCells, ranges, decomp,
+                   writeName, headerSize, numVars, true,
+                   inp.IsSinglePrecisionOutput(), writer);
+}
+
+/* Function to write out the running statistics to their own restart file so
+that they can continue to be accumulated after a restart. The file holds the
+number of samples, the names of the sampled variables, the block sizes, and
+the means and sums of squared and cross deviations of each cell.*/
+void WriteStatisticsRestart(const vector<procBlock> &blks, const int &solIter,
+                            const decomposition &decomp, const input &inp,
+                            const int &rank, outputQueue &writer) {
+  // blks -- procBlocks on this processor
+  // solIter -- iteration number
+  // decomp -- decomposition
+  // inp -- input variables
+  // rank -- processor rank
+  // writer -- queue to write output in background
+
+  const auto parentCells = ParentBlockCells(blks, decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
+  const auto vars = inp.StatisticsVariables();
+  const auto numMoments =
+      2 * static_cast<int>(vars.size()) + StatisticsPairs(vars).size();
+  const auto writeName =
+      inp.SimNameRoot() + "_" + to_string(solIter) + "_stats.rst";
+
+  // all blocks have the same number of samples
+  auto numSamples = blks.empty() ? 0 : blks[0].Statistics().NumSamples();
+  MPI_Allreduce(MPI_IN_PLACE, &numSamples, 1, MPI_INT, MPI_MAX,
+                MPI_COMM_WORLD);
+
+  // header is written by ROOT before the blocks are written
+  MPI_Offset headerSize = 0;
+  if (rank == ROOTP) {
+    ofstream outFile(writeName, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Restart file " << writeName
+           << " did not open correctly!!!" << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // write number of samples
+    outFile.write(reinterpret_cast<char *>(&numSamples), sizeof(numSamples));
+
+    // write variable names (including sizes)
+    auto numVars = static_cast<int>(vars.size());
+    outFile.write(reinterpret_cast<char *>(&numVars), sizeof(numVars));
+    for (const auto &var : vars) {
+      auto varSize = var.size();
+      outFile.write(reinterpret_cast<char *>(&varSize), sizeof(varSize));
+      outFile.write(var.c_str(), varSize * sizeof(char));
+    }
+
+    WriteBlockDims(outFile, parentCells, numMoments);
+    headerSize = outFile.tellp();
+  }
+  MPI_Bcast(&headerSize, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
+
+  // get moments of each block -- all moments of one cell, then the next
+  vector<vector<double>> values(blks.size());
+  for (auto bb = 0U; bb < blks.size(); ++bb) {
+    const auto &stats = blks[bb].Statistics();
+    values[bb] = stats.IsEmpty()
+                     ? vector<double>(blks[bb].NumCells() * numMoments, 0.0)
+                     : stats.Moments();
+  }
+
+  WriteSplitValues(blks, std::move(values), parentCells, ranges, decomp,
+                   writeName, headerSize, numMoments, false, false, writer);
+}
+
+/* Function to write out restart variables. The header is written by ROOT and
+then all processors write the variables of their procBlocks into the correct
+locations of the parent blocks with collective MPI-IO. If the output queue
+writes in the background, the variables are copied into a staging buffer and
+the file is written on the background thread without MPI. If compressed
+restart files are requested, the variables are written by
+WriteCompressedRestart instead.*/
+void WriteRestart(const vector<procBlock> &blks, const physics &phys,
                   const int &solIter, const decomposition &decomp,
-                  const input &inp, const residual &residL2First) {
-  // recombine blocks into original structure
-  auto vars = Recombine(splitVars, decomp);
+                  const input &inp, const residual &residL2First,
+                  const int &rank, outputQueue &writer) {
+  // blks -- procBlocks on this processor
+  // phys -- physics models
+  // solIter -- iteration number
+  // decomp -- decomposition
+  // inp -- input variables
+  // residL2First -- residual normalization (only needed on ROOT)
+  // rank -- processor rank
+  // writer -- queue to write output in background
+
+  // running statistics are kept in their own restart file
+  if (inp.CollectStatistics()) {
+    WriteStatisticsRestart(blks, solIter, decomp, inp, rank, writer);
+  }
+
+  const auto parentCells = ParentBlockCells(blks, decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
 
-  // open binary restart file
   const string fPostfix = ".rst";
   const auto writeName =
       inp.SimNameRoot() + "_" + to_string(solIter) + fPostfix;
-  ofstream outFile(writeName, ios::out | ios::binary);
 
-  // check to see if file opened correctly
-  if (outFile.fail()) {
+  auto numSols = inp.IsMultilevelInTime() ? 2 : 1;
+  auto numSpecies = inp.NumSpecies();
+
+  // variables to write to restart file
+  vector<string> restartVars = {"density", "vel_x", "vel_y", "vel_z",
+                                "pressure"};
+  if (inp.IsRANS()) {
+    restartVars.push_back("tke");
+    restartVars.push_back("sdr");
+  }
+  for (auto ii = 0; ii < numSpecies; ++ii) {
+    auto var = "mf_" + inp.Fluid(ii).Name();
+    restartVars.push_back(var);
+  }
+  const auto numVars = static_cast<int>(restartVars.size());
+
+  // resolve restart variables once
+  vector<cellExtractor> extractors;
+  for (const auto &var : restartVars) {
+    extractors.push_back(RestartExtractor(var, phys, inp));
+  }
+
+  // get variables of each block -- all variables of one cell, then the next
+  const auto numBlks = static_cast<int>(blks.size());
+  vector<vector<double>> values(numBlks);
+#pragma omp parallel for schedule(dynamic) if (ThreadOverOutputBlocks(numBlks))
+  for (auto bb = 0; bb < numBlks; ++bb) {
+    values[bb] = CellValues(blks[bb], extractors, false);
+  }
+
+  vector<vector<double>> valuesNm1;
+  if (numSols == 2) {
+    vector<cellExtractor> extractorsNm1;
+    for (const auto &var : restartVars) {
+      extractorsNm1.push_back(RestartNm1Extractor(var, phys, inp));
+    }
+    valuesNm1.resize(numBlks);
+#pragma omp parallel for schedule(dynamic) if (ThreadOverOutputBlocks(numBlks))
+    for (auto bb = 0; bb < numBlks; ++bb) {
+      valuesNm1[bb] = CellValues(blks[bb], extractorsNm1, false);
+    }
+  }
+
+  if (inp.IsCompressedRestart()) {
+    vector<vector<vector<double>>> solValues(numSols);
+    solValues[0] = std::move(values);
+    if (numSols == 2) {
+      solValues[1] = std::move(valuesNm1);
+    }
+    WriteCompressedRestart(blks, solValues, parentCells, ranges, decomp,
+                           writeName, solIter, numVars, inp, residL2First,
+                           rank, writer);
+    return;
+  }
+
+  // header is written by ROOT before the blocks are written
+  MPI_Offset headerSize = 0;
+  if (rank == ROOTP) {
+    // open binary restart file
+    ofstream outFile(writeName, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Restart file " << writeName
+           << " did not open correctly!!!" << endl;
+      exit(EXIT_FAILURE);
+    }
+
+    WriteRestartHeader(outFile, numSols, solIter, inp, residL2First);
+    WriteBlockDims(outFile, parentCells, numVars);
+    headerSize = outFile.tellp();
+  }
+  MPI_Bcast(&headerSize, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
+
+  // 2nd solution is written after all blocks of 1st solution
+  MPI_Offset solSize = 0;
+  for (const auto &cells : parentCells) {
+    solSize += static_cast<MPI_Offset>(cells.X()) * cells.Y() * cells.Z() *
+        numVars * sizeof(double);
+  }
+
+  if (writer.IsAsync()) {
+    // file already exists because header was written before broadcast
+    const auto parents = SplitBlockParents(blks, decomp);
+    const auto blkRanges = SplitBlockRanges(blks, ranges);
+    writer.Push([writeName, headerSize, solSize, numSols, parentCells,
+                 parents, blkRanges, numVars, values = std::move(values),
+                 valuesNm1 = std::move(valuesNm1)]() {
+      WriteSplitBlocks(writeName, headerSize, parentCells, parents, blkRanges,
+                       values, numVars, false, false);
+      if (numSols == 2) {
+        WriteSplitBlocks(writeName, headerSize + solSize, parentCells, parents,
+                         blkRanges, valuesNm1, numVars, false, false);
+      }
+    });
+    return;
+  }
+
+  MPI_File outFile;
+  if (MPI_File_open(MPI_COMM_WORLD, writeName.c_str(), MPI_MODE_WRONLY,
+                    MPI_INFO_NULL, &outFile) != MPI_SUCCESS) {
     cerr << "ERROR: Restart file " << writeName << " did not open correctly!!!"
          << endl;
     exit(EXIT_FAILURE);
   }
+  WriteSplitBlocksMPI(outFile, headerSize, parentCells, ranges, blks, values,
+                      numVars, false, false, decomp);
+  if (numSols == 2) {
+    WriteSplitBlocksMPI(outFile, headerSize + solSize, parentCells, ranges,
+                        blks, valuesNm1, numVars, false, false, decomp);
+  }
+
+  // close restart file
+  MPI_File_close(&outFile);
+}
+
+// function to write out the restart file header that precedes the block sizes
+void WriteRestartHeader(ofstream &outFile, int numSols, int solIter,
+                        const input &inp, const residual &residL2First) {
+  // outFile -- file to write to
+  // numSols -- number of time levels in file
+  // solIter -- iteration number
+  // inp -- input variables
+  // residL2First -- residual normalization
 
   // write number of time steps contained in file
-  auto numSols = inp.IsMultilevelInTime() ? 2 : 1;
   outFile.write(reinterpret_cast<char *>(&numSols), sizeof(numSols));
 
   // write iteration number
-  outFile.write(const_cast<char *>(reinterpret_cast<const char *>(&solIter)),
-                sizeof(solIter));
+  outFile.write(reinterpret_cast<char *>(&solIter), sizeof(solIter));
 
   // write number of equations
   auto numEqns = inp.NumEquations();
@@ -635,128 +1430,198 @@ void WriteRestart(const vector<procBlock> &splitVars, const physics &phys,
   outFile.write(
       const_cast<char *>(reinterpret_cast<const char *>(&residL2First[0])),
       residL2First.Size() * sizeof(residL2First[0]));
+}
 
-  // variables to write to restart file
-  vector<string> restartVars = {"density", "vel_x", "vel_y", "vel_z",
-                                "pressure"};
-  if (inp.IsRANS()) {
-    restartVars.push_back("tke");
-    restartVars.push_back("sdr");
-  }
-  for (auto ii = 0; ii < numSpecies; ++ii) {
-    auto var = "mf_" + inp.Fluid(ii).Name();
-    restartVars.push_back(var);
+/* Function to write out restart variables in compressed form. The variables
+of each procBlock are shuffled and compressed by the processor that owns the
+procBlock, so each procBlock is an independent chunk of the file. After the
+usual header, a table holds the time level, parent block, cell range, and
+compressed size of every chunk, so that the chunks can be placed within their
+parent blocks when the file is read. ROOT writes the header and the table, and
+then each processor writes its own chunks. The time to compress and write the
+chunks is reported as a rate of uncompressed data, so it can be compared to
+the rate of writing an uncompressed restart file.*/
+void WriteCompressedRestart(const vector<procBlock> &blks,
+                            const vector<vector<vector<double>>> &values,
+                            const vector<vector3d<int>> &parentCells,
+                            const vector<array<range, 3>> &ranges,
+                            const decomposition &decomp,
+                            const string &writeName, const int &solIter,
+                            const int &numVars, const input &inp,
+                            const residual &residL2First, const int &rank,
+                            outputQueue &writer) {
+  // blks -- procBlocks on this processor
+  // values -- variables of each procBlock for each time level
+  // parentCells -- number of cells in each parent block
+  // ranges -- range of parent block cells that make up each procBlock
+  // decomp -- decomposition
+  // writeName -- name of restart file
+  // solIter -- iteration number
+  // numVars -- number of variables per cell
+  // inp -- input variables
+  // residL2First -- residual normalization (only needed on ROOT)
+  // rank -- processor rank
+  // writer -- queue to write output in background
+
+  const auto numSols = static_cast<int>(values.size());
+  const auto numBlks = static_cast<int>(blks.size());
+  auto numChunks = numSols * decomp.NumBlocks();
+  const auto startTime = MPI_Wtime();
+
+  // compress variables of each procBlock on this processor
+  vector<vector<char>> chunks(numSols * numBlks);
+  vector<long long> chunkSizes(numChunks, 0);
+#pragma omp parallel for schedule(dynamic) if (ThreadOverOutputBlocks(numBlks))
+  for (auto bb = 0; bb < numBlks; ++bb) {
+    for (auto ss = 0; ss < numSols; ++ss) {
+      auto &chunk = chunks[ss * numBlks + bb];
+      chunk = CompressLZ(ShuffleBytes(values[ss][bb]));
+      chunkSizes[ss * decomp.NumBlocks() + blks[bb].GlobalPos()] =
+          chunk.size();
+    }
   }
+  MPI_Allreduce(MPI_IN_PLACE, chunkSizes.data(), numChunks, MPI_LONG_LONG,
+                MPI_SUM, MPI_COMM_WORLD);
+
+  // header is written by ROOT before the chunks are written
+  MPI_Offset headerSize = 0;
+  if (rank == ROOTP) {
+    // open binary restart file
+    ofstream outFile(writeName, ios::out | ios::binary);
+
+    // check to see if file opened correctly
+    if (outFile.fail()) {
+      cerr << "ERROR: Restart file " << writeName
+           << " did not open correctly!!!" << endl;
+      exit(EXIT_FAILURE);
+    }
 
-  WriteBlockDims(outFile, vars, restartVars.size());
-
-  // write out variables
-  for (auto &blk : vars) {  // loop over all blocks
-    // write out dimensional variables -- loop over physical cells
-    for (auto kk = blk.StartK(); kk < blk.EndK(); kk++) {
-      for (auto jj = blk.StartJ(); jj < blk.EndJ(); jj++) {
-        for (auto ii = blk.StartI(); ii < blk.EndI(); ii++) {
-          // loop over the number of variables to write out
-          for (auto &var : restartVars) {
-            auto value = 0.0;
-            if (var == "density") {
-              value = blk.State(ii, jj, kk).Rho();
-              value *= inp.RRef();
-            } else if (var == "vel_x") {
-              value = blk.State(ii, jj, kk).U();
-              value *= inp.ARef();
-            } else if (var == "vel_y") {
-              value = blk.State(ii, jj, kk).V();
-              value *= inp.ARef();
-            } else if (var == "vel_z") {
-              value = blk.State(ii, jj, kk).W();
-              value *= inp.ARef();
-            } else if (var == "pressure") {
-              value = blk.State(ii, jj, kk).P();
-              value *= inp.RRef() * inp.ARef() * inp.ARef();
-            } else if (var == "tke") {
-              value = blk.State(ii, jj, kk).Tke();
-              value *= inp.ARef() * inp.ARef();
-            } else if (var == "sdr") {
-              value = blk.State(ii, jj, kk).Omega();
-              value *= inp.ARef() * inp.ARef() * inp.RRef() /
-                       phys.Transport()->MuRef();
-            } else if (var.substr(0, 3) == "mf_" &&
-                       inp.HaveSpecies(var.substr(3, string::npos))) {
-              auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
-              value = blk.State(ii, jj, kk).MassFractionN(ind);
-            } else {
-              cerr << "ERROR: Variable " << var
-                   << " to write to restart file is not defined!" << endl;
-              exit(EXIT_FAILURE);
-            }
-
-            outFile.write(reinterpret_cast<char *>(&value), sizeof(value));
-          }
-        }
+    // write identifier and version of compressed format
+    const string id = COMPRESSED_RESTART_ID;
+    outFile.write(id.c_str(), id.size());
+    auto version = COMPRESSED_RESTART_VERSION;
+    outFile.write(reinterpret_cast<char *>(&version), sizeof(version));
+
+    WriteRestartHeader(outFile, numSols, solIter, inp, residL2First);
+    WriteBlockDims(outFile, parentCells, numVars);
+
+    // write table of chunks -- all chunks of 1st solution, then 2nd solution
+    outFile.write(reinterpret_cast<char *>(&numChunks), sizeof(numChunks));
+    for (auto ss = 0; ss < numSols; ++ss) {
+      for (auto gp = 0; gp < decomp.NumBlocks(); ++gp) {
+        const auto &rng = ranges[gp];
+        array<int, 8> location = {ss, decomp.ParentBlock(gp),
+                                  rng[0].Start(), rng[0].End(),
+                                  rng[1].Start(), rng[1].End(),
+                                  rng[2].Start(), rng[2].End()};
+        outFile.write(reinterpret_cast<char *>(location.data()),
+                      location.size() * sizeof(location[0]));
+        outFile.write(reinterpret_cast<char *>(
+                          &chunkSizes[ss * decomp.NumBlocks() + gp]),
+                      sizeof(chunkSizes[0]));
       }
     }
+    headerSize = outFile.tellp();
   }
+  MPI_Bcast(&headerSize, 1, MPI_OFFSET, ROOTP, MPI_COMM_WORLD);
 
-  // write out 2nd solution
-  if (numSols == 2) {
-    // these variables are conserved variables
-    for (auto &blk : vars) {  // loop over all blocks
-      // write out dimensional variables -- loop over physical cells
-      for (auto kk = blk.StartK(); kk < blk.EndK(); kk++) {
-        for (auto jj = blk.StartJ(); jj < blk.EndJ(); jj++) {
-          for (auto ii = blk.StartI(); ii < blk.EndI(); ii++) {
-            // loop over the number of variables to write out
-            for (auto &var : restartVars) {
-              auto value = 0.0;
-              if (var == "density") {
-                value = blk.ConsVarsNm1(ii, jj, kk)[0];
-                value *= inp.RRef();
-              } else if (var == "vel_x") {  // conserved var is rho-u
-                value = blk.ConsVarsNm1(ii, jj, kk)[1];
-                value *= inp.ARef() * inp.RRef();
-              } else if (var == "vel_y") {  // conserved var is rho-v
-                value = blk.ConsVarsNm1(ii, jj, kk)[2];
-                value *= inp.ARef() * inp.RRef();
-              } else if (var == "vel_z") {  // conserved var is rho-w
-                value = blk.ConsVarsNm1(ii, jj, kk)[3];
-                value *= inp.ARef() * inp.RRef();
-              } else if (var == "pressure") {  // conserved var is rho-E
-                value = blk.ConsVarsNm1(ii, jj, kk)[4];
-                value *= inp.ARef() * inp.ARef() * inp.RRef();
-              } else if (var == "tke") {  // conserved var is rho-tke
-                value = blk.ConsVarsNm1(ii, jj, kk)[5];
-                value *= inp.ARef() * inp.ARef() * inp.RRef();
-              } else if (var == "sdr") {  // conserved var is rho-sdr
-                value = blk.ConsVarsNm1(ii, jj, kk)[6];
-                value *= inp.ARef() * inp.ARef() * inp.RRef() * inp.RRef() /
-                         phys.Transport()->MuRef();
-              } else if (var.substr(0, 3) == "mf_" &&
-                         inp.HaveSpecies(var.substr(3, string::npos))) {
-                auto ind = inp.SpeciesIndex(var.substr(3, string::npos));
-                value = blk.ConsVarsNm1(ii, jj, kk).MassFractionN(ind);
-              } else {
-                cerr << "ERROR: Variable " << var
-                     << " to write to restart file is not defined!" << endl;
-                exit(EXIT_FAILURE);
-              }
-
-              outFile.write(reinterpret_cast<char *>(&value), sizeof(value));
-            }
-          }
-        }
-      }
+  // chunks are written in the order of the table
+  vector<MPI_Offset> tableOffsets(numChunks, headerSize);
+  for (auto cc = 1; cc < numChunks; ++cc) {
+    tableOffsets[cc] = tableOffsets[cc - 1] + chunkSizes[cc - 1];
+  }
+  vector<MPI_Offset> chunkOffsets(chunks.size());
+  for (auto ss = 0; ss < numSols; ++ss) {
+    for (auto bb = 0; bb < numBlks; ++bb) {
+      chunkOffsets[ss * numBlks + bb] =
+          tableOffsets[ss * decomp.NumBlocks() + blks[bb].GlobalPos()];
     }
   }
 
+  auto rawSize = 0LL;
+  for (const auto &cells : parentCells) {
+    rawSize += static_cast<long long>(cells.X()) * cells.Y() * cells.Z() *
+        numVars * numSols * sizeof(double);
+  }
+  auto compressedSize = 0LL;
+  for (const auto &size : chunkSizes) {
+    compressedSize += size;
+  }
+
+  // rate is limited by slowest processor
+  const auto reportRate = [&](const string &stage) {
+    auto elapsed = MPI_Wtime() - startTime;
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX,
+                  MPI_COMM_WORLD);
+    if (rank == ROOTP) {
+      cout << "Restart data compressed by a factor of "
+           << static_cast<double>(rawSize) / std::max(compressedSize, 1LL)
+           << " (" << compressedSize << " of " << rawSize
+           << " bytes written); " << stage << " at "
+           << rawSize / (1.0e6 * std::max(elapsed, 1.0e-12))
+           << " MB/s of uncompressed data (" << elapsed << " s)" << endl;
+    }
+  };
+
+  if (writer.IsAsync()) {
+    // file already exists because header was written before broadcast
+    writer.Push([writeName, chunkOffsets, chunks = std::move(chunks)]() {
+      fstream outFile(writeName, ios::in | ios::out | ios::binary);
+      if (outFile.fail()) {
+        cerr << "ERROR: File " << writeName << " did not open correctly!!!"
+             << endl;
+        exit(EXIT_FAILURE);
+      }
+      for (auto cc = 0U; cc < chunks.size(); ++cc) {
+        outFile.seekp(chunkOffsets[cc]);
+        outFile.write(chunks[cc].data(), chunks[cc].size());
+      }
+      if (outFile.fail()) {
+        cerr << "ERROR: Problem writing file " << writeName << endl;
+        exit(EXIT_FAILURE);
+      }
+    });
+    // chunks are written in the background, so only compression is timed
+    reportRate("compressed");
+    return;
+  }
+
+  MPI_File outFile;
+  if (MPI_File_open(MPI_COMM_WORLD, writeName.c_str(), MPI_MODE_WRONLY,
+                    MPI_INFO_NULL, &outFile) != MPI_SUCCESS) {
+    cerr << "ERROR: Restart file " << writeName << " did not open correctly!!!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+  for (auto cc = 0U; cc < chunks.size(); ++cc) {
+    MPI_File_write_at(outFile, chunkOffsets[cc], chunks[cc].data(),
+                      chunks[cc].size(), MPI_BYTE, MPI_STATUS_IGNORE);
+  }
+
   // close restart file
-  outFile.close();
+  MPI_File_close(&outFile);
+  reportRate("compressed and written");
 }
 
+/* Function to read the restart file on all processors after the grid has been
+decomposed. Every processor reads the header, and then reads only the cells of
+its own procBlocks. The location of each procBlock within its parent block is
+found from the block sizes and the split history, so the parent blocks do not
+need to be read on ROOT, decomposed, and sent to the other processors.*/
 void ReadRestart(gridLevel &vars, const string &restartName,
                  const decomposition &decomp, input &inp, const physics &phys,
-                 residual &residL2First,
-                 const vector<vector3d<int>> &gridSizes) {
+                 residual &residL2First, const int &rank) {
+  // vars -- gridLevel of procBlocks on this processor
+  // restartName -- name of restart file
+  // decomp -- decomposition
+  // inp -- input variables
+  // phys -- physics models
+  // residL2First -- residual normalization
+  // rank -- processor rank
+
+  const auto parentCells = ParentBlockCells(vars.Blocks(), decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
+
   // open binary restart file
   ifstream fName(restartName, ios::in | ios::binary);
 
@@ -767,39 +1632,64 @@ void ReadRestart(gridLevel &vars, const string &restartName,
     exit(EXIT_FAILURE);
   }
 
+  // compressed files start with an identifier and version
+  if (rank == ROOTP) {
+    cout << "Reading restart file..." << endl;
+  }
+  const string id = COMPRESSED_RESTART_ID;
+  string fileId(id.size(), ' ');
+  fName.read(&fileId[0], fileId.size());
+  const auto isCompressed = fName.good() && fileId == id;
+  if (isCompressed) {
+    auto version = 0;
+    fName.read(reinterpret_cast<char *>(&version), sizeof(version));
+    if (version != COMPRESSED_RESTART_VERSION) {
+      cerr << "ERROR: Compressed restart file version " << version
+           << " is not supported!" << endl;
+      exit(EXIT_FAILURE);
+    }
+    if (rank == ROOTP) {
+      cout << "Restart file is compressed" << endl;
+    }
+  } else {
+    fName.clear();
+    fName.seekg(0, ios::beg);
+  }
+
   // read the number of time levels in file
-  cout << "Reading restart file..." << endl;
   auto numSols = 0;
   fName.read(reinterpret_cast<char *>(&numSols), sizeof(numSols));
-  cout << "Number of time levels: " << numSols << endl;
-
-  if (inp.IsMultilevelInTime() && numSols != 2) {
-    cerr << "WARNING: Using multilevel time integration scheme, but only one "
-         << "time level found in restart file" << endl;
-  }
 
   // iteration number
   auto iterNum = 0;
   fName.read(reinterpret_cast<char *>(&iterNum), sizeof(iterNum));
-  cout << "Data from iteration: " << iterNum << endl;
   inp.SetIterationStart(iterNum);
 
   // read the number of equations
   auto numEqns = 0;
   fName.read(reinterpret_cast<char *>(&numEqns), sizeof(numEqns));
-  cout << "Number of equations: " << numEqns << endl;
 
   // read the number of species
   auto numSpecies = 0;
   fName.read(reinterpret_cast<char *>(&numSpecies), sizeof(numSpecies));
-  cout << "Number of species: " << numSpecies << endl;
+
+  if (rank == ROOTP) {
+    cout << "Number of time levels: " << numSols << endl;
+    if (inp.IsMultilevelInTime() && numSols != 2) {
+      cerr << "WARNING: Using multilevel time integration scheme, but only "
+           << "one time level found in restart file" << endl;
+    }
+    cout << "Data from iteration: " << iterNum << endl;
+    cout << "Number of equations: " << numEqns << endl;
+    cout << "Number of species: " << numSpecies << endl;
+  }
 
   // read species names (including sizes)
   vector<string> speciesNames(numSpecies);
   for (auto ii = 0; ii < numSpecies; ++ii) {
     size_t nameSize = 0;
     fName.read(reinterpret_cast<char *>(&nameSize), sizeof(nameSize));
-    
+
     auto buffer = std::make_unique<char[]>(nameSize);
     fName.read(buffer.get(), nameSize * sizeof(char));
     string sname(buffer.get(), nameSize);
@@ -815,11 +1705,11 @@ void ReadRestart(gridLevel &vars, const string &restartName,
   // read the number of blocks
   auto numBlks = 0;
   fName.read(reinterpret_cast<char *>(&numBlks), sizeof(numBlks));
-  if (numBlks != static_cast<int>(gridSizes.size())) {
+  if (numBlks != static_cast<int>(parentCells.size())) {
     cerr << "ERROR: Number of blocks in restart file does not match grid!"
          << endl;
     cerr << "Found " << numBlks << " blocks in restart file and "
-         << gridSizes.size() << " blocks in grid." << endl;
+         << parentCells.size() << " blocks in grid." << endl;
     exit(EXIT_FAILURE);
   }
 
@@ -830,8 +1720,8 @@ void ReadRestart(gridLevel &vars, const string &restartName,
     fName.read(reinterpret_cast<char *>(&numJ), sizeof(numJ));
     fName.read(reinterpret_cast<char *>(&numK), sizeof(numK));
     fName.read(reinterpret_cast<char *>(&numVars), sizeof(numVars));
-    if (numI != gridSizes[ii].X() || numJ != gridSizes[ii].Y() ||
-        numK != gridSizes[ii].Z() || numVars - 1 != numEqns) {
+    if (numI != parentCells[ii].X() || numJ != parentCells[ii].Y() ||
+        numK != parentCells[ii].Z() || numVars - 1 != numEqns) {
       cerr << "ERROR: Problem with restart file. Block size does not match "
            << "grid, or number of variables in block does not match number of "
            << "equations!" << endl;
@@ -850,54 +1740,386 @@ void ReadRestart(gridLevel &vars, const string &restartName,
     auto var = "mf_" + spec;
     restartVars.push_back(var);
   }
+  const auto numVars = static_cast<int>(restartVars.size());
 
-  // loop over blocks and initialize
-  cout << "Reading solution from time n..." << endl;
-  vector<blkMultiArray3d<primitive>> solN(numBlks);
-  for (auto ii = 0U; ii < solN.size(); ++ii) {
-    solN[ii] =
-        ReadSolFromRestart(fName, inp, phys, restartVars, gridSizes[ii].X(),
-                           gridSizes[ii].Y(), gridSizes[ii].Z(), numSpecies);
+  // only read solution at time n-1 if it is needed
+  const auto numRead = (inp.IsMultilevelInTime() && numSols == 2) ? 2 : 1;
+
+  // read variables of procBlocks on this processor
+  vector<vector<vector<double>>> values;
+  if (isCompressed) {
+    values = ReadCompressedChunks(fName, parentCells, ranges, vars.Blocks(),
+                                  numVars, numRead, rank);
+    fName.close();
+  } else {
+    const MPI_Offset headerSize = fName.tellg();
+    fName.close();
+
+    // 2nd solution is written after all blocks of 1st solution
+    MPI_Offset solSize = 0;
+    for (const auto &cells : parentCells) {
+      solSize += static_cast<MPI_Offset>(cells.X()) * cells.Y() * cells.Z() *
+          numVars * sizeof(double);
+    }
+
+    MPI_File resFile;
+    if (MPI_File_open(MPI_COMM_WORLD, restartName.c_str(), MPI_MODE_RDONLY,
+                      MPI_INFO_NULL, &resFile) != MPI_SUCCESS) {
+      cerr << "ERROR: Error in ReadRestart(). Restart file " << restartName
+           << " did not open correctly!!!" << endl;
+      exit(EXIT_FAILURE);
+    }
+    for (auto ss = 0; ss < numRead; ++ss) {
+      values.push_back(ReadSplitBlocksMPI(resFile, headerSize + ss * solSize,
+                                          parentCells, ranges, vars.Blocks(),
+                                          numVars, decomp));
+    }
+    MPI_File_close(&resFile);
   }
-  // decompose solution
-  decomp.DecompArray(solN);
 
   // assign to procBlocks
-  for (auto ii = 0U; ii < solN.size(); ++ii) {
-    vars.Block(ii).GetStatesFromRestart(solN[ii]);
+  if (rank == ROOTP) {
+    cout << "Reading solution from time n..." << endl;
+  }
+  for (auto bb = 0; bb < vars.NumBlocks(); ++bb) {
+    const auto &blk = vars.Block(bb);
+    vars.Block(bb).GetStatesFromRestart(
+        ReadSolFromRestart(values[0][bb], inp, phys, restartVars, blk.NumI(),
+                           blk.NumJ(), blk.NumK(), numSpecies));
   }
 
   if (inp.IsMultilevelInTime()) {
     if (numSols == 2) {
-      cout << "Reading solution from time n-1..." << endl;
-      vector<blkMultiArray3d<conserved>> solNm1(numBlks);
-      for (auto ii = 0U; ii < solNm1.size(); ++ii) {
-        solNm1[ii] = ReadSolNm1FromRestart(fName, inp, phys, restartVars,
-                                           gridSizes[ii].X(), gridSizes[ii].Y(),
-                                           gridSizes[ii].Z(), numSpecies);
+      if (rank == ROOTP) {
+        cout << "Reading solution from time n-1..." << endl;
       }
-      // decompose solution
-      decomp.DecompArray(solNm1);
-
-      // assign to procBlocks
-      for (auto ii = 0U; ii < solNm1.size(); ++ii) {
-        vars.Block(ii).GetSolNm1FromRestart(solNm1[ii]);
+      for (auto bb = 0; bb < vars.NumBlocks(); ++bb) {
+        const auto &blk = vars.Block(bb);
+        vars.Block(bb).GetSolNm1FromRestart(ReadSolNm1FromRestart(
+            values[1][bb], inp, phys, restartVars, blk.NumI(), blk.NumJ(),
+            blk.NumK(), numSpecies));
       }
-
     } else {
-      cerr << "WARNING: Using multilevel time integration scheme, but only one "
-           << "time level found in restart file" << endl;
+      if (rank == ROOTP) {
+        cerr << "WARNING: Using multilevel time integration scheme, but only "
+             << "one time level found in restart file" << endl;
+      }
       // assign solution at time n to n-1
       vars.AssignSolToTimeN(phys);
       vars.AssignSolToTimeNm1();
     }
   }
 
-  // close restart file
+  // running statistics are kept in their own restart file
+  if (inp.CollectStatistics()) {
+    ReadStatisticsRestart(vars, restartName, decomp, inp, rank);
+  }
+
+  if (rank == ROOTP) {
+    cout << "Done with restart file" << endl << endl;
+  }
+}
+
+// function to get the name of the statistics restart file that accompanies a
+// restart file
+string StatisticsRestartName(const string &restartName) {
+  // restartName -- name of restart file
+  const string fPostfix = ".rst";
+  const auto pos = restartName.rfind(fPostfix);
+  const auto root = (pos != string::npos &&
+                     pos == restartName.size() - fPostfix.size())
+                        ? restartName.substr(0, pos)
+                        : restartName;
+  return root + "_stats" + fPostfix;
+}
+
+/* Function to read the running statistics of the procBlocks on this processor
+from the statistics restart file that accompanies a restart file. If there is
+no such file, or its variables do not match the requested statistics, the
+statistics are started from zero.*/
+void ReadStatisticsRestart(gridLevel &vars, const string &restartName,
+                           const decomposition &decomp, const input &inp,
+                           const int &rank) {
+  // vars -- gridLevel of procBlocks on this processor
+  // restartName -- name of restart file
+  // decomp -- decomposition
+  // inp -- input variables
+  // rank -- processor rank
+
+  const auto statsName = StatisticsRestartName(restartName);
+  ifstream fName(statsName, ios::in | ios::binary);
+  if (fName.fail()) {
+    if (rank == ROOTP) {
+      cout << "Statistics restart file " << statsName
+           << " not found, starting statistics from zero" << endl;
+    }
+    return;
+  }
+
+  // read number of samples
+  auto numSamples = 0;
+  fName.read(reinterpret_cast<char *>(&numSamples), sizeof(numSamples));
+
+  // read variable names (including sizes)
+  auto numVars = 0;
+  fName.read(reinterpret_cast<char *>(&numVars), sizeof(numVars));
+  set<string> fileVars;
+  for (auto ii = 0; ii < numVars; ++ii) {
+    size_t nameSize = 0;
+    fName.read(reinterpret_cast<char *>(&nameSize), sizeof(nameSize));
+    string name(nameSize, ' ');
+    fName.read(&name[0], nameSize * sizeof(char));
+    fileVars.insert(name);
+  }
+  const auto statVars = inp.StatisticsVariables();
+  if (fileVars != statVars) {
+    if (rank == ROOTP) {
+      cerr << "WARNING: Variables in statistics restart file " << statsName
+           << " do not match statisticsVariables, starting statistics from "
+           << "zero" << endl;
+    }
+    return;
+  }
+  const auto pairs = StatisticsPairs(statVars);
+  const auto numMoments = 2 * numVars + static_cast<int>(pairs.size());
+
+  // read the block sizes and check for match with grid
+  const auto parentCells = ParentBlockCells(vars.Blocks(), decomp);
+  const auto ranges = decomp.CellRanges(parentCells);
+  auto numBlks = 0;
+  fName.read(reinterpret_cast<char *>(&numBlks), sizeof(numBlks));
+  if (numBlks != static_cast<int>(parentCells.size())) {
+    cerr << "ERROR: Number of blocks in statistics restart file does not "
+         << "match grid!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  for (auto ii = 0; ii < numBlks; ii++) {
+    array<int, 4> dims;
+    fName.read(reinterpret_cast<char *>(dims.data()),
+               dims.size() * sizeof(dims[0]));
+    if (dims[0] != parentCells[ii].X() || dims[1] != parentCells[ii].Y() ||
+        dims[2] != parentCells[ii].Z() || dims[3] != numMoments) {
+      cerr << "ERROR: Problem with statistics restart file. Block size does "
+           << "not match grid!" << endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  const MPI_Offset headerSize = fName.tellg();
   fName.close();
-  cout << "Done with restart file" << endl << endl;
+
+  MPI_File statFile;
+  if (MPI_File_open(MPI_COMM_WORLD, statsName.c_str(), MPI_MODE_RDONLY,
+                    MPI_INFO_NULL, &statFile) != MPI_SUCCESS) {
+    cerr << "ERROR: Error in ReadStatisticsRestart(). Restart file "
+         << statsName << " did not open correctly!!!" << endl;
+    exit(EXIT_FAILURE);
+  }
+  auto values = ReadSplitBlocksMPI(statFile, headerSize, parentCells, ranges,
+                                   vars.Blocks(), numMoments, decomp);
+  MPI_File_close(&statFile);
+
+  // assign to procBlocks
+  for (auto bb = 0; bb < vars.NumBlocks(); ++bb) {
+    runningStatistics stats(vars.Block(bb).NumCells(), numVars, pairs);
+    stats.AssignMoments(numSamples, values[bb]);
+    vars.Block(bb).AssignStatistics(std::move(stats));
+  }
+
+  if (rank == ROOTP) {
+    cout << "Continuing statistics from " << numSamples << " samples" << endl;
+  }
+}
+
+/* Function to read the variables of the procBlocks on this processor from a
+restart file with collective MPI-IO. This is the inverse of
+WriteSplitBlocksMPI for restart files; each procBlock is described by a
+subarray of its parent block, and its variables are returned cell by cell.*/
+vector<vector<double>> ReadSplitBlocksMPI(
+    MPI_File &resFile, const MPI_Offset &start,
+    const vector<vector3d<int>> &parentCells,
+    const vector<array<range, 3>> &ranges, const vector<procBlock> &blks,
+    const int &numVars, const decomposition &decomp) {
+  // resFile -- file to read from
+  // start -- location of first parent block in file
+  // parentCells -- number of cells in each parent block
+  // ranges -- range of parent block cells that make up each procBlock
+  // blks -- procBlocks on this processor
+  // numVars -- number of variables per cell
+  // decomp -- decomposition
+
+  const auto parentOffset =
+      ParentBlockOffsets(start, parentCells, numVars, sizeof(double));
+
+  // collective reads must be called by all processors, so processors with
+  // fewer blocks make empty reads
+  auto maxBlocks = static_cast<int>(blks.size());
+  MPI_Allreduce(MPI_IN_PLACE, &maxBlocks, 1, MPI_INT, MPI_MAX,
+                MPI_COMM_WORLD);
+
+  vector<vector<double>> values(blks.size());
+  for (auto bb = 0; bb < maxBlocks; ++bb) {
+    if (bb >= static_cast<int>(blks.size())) {
+      MPI_File_set_view(resFile, 0, MPI_BYTE, MPI_BYTE, "native",
+                        MPI_INFO_NULL);
+      MPI_File_read_all(resFile, nullptr, 0, MPI_BYTE, MPI_STATUS_IGNORE);
+      continue;
+    }
+
+    const auto gp = blks[bb].GlobalPos();
+    const auto &par = parentCells[decomp.ParentBlock(gp)];
+    const auto &ri = ranges[gp][0];
+    const auto &rj = ranges[gp][1];
+    const auto &rk = ranges[gp][2];
+
+    // k index varies slowest in file
+    array<int, 4> sizes = {par.Z(), par.Y(), par.X(), numVars};
+    array<int, 4> subSizes = {rk.Size(), rj.Size(), ri.Size(), numVars};
+    array<int, 4> starts = {rk.Start(), rj.Start(), ri.Start(), 0};
+
+    MPI_Datatype MPI_subBlock;
+    MPI_Type_create_subarray(4, sizes.data(), subSizes.data(), starts.data(),
+                             MPI_ORDER_C, MPI_DOUBLE, &MPI_subBlock);
+    MPI_Type_commit(&MPI_subBlock);
+    MPI_File_set_view(resFile, parentOffset[decomp.ParentBlock(gp)],
+                      MPI_DOUBLE, MPI_subBlock, "native", MPI_INFO_NULL);
+    values[bb].resize(static_cast<size_t>(ri.Size()) * rj.Size() * rk.Size() *
+                      numVars);
+    MPI_File_read_all(resFile, values[bb].data(), values[bb].size(),
+                      MPI_DOUBLE, MPI_STATUS_IGNORE);
+    MPI_Type_free(&MPI_subBlock);
+  }
+  return values;
 }
 
+/* Function to read the variables of the procBlocks on this processor from a
+compressed restart file. The table of chunks is read, and only the chunks that
+overlap the procBlocks on this processor are read and decompressed. The
+overlapping rows of cells are copied into each procBlock, so the grid does not
+need to be decomposed the same way as when the file was written. The time to
+read and decompress the chunks is reported as a rate of uncompressed data.*/
+vector<vector<vector<double>>> ReadCompressedChunks(
+    ifstream &fName, const vector<vector3d<int>> &parentCells,
+    const vector<array<range, 3>> &ranges, const vector<procBlock> &blks,
+    const int &numVars, const int &numSols, const int &rank) {
+  // fName -- restart file positioned at start of chunk table
+  // parentCells -- number of cells in each parent block
+  // ranges -- range of parent block cells that make up each procBlock
+  // blks -- procBlocks on this processor
+  // numVars -- number of variables per cell
+  // numSols -- number of time levels to read
+  // rank -- processor rank
+
+  const auto startTime = MPI_Wtime();
+  auto numChunks = 0;
+  fName.read(reinterpret_cast<char *>(&numChunks), sizeof(numChunks));
+  vector<array<int, 8>> locations(numChunks);
+  vector<long long> chunkSizes(numChunks);
+  for (auto cc = 0; cc < numChunks; ++cc) {
+    fName.read(reinterpret_cast<char *>(locations[cc].data()),
+               locations[cc].size() * sizeof(locations[cc][0]));
+    fName.read(reinterpret_cast<char *>(&chunkSizes[cc]),
+               sizeof(chunkSizes[cc]));
+  }
+
+  // chunks are stored in the order of the table
+  vector<long long> chunkOffsets(numChunks, fName.tellg());
+  for (auto cc = 1; cc < numChunks; ++cc) {
+    chunkOffsets[cc] = chunkOffsets[cc - 1] + chunkSizes[cc - 1];
+  }
+
+  vector<vector<vector<double>>> values(numSols,
+                                        vector<vector<double>>(blks.size()));
+  for (auto ss = 0; ss < numSols; ++ss) {
+    for (auto bb = 0U; bb < blks.size(); ++bb) {
+      values[ss][bb].resize(static_cast<size_t>(blks[bb].NumCells()) *
+                            numVars);
+    }
+  }
+
+  auto rawSize = 0LL, compressedSize = 0LL;
+  for (auto cc = 0; cc < numChunks; ++cc) {
+    const auto &loc = locations[cc];
+    if (loc[0] >= numSols) {
+      continue;
+    }
+    const auto numI = loc[3] - loc[2];
+    const auto numJ = loc[5] - loc[4];
+    const auto numK = loc[7] - loc[6];
+    const auto chunkRawSize =
+        static_cast<long long>(numI) * numJ * numK * numVars * sizeof(double);
+    rawSize += chunkRawSize;
+    compressedSize += chunkSizes[cc];
+
+    // find overlap of chunk with each procBlock in same parent block
+    vector<int> overlapBlks;
+    vector<array<int, 6>> overlaps;
+    for (auto bb = 0U; bb < blks.size(); ++bb) {
+      const auto &rng = ranges[blks[bb].GlobalPos()];
+      if (blks[bb].ParentBlock() != loc[1]) {
+        continue;
+      }
+      array<int, 6> overlap;
+      auto isOverlap = true;
+      for (auto dd = 0; dd < 3; ++dd) {
+        overlap[2 * dd] = std::max(rng[dd].Start(), loc[2 + 2 * dd]);
+        overlap[2 * dd + 1] = std::min(rng[dd].End(), loc[3 + 2 * dd]);
+        isOverlap = isOverlap && overlap[2 * dd] < overlap[2 * dd + 1];
+      }
+      if (isOverlap) {
+        overlapBlks.push_back(bb);
+        overlaps.push_back(overlap);
+      }
+    }
+    if (overlapBlks.empty()) {
+      continue;
+    }
+
+    vector<char> chunk(chunkSizes[cc]);
+    fName.seekg(chunkOffsets[cc]);
+    fName.read(chunk.data(), chunk.size());
+    if (fName.fail()) {
+      cerr << "ERROR: Compressed restart file is truncated!" << endl;
+      exit(EXIT_FAILURE);
+    }
+    const auto chunkValues = UnshuffleBytes(DecompressLZ(chunk, chunkRawSize));
+
+    // copy each overlapping row of i cells into procBlock
+    for (auto oo = 0U; oo < overlapBlks.size(); ++oo) {
+      const auto bb = overlapBlks[oo];
+      const auto &ov = overlaps[oo];
+      const auto &rng = ranges[blks[bb].GlobalPos()];
+      const auto rowSize = (ov[1] - ov[0]) * numVars;
+      for (auto kk = ov[4]; kk < ov[5]; ++kk) {
+        for (auto jj = ov[2]; jj < ov[3]; ++jj) {
+          const auto from =
+              ((static_cast<size_t>(kk - loc[6]) * numJ + jj - loc[4]) * numI +
+               ov[0] - loc[2]) * numVars;
+          const auto to =
+              ((static_cast<size_t>(kk - rng[2].Start()) * rng[1].Size() + jj -
+                rng[1].Start()) * rng[0].Size() + ov[0] - rng[0].Start()) *
+              numVars;
+          std::copy(chunkValues.begin() + from,
+                    chunkValues.begin() + from + rowSize,
+                    values[loc[0]][bb].begin() + to);
+        }
+      }
+    }
+  }
+
+  // rate is limited by slowest processor
+  auto elapsed = MPI_Wtime() - startTime;
+  MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+  if (rank == ROOTP) {
+    cout << "Restart data decompressed by a factor of "
+         << static_cast<double>(rawSize) / std::max(compressedSize, 1LL)
+         << " (" << compressedSize << " of " << rawSize << " bytes stored); "
+         << "read and decompressed at "
+         << rawSize / (1.0e6 * std::max(elapsed, 1.0e-12))
+         << " MB/s of uncompressed data (" << elapsed << " s)" << endl;
+  }
+  return values;
+}
 
 // function to write out plot3d meta data for Paraview
 void WriteMeta(const input &inp, const int &iter, const bool &isCenter) {
@@ -1004,6 +2226,51 @@ void WriteWallMeta(const input &inp, const int &iter) {
   metaFile.close();
 }
 
+// function to write out plot3d meta data of statistics for Paraview
+void WriteStatisticsMeta(const input &inp, const int &iter) {
+  // open meta file
+  const string fMetaPostfix = ".p3d";
+  const string fEnd = "_stats";
+  const auto metaName = inp.SimNameRoot() + fEnd + fMetaPostfix;
+  ofstream metaFile(metaName, ios::out);
+
+  const auto gridName = inp.GridName() + "_center.xyz";
+  const auto funName = inp.SimNameRoot() + "_" + to_string(iter) + fEnd + ".fun";
+
+  // check to see if file opened correctly
+  if (metaFile.fail()) {
+    cerr << "ERROR: Results file " << metaName << " did not open correctly!!!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  const auto outputVars = StatisticsNames(inp.StatisticsVariables());
+
+  // write to meta file
+  metaFile << "{" << endl;
+  metaFile << "\"auto-detect-format\" : true," << endl;
+  metaFile << "\"format\" : \"binary\"," << endl;
+  metaFile << "\"language\" : \"C\"," << endl;
+  metaFile << "\"filenames\" : [{ \"time\" : " << iter << ", \"xyz\" : \""
+           << gridName << "\", \"function\" : \"" << funName << "\" }]," << endl;
+
+  // Write out scalar variables
+  auto numVar = 0U;
+  metaFile << "\"function-names\" : [ ";
+  for (auto &var : outputVars) {
+    metaFile << "\"" << var << "\"";
+    if (numVar < outputVars.size() - 1) {
+      metaFile << ", ";
+    }
+    numVar++;
+  }
+  metaFile << " ]" << endl;
+  metaFile << "}" << endl;
+
+  // Close results file
+  metaFile.close();
+}
+
 void PrintHeaders(const input &inp, ostream &os) {
   // write out column headers
   os << std::left << setw(7) << "Step" << setw(8) << "NL-Iter";
@@ -1027,8 +2294,8 @@ void PrintHeaders(const input &inp, ostream &os) {
 // function to write out residual information
 void PrintResiduals(const input &inp, residual &residL2First,
                     const residual &residL2, const resid &residLinf,
-                    const double &matrixResid, const int &nn, const int &mm,
-                    ostream &os) {
+                    const double &matrixResid, const double &cfl,
+                    const int &nn, const int &mm, ostream &os) {
   // determine normalization
   // if at first iteration and not restart, normalize by itself
   if (nn == 0 && mm == 0 && !inp.IsRestart()) {
@@ -1049,9 +2316,9 @@ void PrintResiduals(const input &inp, residual &residL2First,
   if (inp.Dt() > 0.0) {
     os << std::left << setw(12) << setprecision(4) << std::scientific
        << inp.Dt();
-  } else if (inp.CFL() > 0.0) {
+  } else if (cfl > 0.0) {
     os << std::left << setw(12) << setprecision(4) << std::scientific
-       << inp.CFL();
+       << cfl;
   }
 
   // normalize residuals
@@ -1174,10 +2441,272 @@ int SplitBlockNumber(const vector<procBlock> &vars, const decomposition &decomp,
   return ind;  // cell was in uppermost split for given parent block
 }
 
+/* Function to find the number of cells in each parent block from the
+procBlocks on all processors. The sizes of all procBlocks are shared among the
+processors and the split history is replayed in reverse to join them back into
+their parent blocks.*/
+vector<vector3d<int>> ParentBlockCells(const vector<procBlock> &blks,
+                                       const decomposition &decomp) {
+  // blks -- procBlocks on this processor
+  // decomp -- decomposition
+
+  vector<int> numCells(3 * decomp.NumBlocks(), 0);
+  for (const auto &blk : blks) {
+    numCells[3 * blk.GlobalPos()] = blk.NumI();
+    numCells[3 * blk.GlobalPos() + 1] = blk.NumJ();
+    numCells[3 * blk.GlobalPos() + 2] = blk.NumK();
+  }
+  MPI_Allreduce(MPI_IN_PLACE, numCells.data(), numCells.size(), MPI_INT,
+                MPI_SUM, MPI_COMM_WORLD);
+
+  vector<vector3d<int>> cells;
+  cells.reserve(decomp.NumBlocks());
+  for (auto ii = 0; ii < decomp.NumBlocks(); ++ii) {
+    cells.emplace_back(numCells[3 * ii], numCells[3 * ii + 1],
+                       numCells[3 * ii + 2]);
+  }
+
+  // join upper portion of each split onto lower portion
+  for (auto ii = decomp.NumSplits() - 1; ii >= 0; ii--) {
+    const auto dir = decomp.SplitHistDir(ii);
+    const auto dd = (dir == "i") ? 0 : (dir == "j") ? 1 : 2;
+    cells[decomp.SplitHistBlkLower(ii)][dd] +=
+        cells[decomp.SplitHistBlkUpper(ii)][dd];
+  }
+  cells.resize(decomp.NumBlocks() - decomp.NumSplits());
+  return cells;
+}
+
+/* Function to write the variables of the procBlocks on this processor into a
+shared file with collective MPI-IO. Each procBlock is described by a subarray
+of its parent block, so the file is laid out exactly as if the recombined
+parent blocks were written one after another. The variables of a parent block
+are either ordered variable by variable (function files), or cell by cell
+(restart files). The values may be written in single precision.*/
+void WriteSplitBlocksMPI(MPI_File &outFile, const MPI_Offset &start,
+                         const vector<vector3d<int>> &parentCells,
+                         const vector<array<range, 3>> &ranges,
+                         const vector<procBlock> &blks,
+                         const vector<vector<double>> &values,
+                         const int &numVars, const bool &varMajor,
+                         const bool &isSingle, const decomposition &decomp) {
+  // outFile -- file to write to
+  // start -- location of first parent block in file
+  // parentCells -- number of cells in each parent block
+  // ranges -- range of parent block cells that make up each procBlock
+  // blks -- procBlocks on this processor
+  // values -- variables to write for each procBlock
+  // numVars -- number of variables per cell
+  // varMajor -- flag that is true if variables are ordered variable by variable
+  // isSingle -- flag that is true if values are written in single precision
+  // decomp -- decomposition
+
+  const auto valueSize = isSingle ? sizeof(float) : sizeof(double);
+  const auto valueType = isSingle ? MPI_FLOAT : MPI_DOUBLE;
+  const auto parentOffset =
+      ParentBlockOffsets(start, parentCells, numVars, valueSize);
+
+  // collective writes must be called by all processors, so processors with
+  // fewer blocks make empty writes
+  auto maxBlocks = static_cast<int>(blks.size());
+  MPI_Allreduce(MPI_IN_PLACE, &maxBlocks, 1, MPI_INT, MPI_MAX,
+                MPI_COMM_WORLD);
+
+  for (auto bb = 0; bb < maxBlocks; ++bb) {
+    if (bb >= static_cast<int>(blks.size())) {
+      MPI_File_set_view(outFile, 0, MPI_BYTE, MPI_BYTE, "native",
+                        MPI_INFO_NULL);
+      MPI_File_write_all(outFile, nullptr, 0, MPI_BYTE, MPI_STATUS_IGNORE);
+      continue;
+    }
+
+    const auto gp = blks[bb].GlobalPos();
+    const auto &par = parentCells[decomp.ParentBlock(gp)];
+    const auto &ri = ranges[gp][0];
+    const auto &rj = ranges[gp][1];
+    const auto &rk = ranges[gp][2];
+
+    // k index varies slowest in file
+    array<int, 4> sizes, subSizes, starts;
+    if (varMajor) {
+      sizes = {numVars, par.Z(), par.Y(), par.X()};
+      subSizes = {numVars, rk.Size(), rj.Size(), ri.Size()};
+      starts = {0, rk.Start(), rj.Start(), ri.Start()};
+    } else {
+      sizes = {par.Z(), par.Y(), par.X(), numVars};
+      subSizes = {rk.Size(), rj.Size(), ri.Size(), numVars};
+      starts = {rk.Start(), rj.Start(), ri.Start(), 0};
+    }
+
+    MPI_Datatype MPI_subBlock;
+    MPI_Type_create_subarray(4, sizes.data(), subSizes.data(), starts.data(),
+                             MPI_ORDER_C, valueType, &MPI_subBlock);
+    MPI_Type_commit(&MPI_subBlock);
+    MPI_File_set_view(outFile, parentOffset[decomp.ParentBlock(gp)],
+                      valueType, MPI_subBlock, "native", MPI_INFO_NULL);
+    if (isSingle) {
+      const vector<float> singleValues(values[bb].begin(), values[bb].end());
+      MPI_File_write_all(outFile, singleValues.data(), singleValues.size(),
+                         MPI_FLOAT, MPI_STATUS_IGNORE);
+    } else {
+      MPI_File_write_all(outFile, values[bb].data(), values[bb].size(),
+                         MPI_DOUBLE, MPI_STATUS_IGNORE);
+    }
+    MPI_Type_free(&MPI_subBlock);
+  }
+}
+
+// function to find location of start of each parent block in file
+vector<MPI_Offset> ParentBlockOffsets(const MPI_Offset &start,
+                                      const vector<vector3d<int>> &parentCells,
+                                      const int &numVars,
+                                      const size_t &valueSize) {
+  // start -- location of first parent block in file
+  // parentCells -- number of cells in each parent block
+  // numVars -- number of variables per cell
+  // valueSize -- number of bytes per value
+  vector<MPI_Offset> parentOffset(parentCells.size(), start);
+  for (auto ii = 1U; ii < parentCells.size(); ++ii) {
+    const auto &prev = parentCells[ii - 1];
+    parentOffset[ii] = parentOffset[ii - 1] +
+        static_cast<MPI_Offset>(prev.X()) * prev.Y() * prev.Z() * numVars *
+            valueSize;
+  }
+  return parentOffset;
+}
+
+// function to get parent block of each procBlock on this processor
+vector<int> SplitBlockParents(const vector<procBlock> &blks,
+                              const decomposition &decomp) {
+  // blks -- procBlocks on this processor
+  // decomp -- decomposition
+  vector<int> parents;
+  parents.reserve(blks.size());
+  for (const auto &blk : blks) {
+    parents.push_back(decomp.ParentBlock(blk.GlobalPos()));
+  }
+  return parents;
+}
+
+// function to get range of parent block cells of each procBlock on this
+// processor
+vector<array<range, 3>> SplitBlockRanges(
+    const vector<procBlock> &blks, const vector<array<range, 3>> &ranges) {
+  // blks -- procBlocks on this processor
+  // ranges -- range of parent block cells that make up each procBlock
+  vector<array<range, 3>> blkRanges;
+  blkRanges.reserve(blks.size());
+  for (const auto &blk : blks) {
+    blkRanges.push_back(ranges[blk.GlobalPos()]);
+  }
+  return blkRanges;
+}
+
+/* Function to write the variables of the procBlocks on this processor into a
+shared file without MPI, so that it can be called from the background output
+thread. The file must already exist. The file is laid out the same as by
+WriteSplitBlocksMPI; each contiguous row of i cells is written in turn. The
+rows written by different processors do not overlap.*/
+void WriteSplitBlocks(const string &fileName, const MPI_Offset &start,
+                      const vector<vector3d<int>> &parentCells,
+                      const vector<int> &parents,
+                      const vector<array<range, 3>> &blkRanges,
+                      const vector<vector<double>> &values,
+                      const int &numVars, const bool &varMajor,
+                      const bool &isSingle) {
+  // fileName -- name of file to write to
+  // start -- location of first parent block in file
+  // parentCells -- number of cells in each parent block
+  // parents -- parent block of each procBlock
+  // blkRanges -- range of parent block cells that make up each procBlock
+  // values -- variables to write for each procBlock
+  // numVars -- number of variables per cell
+  // varMajor -- flag that is true if variables are ordered variable by variable
+  // isSingle -- flag that is true if values are written in single precision
+
+  fstream outFile(fileName, ios::in | ios::out | ios::binary);
+  if (outFile.fail()) {
+    cerr << "ERROR: File " << fileName << " did not open correctly!!!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  const auto valueSize = isSingle ? sizeof(float) : sizeof(double);
+  const auto parentOffset =
+      ParentBlockOffsets(start, parentCells, numVars, valueSize);
+  for (auto bb = 0U; bb < values.size(); ++bb) {
+    const auto &par = parentCells[parents[bb]];
+    const auto &ri = blkRanges[bb][0];
+    const auto &rj = blkRanges[bb][1];
+    const auto &rk = blkRanges[bb][2];
+    const auto numVarRows = varMajor ? numVars : 1;
+    const auto rowSize = varMajor ? ri.Size() : ri.Size() * numVars;
+    const auto cellSize = varMajor ? 1 : numVars;
+
+    auto val = values[bb].data();
+    for (auto vv = 0; vv < numVarRows; ++vv) {
+      for (auto kk = rk.Start(); kk < rk.End(); ++kk) {
+        for (auto jj = rj.Start(); jj < rj.End(); ++jj) {
+          const auto cell =
+              ((static_cast<MPI_Offset>(vv) * par.Z() + kk) * par.Y() + jj) *
+                  par.X() + ri.Start();
+          outFile.seekp(parentOffset[parents[bb]] +
+                        cell * cellSize * valueSize);
+          WriteValues(outFile, val, rowSize, isSingle);
+          val += rowSize;
+        }
+      }
+    }
+  }
+
+  if (outFile.fail()) {
+    cerr << "ERROR: Problem writing file " << fileName << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// function to write out values in single or double precision
+void WriteValues(ostream &outFile, const double *values,
+                 const size_t &numValues, const bool &isSingle) {
+  // outFile -- file to write to
+  // values -- values to write
+  // numValues -- number of values to write
+  // isSingle -- flag that is true if values are written in single precision
+  if (isSingle) {
+    const vector<float> singleValues(values, values + numValues);
+    outFile.write(reinterpret_cast<const char *>(singleValues.data()),
+                  numValues * sizeof(float));
+  } else {
+    outFile.write(reinterpret_cast<const char *>(values),
+                  numValues * sizeof(double));
+  }
+}
+
+// function to write out block dimensions of parent blocks
+void WriteBlockDims(ofstream &outFile, const vector<vector3d<int>> &blkCells,
+                    int numVars) {
+  // write number of blocks to file
+  auto numBlks = static_cast<int>(blkCells.size());
+  outFile.write(reinterpret_cast<char *>(&numBlks), sizeof(numBlks));
+
+  // loop over all blocks and write out imax, jmax, kmax, numVars
+  for (auto cells : blkCells) {
+    outFile.write(reinterpret_cast<char *>(&cells[0]), sizeof(cells[0]));
+    outFile.write(reinterpret_cast<char *>(&cells[1]), sizeof(cells[1]));
+    outFile.write(reinterpret_cast<char *>(&cells[2]), sizeof(cells[2]));
+
+    if (numVars > 0) {
+      outFile.write(reinterpret_cast<char *>(&numVars), sizeof(numVars));
+    }
+  }
+}
+
 blkMultiArray3d<primitive> ReadSolFromRestart(
-    ifstream &resFile, const input &inp, const physics &phys,
+    const vector<double> &values, const input &inp, const physics &phys,
     const vector<string> &restartVars, const int &numI, const int &numJ,
     const int &numK, const int &numSpecies) {
+  // values -- restart variables of block -- all variables of one cell, then
+  //           the next
   // intialize multiArray3d
   // -1 b/c mf and density written to file
   auto numEqns = restartVars.size() - 1;
@@ -1185,6 +2714,7 @@ blkMultiArray3d<primitive> ReadSolFromRestart(
 
   // read the primitive variables
   // read dimensional variables -- loop over physical cells
+  auto val = values.begin();
   for (auto kk = sol.StartK(); kk < sol.EndK(); kk++) {
     for (auto jj = sol.StartJ(); jj < sol.EndJ(); jj++) {
       for (auto ii = sol.StartI(); ii < sol.EndI(); ii++) {
@@ -1193,38 +2723,38 @@ blkMultiArray3d<primitive> ReadSolFromRestart(
         // loop over the number of variables to read
         for (auto &var : restartVars) {
           if (var == "density") {
-            resFile.read(reinterpret_cast<char *>(&rho), sizeof(rho));
+            rho = *val++;
             rho /= inp.RRef();
           } else if (var == "vel_x") {
             auto n = value.MomentumXIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef();
           } else if (var == "vel_y") {
             auto n = value.MomentumYIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef();
           } else if (var == "vel_z") {
             auto n = value.MomentumZIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef();
           } else if (var == "pressure") {
             auto n = value.EnergyIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.RRef() * inp.ARef() * inp.ARef();
           } else if (var == "tke") {
             auto n = value.TurbulenceIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef() * inp.ARef();
           } else if (var == "sdr") {
             auto n = value.TurbulenceIndex() + 1;
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef() * inp.ARef() * inp.RRef() /
                         phys.Transport()->MuRef();
           } else if (var.substr(0, 3) == "mf_" &&
                      inp.HaveSpecies(var.substr(3, string::npos))) {
             auto n = inp.SpeciesIndex(var.substr(3, string::npos));
             auto mf = 0.0;
-            resFile.read(reinterpret_cast<char *>(&mf), sizeof(mf));
+            mf = *val++;
             value[n] = rho * mf;
           } else {
             cerr << "ERROR: Variable " << var
@@ -1240,9 +2770,11 @@ blkMultiArray3d<primitive> ReadSolFromRestart(
 }
 
 blkMultiArray3d<conserved> ReadSolNm1FromRestart(
-    ifstream &resFile, const input &inp, const physics &phys,
+    const vector<double> &values, const input &inp, const physics &phys,
     const vector<string> &restartVars, const int &numI, const int &numJ,
     const int &numK, const int &numSpecies) {
+  // values -- restart variables of block -- all variables of one cell, then
+  //           the next
   // intialize multiArray3d
   // -1 b/c mf and density written to file
   auto numEqns = restartVars.size() - 1;
@@ -1250,6 +2782,7 @@ blkMultiArray3d<conserved> ReadSolNm1FromRestart(
 
   // data is conserved variables
   // read dimensional variables -- loop over physical cells
+  auto val = values.begin();
   for (auto kk = sol.StartK(); kk < sol.EndK(); kk++) {
     for (auto jj = sol.StartJ(); jj < sol.EndJ(); jj++) {
       for (auto ii = sol.StartI(); ii < sol.EndI(); ii++) {
@@ -1258,38 +2791,38 @@ blkMultiArray3d<conserved> ReadSolNm1FromRestart(
         // loop over the number of variables to read
         for (auto &var : restartVars) {
           if (var == "density") {
-            resFile.read(reinterpret_cast<char *>(&rho), sizeof(rho));
+            rho = *val++;
             rho /= inp.RRef();
           } else if (var == "vel_x") {  // conserved var is rho-u
             auto n = value.MomentumXIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef() * inp.RRef();
           } else if (var == "vel_y") {  // conserved var is rho-v
             auto n = value.MomentumYIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef() * inp.RRef();
           } else if (var == "vel_z") {  // conserved var is rho-w
             auto n = value.MomentumZIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef() * inp.RRef();
           } else if (var == "pressure") {  // conserved var is rho-E
             auto n = value.EnergyIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.RRef() * inp.ARef() * inp.ARef();
           } else if (var == "tke") {  // conserved var is rho-tke
             auto n = value.TurbulenceIndex();
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef() * inp.ARef() * inp.RRef();
           } else if (var == "sdr") {  // conserved var is rho-sdr
             auto n = value.TurbulenceIndex() + 1;
-            resFile.read(reinterpret_cast<char *>(&value[n]), sizeof(value[n]));
+            value[n] = *val++;
             value[n] /= inp.ARef() * inp.ARef() * inp.RRef() * inp.RRef() /
                         phys.Transport()->MuRef();
           } else if (var.substr(0, 3) == "mf_" &&
                      inp.HaveSpecies(var.substr(3, string::npos))) {
             auto n = inp.SpeciesIndex(var.substr(3, string::npos));
             auto mf = 0.0;
-            resFile.read(reinterpret_cast<char *>(&mf), sizeof(mf));
+            mf = *val++;
             value[n] = rho * mf;
           } else {
             cerr << "ERROR: Variable " << var
@@ -0,0 +1,93 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <thread>               // thread
+#include <mutex>                // mutex, unique_lock
+#include <condition_variable>   // condition_variable
+#include <functional>           // function
+#include "outputQueue.hpp"
+
+using std::unique_lock;
+using std::mutex;
+
+// constructor -- background thread is only started if tasks can be queued
+outputQueue::outputQueue(const int &maxSize)
+    : maxSize_(maxSize), isWriting_(false), isDone_(false) {
+  // maxSize -- maximum number of tasks queued or being written
+  if (this->IsAsync()) {
+    writer_ = std::thread(&outputQueue::WriteTasks, this);
+  }
+}
+
+// member function to add a task to the queue. If the queue is full, this
+// waits for the oldest task to finish writing. If no tasks can be queued, the
+// task is written immediately.
+void outputQueue::Push(const function<void()> &task) {
+  // task -- function that writes output to disk
+  // task being written counts against queue size, so at most maxSize staging
+  // buffers are held at once
+  if (!this->IsAsync()) {
+    task();
+    return;
+  }
+
+  unique_lock<mutex> lock(mutex_);
+  changed_.wait(lock, [this] {
+    return static_cast<int>(tasks_.size()) + isWriting_ < maxSize_;
+  });
+  tasks_.push_back(task);
+  changed_.notify_all();
+}
+
+// member function to wait for all queued tasks to finish writing
+void outputQueue::Wait() {
+  unique_lock<mutex> lock(mutex_);
+  changed_.wait(lock, [this] { return tasks_.empty() && !isWriting_; });
+}
+
+// member function run on background thread to write tasks in order
+void outputQueue::WriteTasks() {
+  while (true) {
+    unique_lock<mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return !tasks_.empty() || isDone_; });
+    if (tasks_.empty()) {
+      return;
+    }
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    isWriting_ = true;
+    changed_.notify_all();
+    lock.unlock();
+
+    task();
+
+    lock.lock();
+    isWriting_ = false;
+    changed_.notify_all();
+  }
+}
+
+// destructor -- all queued tasks are written before background thread stops
+outputQueue::~outputQueue() noexcept {
+  if (writer_.joinable()) {
+    {
+      unique_lock<mutex> lock(mutex_);
+      isDone_ = true;
+      changed_.notify_all();
+    }
+    writer_.join();
+  }
+}
@@ -16,6 +16,7 @@
 
 #include <algorithm>  // max_element
 #include <iterator>   // distance
+#include <numeric>    // accumulate
 #include <cstring>
 #include <vector>  // vector
 #include <string>  // string
@@ -29,6 +30,9 @@
 #include "boundaryConditions.hpp"  // connection
 #include "resid.hpp"               // resid
 #include "gridLevel.hpp"
+#include "graphPartition.hpp"     // weightedGraph
+#include "input.hpp"               // input
+#include "inputStates.hpp"         // inputState
 #include "macros.hpp"
 
 using std::max_element;
@@ -37,16 +41,89 @@ using std::distance;
 using std::unique_ptr;
 using std::make_unique;
 
+/* Function to estimate the relative cost of a cell in each block. A cell of an
+inviscid, frozen, single species block with second order reconstruction has a
+cost of 1. Physics options add to the cost of every cell: WENO reconstruction,
+viscous fluxes, turbulence models, additional species, finite rate chemistry,
+and block implicit matrix solvers. Boundary work that is done per face, such as
+wall laws, is spread over the cells of the block that owns the faces.
+*/
+vector<double> CellCostModel(const input &inp, const vector<plot3dBlock> &grid,
+                             const vector<boundaryConditions> &bcs) {
+  // inp -- input variables
+  // grid -- vector of plot3dBlocks making up entire grid
+  // bcs -- vector of boundary conditions for all blocks
+
+  // cost of physics options relative to cost of a plain Euler cell
+  auto physicsCost = 1.0;
+  if (inp.UsingHigherOrderReconstruction()) {
+    physicsCost += 1.0;
+  }
+  if (inp.IsViscous()) {
+    physicsCost += 1.0;
+  }
+  if (inp.IsRANS()) {
+    physicsCost += 1.0;
+  } else if (inp.IsLES()) {
+    physicsCost += 0.5;
+  }
+  physicsCost += 0.25 * (inp.NumSpecies() - 1);
+  if (inp.ChemistryModel() == "reacting") {
+    physicsCost += 1.0 + 0.5 * inp.NumSpecies();
+  }
+  if (inp.IsBlockMatrix()) {
+    physicsCost += 0.5;
+  }
+
+  // boundary work per face is spread over the cells of each block
+  const decomposition faces(vector<double>(grid.size(), physicsCost),
+                            FaceCostModel(inp, bcs), 1);
+  vector<double> cellCost(grid.size(), physicsCost);
+  for (auto ii = 0U; ii < grid.size(); ++ii) {
+    cellCost[ii] += faces.FaceLoad(bcs[ii]) / grid[ii].NumCells();
+  }
+  return cellCost;
+}
+
+/* Function to estimate the additional cost of a face of the boundary surfaces
+with each tag. Wall law faces are the only boundary faces with enough work to
+be counted. The face costs are kept in the decomposition so that the cost of
+each portion of a split block can be found from its own boundary surfaces.
+*/
+map<int, double> FaceCostModel(const input &inp,
+                               const vector<boundaryConditions> &bcs) {
+  // inp -- input variables
+  // bcs -- vector of boundary conditions for all blocks
+
+  // cost of a wall law face relative to cost of a plain Euler cell
+  constexpr auto wallLawFaceCost = 5.0;
+
+  map<int, double> faceCost;
+  for (const auto &bc : bcs) {
+    for (auto jj = 0; jj < bc.NumSurfaces(); ++jj) {
+      if (bc.GetBCTypes(jj) == "viscousWall" &&
+          inp.BCData(bc.GetTag(jj))->IsWallLaw()) {
+        faceCost[bc.GetTag(jj)] = wallLawFaceCost;
+      }
+    }
+  }
+  return faceCost;
+}
+
 /* Function to return processor list for manual decomposition. Manual
 decomposition assumes that each block will reside on it's own processor.
 The processor list tells how many procBlocks a processor will have.
 */
 decomposition ManualDecomposition(vector<plot3dBlock> &grid,
                                   vector<boundaryConditions> &bcs,
+                                  const vector<double> &cellCost,
+                                  const map<int, double> &faceCost,
                                   const int &numProc) {
   // grid -- vector of procBlocks (no need to split procBlocks or combine them
   // with manual decomposition)
   // bcs -- vector of boundary conditions for each block in grid
+  // cellCost -- relative cost of a cell in each block
+  // faceCost -- additional cost of a face of boundary surfaces with each tag
   // numProc -- number of processors in run
 
   if (static_cast<int>(grid.size()) != numProc) {
@@ -63,7 +140,7 @@ decomposition ManualDecomposition(vector<plot3dBlock> &grid,
           "------------" << endl;
   cout << "Using manual grid decomposition." << endl;
 
-  decomposition decomp(grid.size(), numProc);
+  decomposition decomp(cellCost, faceCost, numProc);
   for (auto ii = 1U; ii < grid.size(); ii++) {
     decomp.SendToProc(ii, ROOTP, ii);  // send block from ROOT to processor
   }
@@ -89,27 +166,61 @@ decomposition ManualDecomposition(vector<plot3dBlock> &grid,
   return decomp;
 }
 
-/* Function to return processor list for cubic decomposition.
-The processor list tells how many procBlocks a processor will have.
+/* Function to split a block into two blocks. The grid and boundary conditions
+are split, interblock partners of the split block are updated, and the split is
+recorded in the decomposition. The upper portion of the split block is appended
+to the end of the grid and stays on the same processor as the lower portion.
 */
-decomposition CubicDecomposition(vector<plot3dBlock> &grid,
-                                 vector<boundaryConditions> &bcs,
-                                 const int &numProc) {
-  // grid -- vector of procBlocks (no need to split procBlocks or combine them
-  // with manual decomposition)
+void SplitBlock(vector<plot3dBlock> &grid, vector<boundaryConditions> &bcs,
+                decomposition &decomp, const int &blk, const int &ind,
+                const string &dir) {
+  // grid -- vector of plot3dBlocks making up entire grid
   // bcs -- vector of boundary conditions for all blocks
-  // numProc -- number of processors in run
+  // decomp -- decomposition to record split in
+  // blk -- block to split
+  // ind -- index (face) to split at
+  // dir -- direction of split
 
-  cout << "--------------------------------------------------------------------"
-          "------------" << endl;
-  cout << "Using cubic grid decomposition." << endl;
+  auto newBlk = static_cast<int>(grid.size());
+  // find all interblocks that could be altered by this split along with
+  // their partners and orientation
+  auto affectedConnections = GetBlockInterConnBCs(bcs, grid, blk);
+
+  // split grid
+  const auto uBlk = grid[blk].Split(dir, ind);
+  grid.push_back(uBlk);
+
+  // split bcs
+  vector<boundarySurface> altSurf;
+  auto newBcs = bcs[blk].Split(dir, ind, blk, newBlk, altSurf);
+  bcs.push_back(newBcs);
+
+  // update interblock partners affected by split
+  for (auto &alt : altSurf) {
+    bcs[alt.PartnerBlock()].DependentSplit(
+        alt, affectedConnections.at(alt).first,
+        affectedConnections.at(alt).second, alt.PartnerBlock(), dir, ind, blk,
+        newBlk);
+  }
+
+  decomp.Split(blk, ind, dir, grid, bcs);
+}
+
+/* Function to balance the load of a decomposition. Blocks are sent whole or
+split and sent from the most overloaded processor to the most underloaded
+processor until the most loaded processor is within 10% of the ideal load.
+*/
+void BalanceLoad(vector<plot3dBlock> &grid, vector<boundaryConditions> &bcs,
+                 decomposition &decomp) {
+  // grid -- vector of plot3dBlocks making up entire grid
+  // bcs -- vector of boundary conditions for all blocks
+  // decomp -- decomposition to balance
 
-  decomposition decomp(grid.size(), numProc);
   // average number of cells per processor
-  auto idealLoad = decomp.IdealLoad(grid);
+  const auto idealLoad = decomp.IdealLoad(grid);
   auto count = 0;
 
-  const auto maxSplits = numProc * 10;
+  const auto maxSplits = decomp.NumProcs() * 10;
   while (decomp.MaxLoad(grid) / idealLoad > 1.1 && count < maxSplits) {
     auto loaded = 0.0;
     auto ol = decomp.MostOverloadedProc(grid, loaded);
@@ -119,34 +230,10 @@ decomposition CubicDecomposition(vector<plot3dBlock> &grid,
     auto blk = 0;
     auto ind = decomp.SendWholeOrSplit(grid, ol, ul, blk, dir);
 
-    if (ind < 0) {  // send whole
-      decomp.SendToProc(blk, ol, ul);
-    } else {  // split/send
-      auto newBlk = static_cast<int>(grid.size());
-      // find all interblocks that could be altered by this split along with
-      // their partners and orientation
-      auto affectedConnections = GetBlockInterConnBCs(bcs, grid, blk);
-
-      // split grid
-      const auto uBlk = grid[blk].Split(dir, ind);
-      grid.push_back(uBlk);
-
-      // split bcs
-      vector<boundarySurface> altSurf;
-      auto newBcs = bcs[blk].Split(dir, ind, blk, newBlk, altSurf);
-      bcs.push_back(newBcs);
-
-      // update interblock partners affected by split
-      for (auto &alt : altSurf) {
-        bcs[alt.PartnerBlock()].DependentSplit(
-            alt, affectedConnections.at(alt).first,
-            affectedConnections.at(alt).second, alt.PartnerBlock(), dir, ind,
-            blk, newBlk);
-      }
-
-      decomp.Split(blk, ind, dir);
-      decomp.SendToProc(blk, ol, ul);
+    if (ind >= 0) {  // split/send
+      SplitBlock(grid, bcs, decomp, blk, ind, dir);
     }
+    decomp.SendToProc(blk, ol, ul);
 
     count++;
   }
@@ -155,10 +242,197 @@ decomposition CubicDecomposition(vector<plot3dBlock> &grid,
     cout << "WARNING: Maximum number of splits in decomposition has been "
             "reached." << endl;
   }
+}
+
+/* Function to rebalance the load of a decomposition during a simulation. Blocks
+are only sent whole, because splitting a block would change the grid. The block
+on the most loaded processor with a load closest to half the difference between
+the most and least loaded processors is sent to the least loaded processor.
+This is repeated until the most loaded processor is within 10% of the ideal
+load, or no block can be sent without the least loaded processor becoming more
+loaded than the most loaded processor was. The number of blocks sent is
+returned.
+*/
+int RebalanceLoad(decomposition &decomp, const vector<int> &numCells) {
+  // decomp -- decomposition to rebalance
+  // numCells -- number of cells in each block
+
+  vector<double> blockLoad(decomp.NumBlocks());
+  vector<double> procLoad(decomp.NumProcs(), 0.0);
+  for (auto ii = 0; ii < decomp.NumBlocks(); ++ii) {
+    blockLoad[ii] = decomp.CellCost(ii) * numCells[ii];
+    procLoad[decomp.Rank(ii)] += blockLoad[ii];
+  }
+  const auto idealLoad =
+      std::accumulate(std::begin(procLoad), std::end(procLoad), 0.0) /
+      decomp.NumProcs();
+
+  auto count = 0;
+  while (count < decomp.NumBlocks()) {
+    const auto ol = distance(
+        procLoad.begin(), max_element(procLoad.begin(), procLoad.end()));
+    const auto ul = distance(
+        procLoad.begin(), min_element(procLoad.begin(), procLoad.end()));
+    if (procLoad[ol] <= 1.1 * idealLoad) {
+      break;
+    }
+
+    // sending a block with a load less than the difference reduces the load
+    // on the most loaded processor without creating a new one
+    const auto target = 0.5 * (procLoad[ol] - procLoad[ul]);
+    auto blk = -1;
+    for (auto ii = 0; ii < decomp.NumBlocks(); ++ii) {
+      if (decomp.Rank(ii) == ol && blockLoad[ii] > 0.0 &&
+          blockLoad[ii] < 2.0 * target &&
+          (blk < 0 ||
+           fabs(blockLoad[ii] - target) < fabs(blockLoad[blk] - target))) {
+        blk = ii;
+      }
+    }
+    if (blk < 0) {
+      break;
+    }
+
+    decomp.SendToProc(blk, ol, ul);
+    procLoad[ol] -= blockLoad[blk];
+    procLoad[ul] += blockLoad[blk];
+    count++;
+  }
+  return count;
+}
+
+/* Function to determine which node each processor is on. Processors that can
+share memory are on the same node. Nodes are numbered in order of the lowest
+rank on each node, and the node of every processor is returned on all
+processors.
+*/
+vector<int> NodeLayout() {
+  auto rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  auto numProcs = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+
+  // lowest rank on node identifies the node
+  MPI_Comm nodeComm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+                      MPI_INFO_NULL, &nodeComm);
+  auto leader = rank;
+  MPI_Allreduce(MPI_IN_PLACE, &leader, 1, MPI_INT, MPI_MIN, nodeComm);
+  MPI_Comm_free(&nodeComm);
+
+  vector<int> leaders(numProcs, 0);
+  MPI_Allgather(&leader, 1, MPI_INT, leaders.data(), 1, MPI_INT,
+                MPI_COMM_WORLD);
+
+  // number nodes consecutively
+  vector<int> nodeOfRank(numProcs, 0);
+  auto numNodes = 0;
+  for (auto ii = 0; ii < numProcs; ++ii) {
+    nodeOfRank[ii] = (leaders[ii] == ii) ? numNodes++
+                                         : nodeOfRank[leaders[ii]];
+  }
+  return nodeOfRank;
+}
+
+/* Function to map the processors of a decomposition onto the nodes of the
+machine. The decomposition only determines which blocks are grouped together
+on a processor, so the groups can be assigned to any rank. Each node is filled
+in turn, starting with the lowest numbered unassigned processor, and then adding
+the processor that shares the most interblock faces with the processors already
+on the node. This keeps the largest connections between processors within a
+node, where halo data is exchanged through shared memory. The halo data sent
+between nodes before and after the mapping is reported.
+*/
+void MapProcsToNodes(const vector<boundaryConditions> &bcs,
+                     const vector<int> &nodeOfRank, const input &inp,
+                     decomposition &decomp) {
+  // bcs -- vector of boundary conditions for all blocks
+  // nodeOfRank -- node of each processor
+  // inp -- input variables
+  // decomp -- decomposition to map onto nodes
+
+  // interblock faces shared between each pair of processors
+  const auto numProcs = decomp.NumProcs();
+  vector<vector<double>> sharedFaces(numProcs, vector<double>(numProcs, 0.0));
+  for (auto ii = 0U; ii < bcs.size(); ++ii) {
+    for (auto jj = 0; jj < bcs[ii].NumSurfaces(); ++jj) {
+      if (bcs[ii].GetBCTypes(jj) == "interblock") {
+        const auto surf = bcs[ii].GetSurface(jj);
+        const auto p1 = decomp.Rank(ii);
+        const auto p2 = decomp.Rank(surf.PartnerBlock());
+        if (surf.PartnerBlock() > static_cast<int>(ii) && p1 != p2) {
+          sharedFaces[p1][p2] += surf.NumFaces();
+          sharedFaces[p2][p1] += surf.NumFaces();
+        }
+      }
+    }
+  }
+
+  // ranks on each node
+  const auto numNodes =
+      *max_element(std::begin(nodeOfRank), std::end(nodeOfRank)) + 1;
+  vector<vector<int>> nodeRanks(numNodes);
+  for (auto ii = 0; ii < numProcs; ++ii) {
+    nodeRanks[nodeOfRank[ii]].push_back(ii);
+  }
+
+  // fill each node with the processors most connected to it
+  vector<int> newRank(numProcs, -1);
+  for (const auto &ranks : nodeRanks) {
+    vector<double> nodeFaces(numProcs, 0.0);
+    for (const auto &rr : ranks) {
+      auto proc = -1;
+      for (auto ii = 0; ii < numProcs; ++ii) {
+        if (newRank[ii] < 0 &&
+            (proc < 0 || nodeFaces[ii] > nodeFaces[proc])) {
+          proc = ii;
+        }
+      }
+      newRank[proc] = rr;
+      for (auto ii = 0; ii < numProcs; ++ii) {
+        nodeFaces[ii] += sharedFaces[ii][proc];
+      }
+    }
+  }
+
+  // halo data per cell face for one exchange of the state
+  const auto faceBytes =
+      inp.NumberGhostLayers() * inp.NumEquations() * sizeof(double);
+  auto interBefore = 0.0;
+  auto interAfter = 0.0;
+  auto intraAfter = 0.0;
+  for (auto p1 = 0; p1 < numProcs; ++p1) {
+    for (auto p2 = 0; p2 < numProcs; ++p2) {
+      const auto bytes = faceBytes * sharedFaces[p1][p2];
+      if (nodeOfRank[p1] != nodeOfRank[p2]) {
+        interBefore += bytes;
+      }
+      if (nodeOfRank[newRank[p1]] != nodeOfRank[newRank[p2]]) {
+        interAfter += bytes;
+      } else {
+        intraAfter += bytes;
+      }
+    }
+  }
+  decomp.PermuteRanks(newRank);
+
+  cout << "Mapped processors onto " << numNodes << " nodes." << endl;
+  cout << "Halo bytes sent between nodes per exchange: " << interBefore
+       << " before mapping, " << interAfter << " after mapping" << endl;
+  cout << "Halo bytes sent within nodes per exchange: " << intraAfter << endl;
+  cout << "--------------------------------------------------------------------"
+          "------------" << endl;
+}
+
+// function to print a summary of the load on each processor
+void PrintLoadSummary(const vector<plot3dBlock> &grid,
+                      const decomposition &decomp) {
+  // grid -- vector of plot3dBlocks making up entire grid
+  // decomp -- decomposition of grid
 
   decomp.PrintDiagnostics(grid);
   cout << endl;
-  cout << "Ideal Load: " << idealLoad << endl;
+  cout << "Ideal Load: " << decomp.IdealLoad(grid) << endl;
   cout << "Max Load: " << decomp.MaxLoad(grid) << endl;
 
   auto loaded = 0.0;
@@ -170,18 +444,136 @@ decomposition CubicDecomposition(vector<plot3dBlock> &grid,
        << loaded << endl;
 
   cout << "Ratio of most loaded processor to average processor is : "
-       << decomp.MaxLoad(grid) / idealLoad << endl;
+       << decomp.MaxLoad(grid) / decomp.IdealLoad(grid) << endl;
+}
+
+/* Function to return processor list for cubic decomposition.
+The processor list tells how many procBlocks a processor will have.
+*/
+decomposition CubicDecomposition(vector<plot3dBlock> &grid,
+                                 vector<boundaryConditions> &bcs,
+                                 const vector<double> &cellCost,
+                                 const map<int, double> &faceCost,
+                                 const int &numProc) {
+  // grid -- vector of procBlocks (no need to split procBlocks or combine them
+  // with manual decomposition)
+  // bcs -- vector of boundary conditions for all blocks
+  // cellCost -- relative cost of a cell in each block
+  // faceCost -- additional cost of a face of boundary surfaces with each tag
+  // numProc -- number of processors in run
+
+  cout << "--------------------------------------------------------------------"
+          "------------" << endl;
+  cout << "Using cubic grid decomposition." << endl;
+
+  decomposition decomp(cellCost, faceCost, numProc);
+  BalanceLoad(grid, bcs, decomp);
+
+  PrintLoadSummary(grid, decomp);
   cout << "--------------------------------------------------------------------"
           "------------" << endl << endl;
 
   return decomp;
 }
 
-// function to send each processor the number of procBlocks that it should
-// contain
-void SendNumProcBlocks(const vector<int> &loadBal, int &numProcBlock) {
-  MPI_Scatter(&loadBal[0], 1, MPI_INT, &numProcBlock, 1, MPI_INT, ROOTP,
-              MPI_COMM_WORLD);
+/* Function to return processor list for graph decomposition. Blocks larger
+than half the ideal load are first split in half along their longest direction
+so that there is enough granularity to balance the load. A graph is then formed
+where each block is a vertex weighted by its number of cells and each interblock
+connection is an edge weighted by its number of faces. The graph is partitioned
+with multilevel recursive bisection so that few faces are cut between
+processors, and blocks are sent to the processor of their partition. Any
+remaining imbalance is removed in the same way as the cubic decomposition.
+*/
+decomposition GraphDecomposition(vector<plot3dBlock> &grid,
+                                 vector<boundaryConditions> &bcs,
+                                 const vector<double> &cellCost,
+                                 const map<int, double> &faceCost,
+                                 const int &numProc) {
+  // grid -- vector of plot3dBlocks making up entire grid
+  // bcs -- vector of boundary conditions for all blocks
+  // cellCost -- relative cost of a cell in each block
+  // faceCost -- additional cost of a face of boundary surfaces with each tag
+  // numProc -- number of processors in run
+
+  cout << "--------------------------------------------------------------------"
+          "------------" << endl;
+  cout << "Using graph grid decomposition." << endl;
+
+  decomposition decomp(cellCost, faceCost, numProc);
+  if (numProc > 1) {
+    // split large blocks in half along longest direction
+    const auto maxBlockLoad = 0.5 * decomp.IdealLoad(grid);
+    vector<bool> canSplit(grid.size(), true);
+    const auto maxSplits = numProc * 10;
+    for (auto count = 0; count < maxSplits; ++count) {
+      auto blk = -1;
+      auto bLoad = maxBlockLoad;
+      for (auto ii = 0U; ii < grid.size(); ++ii) {
+        if (canSplit[ii] && decomp.BlockLoad(grid, ii) > bLoad) {
+          blk = ii;
+          bLoad = decomp.BlockLoad(grid, ii);
+        }
+      }
+      if (blk < 0) {
+        break;
+      }
+
+      string dir = "k";
+      auto splitLen = grid[blk].NumCellsK();
+      if (grid[blk].NumCellsI() >= grid[blk].NumCellsJ() &&
+          grid[blk].NumCellsI() >= splitLen) {
+        dir = "i";
+        splitLen = grid[blk].NumCellsI();
+      } else if (grid[blk].NumCellsJ() >= splitLen) {
+        dir = "j";
+        splitLen = grid[blk].NumCellsJ();
+      }
+      // need to keep at least 2 cells thick for ghost cell passing
+      if (splitLen < 4) {
+        canSplit[blk] = false;
+        continue;
+      }
+      SplitBlock(grid, bcs, decomp, blk, splitLen / 2, dir);
+      canSplit.push_back(true);
+    }
+
+    // form graph of blocks and interblock connections
+    vector<double> weights(grid.size());
+    for (auto ii = 0U; ii < grid.size(); ++ii) {
+      weights[ii] = decomp.BlockLoad(grid, ii);
+    }
+    weightedGraph graph(weights);
+    auto totalFaces = 0;
+    for (auto ii = 0U; ii < bcs.size(); ++ii) {
+      for (auto jj = 0; jj < bcs[ii].NumSurfaces(); ++jj) {
+        if (bcs[ii].GetBCTypes(jj) == "interblock") {
+          const auto surf = bcs[ii].GetSurface(jj);
+          if (surf.PartnerBlock() > static_cast<int>(ii)) {
+            graph.AddEdge(ii, surf.PartnerBlock(), surf.NumFaces());
+            totalFaces += surf.NumFaces();
+          }
+        }
+      }
+    }
+
+    const auto part = graph.Partition(numProc, 0.05);
+    for (auto ii = 0; ii < graph.NumVertices(); ++ii) {
+      if (part[ii] != decomp.Rank(ii)) {
+        decomp.SendToProc(ii, decomp.Rank(ii), part[ii]);
+      }
+    }
+    cout << "Graph partition cuts " << graph.CutWeight(part) << " of "
+         << totalFaces << " interblock faces." << endl;
+  }
+
+  BalanceLoad(grid, bcs, decomp);
+
+  PrintLoadSummary(grid, decomp);
+  cout << "--------------------------------------------------------------------"
+          "------------" << endl << endl;
+
+  return decomp;
 }
 
 /* Function to set custom MPI datatypes to allow for easier data transmission */
@@ -262,7 +654,7 @@ void SetDataTypesMPI(MPI_Datatype &MPI_vec3d,
   for (auto ii = nFields - 1; ii >= 0; ii--) {
     disp[ii] -= disp[0];
   }
-  MPI_Type_create_struct(11, counts, disp, types, &MPI_connection);
+  MPI_Type_create_struct(nFields, counts, disp, types, &MPI_connection);
 
   // check that datatype has the correct extent, if it doesn't change the extent
   // this is necessary to portably send an array of this type
@@ -347,7 +739,7 @@ void GetProcBlocks(vector<procBlock> &blocks,
         blk = localBlocks[blk.LocalPosition()];
       } else {  // recv data from sending processors
         blk.RecvUnpackSolMPI(MPI_uncoupledScalar, MPI_vec3d, MPI_tensorDouble,
-                             inp);
+                             inp, blk.Rank());
       }
       count++;
     }
@@ -370,7 +762,7 @@ void GetProcBlocks(vector<procBlock> &blocks,
 
     for (auto &lp : localPos) {
       localBlocks[lp.first].PackSendSolMPI(MPI_uncoupledScalar, MPI_vec3d,
-                                           MPI_tensorDouble);
+                                           MPI_tensorDouble, ROOTP);
     }
   }
 }
@@ -398,8 +790,13 @@ void BroadcastString(string &str) {
 }
 
 // constructor with arguements
-decomposition::decomposition(const int &num, const int &nProcs) {
-  // num -- number of grid blocks
+decomposition::decomposition(const vector<double> &cellCost,
+                             const map<int, double> &faceCost,
+                             const int &nProcs) {
+  // cellCost -- relative cost of a cell in each grid block
+  // faceCost -- additional cost of a face of boundary surfaces with each tag
+  // nProcs -- number of processors
+  const auto num = static_cast<int>(cellCost.size());
 
   // default configuration is all blocks on rank 0
   // default value for rank is 0
@@ -422,21 +819,76 @@ decomposition::decomposition(const int &num, const int &nProcs) {
   vector<string> temp3;
   splitHistDir_ = temp3;
 
+  cellCost_ = cellCost;
+  faceCost_ = faceCost;
   numProcs_ = nProcs;
 }
 
+/*Member function to calibrate the relative cost of a cell in each block from
+ * the measured time spent on each block. The costs are scaled so that the total
+ * load of the decomposition is unchanged. Blocks with no measured time keep
+ * their current cost.*/
+void decomposition::CalibrateCellCost(const vector<double> &blockTime,
+                                      const vector<int> &numCells) {
+  // blockTime -- measured time spent on each block
+  // numCells -- number of cells in each block
+  MSG_ASSERT(static_cast<int>(blockTime.size()) == this->NumBlocks() &&
+                 static_cast<int>(numCells.size()) == this->NumBlocks(),
+             "block size mismatch");
+
+  auto totalLoad = 0.0;
+  auto totalTime = 0.0;
+  for (auto ii = 0; ii < this->NumBlocks(); ++ii) {
+    if (blockTime[ii] > 0.0) {
+      totalLoad += cellCost_[ii] * numCells[ii];
+      totalTime += blockTime[ii];
+    }
+  }
+  if (totalTime <= 0.0) {
+    return;
+  }
+
+  for (auto ii = 0; ii < this->NumBlocks(); ++ii) {
+    if (blockTime[ii] > 0.0) {
+      cellCost_[ii] = totalLoad * blockTime[ii] / (totalTime * numCells[ii]);
+    }
+  }
+}
+
+/*Member function to determine the load of a block. The load is the number of
+ * cells weighted by the relative cost of a cell in the block.*/
+double decomposition::BlockLoad(const vector<plot3dBlock> &grid,
+                                const int &blk) const {
+  // grid -- vector of plot3dBlocks containing entire grid
+  // blk -- block to calculate load for
+  return cellCost_[blk] * grid[blk].NumCells();
+}
+
+/*Member function to determine the additional load of the faces of the boundary
+ * surfaces of a block that have per face work.*/
+double decomposition::FaceLoad(const boundaryConditions &bc) const {
+  // bc -- boundary conditions of block
+  auto load = 0.0;
+  for (auto jj = 0; jj < bc.NumSurfaces(); ++jj) {
+    const auto cost = faceCost_.find(bc.GetTag(jj));
+    if (!bc.IsConnection(jj) && cost != faceCost_.end()) {
+      load += cost->second * bc.GetSurface(jj).NumFaces();
+    }
+  }
+  return load;
+}
+
 /*Member function to determine the ideal load given the mesh. The ideal load the
- * the total number of cells divided by the number of processors.*/
+ * the total load of all blocks divided by the number of processors.*/
 double decomposition::IdealLoad(const vector<plot3dBlock> &grid) const {
   // grid -- vector of plot3dBlocks containing entire grid
 
-  auto totalCells = 0;
+  auto totalLoad = 0.0;
   for (auto ii = 0U; ii < grid.size(); ii++) {
-    totalCells += grid[ii].NumCells();
+    totalLoad += this->BlockLoad(grid, ii);
   }
 
-  return static_cast<double>(totalCells) /
-         static_cast<double>(numProcs_);
+  return totalLoad / static_cast<double>(numProcs_);
 }
 
 /*Member function to determine the maximum load (number of cells) on a
@@ -445,12 +897,12 @@ double decomposition::MaxLoad(const vector<plot3dBlock> &grid) const {
   // grid -- vector of plot3dBlocks containing entire grid (split for
   // decomposition)
 
-  vector<int> load(numProcs_, 0);
+  vector<double> load(numProcs_, 0.0);
   for (auto ii = 0U; ii < grid.size(); ii++) {
-    load[rank_[ii]] += grid[ii].NumCells();
+    load[rank_[ii]] += this->BlockLoad(grid, ii);
   }
 
-  return static_cast<double>(*max_element(load.begin(), load.end()));
+  return *max_element(load.begin(), load.end());
 }
 
 /*Member function to determine the minimum load (number of cells) on a
@@ -459,12 +911,12 @@ double decomposition::MinLoad(const vector<plot3dBlock> &grid) const {
   // grid -- vector of plot3dBlocks containing entire grid (split for
   // decomposition)
 
-  vector<int> load(numProcs_, 0);
+  vector<double> load(numProcs_, 0.0);
   for (auto ii = 0U; ii < grid.size(); ii++) {
-    load[rank_[ii]] += grid[ii].NumCells();
+    load[rank_[ii]] += this->BlockLoad(grid, ii);
   }
 
-  return static_cast<double>(*min_element(load.begin(), load.end()));
+  return *min_element(load.begin(), load.end());
 }
 
 /*Member function to determine the index of the maximum loaded (number of cells)
@@ -475,9 +927,9 @@ int decomposition::MostOverloadedProc(const vector<plot3dBlock> &grid,
   // decomposition)
   // overload -- how much the processor is overloaded by
 
-  vector<int> load(numProcs_, 0);
+  vector<double> load(numProcs_, 0.0);
   for (auto ii = 0U; ii < grid.size(); ii++) {
-    load[rank_[ii]] += grid[ii].NumCells();
+    load[rank_[ii]] += this->BlockLoad(grid, ii);
   }
 
   overload = this->MaxLoad(grid) - this->IdealLoad(grid);
@@ -492,9 +944,9 @@ int decomposition::MostUnderloadedProc(const vector<plot3dBlock> &grid,
   // decomposition)
   // underload -- how much processor is underloaded by
 
-  vector<int> load(numProcs_, 0);
+  vector<double> load(numProcs_, 0.0);
   for (auto ii = 0U; ii < grid.size(); ii++) {
-    load[rank_[ii]] += grid[ii].NumCells();
+    load[rank_[ii]] += this->BlockLoad(grid, ii);
   }
 
   underload = this->IdealLoad(grid) - this->MinLoad(grid);
@@ -553,11 +1005,34 @@ void decomposition::SendToProc(const int &blk, const int &fromProc,
   }
 }
 
-/*Member function to add data for a split*/
-void decomposition::Split(const int &low, const int &ind, const string &dir) {
+/*Member function to assign the blocks of each processor to a different
+processor. All blocks on a processor are moved together, so their local
+positions do not change.*/
+void decomposition::PermuteRanks(const vector<int> &newRank) {
+  // newRank -- new rank of each processor
+  MSG_ASSERT(static_cast<int>(newRank.size()) == numProcs_,
+             "processor size mismatch");
+  for (auto &rank : rank_) {
+    rank = newRank[rank];
+  }
+}
+
+/*Member function to add data for a split. The grid and boundary conditions
+must already be split. The cost of a cell in each portion of the split block is
+found from its own boundary surfaces, so the face load is not given to the
+portion that does not have the faces.*/
+void decomposition::Split(const int &low, const int &ind, const string &dir,
+                          const vector<plot3dBlock> &grid,
+                          const vector<boundaryConditions> &bcs) {
   // low -- index of lower block in split
   // dir -- direction of split
   // ind -- index of split
+  // grid -- vector of plot3dBlocks with split block
+  // bcs -- vector of boundary conditions with split block
+  const auto up = static_cast<int>(rank_.size());
+  MSG_ASSERT(up < static_cast<int>(grid.size()) &&
+                 up < static_cast<int>(bcs.size()),
+             "grid must be split before decomposition");
 
   splitHistBlkLow_.push_back(low);  // assign lower block index in split (given)
   // assign upper block index in split (one more than current max index)
@@ -569,6 +1044,16 @@ void decomposition::Split(const int &low, const int &ind, const string &dir) {
                                 // split block is same as lower
   // parent block of upper portion of split block is same as lower
   parBlock_.push_back(parBlock_[low]);
+  // cost of a cell without faces is the same in both portions of the split
+  // block, face load is given to the portion with the faces
+  const auto lowFaces = this->FaceLoad(bcs[low]);
+  const auto upFaces = this->FaceLoad(bcs[up]);
+  const auto lowCells = grid[low].NumCells();
+  const auto upCells = grid[up].NumCells();
+  const auto baseCost =
+      cellCost_[low] - (lowFaces + upFaces) / (lowCells + upCells);
+  cellCost_[low] = baseCost + lowFaces / lowCells;
+  cellCost_.push_back(baseCost + upFaces / upCells);
 
   // local position of upper portion of split block is equal to number of blocks
   // on processor (b/c indexing starts at 0)
@@ -576,6 +1061,65 @@ void decomposition::Split(const int &low, const int &ind, const string &dir) {
   localPos_.push_back(this->NumBlocksOnProc(rank_[low]) - 1);
 }
 
+/* Member function to return the range of parent block nodes that make up each
+procBlock. The ranges are found by replaying the split history on the node
+ranges of the parent blocks. This allows the nodes of a procBlock to be read
+directly from the grid file without reading the entire parent block.
+*/
+vector<array<range, 3>> decomposition::NodeRanges(
+    const vector<vector3d<int>> &parentNodes) const {
+  // parentNodes -- number of nodes in each direction of each parent block
+
+  MSG_ASSERT(static_cast<int>(parentNodes.size()) + this->NumSplits() ==
+                 this->NumBlocks(), "parent block size mismatch");
+  vector<array<range, 3>> ranges(this->NumBlocks(),
+                                 {range(0), range(0), range(0)});
+  for (auto ii = 0U; ii < parentNodes.size(); ++ii) {
+    ranges[ii] = {range(0, parentNodes[ii].X()),
+                  range(0, parentNodes[ii].Y()),
+                  range(0, parentNodes[ii].Z())};
+  }
+
+  // split ranges by decomposition
+  for (auto ii = 0; ii < this->NumSplits(); ++ii) {
+    const auto ind = this->SplitHistIndex(ii);
+    const auto lower = this->SplitHistBlkLower(ii);
+    const auto upper = this->SplitHistBlkUpper(ii);
+    const auto dir = this->SplitHistDir(ii);
+    const auto dd = (dir == "i") ? 0 : (dir == "j") ? 1 : 2;
+
+    // split index is relative to start of lower block
+    const auto start = ranges[lower][dd].Start();
+    ranges[upper] = ranges[lower];
+    ranges[upper][dd] = range(start + ind, ranges[lower][dd].End());
+    ranges[lower][dd] = range(start, start + ind + 1);
+  }
+  return ranges;
+}
+
+/* Member function to return the range of parent block cells that make up each
+procBlock. Unlike the node ranges, the cell ranges of the lower and upper
+portions of a split do not overlap.
+*/
+vector<array<range, 3>> decomposition::CellRanges(
+    const vector<vector3d<int>> &parentCells) const {
+  // parentCells -- number of cells in each direction of each parent block
+
+  vector<vector3d<int>> parentNodes;
+  parentNodes.reserve(parentCells.size());
+  for (const auto &cells : parentCells) {
+    parentNodes.emplace_back(cells.X() + 1, cells.Y() + 1, cells.Z() + 1);
+  }
+
+  auto ranges = this->NodeRanges(parentNodes);
+  for (auto &blkRange : ranges) {
+    for (auto &dirRange : blkRange) {
+      dirRange = range(dirRange.Start(), dirRange.End() - 1);
+    }
+  }
+  return ranges;
+}
+
 int decomposition::GlobalPos(const int &rank, const int &localPos) const {
   auto globalPos = -1;
   for (auto ii = 0U; ii < rank_.size(); ++ii) {
@@ -588,6 +1132,60 @@ int decomposition::GlobalPos(const int &rank, const int &localPos) const {
   return globalPos;
 }
 
+/* Member function to return the number of processors that hold at least one
+procBlock. For agglomerated multigrid levels this is less than the total
+number of processors.*/
+int decomposition::NumActiveProcs() const {
+  const auto numOnProc = this->NumBlocksOnAllProc();
+  return std::count_if(std::begin(numOnProc), std::end(numOnProc),
+                       [](const auto &num) { return num > 0; });
+}
+
+/* Member function to agglomerate the procBlocks onto fewer processors. This
+is used for coarse multigrid levels when there are too few cells per processor
+to make the parallel communication worthwhile. The active processors are
+mapped onto the first numActive ranks so that neighboring ranks are combined.
+The procBlocks of each agglomerated rank are ordered by their original rank,
+then by their original local position. This ordering allows data to be
+transferred between the original and agglomerated decompositions without
+sending any indexing information.*/
+decomposition decomposition::Agglomerate(const int &numActive) const {
+  // numActive -- number of processors to agglomerate onto
+
+  const auto numOld = this->NumActiveProcs();
+  MSG_ASSERT(numActive > 0 && numActive <= numOld,
+             "number of agglomerated processors out of range");
+
+  // map old active ranks onto the new ranks
+  vector<int> newRank(numProcs_, 0);
+  auto activeInd = 0;
+  const auto numOnProc = this->NumBlocksOnAllProc();
+  for (auto pp = 0; pp < numProcs_; ++pp) {
+    if (numOnProc[pp] > 0) {
+      newRank[pp] = activeInd * numActive / numOld;
+      activeInd++;
+    }
+  }
+
+  // blocks are not split, so split history is not needed
+  auto agg = *this;
+  agg.splitHistBlkLow_.clear();
+  agg.splitHistBlkUp_.clear();
+  agg.splitHistIndex_.clear();
+  agg.splitHistDir_.clear();
+
+  // assign ranks and local positions in order of old rank, old local position
+  vector<int> numAgg(numProcs_, 0);
+  for (auto pp = 0; pp < numProcs_; ++pp) {
+    for (auto lp = 0; lp < numOnProc[pp]; ++lp) {
+      const auto gp = this->GlobalPos(pp, lp);
+      agg.rank_[gp] = newRank[pp];
+      agg.localPos_[gp] = numAgg[newRank[pp]]++;
+    }
+  }
+  return agg;
+}
+
 // operator overload for << - allows use of cout, cerr, etc.
 ostream &operator<<(ostream &os, const decomposition &d) {
   // os -- stream to print to
@@ -614,13 +1212,13 @@ double decomposition::ProcLoad(const vector<plot3dBlock> &grid,
   // grid -- vector of plot3dBlocks making up entire grid
   // proc -- rank of processor to calculate load for
 
-  auto load = 0;
+  auto load = 0.0;
   for (auto ii = 0U; ii < grid.size(); ii++) {
     if (rank_[ii] == proc) {
-      load += grid[ii].NumCells();
+      load += this->BlockLoad(grid, ii);
     }
   }
-  return static_cast<double>(load);
+  return load;
 }
 
 double decomposition::LoadRatio(const vector<plot3dBlock> &grid,
@@ -660,10 +1258,10 @@ int decomposition::SendWholeOrSplit(const vector<plot3dBlock> &grid,
   // ratios
   for (auto ii = 0U; ii < grid.size(); ii++) {
     if (rank_[ii] == send) {
-      auto newSendRatio = fabs(
-          1.0 - (sendLoad - static_cast<double>(grid[ii].NumCells())) / ideal);
-      auto newRecvRatio = fabs(
-          1.0 - (recvLoad + static_cast<double>(grid[ii].NumCells())) / ideal);
+      auto newSendRatio =
+          fabs(1.0 - (sendLoad - this->BlockLoad(grid, ii)) / ideal);
+      auto newRecvRatio =
+          fabs(1.0 - (recvLoad + this->BlockLoad(grid, ii)) / ideal);
       if (newSendRatio < sendRatio &&
           newRecvRatio < recvRatio) {  // can send whole block
         blk = ii;
@@ -673,17 +1271,17 @@ int decomposition::SendWholeOrSplit(const vector<plot3dBlock> &grid,
   }
 
   // find out which block to split - largest
-  auto bSize = 0;
+  auto bLoad = 0.0;
   for (auto ii = 0U; ii < grid.size(); ii++) {
     if (rank_[ii] == send) {
-      if (grid[ii].NumCells() > bSize) {
+      if (this->BlockLoad(grid, ii) > bLoad) {
         blk = ii;
-        bSize = grid[ii].NumCells();
+        bLoad = this->BlockLoad(grid, ii);
       }
     }
   }
 
-  // get block split direction, plane size, and possible split length
+  // get block split direction, plane load, and possible split length
   auto planeSize = 0;
   auto splitLen = 0;
   if (grid[blk].NumK() >= grid[blk].NumJ() &&
@@ -702,6 +1300,8 @@ int decomposition::SendWholeOrSplit(const vector<plot3dBlock> &grid,
     splitLen = grid[blk].NumI();
   }
 
+  const auto planeLoad = cellCost_[blk] * planeSize;
+
   // get split index
   // splitLen - 2 bc index is last cell that is kept in lower portion of split,
   // if entire length is kept, no split, need to keep at least 2 cells thick for
@@ -709,10 +1309,8 @@ int decomposition::SendWholeOrSplit(const vector<plot3dBlock> &grid,
   // starting index at 2 so split is at least 2 cells thick for ghost cell
   // passing - ind is the face index to split at
   for (auto ii = 2; ii < splitLen - 2; ii++) {
-    auto newSendRatio = fabs(
-        1.0 - (sendLoad - static_cast<double>(planeSize * ii)) / ideal);
-    auto newRecvRatio = fabs(
-        1.0 - (recvLoad + static_cast<double>(planeSize * ii)) / ideal);
+    auto newSendRatio = fabs(1.0 - (sendLoad - planeLoad * ii) / ideal);
+    auto newRecvRatio = fabs(1.0 - (recvLoad + planeLoad * ii) / ideal);
     if (newSendRatio < sendRatio &&
         newRecvRatio < recvRatio) {  // can send block at index
       sendRatio = newSendRatio;
@@ -734,7 +1332,8 @@ void decomposition::PrintDiagnostics(const vector<plot3dBlock> &grid) const {
          << ", NumI: " << grid[ii].NumI() - 1
          << ", NumJ: " << grid[ii].NumJ() - 1
          << ", NumK: " << grid[ii].NumK() - 1
-         << ", Num Cells: " << grid[ii].NumCells() << endl;
+         << ", Num Cells: " << grid[ii].NumCells()
+         << ", Cell Cost: " << cellCost_[ii] << endl;
   }
   cout << "Split History" << endl;
   for (auto ii = 0U; ii < splitHistBlkLow_.size(); ii++) {
@@ -794,19 +1393,54 @@ void decomposition::Broadcast() {
     BroadcastString(dir);
   }
 
+  // broadcast cell cost
+  vecSize = cellCost_.size();
+  MPI_Bcast(&vecSize, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
+  cellCost_.resize(vecSize);
+  MPI_Bcast(&(*std::begin(cellCost_)), vecSize, MPI_DOUBLE, ROOTP,
+            MPI_COMM_WORLD);
+
   // broadcast number of processors
   MPI_Bcast(&numProcs_, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
 }
 
-void BroadcastViscFaces(const MPI_Datatype &MPI_vec3d,
-                        vector<vector3d<double>> &viscFaces) {
-  // first determine the number of viscous faces and send that to all processors
-  auto nFaces = static_cast<int>(viscFaces.size());
-  MPI_Bcast(&nFaces, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
+/* Function to gather the viscous face centers found on each processor onto all
+processors. This is used when each processor constructs its own procBlocks.
+*/
+vector<vector3d<double>> GatherViscFaces(
+    const MPI_Datatype &MPI_vec3d, const vector<vector3d<double>> &localFaces) {
+  // MPI_vec3d -- MPI_Datatype used for vector3d<double> transmission
+  // localFaces -- viscous face centers on this processor
+
+  auto numProcs = 0;
+  MPI_Comm_size(MPI_COMM_WORLD, &numProcs);
+
+  // determine the number of viscous faces on each processor
+  auto nFaces = static_cast<int>(localFaces.size());
+  vector<int> recvCounts(numProcs, 0);
+  MPI_Allgather(&nFaces, 1, MPI_INT, recvCounts.data(), 1, MPI_INT,
+                MPI_COMM_WORLD);
+  vector<int> displacements(numProcs, 0);
+  for (auto ii = 1; ii < numProcs; ++ii) {
+    displacements[ii] = displacements[ii - 1] + recvCounts[ii - 1];
+  }
 
-  viscFaces.resize(nFaces);  // allocate space to receive the viscous faces
+  // gather all viscous faces to all processors
+  vector<vector3d<double>> viscFaces(displacements.back() + recvCounts.back());
+  MPI_Allgatherv(localFaces.data(), nFaces, MPI_vec3d, viscFaces.data(),
+                 recvCounts.data(), displacements.data(), MPI_vec3d,
+                 MPI_COMM_WORLD);
+  return viscFaces;
+}
 
-  // broadcast all viscous faces to all processors
-  MPI_Bcast(&viscFaces[0], viscFaces.size(), MPI_vec3d, ROOTP,
-            MPI_COMM_WORLD);
+// function to broadcast the connections from ROOT to all processors
+void BroadcastConnections(const MPI_Datatype &MPI_connection,
+                          vector<connection> &conn) {
+  // first determine the number of connections and send that to all processors
+  auto numConn = static_cast<int>(conn.size());
+  MPI_Bcast(&numConn, 1, MPI_INT, ROOTP, MPI_COMM_WORLD);
+  conn.resize(numConn);  // allocate space to receive connections
+
+  // broadcast all connections to all processors
+  MPI_Bcast(conn.data(), conn.size(), MPI_connection, ROOTP, MPI_COMM_WORLD);
 }
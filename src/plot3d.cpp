@@ -19,6 +19,8 @@
 #include <cstdlib>
 #include <string>
 #include <vector>
+#include <array>
+#include <memory>
 #include "plot3d.hpp"
 #include "parallel.hpp"
 
@@ -29,9 +31,35 @@ using std::vector;
 using std::ifstream;
 using std::ofstream;
 using std::ios;
+using std::array;
 
 // plot 3d block member functions
 
+// constructor -- create a plot3d block whose nodes are read from a grid file
+// when they are requested
+plot3dBlock::plot3dBlock(const std::shared_ptr<plot3dFile> &file,
+                         const int &blk, const double &LRef)
+    : coords_(0, 0, 0, 0),
+      file_(file),
+      fileBlock_(blk),
+      start_(0, 0, 0),
+      numNodes_(file->BlockSizes()[blk]),
+      lRef_(LRef) {
+  // file -- plot3d grid file
+  // blk -- block number in grid file
+  // LRef -- reference length to nondimensionalize coordinates
+}
+
+// private member function to get the coordinates of a node from the grid file
+const vector3d<double> &plot3dBlock::FileCoords(const int &ii, const int &jj,
+                                                const int &kk) const {
+  // ii -- i index of node
+  // jj -- j index of node
+  // kk -- k index of node
+  return file_->ReadNode(fileBlock_, start_[0] + ii, start_[1] + jj,
+                         start_[2] + kk, lRef_);
+}
+
 // member function to calculate the centroid of a given cell
 vector3d<double> plot3dBlock::Centroid(const int &ii, const int &jj,
                                        const int &kk) const {
@@ -359,88 +387,282 @@ multiArray3d<vector3d<double>> plot3dBlock::FaceCenterK() const {
 }
 
 //------------------------------------------------------------------------------
-// function to read in a plot3d grid and assign it to a plot3dMesh data type
-vector<plot3dBlock> ReadP3dGrid(const string &gridName, const double &LRef,
-                                double &numCells) {
-  // open binary plot3d grid file
-  ifstream fName;
-  string fPostfix = ".xyz";
-  auto readName = gridName + fPostfix;
-  fName.open(readName, ios::in | ios::binary);
+// constructor -- open grid file and read block dimensions
+plot3dFile::plot3dFile(const string &name)
+    : file_(name, ios::in | ios::binary | ios::ate),
+      name_(name),
+      swapBytes_(false),
+      recordMarkers_(false) {
+  // name -- name of grid file
 
   // check to see if file opened correctly
-  if (fName.fail()) {
-    cerr << "ERROR: Error in plot3d.cpp:ReadP3dGrid(). Grid file " << readName
+  if (file_.fail()) {
+    cerr << "ERROR: Error in plot3dFile::plot3dFile(). Grid file " << name_
          << " did not open correctly!!!" << endl;
     exit(EXIT_FAILURE);
   }
+  const std::streamoff fileSize = file_.tellg();
+
+  // try native byte order without record markers first
+  if (!this->ReadHeader(fileSize, false, false) &&
+      !this->ReadHeader(fileSize, true, false) &&
+      !this->ReadHeader(fileSize, false, true) &&
+      !this->ReadHeader(fileSize, true, true)) {
+    cerr << "ERROR: Error in plot3dFile::plot3dFile(). Size of grid file "
+         << name_ << " does not match the block dimensions in the file. It is "
+         << "not a multi-block, 3D, double precision plot3d grid file!"
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Private member function to read the block dimensions at the start of the
+file assuming a given byte order and whether or not the file has Fortran record
+markers. Each Fortran record is preceded and followed by its length. The header
+is valid if the block dimensions are positive and the size of the file matches
+them.
+*/
+bool plot3dFile::ReadHeader(const std::streamoff &fileSize, const bool &swap,
+                            const bool &markers) {
+  // fileSize -- size of file in bytes
+  // swap -- flag to reverse byte order of values read from file
+  // markers -- flag for Fortran record markers
+  swapBytes_ = swap;
+  recordMarkers_ = markers;
+  blkSize_.clear();
+  blkOffset_.clear();
+
+  const std::streamoff marker = markers ? sizeof(int) : 0;
+  const auto readInt = [this, &swap]() {
+    auto val = 0;
+    file_.read(reinterpret_cast<char *>(&val), sizeof(val));
+    return swap ? ReverseBytes(val) : val;
+  };
+
+  // read the number of plot3d blocks in the file
+  file_.clear();
+  file_.seekg(marker);
+  const auto numBlks = readInt();
+  std::streamoff loc = 3 * marker + sizeof(int);
+  const std::streamoff dimsSize = 3 * sizeof(int) * std::max(numBlks, 0);
+  if (file_.fail() || numBlks <= 0 || loc + dimsSize > fileSize) {
+    return false;
+  }
+
+  // read the number of i, j, k nodes in each plot3d block
+  file_.seekg(loc);
+  blkSize_.resize(numBlks);
+  for (auto &size : blkSize_) {
+    size[0] = readInt();
+    size[1] = readInt();
+    size[2] = readInt();
+    if (size[0] <= 0 || size[1] <= 0 || size[2] <= 0) {
+      return false;
+    }
+  }
+  loc += dimsSize + marker;
+
+  // find location of start of each block in file
+  // each block contains all x coordinates, then y, then z
+  blkOffset_.reserve(numBlks);
+  for (const auto &size : blkSize_) {
+    // dimensions read in wrong byte order can overflow the number of nodes
+    const std::streamoff planeNodes =
+        static_cast<std::streamoff>(size[0]) * size[1];
+    if (planeNodes > fileSize / size[2]) {
+      return false;
+    }
+    blkOffset_.push_back(loc + marker);
+    loc += 2 * marker + 3 * planeNodes * size[2] * sizeof(double);
+    if (loc > fileSize) {
+      return false;
+    }
+  }
+  return !file_.fail() && loc == fileSize;
+}
+
+// member function to read all nodes of a block
+multiArray3d<vector3d<double>> plot3dFile::ReadBlock(const int &blk,
+                                                     const double &LRef) {
+  // blk -- block number
+  // LRef -- reference length to nondimensionalize coordinates
+  const auto &size = blkSize_[blk];
+  const array<range, 3> all = {range(0, size[0]), range(0, size[1]),
+                               range(0, size[2])};
+  return this->ReadBlock(blk, all, LRef);
+}
+
+/* Member function to read the nodes in a range of a block. Nodes that are
+contiguous in the file are read in bulk. This is each row of i nodes, each
+plane of nodes if the range covers all i nodes, or all nodes in the range if it
+also covers all j nodes. The coordinates are nondimensionalized in a single
+pass over each portion read.
+*/
+multiArray3d<vector3d<double>> plot3dFile::ReadBlock(
+    const int &blk, const array<range, 3> &ranges, const double &LRef) {
+  // blk -- block number
+  // ranges -- range of nodes to read in i, j, k directions
+  // LRef -- reference length to nondimensionalize coordinates
+  const auto &size = blkSize_[blk];
+  const auto &ri = ranges[0];
+  const auto &rj = ranges[1];
+  const auto &rk = ranges[2];
+  const std::streamoff numNodes =
+      static_cast<std::streamoff>(size[0]) * size[1] * size[2];
+
+  // number of j and k nodes in each contiguous portion of file
+  const auto runJ = (ri.Size() == size[0]) ? rj.Size() : 1;
+  const auto runK = (runJ == size[1]) ? rk.Size() : 1;
+
+  multiArray3d<vector3d<double>> coordinates(ri.Size(), rj.Size(), rk.Size(),
+                                             0);
+  vector<double> buffer(ri.Size() * runJ * runK);
+  for (auto dd = 0; dd < 3; ++dd) {
+    for (auto kk = rk.Start(); kk < rk.End(); kk += runK) {
+      for (auto jj = rj.Start(); jj < rj.End(); jj += runJ) {
+        const std::streamoff loc =
+            dd * numNodes +
+            (static_cast<std::streamoff>(kk) * size[1] + jj) * size[0] +
+            ri.Start();
+        file_.seekg(blkOffset_[blk] + loc * sizeof(double));
+        file_.read(reinterpret_cast<char *>(buffer.data()),
+                   buffer.size() * sizeof(double));
+
+        if (swapBytes_) {
+          for (auto &val : buffer) {
+            val = ReverseBytes(val);
+          }
+        }
+        for (auto &val : buffer) {
+          val /= LRef;
+        }
+
+        auto nn = 0;
+        for (auto k2 = kk - rk.Start(); k2 < kk - rk.Start() + runK; ++k2) {
+          for (auto j2 = jj - rj.Start(); j2 < jj - rj.Start() + runJ; ++j2) {
+            for (auto i2 = 0; i2 < ri.Size(); ++i2) {
+              coordinates(i2, j2, k2)[dd] = buffer[nn++];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (file_.fail()) {
+    cerr << "ERROR: Error in plot3dFile::ReadBlock(). Could not read block "
+         << blk << " from grid file " << name_ << endl;
+    exit(EXIT_FAILURE);
+  }
+  return coordinates;
+}
+
+/* Member function to read a single node of a block. Nodes that have already
+been read are kept, so each node is only read from the file once. This is used
+when only a few nodes of the grid are needed, such as the corners of the
+boundary surfaces.
+*/
+const vector3d<double> &plot3dFile::ReadNode(const int &blk, const int &ii,
+                                             const int &jj, const int &kk,
+                                             const double &LRef) {
+  // blk -- block number
+  // ii -- i index of node
+  // jj -- j index of node
+  // kk -- k index of node
+  // LRef -- reference length to nondimensionalize coordinates
+  const array<int, 4> key = {blk, ii, jj, kk};
+  auto node = nodes_.find(key);
+  if (node == nodes_.end()) {
+    const array<range, 3> ranges = {range(ii, ii + 1), range(jj, jj + 1),
+                                    range(kk, kk + 1)};
+    node = nodes_.emplace(key, this->ReadBlock(blk, ranges, LRef)(0, 0, 0))
+               .first;
+  }
+  return node->second;
+}
+
+/* Function to read the header of a plot3d grid. The blocks returned only hold
+their location in the grid file, so the coordinates of the grid are not read.
+The nodes of these blocks are read individually when they are requested. This
+is used on the ROOT processor to decompose the grid and find the connections
+between blocks, which only need the block dimensions, the boundary conditions,
+and the nodes at the corners of the boundary surfaces.
+*/
+vector<plot3dBlock> ReadP3dGrid(const string &gridName, const double &LRef,
+                                double &numCells) {
+  // gridName -- name of grid file (without extension)
+  // LRef -- reference length to nondimensionalize coordinates
+  // numCells -- total number of cells in grid
+
+  // open binary plot3d grid file
+  cout << "Reading grid file header..." << endl << endl;
+  auto grid = std::make_shared<plot3dFile>(gridName + ".xyz");
+  if (grid->SwapBytes()) {
+    cout << "Grid file is in opposite byte order" << endl;
+  }
+  if (grid->RecordMarkers()) {
+    cout << "Grid file has Fortran record markers" << endl;
+  }
 
   // read the number of plot3d blocks in the file
-  cout << "Reading grid file..." << endl << endl;
-  auto numBlks = 1;
-  fName.read(reinterpret_cast<char *>(&numBlks), sizeof(numBlks));
+  const auto numBlks = grid->NumBlocks();
   cout << "Number of blocks: " << numBlks << endl << endl;
 
-  // read the number of i, j, k coordinates in each plot3d block
+  // print the number of i, j, k coordinates in each plot3d block
   cout << "Size of each block is..." << endl;
-  vector<vector3d<int>> blkSize(numBlks);
-  auto tempInt = 0;
   numCells = 0;
-
-  // loop over all blocks and fill i, j, k vectors with block sizes
   for (auto ii = 0; ii < numBlks; ii++) {
+    const auto &size = grid->BlockSizes()[ii];
     cout << "Block Number: " << ii << "     ";
-    fName.read(reinterpret_cast<char *>(&tempInt), sizeof(tempInt));
-    blkSize[ii][0] = tempInt;
-    cout << "I-DIM: " << tempInt << "     ";
-    fName.read(reinterpret_cast<char *>(&tempInt), sizeof(tempInt));
-    blkSize[ii][1] = tempInt;
-    cout << "J-DIM: " << tempInt << "     ";
-    fName.read(reinterpret_cast<char *>(&tempInt), sizeof(tempInt));
-    blkSize[ii][2] = tempInt;
-    cout << "K-DIM: " << tempInt << endl;
+    cout << "I-DIM: " << size[0] << "     ";
+    cout << "J-DIM: " << size[1] << "     ";
+    cout << "K-DIM: " << size[2] << endl;
 
     // calculate total number of cells (subtract 1 because number of cells is 1
     // less than number of points)
-    numCells +=
-        (blkSize[ii][0] - 1) * (blkSize[ii][1] - 1) * (blkSize[ii][2] - 1);
+    numCells += (size[0] - 1) * (size[1] - 1) * (size[2] - 1);
   }
   cout << endl;
 
-  // read each block and add it to the vector of plot3dBlocks
-  auto tempDouble = 0.0;
+  // nodes of each block are read from the file when requested
   vector<plot3dBlock> mesh;
   mesh.reserve(numBlks);
-
   for (auto ii = 0; ii < numBlks; ii++) {
-    multiArray3d<vector3d<double>> coordinates(blkSize[ii][0], blkSize[ii][1],
-                                               blkSize[ii][2], 0);
-
-    for (auto jj = 0; jj < coordinates.Size(); jj++) {
-      fName.read(reinterpret_cast<char *>(&tempDouble), sizeof(tempDouble));
-      coordinates(jj)[0] = tempDouble / LRef;
-    }
-    for (auto jj = 0; jj < coordinates.Size(); jj++) {
-      fName.read(reinterpret_cast<char *>(&tempDouble), sizeof(tempDouble));
-      coordinates(jj)[1] = tempDouble / LRef;
-    }
-    for (auto jj = 0; jj < coordinates.Size(); jj++) {
-      fName.read(reinterpret_cast<char *>(&tempDouble), sizeof(tempDouble));
-      coordinates(jj)[2] = tempDouble / LRef;
-    }
-
-    // create single plot3dBlock and assign it appropriate location in vector
-    mesh.push_back(plot3dBlock(coordinates));
-
-    cout << "Block " << ii << " read" << endl;
+    mesh.emplace_back(grid, ii, LRef);
   }
 
-  cout << endl << "Grid file read" << endl;
+  cout << "Grid file header read" << endl;
   cout << "Total number of cells is " << numCells << endl;
 
-  // close plot3d grid file
-  fName.close();
+  return mesh;
+}
+
 
+/* Function to read the nodes of the procBlocks on a processor directly from a
+plot3d grid file. Only the block dimensions at the start of the file are read
+in full. The node ranges of each procBlock within its parent block are found
+from the decomposition, and only those nodes are read from the file. This
+allows each processor to read its portion of the grid without the entire grid
+being read on a single processor.
+*/
+vector<plot3dBlock> ReadP3dGridLocal(const string &gridName, const double &LRef,
+                                     const decomposition &decomp,
+                                     const int &rank) {
+  // gridName -- name of grid file (without extension)
+  // LRef -- reference length to nondimensionalize coordinates
+  // decomp -- decomposition of grid onto processors
+  // rank -- processor rank
+
+  plot3dFile grid(gridName + ".xyz");
+  const auto ranges = decomp.NodeRanges(grid.BlockSizes());
+
+  vector<plot3dBlock> mesh(decomp.NumBlocksOnProc(rank));
+  for (auto gp = 0; gp < decomp.NumBlocks(); ++gp) {
+    if (decomp.Rank(gp) == rank) {
+      mesh[decomp.LocalPosition(gp)] = plot3dBlock(
+          grid.ReadBlock(decomp.ParentBlock(gp), ranges[gp], LRef));
+    }
+  }
   return mesh;
 }
 
@@ -452,6 +674,21 @@ plot3dBlock plot3dBlock::Split(const string &dir, const int &ind) {
   // dir -- plane to split along, either i, j, or k
   // ind -- index (face) to split at (w/o counting ghost cells)
 
+  // split location of block in grid file, nodes are not read
+  if (file_) {
+    if (dir != "i" && dir != "j" && dir != "k") {
+      cerr << "ERROR: Error in plot3dBlock::Split(). Direction " << dir
+           << " is not recognized! Choose either i, j, or k." << endl;
+      exit(EXIT_FAILURE);
+    }
+    const auto dd = (dir == "i") ? 0 : (dir == "j") ? 1 : 2;
+    auto blk2 = *this;
+    blk2.start_[dd] += ind;
+    blk2.numNodes_[dd] -= ind;
+    numNodes_[dd] = ind + 1;
+    return blk2;
+  }
+
   const auto blk2 = plot3dBlock(coords_.Slice(dir, {ind, coords_.End(dir)}));
   (*this) = plot3dBlock(coords_.Slice(dir, {coords_.Start(dir), ind + 1}));
   return blk2;
@@ -462,6 +699,7 @@ The calling instance will be the lower portion of the joined block,
 and the input instance will be the upper portion of the joined block.
 */
 void plot3dBlock::Join(const plot3dBlock &blk, const string &dir) {
+  MSG_ASSERT(!file_ && !blk.file_, "nodes of blocks must be read to join");
   auto iTot = this->NumI();
   auto jTot = this->NumJ();
   auto kTot = this->NumK();
@@ -21,6 +21,7 @@
 #include <memory>
 #include <utility>
 #include <map>
+#include <limits>                 // numeric_limits
 #include "procBlock.hpp"
 #include "plot3d.hpp"              // plot3d
 #include "eos.hpp"                 // equation of state
@@ -44,6 +45,7 @@
 #include "matMultiArray3d.hpp"
 #include "physicsModels.hpp"
 #include "output.hpp"
+#include "parallel.hpp"               // decomposition
 
 using std::cout;
 using std::endl;
@@ -382,16 +384,25 @@ variable and is eventually used in the time step calculation if the time step
 isn't explicitly specified.
 */
 void procBlock::CalcInvFluxI(const physics &phys, const input &inp,
-                             matMultiArray3d &mainDiagonal) {
+                             matMultiArray3d &mainDiagonal,
+                             const bool &calcJacobian,
+                             const facePass &pass) {
   // phys -- physics models
   // inp -- all input variables
   // mainDiagonal -- main diagonal of LHS to store flux jacobians for implicit
   //                 solver
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
+  // pass -- faces to calculate fluxes on
 
-  // loop over all physical i-faces
+  // loop over all physical i-faces; each k-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
   for (auto kk = fAreaI_.PhysStartK(); kk < fAreaI_.PhysEndK(); kk++) {
     for (auto jj = fAreaI_.PhysStartJ(); jj < fAreaI_.PhysEndJ(); jj++) {
       for (auto ii = fAreaI_.PhysStartI(); ii < fAreaI_.PhysEndI(); ii++) {
+        if (!this->IsFaceInPass(pass, ii, this->NumI())) {
+          continue;
+        }
         primitive faceStateLower;
         primitive faceStateUpper;
 
@@ -449,7 +460,7 @@ void procBlock::CalcInvFluxI(const physics &phys, const input &inp,
                               tempFlux * this->FAreaMagI(ii, jj, kk));
 
           // if using a block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             fluxJacobian fluxJac;
             fluxJac.RusanovFluxJacobian(faceStateLower, phys,
                                         this->FAreaI(ii, jj, kk), true, inp);
@@ -478,12 +489,12 @@ void procBlock::CalcInvFluxI(const physics &phys, const input &inp,
           specRadius_(ii, jj, kk) += specRad;
 
           // if using a block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             fluxJacobian fluxJac;
             fluxJac.RusanovFluxJacobian(faceStateUpper, phys,
                                         this->FAreaI(ii, jj, kk), false, inp);
             mainDiagonal.Subtract(ii, jj, kk, fluxJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             mainDiagonal.Add(ii, jj, kk, fluxJacobian(specRad, isRANS_));
           }
         }
@@ -521,15 +532,24 @@ isn't explicitly specified.
 */
 void procBlock::CalcInvFluxJ(const physics &phys,
                              const input &inp,
-                             matMultiArray3d &mainDiagonal) {
+                             matMultiArray3d &mainDiagonal,
+                             const bool &calcJacobian,
+                             const facePass &pass) {
   // physics -- physics models
   // inp -- all input variables
   // mainDiagonal -- main diagonal of LHS to store flux jacobians for implicit
   //                 solver
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
+  // pass -- faces to calculate fluxes on
 
-  // loop over all physical j-faces
+  // loop over all physical j-faces; each k-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
   for (auto kk = fAreaJ_.PhysStartK(); kk < fAreaJ_.PhysEndK(); kk++) {
     for (auto jj = fAreaJ_.PhysStartJ(); jj < fAreaJ_.PhysEndJ(); jj++) {
+      if (!this->IsFaceInPass(pass, jj, this->NumJ())) {
+        continue;
+      }
       for (auto ii = fAreaJ_.PhysStartI(); ii < fAreaJ_.PhysEndI(); ii++) {
         primitive faceStateLower;
         primitive faceStateUpper;
@@ -588,7 +608,7 @@ void procBlock::CalcInvFluxJ(const physics &phys,
                               tempFlux * this->FAreaMagJ(ii, jj, kk));
 
           // if using block matrix on main diagonal, calculate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             fluxJacobian fluxJac;
             fluxJac.RusanovFluxJacobian(faceStateLower, phys,
                                         this->FAreaJ(ii, jj, kk), true, inp);
@@ -616,12 +636,12 @@ void procBlock::CalcInvFluxJ(const physics &phys,
           specRadius_(ii, jj, kk) += specRad;
 
           // if using block matrix on main diagonal, calculate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             fluxJacobian fluxJac;
             fluxJac.RusanovFluxJacobian(faceStateUpper, phys,
                                         this->FAreaJ(ii, jj, kk), false, inp);
             mainDiagonal.Subtract(ii, jj, kk, fluxJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             mainDiagonal.Add(ii, jj, kk, fluxJacobian(specRad, isRANS_));
           }
         }
@@ -659,15 +679,24 @@ isn't explicitly specified.
 */
 void procBlock::CalcInvFluxK(const physics &phys,
                              const input &inp,
-                             matMultiArray3d &mainDiagonal) {
+                             matMultiArray3d &mainDiagonal,
+                             const bool &calcJacobian,
+                             const facePass &pass) {
   // phys -- physics models
   // inp -- all input variables
   // mainDiagonal -- main diagonal of LHS to store flux jacobians for implicit
   //                 solver
-
-  // loop over all physical k-faces
-  for (auto kk = fAreaK_.PhysStartK(); kk < fAreaK_.PhysEndK(); kk++) {
-    for (auto jj = fAreaK_.PhysStartJ(); jj < fAreaK_.PhysEndJ(); jj++) {
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
+  // pass -- faces to calculate fluxes on
+
+  // loop over all physical k-faces; each j-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
+  for (auto jj = fAreaK_.PhysStartJ(); jj < fAreaK_.PhysEndJ(); jj++) {
+    for (auto kk = fAreaK_.PhysStartK(); kk < fAreaK_.PhysEndK(); kk++) {
+      if (!this->IsFaceInPass(pass, kk, this->NumK())) {
+        continue;
+      }
       for (auto ii = fAreaK_.PhysStartI(); ii < fAreaK_.PhysEndI(); ii++) {
         primitive faceStateLower;
         primitive faceStateUpper;
@@ -726,7 +755,7 @@ void procBlock::CalcInvFluxK(const physics &phys,
                               tempFlux * this->FAreaMagK(ii, jj, kk));
 
           // if using block matrix on main diagonal, calculate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             fluxJacobian fluxJac;
             fluxJac.RusanovFluxJacobian(faceStateLower, phys,
                                         this->FAreaK(ii, jj, kk), true, inp);
@@ -754,12 +783,12 @@ void procBlock::CalcInvFluxK(const physics &phys,
           specRadius_(ii, jj, kk) += specRad;
 
           // if using block matrix on main diagonal, calculate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             fluxJacobian fluxJac;
             fluxJac.RusanovFluxJacobian(faceStateUpper, phys,
                                         this->FAreaK(ii, jj, kk), false, inp);
             mainDiagonal.Subtract(ii, jj, kk, fluxJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             mainDiagonal.Add(ii, jj, kk, fluxJacobian(specRad, isRANS_));
           }
         }
@@ -1231,16 +1260,20 @@ touches 15 cells. The gradient calculation with this stencil uses the "edge"
 ghost cells, but not the "corner" ghost cells.
 */
 void procBlock::CalcViscFluxI(const physics &phys, const input &inp,
-                              matMultiArray3d &mainDiagonal) {
+                              matMultiArray3d &mainDiagonal,
+                              const bool &calcJacobian) {
   // phys -- physics models
   // inp -- all input variables
   // mainDiagonal -- main diagonal of LHS used to store flux jacobians for
   //                 implicit solver
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
 
   const auto viscCoeff = inp.ViscousCFLCoefficient();
   constexpr auto sixth = 1.0 / 6.0;
 
-  // loop over all physical i-faces
+  // loop over all physical i-faces; each k-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
   for (auto kk = fAreaI_.PhysStartK(); kk < fAreaI_.PhysEndK(); kk++) {
     for (auto jj = fAreaI_.PhysStartJ(); jj < fAreaI_.PhysEndJ(); jj++) {
       for (auto ii = fAreaI_.PhysStartI(); ii < fAreaI_.PhysEndI(); ii++) {
@@ -1414,7 +1447,7 @@ void procBlock::CalcViscFluxI(const physics &phys, const input &inp,
           }
 
           // if using block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             // using mu, mut, and f1 at face
             fluxJacobian fluxJac;
             fluxJac.ApproxTSLJacobian(state, mu, mut, f1, phys,
@@ -1465,14 +1498,14 @@ void procBlock::CalcViscFluxI(const physics &phys, const input &inp,
           specRadius_(ii, jj, kk) += specRad * viscCoeff;
 
           // if using block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             // using mu, mut, and f1 at face
             fluxJacobian fluxJac;
             fluxJac.ApproxTSLJacobian(state, mu, mut, f1, phys,
                                       this->FAreaI(ii, jj, kk), c2cDist, inp,
                                       false, velGrad);
             mainDiagonal.Add(ii, jj, kk, fluxJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             // factor 2 because visc spectral radius is not halved (Blazek 6.53)
             mainDiagonal.Add(ii, jj, kk, fluxJacobian(2.0 * specRad, isRANS_));
           }
@@ -1554,16 +1587,20 @@ faces in a cell touches 15 cells. The gradient calculation with this stencil use
 the "edge" ghost cells, but not the "corner" ghost cells.
 */
 void procBlock::CalcViscFluxJ(const physics &phys, const input &inp,
-                              matMultiArray3d &mainDiagonal) {
+                              matMultiArray3d &mainDiagonal,
+                              const bool &calcJacobian) {
   // phys -- physics models
   // inp -- all input variables
   // mainDiagonal -- main diagonal of LHS used to store flux jacobians for
   //                 implicit solver
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
 
   const auto viscCoeff = inp.ViscousCFLCoefficient();
   constexpr auto sixth = 1.0 / 6.0;
 
-  // loop over all physical j-faces
+  // loop over all physical j-faces; each k-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
   for (auto kk = fAreaJ_.PhysStartK(); kk < fAreaJ_.PhysEndK(); kk++) {
     for (auto jj = fAreaJ_.PhysStartJ(); jj < fAreaJ_.PhysEndJ(); jj++) {
       for (auto ii = fAreaJ_.PhysStartI(); ii < fAreaJ_.PhysEndI(); ii++) {
@@ -1737,7 +1774,7 @@ void procBlock::CalcViscFluxJ(const physics &phys, const input &inp,
           }
 
           // if using block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             // using mu, mut, and f1 at face
             fluxJacobian fluxJac;
             fluxJac.ApproxTSLJacobian(state, mu, mut, f1, phys,
@@ -1789,14 +1826,14 @@ void procBlock::CalcViscFluxJ(const physics &phys, const input &inp,
 
 
           // if using block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             // using mu, mut, and f1 at face
             fluxJacobian fluxJac;
             fluxJac.ApproxTSLJacobian(state, mu, mut, f1, phys,
                                       this->FAreaJ(ii, jj, kk), c2cDist, inp,
                                       false, velGrad);
             mainDiagonal.Add(ii, jj, kk, fluxJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             // factor 2 because visc spectral radius is not halved (Blazek 6.53)
             mainDiagonal.Add(ii, jj, kk, fluxJacobian(2.0 * specRad, isRANS_));
           }
@@ -1877,7 +1914,8 @@ faces in a cell touches 15 cells. The gradient calculation with this stencil use
 the "edge" ghost cells, but not the "corner" ghost cells.
 */
 void procBlock::CalcViscFluxK(const physics &phys, const input &inp,
-                              matMultiArray3d &mainDiagonal) {
+                              matMultiArray3d &mainDiagonal,
+                              const bool &calcJacobian) {
   // trans -- viscous transport model
   // thermo -- thermodynamic model
   // eqnState -- equation of state
@@ -1887,13 +1925,16 @@ void procBlock::CalcViscFluxK(const physics &phys, const input &inp,
   // turb -- turbulence model
   // mainDiagonal -- main diagonal of LHS used to store flux jacobians for
   //                 implicit solver
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
 
   const auto viscCoeff = inp.ViscousCFLCoefficient();
   constexpr auto sixth = 1.0 / 6.0;
 
-  // loop over all physical k-faces
-  for (auto kk = fAreaK_.PhysStartK(); kk < fAreaK_.PhysEndK(); kk++) {
-    for (auto jj = fAreaK_.PhysStartJ(); jj < fAreaK_.PhysEndJ(); jj++) {
+  // loop over all physical k-faces; each j-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
+  for (auto jj = fAreaK_.PhysStartJ(); jj < fAreaK_.PhysEndJ(); jj++) {
+    for (auto kk = fAreaK_.PhysStartK(); kk < fAreaK_.PhysEndK(); kk++) {
       for (auto ii = fAreaK_.PhysStartI(); ii < fAreaK_.PhysEndI(); ii++) {
         // calculate gradients
         tensor<double> velGrad;
@@ -2066,7 +2107,7 @@ void procBlock::CalcViscFluxK(const physics &phys, const input &inp,
           }
 
           // if using block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             // using mu, mut, and f1 at face
             fluxJacobian fluxJac;
             fluxJac.ApproxTSLJacobian(state, mu, mut, f1, phys,
@@ -2117,14 +2158,14 @@ void procBlock::CalcViscFluxK(const physics &phys, const input &inp,
           specRadius_(ii, jj, kk) += specRad * viscCoeff;
 
           // if using block matrix on main diagonal, accumulate flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             // using mu, mut, and f1 at face
             fluxJacobian fluxJac;
             fluxJac.ApproxTSLJacobian(state, mu, mut, f1, phys,
                                       this->FAreaK(ii, jj, kk), c2cDist, inp,
                                       false, velGrad);
             mainDiagonal.Add(ii, jj, kk, fluxJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             // factor 2 because visc spectral radius is not halved (Blazek 6.53)
             mainDiagonal.Add(ii, jj, kk, fluxJacobian(2.0 * specRad, isRANS_));
           }
@@ -3122,6 +3163,77 @@ void procBlock::SwapEddyViscAndGradientSliceMPI(
   }
 }
 
+/* Functions to pack and unpack the slices swapped across a connection boundary
+when the neighboring procBlocks are on different processors. Data is copied
+directly between the block arrays and the message buffer using the cell
+locations precomputed for the connection. Each function returns a pointer to
+the end of the data it packed or unpacked.
+*/
+double *procBlock::PackStateSlice(const haloSlice &slice,
+                                  double *buffer) const {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to pack data into
+  return PackCells(state_, slice.sendCells_, buffer);
+}
+
+const double *procBlock::UnpackStateSlice(const haloSlice &slice,
+                                          const double *buffer) {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to unpack data from
+  return UnpackCells(state_, slice.recvCells_, buffer);
+}
+
+double *procBlock::PackTurbSlice(const haloSlice &slice,
+                                 double *buffer) const {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to pack data into
+  buffer = PackCells(f1_, slice.sendCells_, buffer);
+  return PackCells(f2_, slice.sendCells_, buffer);
+}
+
+const double *procBlock::UnpackTurbSlice(const haloSlice &slice,
+                                         const double *buffer) {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to unpack data from
+  buffer = UnpackCells(f1_, slice.recvCells_, buffer);
+  return UnpackCells(f2_, slice.recvCells_, buffer);
+}
+
+double *procBlock::PackWallDistSlice(const haloSlice &slice,
+                                     double *buffer) const {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to pack data into
+  return PackCells(wallDist_, slice.sendCells_, buffer);
+}
+
+const double *procBlock::UnpackWallDistSlice(const haloSlice &slice,
+                                             const double *buffer) {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to unpack data from
+  return UnpackCells(wallDist_, slice.recvCells_, buffer);
+}
+
+double *procBlock::PackEddyViscAndGradientSlice(const haloSlice &slice,
+                                                double *buffer) const {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to pack data into
+  buffer = PackCells(velocityGrad_, slice.sendCells_, buffer);
+  if (isTurbulent_) {
+    buffer = PackCells(eddyViscosity_, slice.sendCells_, buffer);
+  }
+  return buffer;
+}
+
+const double *procBlock::UnpackEddyViscAndGradientSlice(
+    const haloSlice &slice, const double *buffer) {
+  // slice -- cells swapped across connection boundary
+  // buffer -- buffer to unpack data from
+  buffer = UnpackCells(velocityGrad_, slice.recvCells_, buffer);
+  if (isTurbulent_) {
+    buffer = UnpackCells(eddyViscosity_, slice.recvCells_, buffer);
+  }
+  return buffer;
+}
 
 /* Member function to overwrite a section of a procBlock's geometry with a
 geomSlice. The function uses the orientation supplied in the connection to
@@ -4038,14 +4150,11 @@ void procBlock::PutStateSlice(const blkMultiArray3d<primitive> &slice,
   state_.PutSlice(slice, inter, d3);
 }
 
-/*Member function to pack and send procBlock geometry data to appropriate
- * processor. */
-void procBlock::PackSendGeomMPI(const MPI_Datatype &MPI_vec3d,
-                                const MPI_Datatype &MPI_vec3dMag) const {
+// member function to get the size of the buffer needed to pack the geometry
+int procBlock::GeomPackSize(const MPI_Datatype &MPI_vec3d,
+                            const MPI_Datatype &MPI_vec3dMag) const {
   // MPI_vec3d -- MPI data type for a vector3d
   // MPI_vec3dMag -- MPI data type for a unitVect3dMag
-  
-  // determine size of buffer to send
   auto sendBufSize = 0;
   auto tempSize = 0;
   // adding 3 more ints for block dimensions
@@ -4108,141 +4217,145 @@ void procBlock::PackSendGeomMPI(const MPI_Datatype &MPI_vec3d,
   for (auto &wd : wallData_) {
     wd.PackSize(sendBufSize, MPI_vec3d);
   }
+  return sendBufSize;
+}
 
-  // allocate buffer to pack data into
-  // use unique_ptr to manage memory; use underlying pointer with MPI calls
-  auto sendBuffer = std::make_unique<char[]>(sendBufSize);
-  auto *rawSendBuffer = sendBuffer.get();
+/* Member function to pack the geometry, boundary conditions, and states of the
+procBlock into a buffer. The buffer can be sent to another processor, or
+written to a file and unpacked later by the same build of aither.*/
+void procBlock::PackGeomMPI(char *buffer, const int &bufSize, int &position,
+                            const MPI_Datatype &MPI_vec3d,
+                            const MPI_Datatype &MPI_vec3dMag) const {
+  // buffer -- buffer to pack data into
+  // bufSize -- size of buffer
+  // position -- position in buffer, updated as data is packed
+  // MPI_vec3d -- MPI data type for a vector3d
+  // MPI_vec3dMag -- MPI data type for a unitVect3dMag
 
   const auto numI = this->NumI();
   const auto numJ = this->NumJ();
   const auto numK = this->NumK();
 
-  // pack data to send into buffer
-  auto position = 0;
+  // pack data into buffer
   // int and vector data
-  MPI_Pack(&numI, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&numJ, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&numK, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&numGhosts_, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&parBlock_, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&rank_, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&localPos_, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&globalPos_, 1, MPI_INT, rawSendBuffer, sendBufSize, &position,
-           MPI_COMM_WORLD);
-  MPI_Pack(&isViscous_, 1, MPI_CXX_BOOL, rawSendBuffer, sendBufSize,
+  MPI_Pack(&numI, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&numJ, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&numK, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&numGhosts_, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&parBlock_, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&rank_, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&localPos_, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&globalPos_, 1, MPI_INT, buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&isViscous_, 1, MPI_CXX_BOOL, buffer, bufSize,
            &position, MPI_COMM_WORLD);
-  MPI_Pack(&isTurbulent_, 1, MPI_CXX_BOOL, rawSendBuffer, sendBufSize,
+  MPI_Pack(&isTurbulent_, 1, MPI_CXX_BOOL, buffer, bufSize,
            &position, MPI_COMM_WORLD);
-  MPI_Pack(&isRANS_, 1, MPI_CXX_BOOL, rawSendBuffer, sendBufSize, &position,
+  MPI_Pack(&isRANS_, 1, MPI_CXX_BOOL, buffer, bufSize, &position,
            MPI_COMM_WORLD);
-  MPI_Pack(&storeTimeN_, 1, MPI_CXX_BOOL, rawSendBuffer, sendBufSize,
+  MPI_Pack(&storeTimeN_, 1, MPI_CXX_BOOL, buffer, bufSize,
            &position, MPI_COMM_WORLD);
-  MPI_Pack(&isMultiLevelTime_, 1, MPI_CXX_BOOL, rawSendBuffer, sendBufSize,
+  MPI_Pack(&isMultiLevelTime_, 1, MPI_CXX_BOOL, buffer, bufSize,
            &position, MPI_COMM_WORLD);
-  MPI_Pack(&isMultiSpecies_, 1, MPI_CXX_BOOL, rawSendBuffer, sendBufSize,
+  MPI_Pack(&isMultiSpecies_, 1, MPI_CXX_BOOL, buffer, bufSize,
            &position, MPI_COMM_WORLD);
-  MPI_Pack(&(*std::begin(state_)), state_.Size(), MPI_DOUBLE, rawSendBuffer,
-           sendBufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&(*std::begin(state_)), state_.Size(), MPI_DOUBLE, buffer,
+           bufSize, &position, MPI_COMM_WORLD);
   if (isMultiLevelTime_) {
     MPI_Pack(&(*std::begin(consVarsNm1_)), consVarsNm1_.Size(), MPI_DOUBLE,
-             rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+             buffer, bufSize, &position, MPI_COMM_WORLD);
   }
-  MPI_Pack(&(*std::begin(nodes_)), nodes_.Size(), MPI_vec3d, rawSendBuffer,
-           sendBufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&(*std::begin(nodes_)), nodes_.Size(), MPI_vec3d, buffer,
+           bufSize, &position, MPI_COMM_WORLD);
   MPI_Pack(&(*std::begin(center_)), center_.Size(), MPI_vec3d,
-           rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+           buffer, bufSize, &position, MPI_COMM_WORLD);
   MPI_Pack(&(*std::begin(fAreaI_)), fAreaI_.Size(), MPI_vec3dMag,
-           rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+           buffer, bufSize, &position, MPI_COMM_WORLD);
   MPI_Pack(&(*std::begin(fAreaJ_)), fAreaJ_.Size(), MPI_vec3dMag,
-           rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+           buffer, bufSize, &position, MPI_COMM_WORLD);
   MPI_Pack(&(*std::begin(fAreaK_)), fAreaK_.Size(), MPI_vec3dMag,
-           rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+           buffer, bufSize, &position, MPI_COMM_WORLD);
   MPI_Pack(&(*std::begin(fCenterI_)), fCenterI_.Size(), MPI_vec3d,
-           rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+           buffer, bufSize, &position, MPI_COMM_WORLD);
   MPI_Pack(&(*std::begin(fCenterJ_)), fCenterJ_.Size(), MPI_vec3d,
-           rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
+           buffer, bufSize, &position, MPI_COMM_WORLD);
   MPI_Pack(&(*std::begin(fCenterK_)), fCenterK_.Size(), MPI_vec3d,
-           rawSendBuffer, sendBufSize, &position, MPI_COMM_WORLD);
-  MPI_Pack(&(*std::begin(vol_)), vol_.Size(), MPI_DOUBLE, rawSendBuffer,
-           sendBufSize, &position, MPI_COMM_WORLD);
+           buffer, bufSize, &position, MPI_COMM_WORLD);
+  MPI_Pack(&(*std::begin(vol_)), vol_.Size(), MPI_DOUBLE, buffer,
+           bufSize, &position, MPI_COMM_WORLD);
 
   // pack boundary condition data
-  bc_.PackBC(rawSendBuffer, sendBufSize, position);
+  bc_.PackBC(buffer, bufSize, position);
 
   // pack wall data
   for (auto &wd : wallData_) {
-    wd.PackWallData(rawSendBuffer, sendBufSize, position, MPI_vec3d);
+    wd.PackWallData(buffer, bufSize, position, MPI_vec3d);
   }
-
-  // send buffer to appropriate processor
-  MPI_Send(rawSendBuffer, sendBufSize, MPI_PACKED, rank_, 2,
-           MPI_COMM_WORLD);
 }
 
-void procBlock::RecvUnpackGeomMPI(const MPI_Datatype &MPI_vec3d,
-                                  const MPI_Datatype &MPI_vec3dMag,
-                                  const input &inp) {
+/*Member function to pack and send procBlock geometry data to appropriate
+ * processor. */
+void procBlock::PackSendGeomMPI(const MPI_Datatype &MPI_vec3d,
+                                const MPI_Datatype &MPI_vec3dMag,
+                                const int &dest) const {
   // MPI_vec3d -- MPI data type for a vector3d
   // MPI_vec3dMag -- MPI data type for a unitVect3dMag
-  // input -- input variables
+  // dest -- processor to send data to
 
-  MPI_Status status;  // allocate MPI_Status structure
+  // allocate buffer to pack data into
+  // use unique_ptr to manage memory; use underlying pointer with MPI calls
+  const auto sendBufSize = this->GeomPackSize(MPI_vec3d, MPI_vec3dMag);
+  auto sendBuffer = std::make_unique<char[]>(sendBufSize);
+  auto *rawSendBuffer = sendBuffer.get();
 
-  // probe message to get correct data size
-  auto recvBufSize = 0;
-  MPI_Probe(ROOTP, 2, MPI_COMM_WORLD, &status);
-  // use MPI_CHAR because sending buffer was allocated with chars
-  MPI_Get_count(&status, MPI_CHAR, &recvBufSize);
+  auto position = 0;
+  this->PackGeomMPI(rawSendBuffer, sendBufSize, position, MPI_vec3d,
+                    MPI_vec3dMag);
 
-  // allocate buffer of correct size
-  // use unique_ptr to manage memory; use underlying pointer with MPI
-  auto recvBuffer = std::make_unique<char[]>(recvBufSize);
-  auto *rawRecvBuffer = recvBuffer.get();
+  // send buffer to appropriate processor
+  MPI_Send(rawSendBuffer, sendBufSize, MPI_PACKED, dest, 2,
+           MPI_COMM_WORLD);
+}
 
-  // receive message from ROOT
-  MPI_Recv(rawRecvBuffer, recvBufSize, MPI_PACKED, ROOTP, 2, MPI_COMM_WORLD,
-           &status);
+// member function to unpack the geometry, boundary conditions, and states of
+// the procBlock from a buffer packed with PackGeomMPI
+void procBlock::UnpackGeomMPI(char *buffer, const int &bufSize, int &position,
+                              const MPI_Datatype &MPI_vec3d,
+                              const MPI_Datatype &MPI_vec3dMag,
+                              const input &inp) {
+  // buffer -- buffer to unpack data from
+  // bufSize -- size of buffer
+  // position -- position in buffer, updated as data is unpacked
+  // MPI_vec3d -- MPI data type for a vector3d
+  // MPI_vec3dMag -- MPI data type for a unitVect3dMag
+  // input -- input variables
 
   auto numI = 0, numJ = 0, numK = 0;
   // unpack procBlock INTs
-  auto position = 0;
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &numI, 1, MPI_INT,
-             MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &numJ, 1, MPI_INT,
-             MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &numK, 1, MPI_INT,
-             MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &numGhosts_, 1, MPI_INT,
+  MPI_Unpack(buffer, bufSize, &position, &numI, 1, MPI_INT, MPI_COMM_WORLD);
+  MPI_Unpack(buffer, bufSize, &position, &numJ, 1, MPI_INT, MPI_COMM_WORLD);
+  MPI_Unpack(buffer, bufSize, &position, &numK, 1, MPI_INT, MPI_COMM_WORLD);
+  MPI_Unpack(buffer, bufSize, &position, &numGhosts_, 1, MPI_INT,
              MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &parBlock_, 1, MPI_INT,
+  MPI_Unpack(buffer, bufSize, &position, &parBlock_, 1, MPI_INT,
              MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &rank_, 1, MPI_INT,
+  MPI_Unpack(buffer, bufSize, &position, &rank_, 1, MPI_INT, MPI_COMM_WORLD);
+  MPI_Unpack(buffer, bufSize, &position, &localPos_, 1, MPI_INT,
              MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &localPos_, 1, MPI_INT,
-             MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &globalPos_, 1, MPI_INT,
+  MPI_Unpack(buffer, bufSize, &position, &globalPos_, 1, MPI_INT,
              MPI_COMM_WORLD);
 
   // unpack procBlock bools
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &isViscous_, 1,
+  MPI_Unpack(buffer, bufSize, &position, &isViscous_, 1,
              MPI_CXX_BOOL, MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &isTurbulent_, 1,
+  MPI_Unpack(buffer, bufSize, &position, &isTurbulent_, 1,
              MPI_CXX_BOOL, MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &isRANS_, 1,
+  MPI_Unpack(buffer, bufSize, &position, &isRANS_, 1,
              MPI_CXX_BOOL, MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &storeTimeN_, 1,
+  MPI_Unpack(buffer, bufSize, &position, &storeTimeN_, 1,
              MPI_CXX_BOOL, MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &isMultiLevelTime_, 1,
+  MPI_Unpack(buffer, bufSize, &position, &isMultiLevelTime_, 1,
              MPI_CXX_BOOL, MPI_COMM_WORLD);
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &isMultiSpecies_, 1,
+  MPI_Unpack(buffer, bufSize, &position, &isMultiSpecies_, 1,
              MPI_CXX_BOOL, MPI_COMM_WORLD);
 
   // clean and resize the vectors in the class to
@@ -4250,52 +4363,82 @@ void procBlock::RecvUnpackGeomMPI(const MPI_Datatype &MPI_vec3d,
                         inp.NumSpecies());
 
   // unpack vector data into allocated vectors
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &(*std::begin(state_)),
+  MPI_Unpack(buffer, bufSize, &position, &(*std::begin(state_)),
              state_.Size(), MPI_DOUBLE,
              MPI_COMM_WORLD);  // unpack states
   if (isMultiLevelTime_) {
-    MPI_Unpack(rawRecvBuffer, recvBufSize, &position,
+    MPI_Unpack(buffer, bufSize, &position,
                &(*std::begin(consVarsNm1_)), consVarsNm1_.Size(), MPI_DOUBLE,
                MPI_COMM_WORLD);  // unpack sol n-1
   }
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &(*std::begin(nodes_)),
+  MPI_Unpack(buffer, bufSize, &position, &(*std::begin(nodes_)),
              nodes_.Size(), MPI_vec3d,
              MPI_COMM_WORLD);  // unpack nodes
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &(*std::begin(center_)),
+  MPI_Unpack(buffer, bufSize, &position, &(*std::begin(center_)),
              center_.Size(), MPI_vec3d,
              MPI_COMM_WORLD);  // unpack cell centers
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &(*std::begin(fAreaI_)),
+  MPI_Unpack(buffer, bufSize, &position, &(*std::begin(fAreaI_)),
              fAreaI_.Size(), MPI_vec3dMag,
              MPI_COMM_WORLD);  // unpack face area I
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &(*std::begin(fAreaJ_)),
+  MPI_Unpack(buffer, bufSize, &position, &(*std::begin(fAreaJ_)),
              fAreaJ_.Size(), MPI_vec3dMag,
              MPI_COMM_WORLD);  // unpack face area J
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &(*std::begin(fAreaK_)),
+  MPI_Unpack(buffer, bufSize, &position, &(*std::begin(fAreaK_)),
              fAreaK_.Size(), MPI_vec3dMag,
              MPI_COMM_WORLD);  // unpack face area K
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position,
+  MPI_Unpack(buffer, bufSize, &position,
              &(*std::begin(fCenterI_)), fCenterI_.Size(), MPI_vec3d,
              MPI_COMM_WORLD);  // unpack face center I
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position,
+  MPI_Unpack(buffer, bufSize, &position,
              &(*std::begin(fCenterJ_)), fCenterJ_.Size(), MPI_vec3d,
              MPI_COMM_WORLD);  // unpack face center J
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position,
+  MPI_Unpack(buffer, bufSize, &position,
              &(*std::begin(fCenterK_)), fCenterK_.Size(), MPI_vec3d,
              MPI_COMM_WORLD);  // unpack face center K
-  MPI_Unpack(rawRecvBuffer, recvBufSize, &position, &(*std::begin(vol_)),
+  MPI_Unpack(buffer, bufSize, &position, &(*std::begin(vol_)),
              vol_.Size(), MPI_DOUBLE,
              MPI_COMM_WORLD);  // unpack volumes
 
   // unpack boundary conditions
-  bc_.UnpackBC(rawRecvBuffer, recvBufSize, position);
+  bc_.UnpackBC(buffer, bufSize, position);
 
   // unpack wall data
   wallData_.resize(bc_.NumViscousSurfaces());
   for (auto &wd : wallData_) {
-    wd.UnpackWallData(rawRecvBuffer, recvBufSize, position, MPI_vec3d, inp);
+    wd.UnpackWallData(buffer, bufSize, position, MPI_vec3d, inp);
   }
 }
 
+void procBlock::RecvUnpackGeomMPI(const MPI_Datatype &MPI_vec3d,
+                                  const MPI_Datatype &MPI_vec3dMag,
+                                  const input &inp, const int &source) {
+  // MPI_vec3d -- MPI data type for a vector3d
+  // MPI_vec3dMag -- MPI data type for a unitVect3dMag
+  // input -- input variables
+  // source -- processor to receive data from
+
+  MPI_Status status;  // allocate MPI_Status structure
+
+  // probe message to get correct data size
+  auto recvBufSize = 0;
+  MPI_Probe(source, 2, MPI_COMM_WORLD, &status);
+  // use MPI_CHAR because sending buffer was allocated with chars
+  MPI_Get_count(&status, MPI_CHAR, &recvBufSize);
+
+  // allocate buffer of correct size
+  // use unique_ptr to manage memory; use underlying pointer with MPI
+  auto recvBuffer = std::make_unique<char[]>(recvBufSize);
+  auto *rawRecvBuffer = recvBuffer.get();
+
+  // receive message from source processor
+  MPI_Recv(rawRecvBuffer, recvBufSize, MPI_PACKED, source, 2, MPI_COMM_WORLD,
+           &status);
+
+  auto position = 0;
+  this->UnpackGeomMPI(rawRecvBuffer, recvBufSize, position, MPI_vec3d,
+                      MPI_vec3dMag, inp);
+}
+
 /*Member function to zero and resize the vectors in a procBlock to their
  * appropriate size given the i, j, and k dimensions.*/
 void procBlock::CleanResizeVecs(const int &numI, const int &numJ,
@@ -4366,22 +4509,24 @@ void procBlock::CleanResizeVecs(const int &numI, const int &numJ,
 }
 
 /*Member function to receive and unpack procBlock state data. This is used to
- * gather the solution on the ROOT processor to write out the solution. */
+ * gather the solution on the ROOT processor to write out the solution, and to
+ * move blocks between processors when the load is rebalanced. */
 void procBlock::RecvUnpackSolMPI(const MPI_Datatype &MPI_uncoupledScalar,
                                  const MPI_Datatype &MPI_vec3d,
                                  const MPI_Datatype &MPI_tensorDouble,
-                                 const input &inp) {
+                                 const input &inp, const int &source) {
   // MPI_uncoupledScalar -- MPI data type for uncoupledScalar
   // MPI_vec3d -- MPI data type for vector3d<double>
   // MPI_tensorDouble -- MPI data taype for tensor<double>
   // input -- input variables
+  // source -- processor to receive data from
 
   MPI_Status status;  // allocate MPI_Status structure
 
   // probe message to get correct data size
   auto recvBufSize = 0;
   // global position used as tag because each block has a unique one
-  MPI_Probe(rank_, globalPos_, MPI_COMM_WORLD, &status);
+  MPI_Probe(source, globalPos_, MPI_COMM_WORLD, &status);
   MPI_Get_count(&status, MPI_CHAR, &recvBufSize);  // use MPI_CHAR because
                                                    // sending buffer was
                                                    // allocated with chars
@@ -4390,8 +4535,8 @@ void procBlock::RecvUnpackSolMPI(const MPI_Datatype &MPI_uncoupledScalar,
   auto recvBuffer = std::make_unique<char[]>(recvBufSize);
   auto *rawRecvBuffer = recvBuffer.get();
 
-  // receive message from non-ROOT
-  MPI_Recv(rawRecvBuffer, recvBufSize, MPI_PACKED, rank_, globalPos_,
+  // receive message from source processor
+  MPI_Recv(rawRecvBuffer, recvBufSize, MPI_PACKED, source, globalPos_,
            MPI_COMM_WORLD, &status);
 
   // unpack vector data into allocated vectors
@@ -4485,15 +4630,18 @@ void procBlock::RecvUnpackSolMPI(const MPI_Datatype &MPI_uncoupledScalar,
   }
 }
 
-/*Member function to pack and send procBlock state data to the ROOT proecessor.
+/*Member function to pack and send procBlock state data to another processor.
  * This is used to gather the solution on the ROOT processor to write out the
- * solution. */
+ * solution, and to move blocks between processors when the load is
+ * rebalanced. */
 void procBlock::PackSendSolMPI(const MPI_Datatype &MPI_uncoupledScalar,
                                const MPI_Datatype &MPI_vec3d,
-                               const MPI_Datatype &MPI_tensorDouble) const {
+                               const MPI_Datatype &MPI_tensorDouble,
+                               const int &dest) const {
   // MPI_uncoupledScalar -- MPI data type for uncoupledScalar
   // MPI_vec3d -- MPI data type for vector3d<double>
   // MPI_tensorDouble -- MPI data taype for tensor<double>
+  // dest -- processor to send data to
 
   // determine size of buffer to send
   auto sendBufSize = 0;
@@ -4653,10 +4801,18 @@ void procBlock::PackSendSolMPI(const MPI_Datatype &MPI_uncoupledScalar,
   }
 
   // send buffer to appropriate processor
-  MPI_Send(rawSendBuffer, sendBufSize, MPI_PACKED, ROOTP, globalPos_,
+  MPI_Send(rawSendBuffer, sendBufSize, MPI_PACKED, dest, globalPos_,
            MPI_COMM_WORLD);
 }
 
+// member function to assign the processor and local position of the procBlock
+// from a decomposition
+void procBlock::AssignDecomposition(const decomposition &decomp) {
+  // decomp -- decomposition of grid onto processors
+  rank_ = decomp.Rank(globalPos_);
+  localPos_ = decomp.LocalPosition(globalPos_);
+}
+
 /* Member function to split a procBlock along a plane defined by a direction and
 an index. The calling instance will retain the lower portion of the split,
 and the returned instance will retain the upper portion of the split.
@@ -5791,7 +5947,9 @@ void procBlock::CalcGradsI() {
 
   constexpr auto sixth = 1.0 / 6.0;
 
-  // loop over all physical i-faces
+  // loop over all physical i-faces; each k-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
   for (auto kk = fAreaI_.PhysStartK(); kk < fAreaI_.PhysEndK(); kk++) {
     for (auto jj = fAreaI_.PhysStartJ(); jj < fAreaI_.PhysEndJ(); jj++) {
       for (auto ii = fAreaI_.PhysStartI(); ii < fAreaI_.PhysEndI(); ii++) {
@@ -5846,7 +6004,9 @@ void procBlock::CalcGradsJ() {
 
   constexpr auto sixth = 1.0 / 6.0;
 
-  // loop over all physical j-faces
+  // loop over all physical j-faces; each k-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
   for (auto kk = fAreaJ_.PhysStartK(); kk < fAreaJ_.PhysEndK(); kk++) {
     for (auto jj = fAreaJ_.PhysStartJ(); jj < fAreaJ_.PhysEndJ(); jj++) {
       for (auto ii = fAreaJ_.PhysStartI(); ii < fAreaJ_.PhysEndI(); ii++) {
@@ -5901,9 +6061,11 @@ void procBlock::CalcGradsK() {
 
   constexpr auto sixth = 1.0 / 6.0;
 
-  // loop over all physical k-faces
-  for (auto kk = fAreaK_.PhysStartK(); kk < fAreaK_.PhysEndK(); kk++) {
-    for (auto jj = fAreaK_.PhysStartJ(); jj < fAreaK_.PhysEndJ(); jj++) {
+  // loop over all physical k-faces; each j-slab of faces only updates
+  // the cells in that slab, so slabs are processed concurrently
+#pragma omp parallel for schedule(static)
+  for (auto jj = fAreaK_.PhysStartJ(); jj < fAreaK_.PhysEndJ(); jj++) {
+    for (auto kk = fAreaK_.PhysStartK(); kk < fAreaK_.PhysEndK(); kk++) {
       for (auto ii = fAreaK_.PhysStartI(); ii < fAreaK_.PhysEndI(); ii++) {
         // calculate gradients
         tensor<double> velGrad;
@@ -5954,10 +6116,12 @@ void procBlock::CalcGradsK() {
 
 // Member function to calculate the source terms and add them to the residual
 void procBlock::CalcSrcTerms(const physics &phys, const input &inp,
-                             matMultiArray3d &mainDiagonal) {
+                             matMultiArray3d &mainDiagonal,
+                             const bool &calcJacobian) {
   // phys -- phyics models
   // mainDiagonal -- main diagonal of LHS used to store flux jacobians for
   //                 implicit solver
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
 
   // loop over all physical cells - no ghost cells needed for source terms
   for (auto kk = 0; kk < this->NumK(); kk++) {
@@ -5968,20 +6132,19 @@ void procBlock::CalcSrcTerms(const physics &phys, const input &inp,
         if (phys.Chemistry()->IsReacting()) {
           // calculate chemistry source terms
           auto chemSpecRad = 0.0;
-          const auto chemJac = src.CalcChemSrc(phys, state_(ii, jj, kk),
-                                               temperature_(ii, jj, kk), 
-                                               vol_(ii, jj, kk),
-                                               inp.IsBlockMatrix(), 
-                                               chemSpecRad);
+          const auto chemJac = src.CalcChemSrc(
+              phys, state_(ii, jj, kk), temperature_(ii, jj, kk),
+              vol_(ii, jj, kk), calcJacobian && inp.IsBlockMatrix(),
+              chemSpecRad);
 
           // add source spectral radius for species equations
           // subtract because residual is initially on opposite side of equation
           specRadius_(ii, jj, kk).SubtractFromFlowVariable(chemSpecRad);
 
           // add contribution of source spectral radius to flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             mainDiagonal.SubtractFromFlow(ii, jj, kk, chemJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             const uncoupledScalar srcJacScalar(chemSpecRad, 0.0);
             mainDiagonal.Subtract(ii, jj, kk,
                                   fluxJacobian(srcJacScalar, isRANS_));
@@ -6007,9 +6170,9 @@ void procBlock::CalcSrcTerms(const physics &phys, const input &inp,
           specRadius_(ii, jj, kk).SubtractFromTurbVariable(turbSpecRad);
 
           // add contribution of source spectral radius to flux jacobian
-          if (inp.IsBlockMatrix()) {
+          if (calcJacobian && inp.IsBlockMatrix()) {
             mainDiagonal.SubtractFromTurb(ii, jj, kk, srcJac);
-          } else if (inp.IsImplicit()) {
+          } else if (calcJacobian && inp.IsImplicit()) {
             const uncoupledScalar srcJacScalar(0.0, turbSpecRad);
             mainDiagonal.Subtract(ii, jj, kk,
                                   fluxJacobian(srcJacScalar, isRANS_));
@@ -6106,21 +6269,40 @@ void procBlock::CalcWallDistance(const kdtree &tree) {
   }
 }
 
-// member function to calculate the residual (RHS) excluding any contributions
-// from source terms
+/* Member function to calculate the residual (RHS) excluding any contributions
+from source terms. The residual can be split into two passes so that the
+interior pass can be done while the ghost cells are still being exchanged. The
+interior pass resets the residual and calculates the inviscid fluxes on the
+interior faces. The boundary pass calculates the inviscid fluxes on the
+remaining faces and everything that depends on the ghost cells.
+*/
 void procBlock::CalcResidualNoSource(const physics &phys, const input &inp,
-                                     matMultiArray3d &mainDiagonal) {
-  // Zero spectral radii, residuals, gradients, turbulence variables
-  this->ResetResidWS();
-  this->ResetGradients();
-  if (isTurbulent_) {
-    this->ResetTurbVars();
+                                     matMultiArray3d &mainDiagonal,
+                                     const bool &calcJacobian,
+                                     const facePass &pass) {
+  // phys -- physics models
+  // inp -- all input variables
+  // mainDiagonal -- main diagonal of LHS to store flux jacobians
+  // calcJacobian -- flag to accumulate flux jacobians on main diagonal
+  // pass -- faces to calculate residual on
+
+  if (pass != facePass::boundary) {
+    // Zero spectral radii, residuals, gradients, turbulence variables
+    this->ResetResidWS();
+    this->ResetGradients();
+    if (isTurbulent_) {
+      this->ResetTurbVars();
+    }
   }
 
   // Calculate inviscid fluxes
-  this->CalcInvFluxI(phys, inp, mainDiagonal);
-  this->CalcInvFluxJ(phys, inp, mainDiagonal);
-  this->CalcInvFluxK(phys, inp, mainDiagonal);
+  this->CalcInvFluxI(phys, inp, mainDiagonal, calcJacobian, pass);
+  this->CalcInvFluxJ(phys, inp, mainDiagonal, calcJacobian, pass);
+  this->CalcInvFluxK(phys, inp, mainDiagonal, calcJacobian, pass);
+
+  if (pass == facePass::interior) {
+    return;
+  }
 
   // If viscous change ghost cells and calculate viscous fluxes
   if (isViscous_) {
@@ -6131,9 +6313,9 @@ void procBlock::CalcResidualNoSource(const physics &phys, const input &inp,
     this->UpdateAuxillaryVariables(phys);
 
     // Calculate viscous fluxes
-    this->CalcViscFluxI(phys, inp, mainDiagonal);
-    this->CalcViscFluxJ(phys, inp, mainDiagonal);
-    this->CalcViscFluxK(phys, inp, mainDiagonal);
+    this->CalcViscFluxI(phys, inp, mainDiagonal, calcJacobian);
+    this->CalcViscFluxJ(phys, inp, mainDiagonal, calcJacobian);
+    this->CalcViscFluxK(phys, inp, mainDiagonal, calcJacobian);
 
   } else {
     // Update temperature
@@ -6419,6 +6601,20 @@ void procBlock::GetSolNm1FromRestart(const blkMultiArray3d<conserved> &restart)
   consVarsNm1_ = restart;
 }
 
+// member function to add a sample of variables at all physical cells to the
+// running statistics -- statistics are started at the first sample
+void procBlock::AddStatisticsSample(const vector<double> &values,
+                                    const int &numVars,
+                                    const vector<array<int, 2>> &pairs) {
+  // values -- sampled variables -- all variables of one cell, then the next
+  // numVars -- number of variables sampled
+  // pairs -- pairs of variables to correlate
+  if (stats_.IsEmpty()) {
+    stats_ = runningStatistics(this->NumCells(), numVars, pairs);
+  }
+  stats_.AddSample(values);
+}
+
 // split all wallData in procBlock
 // The calling instance keeps the lower wallData in the split, and the upper
 // wallData is returned
@@ -172,16 +172,19 @@ geomSlice::geomSlice(const procBlock &blk, const range &ir, const range &jr,
   }
 }
 
-void geomSlice::SameSizeResize(const int &numI, const int &numJ,
-                               const int &numK, const int &ng) {
-  center_.SameSizeResize(numI, numJ, numK);
-  fAreaI_.SameSizeResize(numI + 1, numJ, numK);
-  fAreaJ_.SameSizeResize(numI, numJ + 1, numK);
-  fAreaK_.SameSizeResize(numI, numJ, numK + 1);
-  fCenterI_.SameSizeResize(numI + 1, numJ, numK);
-  fCenterJ_.SameSizeResize(numI, numJ + 1, numK);
-  fCenterK_.SameSizeResize(numI, numJ, numK + 1);
-  vol_.SameSizeResize(numI, numJ, numK);
+// member function to resize the slice to the dimensions of a partner slice
+// the face arrays of a partner slice with a different orientation hold a
+// different number of faces, so the arrays are cleared and resized
+void geomSlice::ClearResize(const int &numI, const int &numJ, const int &numK,
+                            const int &ng) {
+  center_.ClearResize(numI, numJ, numK, ng);
+  fAreaI_.ClearResize(numI + 1, numJ, numK, ng);
+  fAreaJ_.ClearResize(numI, numJ + 1, numK, ng);
+  fAreaK_.ClearResize(numI, numJ, numK + 1, ng);
+  fCenterI_.ClearResize(numI + 1, numJ, numK, ng);
+  fCenterJ_.ClearResize(numI, numJ + 1, numK, ng);
+  fCenterK_.ClearResize(numI, numJ, numK + 1, ng);
+  vol_.ClearResize(numI, numJ, numK, ng);
 }
 
 void geomSlice::PackSwapUnpackMPI(const connection &inter,
@@ -275,7 +278,7 @@ void geomSlice::PackSwapUnpackMPI(const connection &inter,
              MPI_COMM_WORLD);
 
   // resize slice
-  this->SameSizeResize(numI, numJ, numK, numGhosts);
+  this->ClearResize(numI, numJ, numK, numGhosts);
   // unpack center
   MPI_Unpack(rawBuffer, bufSize, &position, &(*std::begin(center_)),
              center_.Size(), MPI_vec3d, MPI_COMM_WORLD);
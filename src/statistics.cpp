@@ -0,0 +1,163 @@
+/*  This file is part of aither.
+    Copyright (C) 2015-19  Michael Nucci (mnucci@pm.me)
+
+    Aither is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Aither is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <vector>       // vector
+#include <string>       // string
+#include <cmath>        // sqrt
+#include <iterator>     // distance
+#include "mpi.h"        // parallelism
+#include "statistics.hpp"
+#include "macros.hpp"
+
+// member function to assign moments read from restart file
+void runningStatistics::AssignMoments(const int &numSamples,
+                                      const vector<double> &moments) {
+  // numSamples -- number of samples accumulated in moments
+  // moments -- moments of all cells
+  MSG_ASSERT(moments.size() == moments_.size(), "moment size mismatch");
+  numSamples_ = numSamples;
+  moments_ = moments;
+}
+
+// member function to add a sample to the moments of all cells with Welford's
+// algorithm
+void runningStatistics::AddSample(const vector<double> &values) {
+  // values -- sampled variables -- all variables of one cell, then the next
+  MSG_ASSERT(values.size() == static_cast<size_t>(numCells_ * numVars_),
+             "sample size mismatch");
+
+  numSamples_++;
+  const auto nInv = 1.0 / numSamples_;
+  const auto numMoments = this->NumMoments();
+  vector<double> delta(numVars_), deltaNew(numVars_);
+  for (auto cc = 0; cc < numCells_; ++cc) {
+    auto *mean = &moments_[cc * numMoments];
+    auto *sqDev = mean + numVars_;
+    auto *prodDev = sqDev + numVars_;
+    const auto *val = &values[cc * numVars_];
+    for (auto vv = 0; vv < numVars_; ++vv) {
+      // deviation from mean before and after mean is updated
+      delta[vv] = val[vv] - mean[vv];
+      mean[vv] += delta[vv] * nInv;
+      deltaNew[vv] = val[vv] - mean[vv];
+      sqDev[vv] += delta[vv] * deltaNew[vv];
+    }
+    for (auto pp = 0U; pp < pairs_.size(); ++pp) {
+      prodDev[pp] += delta[pairs_[pp][0]] * deltaNew[pairs_[pp][1]];
+    }
+  }
+}
+
+// member function to return the mean and rms of each variable, and the
+// covariance of each pair -- all cells of one value, then the next
+vector<double> runningStatistics::Values() const {
+  const auto numMoments = this->NumMoments();
+  vector<double> values(numCells_ * numMoments, 0.0);
+  if (numSamples_ == 0) {
+    return values;
+  }
+  const auto nInv = 1.0 / numSamples_;
+  for (auto cc = 0; cc < numCells_; ++cc) {
+    const auto *mom = &moments_[cc * numMoments];
+    for (auto mm = 0; mm < numMoments; ++mm) {
+      // mean is stored directly, deviations are stored as sums
+      auto val = mom[mm];
+      if (mm >= numVars_) {
+        val *= nInv;
+      }
+      if (mm >= numVars_ && mm < 2 * numVars_) {
+        val = sqrt(val);
+      }
+      values[mm * numCells_ + cc] = val;
+    }
+  }
+  return values;
+}
+
+// member function to send statistics to another processor
+void runningStatistics::SendMPI(const int &dest, const int &tag) const {
+  // dest -- processor to send statistics to
+  // tag -- tag of message
+  vector<int> sizes = {numCells_, numVars_, numSamples_, this->NumPairs()};
+  for (const auto &pair : pairs_) {
+    sizes.push_back(pair[0]);
+    sizes.push_back(pair[1]);
+  }
+  MPI_Send(sizes.data(), sizes.size(), MPI_INT, dest, tag, MPI_COMM_WORLD);
+  MPI_Send(moments_.data(), moments_.size(), MPI_DOUBLE, dest, tag,
+           MPI_COMM_WORLD);
+}
+
+// member function to receive statistics from another processor
+void runningStatistics::RecvMPI(const int &source, const int &tag) {
+  // source -- processor to receive statistics from
+  // tag -- tag of message
+  MPI_Status status;
+  auto numSizes = 0;
+  MPI_Probe(source, tag, MPI_COMM_WORLD, &status);
+  MPI_Get_count(&status, MPI_INT, &numSizes);
+  vector<int> sizes(numSizes);
+  MPI_Recv(sizes.data(), numSizes, MPI_INT, source, tag, MPI_COMM_WORLD,
+           MPI_STATUS_IGNORE);
+
+  vector<array<int, 2>> pairs(sizes[3]);
+  for (auto pp = 0U; pp < pairs.size(); ++pp) {
+    pairs[pp] = {sizes[4 + 2 * pp], sizes[5 + 2 * pp]};
+  }
+  *this = runningStatistics(sizes[0], sizes[1], pairs);
+  numSamples_ = sizes[2];
+  MPI_Recv(moments_.data(), moments_.size(), MPI_DOUBLE, source, tag,
+           MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+// function to find the pairs of variables to correlate -- velocity components
+// are correlated to give the reynolds stresses
+vector<array<int, 2>> StatisticsPairs(const set<string> &vars) {
+  // vars -- variables sampled
+  const vector<string> correlated = {"vel_x", "vel_y", "vel_z"};
+  vector<int> indices;
+  for (const auto &var : correlated) {
+    const auto pos = vars.find(var);
+    if (pos != vars.end()) {
+      indices.push_back(std::distance(vars.begin(), pos));
+    }
+  }
+
+  vector<array<int, 2>> pairs;
+  for (auto ii = 0U; ii < indices.size(); ++ii) {
+    for (auto jj = ii + 1; jj < indices.size(); ++jj) {
+      pairs.push_back({indices[ii], indices[jj]});
+    }
+  }
+  return pairs;
+}
+
+// function to get the names of the statistics written to the function file
+vector<string> StatisticsNames(const set<string> &vars) {
+  // vars -- variables sampled
+  vector<string> names;
+  for (const auto &var : vars) {
+    names.push_back("mean_" + var);
+  }
+  for (const auto &var : vars) {
+    names.push_back("rms_" + var);
+  }
+  const vector<string> sampled(vars.begin(), vars.end());
+  for (const auto &pair : StatisticsPairs(vars)) {
+    names.push_back("cov_" + sampled[pair[0]] + "_" + sampled[pair[1]]);
+  }
+  return names;
+}
@@ -32,6 +32,7 @@
 #include "kdtree.hpp"
 #include "resid.hpp"
 #include "primitive.hpp"
+#include "haloExchange.hpp"
 #include "macros.hpp"
 
 using std::cout;
@@ -398,28 +399,41 @@ vector<vector3d<int>> HyperplaneReorder(const int &imax, const int &jmax,
 }
 
 void SwapImplicitUpdate(vector<blkMultiArray3d<varArray>> &du,
-                        const vector<connection> &connections, const int &rank,
+                        const vector<connection> &connections,
+                        haloExchange &halo, const int &rank,
                         const int &numGhosts) {
   // du -- implicit update in conservative variables
   // conn -- connection boundary conditions
+  // halo -- halo exchange for connection boundaries
   // rank -- processor rank
   // numGhosts -- number of ghost cells
 
-  // loop over all connections and swap connection updates when necessary
-  for (auto &conn : connections) {
-    if (conn.RankFirst() == rank && conn.RankSecond() == rank) {
-      // both sides of connection are on this processor, swap w/o mpi
-      du[conn.LocalBlockFirst()].SwapSlice(conn, du[conn.LocalBlockSecond()]);
-    } else if (conn.RankFirst() == rank) {
-      // rank matches rank of first side of connection, swap over mpi
-      du[conn.LocalBlockFirst()].SwapSliceMPI(conn, rank, MPI_DOUBLE);
-    } else if (conn.RankSecond() == rank) {
-      // rank matches rank of second side of connection, swap over mpi
-      du[conn.LocalBlockSecond()].SwapSliceMPI(conn, rank, MPI_DOUBLE);
+  // set up exchange on first use; update has same dimensions as blocks
+  const auto numVals = du.empty() ? 0 : HaloValuesPerCell(du[0]);
+  if (!halo.IsSetUp(rank)) {
+    vector<vector3d<int>> dims;
+    dims.reserve(du.size());
+    for (const auto &blk : du) {
+      dims.emplace_back(blk.NumINoGhosts(), blk.NumJNoGhosts(),
+                        blk.NumKNoGhosts());
     }
-    // if rank doesn't match either side of connection, then do nothing and
-    // move on to the next connection
+    halo = haloExchange(connections, rank, dims, numGhosts, {{4, numVals}});
   }
+
+  // swap local connections directly, and connections shared with other
+  // processors with one message per neighboring processor
+  halo.Exchange(
+      connections, 4, numVals,
+      [&](const connection &conn) {
+        du[conn.LocalBlockFirst()].SwapSlice(conn,
+                                             du[conn.LocalBlockSecond()]);
+      },
+      [&](const haloSlice &slice, double *buffer) {
+        return PackCells(du[slice.block_], slice.sendCells_, buffer);
+      },
+      [&](const haloSlice &slice, const double *buffer) {
+        return UnpackCells(du[slice.block_], slice.recvCells_, buffer);
+      });
 }
 
 
@@ -41,6 +41,7 @@ class regressionTest:
         self.restartFile = "none"
         self.passedStatus = "none"
         self.isProfile = False
+        self.inputLines = []
 
     def SetRegressionCase(self, name):
         self.caseName = name
@@ -87,6 +88,18 @@ class regressionTest:
     def SetRestartFile(self, resFile):
         self.restartFile = resFile
 
+    # input lines replace the keywords they set in the case input file
+    def SetInputLines(self, lines):
+        self.inputLines = lines
+
+    # copy the case into its own directory so variants of a case do not
+    # share restart, cache, or output files
+    def CopyCase(self, variant):
+        self.runDirectory = self.caseName + "_" + variant
+        if os.path.exists(self.runDirectory):
+            shutil.rmtree(self.runDirectory)
+        shutil.copytree(self.caseName, self.runDirectory)
+
     def ReturnToHomeDirectory(self):
         os.chdir(self.location)
 
@@ -116,16 +129,34 @@ class regressionTest:
 
     def GetResiduals(self):
         return self.residuals
+
+    # run a check on the files of a completed run; a failed check marks the
+    # test as a mismatch
+    def CheckFiles(self, check, description):
+        if self.isProfile or self.passedStatus != "PASSED":
+            return [self.passedStatus in ("PASSED", "PROFILE")]
+        self.GoToRunDirectory()
+        passed = check()
+        self.ReturnToHomeDirectory()
+        if passed:
+            print("Check", description, "for", self.caseName, "PASSED!")
+        else:
+            print("Check", description, "for", self.caseName, "FAILED!")
+            self.passedStatus = "MISMATCH"
+        return [passed]
         
     # change input file to have number of iterations specified for test
     def ModifyInputFile(self):
         fname = self.caseName + ".inp"
         fnameBackup = fname + ".old"
         shutil.move(fname, fnameBackup)
+        replacedKeys = [line.split(":")[0] + ":" for line in self.inputLines]
         with open(fname, "w") as fout:
             with open(fnameBackup, "r") as fin:
                 for line in fin:
-                    if "iterations:" in line:
+                    if any(line.startswith(key) for key in replacedKeys):
+                        continue
+                    elif "iterations:" in line:
                         fout.write("iterations: " + str(self.iterations) + "\n")
                     elif "outputFrequency:" in line:
                         fout.write("outputFrequency: " + str(self.iterations) + "\n")
@@ -133,6 +164,8 @@ class regressionTest:
                         fout.write("restartFrequency: " + str(self.iterations) + "\n")
                     else:
                         fout.write(line)
+            for line in self.inputLines:
+                fout.write(line + "\n")
 
     # modify the input file and run the test
     def RunCase(self):